@@ -0,0 +1,513 @@
+// bench.cpp
+//
+// Standard benchmark driver. Runs a set of grid algorithms over named
+// families of maps (e.g. the movingai bgmaps, dao, iron, mazes) and
+// reports, for each family and algorithm: throughput, latency percentiles,
+// expansions and memory. Results are written as CSV or JSON and can be
+// compared against a saved baseline; the program exits with a non-zero
+// status when a metric regresses by more than the configured threshold.
+//
+// Maps are read from <maps>/<family>/*.map and each map is paired with
+// the scenario file <scens>/<family>/<mapname>.scen
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "cfg.h"
+#include "constants.h"
+#include "global.h"
+#include "gridmap.h"
+#include "grid_searcher.h"
+#include "scenario_manager.h"
+#include "timer.h"
+
+#include "getopt.h"
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace G = global;
+
+int print_help = 0;
+int checkopt = 0;
+
+void
+help()
+{
+    std::cerr
+        << "==> manual <==\n"
+        << "Benchmark grid algorithms over families of maps and compare "
+        << "against a baseline.\n\n"
+        << "--family <name> [name ...]  map families, e.g. bgmaps dao iron\n"
+        << "--alg <name> [name ...]     algorithms (default: jps2 jps2-prune2)\n"
+        << "--maps <dir>                map root (default: ./maps)\n"
+        << "--scens <dir>               scenario root "
+        << "(default: ./scenarios/movingai)\n"
+        << "--max-maps <n>              maps per family (default: all)\n"
+        << "--max-queries <n>           queries per map (default: all)\n"
+        << "--reps <n>                  repetitions; a query's latency is its "
+        << "fastest run (default: 1)\n"
+        << "--format <csv|json>         output format (default: csv)\n"
+        << "--out <file>                write results here (default: stdout)\n"
+        << "--baseline <file>           csv results of an earlier run\n"
+        << "--threshold <frac>          tolerated regression (default: 0.05)\n"
+        << "--metric <name> [name ...]  gated metrics; any of qps, mean_ns, "
+        << "p50_ns, p90_ns, p99_ns, expanded (default: qps p50_ns)\n"
+        << "--checkopt                  verify path costs against the "
+        << "scenario files\n";
+}
+
+struct bench_result
+{
+    std::string family_;
+    std::string alg_;
+    uint32_t maps_;
+    uint64_t queries_;
+    double qps_;
+    double mean_ns_;
+    double p50_ns_;
+    double p90_ns_;
+    double p99_ns_;
+    double max_ns_;
+    double expanded_;
+    double generated_;
+    double touched_;
+    size_t mem_;
+
+    // value of a gated metric and whether larger values are better
+    bool
+    get_metric(const std::string& name, double& value, bool& higher_better) const
+    {
+        higher_better = false;
+        if(name == "qps") { value = qps_; higher_better = true; }
+        else if(name == "mean_ns") { value = mean_ns_; }
+        else if(name == "p50_ns") { value = p50_ns_; }
+        else if(name == "p90_ns") { value = p90_ns_; }
+        else if(name == "p99_ns") { value = p99_ns_; }
+        else if(name == "expanded") { value = expanded_; }
+        else { return false; }
+        return true;
+    }
+};
+
+const char* CSV_HEADER =
+    "family,alg,maps,queries,qps,mean_ns,p50_ns,p90_ns,p99_ns,max_ns,"
+    "expanded,generated,touched,mem";
+
+// nearest-rank percentile over sorted values
+double
+percentile(const std::vector<double>& sorted, double pct)
+{
+    if(sorted.empty()) { return 0; }
+    size_t rank = (size_t)ceil(pct / 100.0 * sorted.size());
+    if(rank > 0) { rank--; }
+    return sorted.at(std::min(rank, sorted.size()-1));
+}
+
+bool
+is_regular_file(const std::string& path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+// list all .map files of a family together with their scenario files
+void
+list_family(const std::string& mapdir, const std::string& scendir,
+        std::vector<std::pair<std::string, std::string>>& files)
+{
+    DIR* dir = opendir(mapdir.c_str());
+    if(!dir)
+    {
+        std::cerr << "err; cannot open map directory " << mapdir << "\n";
+        return;
+    }
+
+    std::vector<std::string> names;
+    for(struct dirent* ent = readdir(dir); ent != 0; ent = readdir(dir))
+    {
+        std::string name(ent->d_name);
+        if(name.size() > 4 && name.compare(name.size()-4, 4, ".map") == 0)
+        { names.push_back(name); }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    for(const std::string& name : names)
+    {
+        std::string scen = scendir + "/" + name + ".scen";
+        if(!is_regular_file(scen))
+        {
+            std::cerr << "skipping " << name << "; no scenario file "
+                << scen << "\n";
+            continue;
+        }
+        files.push_back(std::make_pair(mapdir + "/" + name, scen));
+    }
+}
+
+bool
+check_optimality(warthog::solution& sol, warthog::experiment* exp)
+{
+    double epsilon = 0.005;
+    return fabs(sol.sum_of_edge_costs_ - exp->distance()) <= epsilon;
+}
+
+bench_result
+run_family(const std::string& family, const std::string& alg,
+        const std::vector<std::pair<std::string, std::string>>& files,
+        uint32_t max_queries, uint32_t reps, uint32_t& failures)
+{
+    bench_result res;
+    res.family_ = family;
+    res.alg_ = alg;
+    res.maps_ = 0;
+    res.queries_ = 0;
+    res.mem_ = 0;
+
+    std::vector<double> latencies;
+    double tot_ns = 0, tot_expd = 0, tot_gend = 0, tot_touched = 0;
+
+    for(auto& file : files)
+    {
+        warthog::scenario_manager scenmgr;
+        scenmgr.load_scenario(file.second.c_str());
+        warthog::gridmap map(file.first.c_str());
+        warthog::grid_searcher* algo = warthog::create_grid_searcher(alg, &map);
+
+        uint32_t nqueries = std::min(scenmgr.num_experiments(), max_queries);
+        std::vector<double> best(nqueries, warthog::COST_MAX);
+        warthog::solution sol;
+        for(uint32_t r = 0; r < reps; r++)
+        {
+            for(uint32_t i = 0; i < nqueries; i++)
+            {
+                warthog::experiment* exp = scenmgr.get_experiment(i);
+                warthog::grid_id_t startid = (warthog::grid_id_t)exp->starty() *
+                    exp->mapwidth() + exp->startx();
+                warthog::grid_id_t goalid = (warthog::grid_id_t)exp->goaly() *
+                    exp->mapwidth() + exp->goalx();
+                warthog::problem_instance pi(startid, goalid);
+                G::statis::clear();
+                algo->get_path(pi, sol);
+                best.at(i) = std::min(best.at(i), sol.time_elapsed_nano_);
+
+                // search effort is deterministic; count it once
+                if(r != 0) { continue; }
+                tot_expd += sol.nodes_expanded_;
+                tot_gend += sol.nodes_inserted_;
+                tot_touched += sol.nodes_touched_;
+                if(checkopt && !check_optimality(sol, exp))
+                {
+                    std::cerr << "optimality check failed; " << alg << " "
+                        << file.second << " query " << i << " expected "
+                        << exp->distance() << " computed "
+                        << sol.sum_of_edge_costs_ << "\n";
+                    failures++;
+                }
+            }
+        }
+
+        for(double ns : best) { tot_ns += ns; latencies.push_back(ns); }
+        res.queries_ += nqueries;
+        res.maps_++;
+        res.mem_ = std::max(res.mem_, algo->mem() + scenmgr.mem());
+        delete algo;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double n = res.queries_ ? (double)res.queries_ : 1;
+    res.qps_ = tot_ns > 0 ? res.queries_ / (tot_ns / 1e9) : 0;
+    res.mean_ns_ = tot_ns / n;
+    res.p50_ns_ = percentile(latencies, 50);
+    res.p90_ns_ = percentile(latencies, 90);
+    res.p99_ns_ = percentile(latencies, 99);
+    res.max_ns_ = latencies.empty() ? 0 : latencies.back();
+    res.expanded_ = tot_expd / n;
+    res.generated_ = tot_gend / n;
+    res.touched_ = tot_touched / n;
+    return res;
+}
+
+void
+write_csv(const std::vector<bench_result>& results, std::ostream& out)
+{
+    out << CSV_HEADER << "\n";
+    out << std::fixed << std::setprecision(3);
+    for(const bench_result& r : results)
+    {
+        out << r.family_ << "," << r.alg_ << "," << r.maps_ << ","
+            << r.queries_ << "," << r.qps_ << "," << r.mean_ns_ << ","
+            << r.p50_ns_ << "," << r.p90_ns_ << "," << r.p99_ns_ << ","
+            << r.max_ns_ << "," << r.expanded_ << "," << r.generated_ << ","
+            << r.touched_ << "," << r.mem_ << "\n";
+    }
+}
+
+void
+write_json(const std::vector<bench_result>& results, std::ostream& out)
+{
+    out << std::fixed << std::setprecision(3);
+    out << "[\n";
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const bench_result& r = results.at(i);
+        out << "  {\"family\": \"" << r.family_ << "\", "
+            << "\"alg\": \"" << r.alg_ << "\", "
+            << "\"maps\": " << r.maps_ << ", "
+            << "\"queries\": " << r.queries_ << ", "
+            << "\"qps\": " << r.qps_ << ", "
+            << "\"mean_ns\": " << r.mean_ns_ << ", "
+            << "\"p50_ns\": " << r.p50_ns_ << ", "
+            << "\"p90_ns\": " << r.p90_ns_ << ", "
+            << "\"p99_ns\": " << r.p99_ns_ << ", "
+            << "\"max_ns\": " << r.max_ns_ << ", "
+            << "\"expanded\": " << r.expanded_ << ", "
+            << "\"generated\": " << r.generated_ << ", "
+            << "\"touched\": " << r.touched_ << ", "
+            << "\"mem\": " << r.mem_ << "}"
+            << (i+1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+bool
+load_baseline(const std::string& file, std::vector<bench_result>& results)
+{
+    std::ifstream in(file.c_str());
+    if(!in.good())
+    {
+        std::cerr << "err; cannot read baseline file " << file << "\n";
+        return false;
+    }
+
+    std::string line;
+    std::getline(in, line); // header
+    while(std::getline(in, line))
+    {
+        if(line.empty()) { continue; }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream row(line);
+        bench_result r;
+        row >> r.family_ >> r.alg_ >> r.maps_ >> r.queries_ >> r.qps_
+            >> r.mean_ns_ >> r.p50_ns_ >> r.p90_ns_ >> r.p99_ns_ >> r.max_ns_
+            >> r.expanded_ >> r.generated_ >> r.touched_ >> r.mem_;
+        if(row.fail())
+        {
+            std::cerr << "err; malformed baseline row: " << line << "\n";
+            return false;
+        }
+        results.push_back(r);
+    }
+    return true;
+}
+
+// @return the number of regressions found
+uint32_t
+compare_baseline(const std::vector<bench_result>& current,
+        const std::vector<bench_result>& baseline,
+        const std::vector<std::string>& metrics, double threshold)
+{
+    uint32_t regressions = 0;
+    std::cerr << std::fixed << std::setprecision(3);
+    std::cerr << "family\talg\tmetric\tbaseline\tcurrent\tchange\tstatus\n";
+    for(const bench_result& cur : current)
+    {
+        const bench_result* base = 0;
+        for(const bench_result& b : baseline)
+        {
+            if(b.family_ == cur.family_ && b.alg_ == cur.alg_) { base = &b; }
+        }
+        if(!base)
+        {
+            std::cerr << cur.family_ << "\t" << cur.alg_
+                << "\t-\t-\t-\t-\tno-baseline\n";
+            continue;
+        }
+
+        for(const std::string& metric : metrics)
+        {
+            double b, c;
+            bool higher_better;
+            if(!base->get_metric(metric, b, higher_better) ||
+               !cur.get_metric(metric, c, higher_better))
+            { continue; }
+
+            // relative change, positive when performance got worse
+            double change = 0;
+            if(b > 0) { change = higher_better ? (b - c) / b : (c - b) / b; }
+            bool regressed = change > threshold;
+            regressions += regressed;
+            std::cerr << cur.family_ << "\t" << cur.alg_ << "\t" << metric
+                << "\t" << b << "\t" << c << "\t" << -change * 100 << "%\t"
+                << (regressed ? "REGRESSION" : "ok") << "\n";
+        }
+    }
+    return regressions;
+}
+
+int
+main(int argc, char** argv)
+{
+	warthog::util::param valid_args[] =
+	{
+		{"family", required_argument, 0, 1},
+		{"alg", required_argument, 0, 1},
+		{"maps", required_argument, 0, 1},
+		{"scens", required_argument, 0, 1},
+		{"max-maps", required_argument, 0, 1},
+		{"max-queries", required_argument, 0, 1},
+		{"reps", required_argument, 0, 1},
+		{"format", required_argument, 0, 1},
+		{"out", required_argument, 0, 1},
+		{"baseline", required_argument, 0, 1},
+		{"threshold", required_argument, 0, 1},
+		{"metric", required_argument, 0, 1},
+		{"checkopt", no_argument, &checkopt, 1},
+		{"help", no_argument, &print_help, 1},
+		{0, 0, 0, 0}
+	};
+
+	warthog::util::cfg cfg;
+	cfg.parse_args(argc, argv, "", valid_args);
+
+    if(argc == 1 || print_help)
+    {
+        help();
+        exit(0);
+    }
+
+    std::vector<std::string> families;
+    for(std::string f = cfg.get_param_value("family"); f != "";
+            f = cfg.get_param_value("family"))
+    { families.push_back(f); }
+
+    std::vector<std::string> algs;
+    for(std::string a = cfg.get_param_value("alg"); a != "";
+            a = cfg.get_param_value("alg"))
+    { algs.push_back(a); }
+    if(algs.empty()) { algs = {"jps2", "jps2-prune2"}; }
+
+    std::vector<std::string> metrics;
+    for(std::string m = cfg.get_param_value("metric"); m != "";
+            m = cfg.get_param_value("metric"))
+    { metrics.push_back(m); }
+    if(metrics.empty()) { metrics = {"qps", "p50_ns"}; }
+
+    std::string maproot = cfg.get_param_value("maps");
+    std::string scenroot = cfg.get_param_value("scens");
+    std::string format = cfg.get_param_value("format");
+    std::string outfile = cfg.get_param_value("out");
+    std::string basefile = cfg.get_param_value("baseline");
+    std::string s_threshold = cfg.get_param_value("threshold");
+    std::string s_max_maps = cfg.get_param_value("max-maps");
+    std::string s_max_queries = cfg.get_param_value("max-queries");
+    std::string s_reps = cfg.get_param_value("reps");
+
+    if(maproot == "") { maproot = "./maps"; }
+    if(scenroot == "") { scenroot = "./scenarios/movingai"; }
+    if(format == "") { format = "csv"; }
+    double threshold = s_threshold == "" ? 0.05 : atof(s_threshold.c_str());
+    uint32_t max_maps = s_max_maps == "" ?
+        UINT32_MAX : (uint32_t)atoi(s_max_maps.c_str());
+    uint32_t max_queries = s_max_queries == "" ?
+        UINT32_MAX : (uint32_t)atoi(s_max_queries.c_str());
+    uint32_t reps = s_reps == "" ? 1 : std::max(1, atoi(s_reps.c_str()));
+
+    if(families.empty())
+    {
+        std::cerr << "err; no map families given (--family)\n";
+        exit(1);
+    }
+    if(format != "csv" && format != "json")
+    {
+        std::cerr << "err; unknown output format: " << format << "\n";
+        exit(1);
+    }
+    for(const std::string& alg : algs)
+    {
+        const std::vector<std::string>& names = warthog::grid_searcher_names();
+        if(std::find(names.begin(), names.end(), alg) == names.end())
+        {
+            std::cerr << "err; invalid search algorithm: " << alg << "\n";
+            exit(1);
+        }
+    }
+    for(const std::string& metric : metrics)
+    {
+        double value;
+        bool higher_better;
+        if(!bench_result().get_metric(metric, value, higher_better))
+        {
+            std::cerr << "err; unknown metric: " << metric << "\n";
+            exit(1);
+        }
+    }
+
+    std::vector<bench_result> baseline;
+    if(basefile != "" && !load_baseline(basefile, baseline)) { exit(1); }
+
+    std::vector<bench_result> results;
+    uint32_t failures = 0;
+    for(const std::string& family : families)
+    {
+        std::vector<std::pair<std::string, std::string>> files;
+        list_family(maproot + "/" + family, scenroot + "/" + family, files);
+        if(files.size() > max_maps) { files.resize(max_maps); }
+        if(files.empty())
+        {
+            std::cerr << "err; no maps with scenarios in family "
+                << family << "\n";
+            exit(1);
+        }
+
+        for(const std::string& alg : algs)
+        {
+            std::cerr << "running " << alg << " on " << family
+                << " (" << files.size() << " maps)\n";
+            results.push_back(
+                run_family(family, alg, files, max_queries, reps, failures));
+        }
+    }
+
+    if(outfile == "")
+    {
+        if(format == "csv") { write_csv(results, std::cout); }
+        else { write_json(results, std::cout); }
+    }
+    else
+    {
+        std::ofstream out(outfile.c_str());
+        if(format == "csv") { write_csv(results, out); }
+        else { write_json(results, out); }
+    }
+
+    int retval = 0;
+    if(failures)
+    {
+        std::cerr << "err; " << failures << " optimality check failures\n";
+        retval = 1;
+    }
+    if(!baseline.empty())
+    {
+        uint32_t regressions =
+            compare_baseline(results, baseline, metrics, threshold);
+        if(regressions)
+        {
+            std::cerr << "err; " << regressions << " regressions above "
+                << threshold * 100 << "%\n";
+            retval = 2;
+        }
+    }
+    return retval;
+}
@@ -32,12 +32,12 @@ struct ExpData {
     exp = gen = scan = pruneable = 0;
     subopt_expd = subopt_gen = 0;
   }
-  void update(const w::solution& si) {
+  void update(const w::solution& si, const G::search_context& ctx) {
     exp += si.nodes_expanded_;
     // gen += si.nodes_touched_;
     gen += si.nodes_inserted_;
     time += si.time_elapsed_nano_;
-    scan += G::statis::scan_cnt;
+    scan += ctx.scan_cnt;
   }
 
   void update_subopt() {
@@ -115,7 +115,7 @@ void subcnt() {
   // int toindx = 1961;
 
   G::query::map = &map;
-  G::query::open = &open;
+  expd_cjps2.get_context()->open = &open;
   for (int i=fromidx; i<toindx; i++) {
     w::experiment* exp = scenmgr.get_experiment(i);
     uint32_t sid = exp->starty() * exp->mapwidth() + exp->startx();
@@ -133,19 +133,21 @@ void subcnt() {
     G::statis::clear();
     G::nodepool = expd_jps2.get_nodepool();
     G::sol = &sol_jps;
+    expd_jps2.get_context()->scan_cnt = 0;
     jps2.get_path(pi_jps2, sol_jps);
-    cnt_jps2.update(sol_jps);
+    cnt_jps2.update(sol_jps, *expd_jps2.get_context());
     cnt_jps2.update_subopt();
 
     G::statis::clear();
     G::nodepool = expd_cjps2.get_nodepool();
     G::sol = &sol_cjps;
+    expd_cjps2.get_context()->scan_cnt = 0;
     cjps2.get_path(pi_cjps2, sol_cjps);
-    cnt_cjps2.update(sol_cjps);
+    cnt_cjps2.update(sol_cjps, *expd_cjps2.get_context());
     cnt_cjps2.update_subopt();
 
-    cout << mfile << "\t" << i << "\t" << cnt_jps2.subopt_str() << "\tjps2" << endl;
-    cout << mfile << "\t" << i << "\t" << cnt_cjps2.subopt_str() << "\tc2jps2" << endl;
+    cout << mfile << "\t" << i << "\t" << cnt_jps2.subopt_str() << "\tjps2\n";
+    cout << mfile << "\t" << i << "\t" << cnt_cjps2.subopt_str() << "\tc2jps2\n";
 
     if ((!cnt_cjps2.valid()) || (!cnt_jps2.valid())) {
       cerr << i << " " << exp->startx() << " " << exp->starty() << " " << exp->distance() << endl;
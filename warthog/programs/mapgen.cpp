@@ -0,0 +1,313 @@
+// mapgen.cpp
+//
+// Generates synthetic maps and scenarios; a native replacement for the
+// map families built by gen.py, plus random, room, maze and cave maps.
+// Writes <out>.map and <out>.scen; scenario distances are optimal and
+// computed in parallel.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "cfg.h"
+#include "constants.h"
+#include "gridmap.h"
+#include "map_generator.h"
+#include "scenario_manager.h"
+#include "timer.h"
+
+#include "getopt.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int print_help = 0;
+int no_distances = 0;
+
+void
+help()
+{
+    std::cerr
+        << "==> manual <==\n"
+        << "Generate a synthetic map and scenario file.\n\n"
+        << "--family <name>    one of:\n"
+        << "    diag       --size l --ratio r --blocked dr (as gen.py diag-map)\n"
+        << "    square     --size l --ratio r\n"
+        << "    empty      --size l\n"
+        << "    random     --width w --height h --ratio r\n"
+        << "    rooms      --width w --height h --room s --doors p\n"
+        << "    maze       --width w --height h --corridor c\n"
+        << "    cave       --width w --height h --fill p --iterations n\n"
+        << "    scale      --map <file> --factor f [--scen <file>]\n"
+        << "    obstacles  --map <file> --ratio r [--scen <file>]\n"
+        << "               (random obstacles; tiles used by --scen stay free)\n"
+        << "    distances  --map <file> --scen <file>\n"
+        << "               (recompute the optimal distances of a scenario;\n"
+        << "               only <prefix>.scen is written)\n"
+        << "--out <prefix>     write <prefix>.map and <prefix>.scen\n"
+        << "--queries <n>      number of queries to generate (default: 100)\n"
+        << "--scen-type <t>    diag: starts top-left, targets bottom-right;\n"
+        << "                   random: anywhere (default: diag for the diag\n"
+        << "                   family, random otherwise)\n"
+        << "--goals-per-start <n>\n"
+        << "                   random queries sharing each start (default: 1).\n"
+        << "                   queries with a common start are solved by a\n"
+        << "                   single Dijkstra search\n"
+        << "--seed <n>         random seed (default: 0)\n"
+        << "--no-distances     skip computing optimal distances\n"
+        << "\nWidth and height default to --size when not given.\n";
+}
+
+uint32_t
+get_uint(warthog::util::cfg& cfg, const std::string& name, uint32_t def)
+{
+    std::string val = cfg.get_param_value(name);
+    return val == "" ? def : (uint32_t)strtoul(val.c_str(), 0, 10);
+}
+
+double
+get_double(warthog::util::cfg& cfg, const std::string& name, double def)
+{
+    std::string val = cfg.get_param_value(name);
+    return val == "" ? def : atof(val.c_str());
+}
+
+// copy the queries of @param in to @param out, rewritten for a new map
+// whose coordinates are scaled by @param factor
+void
+transform_scenario(warthog::scenario_manager& in,
+        warthog::scenario_manager& out, warthog::gridmap* map,
+        const std::string& mapname, uint32_t factor)
+{
+    for(uint32_t i = 0; i < in.num_experiments(); i++)
+    {
+        warthog::experiment* exp = in.get_experiment(i);
+        out.add_experiment(new warthog::experiment(
+                exp->startx() * factor, exp->starty() * factor,
+                exp->goalx() * factor, exp->goaly() * factor,
+                map->header_width(), map->header_height(),
+                exp->distance() * factor, mapname));
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+	warthog::util::param valid_args[] =
+	{
+		{"family", required_argument, 0, 1},
+		{"out", required_argument, 0, 1},
+		{"size", required_argument, 0, 1},
+		{"width", required_argument, 0, 1},
+		{"height", required_argument, 0, 1},
+		{"ratio", required_argument, 0, 1},
+		{"blocked", required_argument, 0, 1},
+		{"room", required_argument, 0, 1},
+		{"doors", required_argument, 0, 1},
+		{"corridor", required_argument, 0, 1},
+		{"fill", required_argument, 0, 1},
+		{"iterations", required_argument, 0, 1},
+		{"factor", required_argument, 0, 1},
+		{"map", required_argument, 0, 1},
+		{"scen", required_argument, 0, 1},
+		{"queries", required_argument, 0, 1},
+		{"scen-type", required_argument, 0, 1},
+		{"goals-per-start", required_argument, 0, 1},
+		{"seed", required_argument, 0, 1},
+		{"no-distances", no_argument, &no_distances, 1},
+		{"help", no_argument, &print_help, 1},
+		{0, 0, 0, 0}
+	};
+
+	warthog::util::cfg cfg;
+	cfg.parse_args(argc, argv, "", valid_args);
+
+    if(argc == 1 || print_help)
+    {
+        help();
+        exit(0);
+    }
+
+    std::string family = cfg.get_param_value("family");
+    std::string out = cfg.get_param_value("out");
+    std::string mapfile = cfg.get_param_value("map");
+    std::string scenfile = cfg.get_param_value("scen");
+    std::string scentype = cfg.get_param_value("scen-type");
+    uint32_t size = get_uint(cfg, "size", 512);
+    uint32_t width = get_uint(cfg, "width", size);
+    uint32_t height = get_uint(cfg, "height", size);
+    uint32_t queries = get_uint(cfg, "queries", 100);
+    uint32_t goals_per_start = get_uint(cfg, "goals-per-start", 1);
+    uint64_t seed = get_uint(cfg, "seed", 0);
+
+    if(family == "" || out == "")
+    {
+        std::cerr << "err; --family and --out are required\n";
+        exit(1);
+    }
+    if(size > 16384 || width > 16384 || height > 16384)
+    {
+        std::cerr << "err; maps are limited to 16384 x 16384\n";
+        exit(1);
+    }
+    if(scentype == "") { scentype = family == "diag" ? "diag" : "random"; }
+
+    std::string mapname = out + ".map";
+    std::string scenname = out + ".scen";
+    warthog::map_generator gen(seed);
+    warthog::gridmap* map = 0;
+    warthog::scenario_manager scenmgr;
+
+    warthog::timer t;
+    t.start();
+    if(family == "diag")
+    {
+        map = gen.diag(size, get_double(cfg, "ratio", 0),
+                get_double(cfg, "blocked", 0.75));
+    }
+    else if(family == "square")
+    {
+        map = gen.square(size, get_double(cfg, "ratio", 0.01));
+    }
+    else if(family == "empty")
+    {
+        map = gen.empty(size);
+    }
+    else if(family == "random")
+    {
+        map = gen.random(height, width, get_double(cfg, "ratio", 0.1));
+    }
+    else if(family == "rooms")
+    {
+        map = gen.rooms(height, width, get_uint(cfg, "room", 16),
+                get_double(cfg, "doors", 0.5));
+    }
+    else if(family == "maze")
+    {
+        map = gen.maze(height, width, get_uint(cfg, "corridor", 1));
+    }
+    else if(family == "cave")
+    {
+        map = gen.cave(height, width, get_double(cfg, "fill", 0.45),
+                get_uint(cfg, "iterations", 4));
+    }
+    else if(family == "distances")
+    {
+        if(mapfile == "" || scenfile == "")
+        {
+            std::cerr << "err; --map and --scen are required for family "
+                << family << "\n";
+            exit(1);
+        }
+        warthog::gridmap input(mapfile.c_str());
+        scenmgr.load_scenario(scenfile.c_str());
+
+        warthog::timer dt;
+        dt.start();
+        scenmgr.compute_distances(&input);
+        dt.stop();
+
+        std::ofstream scenout(scenname.c_str());
+        scenmgr.write_scenario(scenout);
+        scenout.close();
+        std::cerr << "computed " << scenmgr.num_experiments()
+            << " distances in " << dt.elapsed_time_nano() / 1e9 << " s; "
+            << "wrote " << scenname << "\n";
+        return 0;
+    }
+    else if(family == "scale" || family == "obstacles")
+    {
+        if(mapfile == "")
+        {
+            std::cerr << "err; --map is required for family " << family << "\n";
+            exit(1);
+        }
+        warthog::gridmap input(mapfile.c_str());
+        warthog::scenario_manager inscen;
+        if(scenfile != "") { inscen.load_scenario(scenfile.c_str()); }
+
+        uint32_t factor = 1;
+        if(family == "scale")
+        {
+            factor = get_uint(cfg, "factor", 2);
+            map = gen.scale(&input, factor);
+        }
+        else
+        {
+            // endpoints of the given queries must stay traversable
+            std::vector<uint32_t> keep;
+            for(uint32_t i = 0; i < inscen.num_experiments(); i++)
+            {
+                warthog::experiment* exp = inscen.get_experiment(i);
+                keep.push_back(exp->starty() * exp->mapwidth() + exp->startx());
+                keep.push_back(exp->goaly() * exp->mapwidth() + exp->goalx());
+            }
+            map = gen.add_obstacles(&input, get_double(cfg, "ratio", 0.01), keep);
+        }
+        transform_scenario(inscen, scenmgr, map, mapname, factor);
+    }
+    else
+    {
+        std::cerr << "err; unknown map family: " << family << "\n";
+        exit(1);
+    }
+    t.stop();
+    std::cerr << "generated " << map->header_width() << "x"
+        << map->header_height() << " map in "
+        << t.elapsed_time_nano() / 1e9 << " s\n";
+
+    // new queries are topped up until enough of them have a path
+    bool fresh = scenmgr.num_experiments() == 0;
+    for(uint32_t round = 0; fresh && round < 10; round++)
+    {
+        warthog::scenario_manager batch;
+        uint32_t needed = queries - scenmgr.num_experiments();
+        if(scentype == "diag")
+        { gen.diag_scenario(map, needed, mapname, batch); }
+        else
+        {
+            gen.random_scenario(map, needed, mapname, batch, goals_per_start);
+        }
+        if(batch.num_experiments() == 0) { break; }
+
+        if(!no_distances)
+        {
+            batch.compute_distances(map);
+            batch.remove_unsolvable();
+        }
+        transform_scenario(batch, scenmgr, map, mapname, 1);
+        if(scenmgr.num_experiments() == queries) { break; }
+    }
+
+    if(!fresh && !no_distances)
+    {
+        scenmgr.compute_distances(map);
+        uint32_t removed = scenmgr.remove_unsolvable();
+        if(removed)
+        {
+            std::cerr << "warning; removed " << removed
+                << " queries which no longer have a path\n";
+        }
+    }
+    if(fresh && scenmgr.num_experiments() < queries)
+    {
+        std::cerr << "warning; generated only " << scenmgr.num_experiments()
+            << " of " << queries << " queries\n";
+    }
+
+    std::ofstream mapout(mapname.c_str());
+    warthog::map_generator::write_map(map, mapout);
+    mapout.close();
+
+    std::ofstream scenout(scenname.c_str());
+    scenmgr.write_scenario(scenout);
+    scenout.close();
+
+    std::cerr << "wrote " << mapname << " and " << scenname
+        << " (" << scenmgr.num_experiments() << " queries)\n";
+    delete map;
+    return 0;
+}
@@ -0,0 +1,280 @@
+// pathclient.cpp
+//
+// Local client for pathserver. Connects to the server's Unix domain
+// socket, makes sure the map is loaded and replays the queries of a scenario file
+// in small bursts, the way a game backend would. Reports burst latency and
+// throughput and, with --checkopt, compares the costs with the scenario.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "cfg.h"
+#include "scenario_manager.h"
+#include "timer.h"
+
+#include "getopt.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+int print_help = 0;
+int checkopt = 0;
+int shutdown_server = 0;
+
+void
+help()
+{
+    std::cerr
+        << "==> manual <==\n"
+        << "Replay a scenario against a running pathserver.\n\n"
+        << "--socket <path>    server socket\n"
+        << "--map <file>       map to query; loaded on the server unless a map\n"
+        << "                   of the same name is already there\n"
+        << "--name <name>      name of the map on the server (default: the\n"
+        << "                   file name of --map)\n"
+        << "--scen <file>      queries to send\n"
+        << "--alg <name>       algorithm (default: jps2)\n"
+        << "--burst <n>        queries sent before waiting for the answers "
+        << "(default: 16)\n"
+        << "--path             request full paths instead of costs only\n"
+        << "--checkopt         compare costs with the scenario distances\n"
+        << "--shutdown         stop the server when done\n";
+}
+
+class connection
+{
+    public:
+        connection() : fd_(-1), pos_(0), len_(0) { }
+        ~connection() { if(fd_ >= 0) { close(fd_); } }
+
+        bool
+        open(const std::string& path)
+        {
+            sockaddr_un addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+            fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+            return fd_ >= 0 &&
+                connect(fd_, (sockaddr*)&addr, sizeof(addr)) == 0;
+        }
+
+        bool
+        send_all(const std::string& data)
+        {
+            size_t done = 0;
+            while(done < data.size())
+            {
+                ssize_t n = send(fd_, data.c_str() + done,
+                        data.size() - done, MSG_NOSIGNAL);
+                if(n < 0 && errno == EINTR) { continue; }
+                if(n <= 0) { return false; }
+                done += (size_t)n;
+            }
+            return true;
+        }
+
+        bool
+        read_line(std::string& line)
+        {
+            line.clear();
+            while(true)
+            {
+                while(pos_ < len_)
+                {
+                    char c = buf_[pos_++];
+                    if(c == '\n') { return true; }
+                    line.push_back(c);
+                }
+                ssize_t n = recv(fd_, buf_, sizeof(buf_), 0);
+                if(n < 0 && errno == EINTR) { continue; }
+                if(n <= 0) { return false; }
+                pos_ = 0;
+                len_ = (size_t)n;
+            }
+        }
+
+    private:
+        int fd_;
+        char buf_[65536];
+        size_t pos_;
+        size_t len_;
+};
+
+int
+main(int argc, char** argv)
+{
+	warthog::util::param valid_args[] =
+	{
+		{"socket", required_argument, 0, 1},
+		{"map", required_argument, 0, 1},
+		{"name", required_argument, 0, 1},
+		{"scen", required_argument, 0, 1},
+		{"alg", required_argument, 0, 1},
+		{"burst", required_argument, 0, 1},
+		{"path", no_argument, 0, 1},
+		{"checkopt", no_argument, &checkopt, 1},
+		{"shutdown", no_argument, &shutdown_server, 1},
+		{"help", no_argument, &print_help, 1},
+		{0, 0, 0, 0}
+	};
+
+	warthog::util::cfg cfg;
+	cfg.parse_args(argc, argv, "", valid_args);
+
+    if(argc == 1 || print_help)
+    {
+        help();
+        exit(0);
+    }
+
+    std::string sockpath = cfg.get_param_value("socket");
+    std::string mapfile = cfg.get_param_value("map");
+    std::string mapname = cfg.get_param_value("name");
+    std::string scenfile = cfg.get_param_value("scen");
+    std::string alg = cfg.get_param_value("alg");
+    std::string s_burst = cfg.get_param_value("burst");
+    std::string cmd = cfg.get_num_values("path") > 0 ? "path" : "cost";
+    if(alg == "") { alg = "jps2"; }
+    uint32_t burst = s_burst == "" ? 16 : (uint32_t)strtoul(s_burst.c_str(), 0, 10);
+    if(burst == 0) { burst = 1; }
+
+    if(sockpath == "" || mapfile == "" || scenfile == "")
+    {
+        std::cerr << "err; --socket, --map and --scen are required\n";
+        exit(1);
+    }
+
+    if(mapname == "")
+    {
+        size_t slash = mapfile.find_last_of('/');
+        mapname = slash == std::string::npos ? mapfile : mapfile.substr(slash+1);
+    }
+
+    // the server resolves paths relative to its own working directory
+    char resolved[PATH_MAX];
+    if(realpath(mapfile.c_str(), resolved)) { mapfile = resolved; }
+
+    connection conn;
+    if(!conn.open(sockpath))
+    {
+        std::cerr << "err; cannot connect to " << sockpath << ": "
+            << strerror(errno) << "\n";
+        exit(1);
+    }
+
+    // reuse a map the server already has, along with its caches
+    std::string line;
+    if(!conn.send_all("maps\n") || !conn.read_line(line))
+    {
+        std::cerr << "err; connection lost\n";
+        exit(1);
+    }
+    std::istringstream maps(line);
+    bool loaded = false;
+    for(std::string m; maps >> m; ) { loaded = loaded || m == mapname; }
+
+    if(!loaded)
+    {
+        if(!conn.send_all("load " + mapname + " " + mapfile + "\n") ||
+           !conn.read_line(line))
+        {
+            std::cerr << "err; connection lost\n";
+            exit(1);
+        }
+        if(line.compare(0, 2, "ok") != 0)
+        {
+            std::cerr << "err; server: " << line << "\n";
+            exit(1);
+        }
+    }
+
+    warthog::scenario_manager scenmgr;
+    scenmgr.load_scenario(scenfile.c_str());
+
+    std::vector<double> latency;
+    uint32_t errors = 0, mismatches = 0;
+    warthog::timer total, t;
+    total.start();
+    for(uint32_t first = 0; first < scenmgr.num_experiments(); first += burst)
+    {
+        uint32_t last = std::min(first + burst, scenmgr.num_experiments());
+        std::ostringstream req;
+        for(uint32_t i = first; i < last; i++)
+        {
+            warthog::experiment* exp = scenmgr.get_experiment(i);
+            req << cmd << " " << mapname << " " << alg << " "
+                << exp->startx() << " " << exp->starty() << " "
+                << exp->goalx() << " " << exp->goaly() << "\n";
+        }
+
+        t.start();
+        if(!conn.send_all(req.str()))
+        {
+            std::cerr << "err; connection lost\n";
+            exit(1);
+        }
+        for(uint32_t i = first; i < last; i++)
+        {
+            if(!conn.read_line(line))
+            {
+                std::cerr << "err; connection lost\n";
+                exit(1);
+            }
+
+            std::istringstream resp(line);
+            std::string status;
+            double cost = -1;
+            resp >> status >> cost;
+            if(status == "err") { errors++; continue; }
+            if(!checkopt) { continue; }
+
+            // scenario distances are rounded; as in check_optimality
+            // (warthog.cpp), costs agree to half of two decimal places
+            warthog::experiment* exp = scenmgr.get_experiment(i);
+            bool solvable = exp->distance() >= 0;
+            if(status == "none" ? solvable
+                    : fabs(cost - exp->distance()) > 0.005)
+            {
+                mismatches++;
+                std::cerr << "mismatch; query " << i << " expected "
+                    << exp->distance() << " got " << line << "\n";
+            }
+        }
+        t.stop();
+        latency.push_back(t.elapsed_time_nano());
+    }
+    total.stop();
+
+    if(shutdown_server) { conn.send_all("shutdown\n"); }
+
+    std::sort(latency.begin(), latency.end());
+    double sum = 0;
+    for(double l : latency) { sum += l; }
+    size_t n = latency.size();
+    std::cout
+        << "queries=" << scenmgr.num_experiments()
+        << " bursts=" << n
+        << " qps=" << scenmgr.num_experiments() /
+            (total.elapsed_time_nano() / 1e9)
+        << " burst_mean_us=" << (n ? sum / n / 1e3 : 0)
+        << " burst_p50_us=" << (n ? latency[n / 2] / 1e3 : 0)
+        << " burst_p99_us=" << (n ? latency[std::min(n - 1, n * 99 / 100)] / 1e3 : 0)
+        << " errors=" << errors;
+    if(checkopt) { std::cout << " mismatches=" << mismatches; }
+    std::cout << std::endl;
+    return (errors || mismatches) ? 1 : 0;
+}
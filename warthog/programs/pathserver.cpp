@@ -0,0 +1,168 @@
+// pathserver.cpp
+//
+// Long running query server. Keeps maps resident (within a memory budget)
+// and answers path queries read from stdin, or from clients of a Unix
+// domain socket, on a pool of worker threads. See util/query_server.h for
+// the protocol.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "cfg.h"
+#include "query_server.h"
+
+#include "getopt.h"
+
+#include <cstdlib>
+#include <dirent.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+int print_help = 0;
+int components = 0;
+
+void
+help()
+{
+    std::cerr
+        << "==> manual <==\n"
+        << "Answer path queries against maps that stay loaded.\n\n"
+        << "--map <name=file> [...]  maps to load at startup; a bare file is\n"
+        << "                         named after its file name\n"
+        << "--map-dir <dir>          register every .map file in <dir>;\n"
+        << "                         these are loaded on first use\n"
+        << "--budget <MB>            memory for resident maps; least recently\n"
+        << "                         used maps are evicted (default: no limit)\n"
+        << "--cache <dir>            keep binary copies of text maps here for\n"
+        << "                         faster reloads\n"
+        << "--components             label connected components and answer\n"
+        << "                         queries between components without search\n"
+        << "--path-cache <n>         cache up to n paths per map; mirrored\n"
+        << "                         queries share an entry (default: 0, off)\n"
+        << "--timeout <ms>           give up queries not answered within this\n"
+        << "                         time of being read (default: no limit)\n"
+        << "--socket <path>          listen on a Unix domain socket\n"
+        << "                         (default: read stdin, write stdout)\n"
+        << "--workers <n>            worker threads (default: one per core)\n"
+        << "\nRequests, one per line:\n"
+        << "  load <name> <mapfile>\n"
+        << "  add <name> <mapfile>\n"
+        << "  path <name> <alg> <sx> <sy> <gx> <gy>\n"
+        << "  cost <name> <alg> <sx> <sy> <gx> <gy>\n"
+        << "  block <name> <x> <y> [<x> <y> ...]\n"
+        << "  unblock <name> <x> <y> [<x> <y> ...]\n"
+        << "  maps | stats | quit | shutdown\n";
+}
+
+int
+main(int argc, char** argv)
+{
+	warthog::util::param valid_args[] =
+	{
+		{"map", required_argument, 0, 1},
+		{"map-dir", required_argument, 0, 1},
+		{"budget", required_argument, 0, 1},
+		{"cache", required_argument, 0, 1},
+		{"components", no_argument, &components, 1},
+		{"path-cache", required_argument, 0, 1},
+		{"timeout", required_argument, 0, 1},
+		{"socket", required_argument, 0, 1},
+		{"workers", required_argument, 0, 1},
+		{"help", no_argument, &print_help, 1},
+		{0, 0, 0, 0}
+	};
+
+	warthog::util::cfg cfg;
+	cfg.parse_args(argc, argv, "", valid_args);
+
+    if(print_help)
+    {
+        help();
+        exit(0);
+    }
+
+    uint32_t workers = std::thread::hardware_concurrency();
+    std::string s_workers = cfg.get_param_value("workers");
+    if(s_workers != "") { workers = (uint32_t)strtoul(s_workers.c_str(), 0, 10); }
+    if(workers == 0) { workers = 1; }
+
+    size_t budget = 0;
+    std::string s_budget = cfg.get_param_value("budget");
+    if(s_budget != "") { budget = (size_t)(atof(s_budget.c_str()) * 1024 * 1024); }
+
+    warthog::query_server server(workers, budget,
+            cfg.get_param_value("cache"), components != 0);
+    std::string s_path_cache = cfg.get_param_value("path-cache");
+    if(s_path_cache != "")
+    {
+        server.get_registry().set_path_cache(
+                (uint32_t)strtoul(s_path_cache.c_str(), 0, 10));
+    }
+    std::string s_timeout = cfg.get_param_value("timeout");
+    if(s_timeout != "") { server.set_timeout(atof(s_timeout.c_str()) * 1e6); }
+    for(std::string d = cfg.get_param_value("map-dir"); d != "";
+            d = cfg.get_param_value("map-dir"))
+    {
+        DIR* dir = opendir(d.c_str());
+        if(!dir)
+        {
+            std::cerr << "err; cannot open map directory " << d << "\n";
+            exit(1);
+        }
+        uint32_t num = 0;
+        for(struct dirent* ent = readdir(dir); ent != 0; ent = readdir(dir))
+        {
+            std::string name(ent->d_name);
+            if(name.size() > 4 && name.compare(name.size()-4, 4, ".map") == 0)
+            {
+                server.add_map(name, d + "/" + name);
+                num++;
+            }
+        }
+        closedir(dir);
+        std::cerr << "registered " << num << " maps from " << d << "\n";
+    }
+
+    for(std::string m = cfg.get_param_value("map"); m != "";
+            m = cfg.get_param_value("map"))
+    {
+        std::string name, file;
+        size_t eq = m.find('=');
+        if(eq != std::string::npos)
+        {
+            name = m.substr(0, eq);
+            file = m.substr(eq+1);
+        }
+        else
+        {
+            file = m;
+            size_t slash = m.find_last_of('/');
+            name = slash == std::string::npos ? m : m.substr(slash+1);
+        }
+
+        std::string err;
+        if(!server.load_map(name, file, err))
+        {
+            std::cerr << "err; " << err << "\n";
+            exit(1);
+        }
+        std::cerr << "loaded " << name << " from " << file << "\n";
+    }
+
+    std::string socket = cfg.get_param_value("socket");
+    if(socket == "")
+    {
+        server.serve(STDIN_FILENO, STDOUT_FILENO);
+    }
+    else
+    {
+        std::cerr << "listening on " << socket << " with " << workers
+            << " workers\n";
+        if(!server.listen(socket)) { exit(1); }
+    }
+    std::cerr << "answered " << server.num_queries() << " queries\n";
+    return 0;
+}
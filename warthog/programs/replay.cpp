@@ -0,0 +1,484 @@
+// replay.cpp
+//
+// Load generator. Replays a timestamped query log against the library in
+// real time (or scaled), with a pool of client threads answering queries
+// as they arrive. Arrivals are open loop: a query arrives at its time in
+// the log whether or not the clients keep up, and its latency runs from
+// that time to its answer, so time spent waiting for a free client is
+// included. Several rates can be replayed in one run to find the rate at
+// which the tail latency starts to grow.
+//
+// A log has one query per line:
+//
+//   <arrival ms> <map> <sx> <sy> <gx> <gy>
+//
+// where maps are named as given to --map or --map-dir; lines starting with
+// '#' are ignored. --gen writes such a log for the queries of a scenario.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "cfg.h"
+#include "grid_searcher.h"
+#include "gridmap.h"
+#include "map_registry.h"
+#include "problem_instance.h"
+#include "scenario_manager.h"
+#include "solution.h"
+#include "timer.h"
+
+#include "getopt.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int print_help = 0;
+
+void
+help()
+{
+    std::cerr
+        << "==> manual <==\n"
+        << "Replay a timestamped query log with a pool of client threads and\n"
+        << "report the latency of the queries, waiting time included.\n\n"
+        << "--log <file>             queries: <arrival ms> <map> <sx> <sy> <gx> <gy>\n"
+        << "--map <name=file> [...]  maps the log refers to\n"
+        << "--map-dir <dir>          or every .map file in <dir>, by file name\n"
+        << "--alg <name>             algorithm (default: jps2)\n"
+        << "--clients <n>            client threads (default: one per core)\n"
+        << "--speed <f>              replay f times faster than logged (default: 1)\n"
+        << "--qps <r> [...]          replay once at each of these mean rates\n"
+        << "                         instead, lowest first\n"
+        << "--knee <f>               the tail has grown once p99 exceeds f times\n"
+        << "                         the p99 of the first rate (default: 2)\n"
+        << "--limit <n>              replay only the first n queries\n\n"
+        << "--gen <scen>             write a log of the scenario's queries instead,\n"
+        << "  --rate <qps>           with exponential gaps at this mean rate\n"
+        << "  --burst <n>            arriving in bursts of n (default: 1)\n"
+        << "  --count <n>            n queries, cycling through the scenario\n"
+        << "  --name <map>           map name to log (default: the scenario's)\n";
+}
+
+struct logged_query
+{
+    double arrival_nano_;
+    std::string map_;
+    uint32_t sx_, sy_, gx_, gy_;
+};
+
+struct replay_stats
+{
+    double offered_qps_;
+    double achieved_qps_;
+    // nanoseconds, by query
+    std::vector<double> latency_;
+    std::vector<double> wait_;
+    uint32_t errors_;
+};
+
+bool
+read_log(const std::string& file, std::vector<logged_query>& log)
+{
+    std::ifstream in(file.c_str());
+    if(!in) { return false; }
+    std::string line;
+    while(std::getline(in, line))
+    {
+        if(line.empty() || line[0] == '#') { continue; }
+        std::istringstream ls(line);
+        logged_query q;
+        double ms;
+        if(!(ls >> ms >> q.map_ >> q.sx_ >> q.sy_ >> q.gx_ >> q.gy_))
+        {
+            std::cerr << "err; bad log line: " << line << "\n";
+            return false;
+        }
+        q.arrival_nano_ = ms * 1e6;
+        log.push_back(q);
+    }
+    // logs are usually in order already
+    std::stable_sort(log.begin(), log.end(),
+            [](const logged_query& a, const logged_query& b)
+            { return a.arrival_nano_ < b.arrival_nano_; });
+    return true;
+}
+
+// answer every query of @param log, arriving at its logged time divided
+// by @param speed, with @param clients threads
+replay_stats
+replay(warthog::map_registry& registry, const std::string& alg,
+        const std::vector<logged_query>& log, double speed, uint32_t clients)
+{
+    replay_stats stats;
+    stats.latency_.assign(log.size(), 0);
+    stats.wait_.assign(log.size(), 0);
+    stats.errors_ = 0;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<uint32_t> arrived;
+    bool done = false;
+    std::atomic<uint32_t> errors(0);
+
+    warthog::timer clock;
+    double first = log.empty() ? 0 : log.front().arrival_nano_;
+    double start = clock.get_time_nano();
+    auto due = [&](uint32_t i)
+    { return start + (log[i].arrival_nano_ - first) / speed; };
+
+    std::vector<std::thread> pool;
+    for(uint32_t c = 0; c < clients; c++)
+    {
+        pool.emplace_back([&]() {
+            warthog::timer t;
+            while(true)
+            {
+                uint32_t i;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&]() { return done || !arrived.empty(); });
+                    if(arrived.empty()) { return; }
+                    i = arrived.front();
+                    arrived.pop_front();
+                }
+                double taken = t.get_time_nano();
+
+                const logged_query& q = log[i];
+                std::string err;
+                std::shared_ptr<warthog::map_registry::entry> e =
+                    registry.acquire(q.map_, err);
+                bool ok = (bool)e;
+                warthog::grid_searcher* searcher = 0;
+                if(ok)
+                {
+                    std::shared_ptr<const warthog::gridmap_snapshot> snap =
+                        e->snapshot();
+                    warthog::gridmap* map = snap->get_map();
+                    uint32_t w = map->header_width();
+                    uint32_t h = map->header_height();
+                    ok = q.sx_ < w && q.gx_ < w && q.sy_ < h && q.gy_ < h;
+                    if(ok)
+                    {
+                        searcher = e->checkout(alg, *snap);
+                        ok = searcher != 0;
+                    }
+                    if(ok)
+                    {
+                        warthog::problem_instance pi(
+                                (warthog::grid_id_t)q.sy_ * w + q.sx_,
+                                (warthog::grid_id_t)q.gy_ * w + q.gx_);
+                        warthog::solution sol;
+                        searcher->get_pathcost(pi, sol);
+                    }
+                    registry.release(e, searcher);
+                }
+                if(!ok) { errors++; }
+
+                double finished = t.get_time_nano();
+                stats.latency_[i] = finished - due(i);
+                stats.wait_[i] = taken - due(i);
+            }
+        });
+    }
+
+    // queries are released at their due time. latency is measured from
+    // then, not from the release, so a late dispatcher shows up in the
+    // latency instead of hiding it
+    for(uint32_t i = 0; i < log.size(); i++)
+    {
+        double wait = due(i) - clock.get_time_nano();
+        if(wait > 0)
+        {
+            std::this_thread::sleep_for(
+                    std::chrono::nanoseconds((int64_t)wait));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            arrived.push_back(i);
+        }
+        cv.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    cv.notify_all();
+    for(std::thread& t : pool) { t.join(); }
+    double elapsed = clock.get_time_nano() - start;
+
+    double span = log.size() < 2 ? 0 :
+        (log.back().arrival_nano_ - first) / speed;
+    stats.offered_qps_ = span > 0 ? (log.size() - 1) / (span / 1e9) : 0;
+    stats.achieved_qps_ = elapsed > 0 ? log.size() / (elapsed / 1e9) : 0;
+    stats.errors_ = errors;
+    return stats;
+}
+
+double
+percentile(const std::vector<double>& sorted, double p)
+{
+    if(sorted.empty()) { return 0; }
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+// write a log of the queries of @param scenfile to stdout
+void
+generate(const std::string& scenfile, const std::string& name, double rate,
+        uint32_t burst, uint32_t count)
+{
+    warthog::scenario_manager scenmgr;
+    scenmgr.load_scenario(scenfile.c_str());
+    uint32_t n = scenmgr.num_experiments();
+    if(n == 0)
+    {
+        std::cerr << "err; scenario file does not contain any instances\n";
+        exit(1);
+    }
+    if(count == 0) { count = n; }
+
+    std::string map = name;
+    if(map == "")
+    {
+        map = scenmgr.get_experiment(0)->map();
+        size_t slash = map.find_last_of('/');
+        if(slash != std::string::npos) { map = map.substr(slash+1); }
+    }
+
+    // bursts arrive as a poisson process with rate / burst bursts a second
+    std::mt19937_64 rng(1);
+    std::exponential_distribution<double> gap(rate / burst);
+    double ms = 0;
+    std::cout << std::fixed << std::setprecision(3);
+    for(uint32_t i = 0; i < count; i++)
+    {
+        if(i % burst == 0 && i > 0) { ms += gap(rng) * 1e3; }
+        warthog::experiment* exp = scenmgr.get_experiment(i % n);
+        std::cout << ms << " " << map << " "
+            << exp->startx() << " " << exp->starty() << " "
+            << exp->goalx() << " " << exp->goaly() << "\n";
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+	warthog::util::param valid_args[] =
+	{
+		{"log", required_argument, 0, 1},
+		{"map", required_argument, 0, 1},
+		{"map-dir", required_argument, 0, 1},
+		{"alg", required_argument, 0, 1},
+		{"clients", required_argument, 0, 1},
+		{"speed", required_argument, 0, 1},
+		{"qps", required_argument, 0, 1},
+		{"knee", required_argument, 0, 1},
+		{"limit", required_argument, 0, 1},
+		{"gen", required_argument, 0, 1},
+		{"rate", required_argument, 0, 1},
+		{"burst", required_argument, 0, 1},
+		{"count", required_argument, 0, 1},
+		{"name", required_argument, 0, 1},
+		{"help", no_argument, &print_help, 1},
+		{0, 0, 0, 0}
+	};
+
+	warthog::util::cfg cfg;
+	cfg.parse_args(argc, argv, "", valid_args);
+
+    if(argc == 1 || print_help)
+    {
+        help();
+        exit(0);
+    }
+
+    std::string gen = cfg.get_param_value("gen");
+    if(gen != "")
+    {
+        std::string rate = cfg.get_param_value("rate");
+        std::string burst = cfg.get_param_value("burst");
+        std::string count = cfg.get_param_value("count");
+        generate(gen, cfg.get_param_value("name"),
+                rate == "" ? 1000 : std::max(1e-3, atof(rate.c_str())),
+                burst == "" ? 1 : std::max(1, atoi(burst.c_str())),
+                count == "" ? 0 : (uint32_t)strtoul(count.c_str(), 0, 10));
+        return 0;
+    }
+
+    std::vector<logged_query> log;
+    std::string logfile = cfg.get_param_value("log");
+    if(logfile == "" || !read_log(logfile, log))
+    {
+        std::cerr << "err; cannot read query log " << logfile << "\n";
+        exit(1);
+    }
+    std::string limit = cfg.get_param_value("limit");
+    if(limit != "")
+    {
+        log.resize(std::min<size_t>(log.size(), strtoul(limit.c_str(), 0, 10)));
+    }
+    if(log.empty())
+    {
+        std::cerr << "err; the query log is empty\n";
+        exit(1);
+    }
+
+    warthog::map_registry registry(0);
+    for(std::string d = cfg.get_param_value("map-dir"); d != "";
+            d = cfg.get_param_value("map-dir"))
+    {
+        DIR* dir = opendir(d.c_str());
+        if(!dir)
+        {
+            std::cerr << "err; cannot open map directory " << d << "\n";
+            exit(1);
+        }
+        for(struct dirent* ent = readdir(dir); ent != 0; ent = readdir(dir))
+        {
+            std::string name(ent->d_name);
+            if(name.size() > 4 && name.compare(name.size()-4, 4, ".map") == 0)
+            {
+                registry.add(name, d + "/" + name);
+            }
+        }
+        closedir(dir);
+    }
+    for(std::string m = cfg.get_param_value("map"); m != "";
+            m = cfg.get_param_value("map"))
+    {
+        size_t eq = m.find('=');
+        size_t slash = m.find_last_of('/');
+        if(eq != std::string::npos)
+        {
+            registry.add(m.substr(0, eq), m.substr(eq+1));
+        }
+        else
+        {
+            registry.add(slash == std::string::npos ? m : m.substr(slash+1), m);
+        }
+    }
+
+    std::string alg = cfg.get_param_value("alg");
+    if(alg == "") { alg = "jps2"; }
+    const std::vector<std::string>& algs = warthog::grid_searcher_names();
+    if(std::find(algs.begin(), algs.end(), alg) == algs.end())
+    {
+        std::cerr << "err; invalid search algorithm: " << alg << "\n";
+        exit(1);
+    }
+
+    uint32_t clients = std::thread::hardware_concurrency();
+    std::string s_clients = cfg.get_param_value("clients");
+    if(s_clients != "") { clients = (uint32_t)strtoul(s_clients.c_str(), 0, 10); }
+    if(clients == 0) { clients = 1; }
+
+    // load every map up front so the first queries do not pay for it
+    {
+        std::vector<std::string> maps;
+        for(const logged_query& q : log) { maps.push_back(q.map_); }
+        std::sort(maps.begin(), maps.end());
+        maps.erase(std::unique(maps.begin(), maps.end()), maps.end());
+        for(const std::string& m : maps)
+        {
+            std::string err;
+            std::shared_ptr<warthog::map_registry::entry> e =
+                registry.acquire(m, err);
+            if(!e)
+            {
+                std::cerr << "err; " << err << "\n";
+                exit(1);
+            }
+            registry.release(e, 0);
+        }
+    }
+
+    // the speed factors to replay at
+    double span = (log.back().arrival_nano_ - log.front().arrival_nano_) / 1e9;
+    double log_qps = span > 0 ? (log.size() - 1) / span : 0;
+    std::vector<double> speeds;
+    for(std::string r = cfg.get_param_value("qps"); r != "";
+            r = cfg.get_param_value("qps"))
+    {
+        if(log_qps == 0)
+        {
+            std::cerr << "err; --qps needs a log that spans some time\n";
+            exit(1);
+        }
+        speeds.push_back(atof(r.c_str()) / log_qps);
+    }
+    std::sort(speeds.begin(), speeds.end());
+    if(speeds.empty())
+    {
+        std::string s = cfg.get_param_value("speed");
+        speeds.push_back(s == "" ? 1 : atof(s.c_str()));
+    }
+    for(double s : speeds)
+    {
+        if(!(s > 0))
+        {
+            std::cerr << "err; rates and speeds must be positive\n";
+            exit(1);
+        }
+    }
+    std::string s_knee = cfg.get_param_value("knee");
+    double knee = s_knee == "" ? 2 : atof(s_knee.c_str());
+
+    std::cerr << "replaying " << log.size() << " queries with " << clients
+        << " clients\n";
+    std::cout << "speed\toffered_qps\tachieved_qps\tqueries\terrors"
+        << "\tp50_us\tp90_us\tp99_us\tp999_us\tmax_us\tmean_wait_us\n";
+    std::cout << std::fixed << std::setprecision(1);
+    double base_p99 = 0, knee_qps = 0;
+    for(uint32_t k = 0; k < speeds.size(); k++)
+    {
+        replay_stats st = replay(registry, alg, log, speeds[k], clients);
+        std::vector<double>& lat = st.latency_;
+        std::sort(lat.begin(), lat.end());
+        double wait = 0;
+        for(double w : st.wait_) { wait += w; }
+        double p99 = percentile(lat, 0.99);
+
+        std::cout << std::setprecision(3) << speeds[k] << std::setprecision(1)
+            << "\t" << st.offered_qps_
+            << "\t" << st.achieved_qps_
+            << "\t" << lat.size()
+            << "\t" << st.errors_
+            << "\t" << percentile(lat, 0.5) / 1e3
+            << "\t" << percentile(lat, 0.9) / 1e3
+            << "\t" << p99 / 1e3
+            << "\t" << percentile(lat, 0.999) / 1e3
+            << "\t" << lat.back() / 1e3
+            << "\t" << wait / st.wait_.size() / 1e3 << std::endl;
+
+        if(k == 0) { base_p99 = p99; }
+        else if(knee_qps == 0 && p99 > knee * base_p99)
+        {
+            knee_qps = st.offered_qps_;
+        }
+    }
+
+    if(speeds.size() > 1)
+    {
+        if(knee_qps > 0)
+        {
+            std::cerr << "knee_qps=" << knee_qps << " (first rate with p99 above "
+                << knee << "x the p99 at the lowest rate)\n";
+        }
+        else { std::cerr << "knee_qps=none (p99 stayed within " << knee << "x)\n"; }
+    }
+    return 0;
+}
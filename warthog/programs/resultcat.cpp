@@ -0,0 +1,108 @@
+// resultcat.cpp
+//
+// Prints the binary results written by warthog --format bin as text, or
+// summarises them.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "cfg.h"
+#include "constants.h"
+#include "result_sink.h"
+
+#include "getopt.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int print_help = 0;
+int summary = 0;
+
+void
+help()
+{
+    std::cerr
+        << "==> manual <==\n"
+        << "Print results written by warthog --format bin.\n\n"
+        << "--in <file>            binary results\n"
+        << "--format <tsv|csv>     output format (default: tsv)\n"
+        << "--summary              print totals instead of the rows\n";
+}
+
+int
+main(int argc, char** argv)
+{
+	warthog::util::param valid_args[] =
+	{
+		{"in", required_argument, 0, 1},
+		{"format", required_argument, 0, 1},
+		{"summary", no_argument, &summary, 1},
+		{"help", no_argument, &print_help, 1},
+		{0, 0, 0, 0}
+	};
+
+	warthog::util::cfg cfg;
+	cfg.parse_args(argc, argv, "", valid_args);
+
+    if(argc == 1 || print_help)
+    {
+        help();
+        exit(0);
+    }
+
+    std::string infile = cfg.get_param_value("in");
+    std::string format = cfg.get_param_value("format");
+    if(format == "") { format = "tsv"; }
+
+    warthog::result_reader reader(infile);
+    if(!reader.good())
+    {
+        std::cerr << "err; not a result file: " << infile << "\n";
+        exit(1);
+    }
+
+    warthog::query_result r;
+    if(summary)
+    {
+        uint64_t rows = 0, expanded = 0, unsolved = 0;
+        double time = 0;
+        while(reader.next(r))
+        {
+            rows++;
+            expanded += r.expanded_;
+            time += r.time_nano_;
+            if(r.cost_ == warthog::COST_MAX) { unsolved++; }
+        }
+        std::cout << "alg=" << reader.get_header().alg_
+            << " sfile=" << reader.get_header().scenario_
+            << " queries=" << rows
+            << " unsolved=" << unsolved
+            << " expanded=" << expanded
+            << " time_ns=" << (uint64_t)time
+            << " mean_time_ns=" << (rows ? time / rows : 0) << "\n";
+    }
+    else
+    {
+        std::string err;
+        warthog::result_sink* out =
+            warthog::create_result_sink(format, "", err);
+        if(!out)
+        {
+            std::cerr << "err; " << err << "\n";
+            exit(1);
+        }
+        out->begin(reader.get_header());
+        while(reader.next(r)) { out->write(r); }
+        out->finish();
+        delete out;
+    }
+
+    if(!reader.good())
+    {
+        std::cerr << "err; " << infile << " is truncated\n";
+        return 1;
+    }
+    return 0;
+}
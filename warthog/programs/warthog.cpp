@@ -7,16 +7,28 @@
 // @created: 2016-11-23
 //
 
+#include "batch_scheduler.h"
 #include "cfg.h"
 #include "constants.h"
+#include "dead_end_filter.h"
+#include "dead_end_regions.h"
 #include "flexible_astar.h"
+#include "grid_bb_labelling.h"
 #include "gridmap.h"
 #include "gridmap_expansion_policy.h"
+#include "grid_searcher.h"
+#include "gridmap_pager.h"
+#include "hpa_search.h"
 #include "jps_expansion_policy.h"
 #include "jps2_expansion_policy.h"
 #include "jps2_expansion_policy_prune2.h"
+#include "landmark_heuristic.h"
 #include "octile_heuristic.h"
+#include "phase_timer.h"
+#include "result_sink.h"
+#include "rsr_expansion_policy.h"
 #include "scenario_manager.h"
+#include "subgoal_expansion_policy.h"
 #include "timer.h"
 #include "nodemap.h"
 #include "zero_heuristic.h"
@@ -24,6 +36,7 @@
 #include "getopt.h"
 #include "global.h"
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include <iomanip>
@@ -32,6 +45,7 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 namespace G = global;
 // check computed solutions are optimal
@@ -41,6 +55,25 @@ int verbose = 0;
 // display program help on startup
 int print_help = 0;
 long long tot = 0;
+// give jps2 and jps2-prune2 maps a strip summary; see --summary
+int summary = 0;
+// give jps2 maps sheared diagonal copies too; see --diagonals
+int diagonals = 0;
+// skip dead-end regions in grid searches; see --dead-ends
+int dead_ends = 0;
+// goal bounding boxes for jps2 and jps2-prune2; see --goal-bounds
+std::string goal_bounds_file;
+// landmarks of the -lm algorithms; see --landmarks
+uint32_t num_landmarks = 8;
+// tiles a side of the hpa clusters, and whether hpa refines lazily; see
+// --cluster and --lazy
+uint32_t cluster_size = 64;
+int lazy = 0;
+// bytes of a paged jps2 map (and of its rotated copy) kept resident; 0
+// reads the map into memory. see --paged
+size_t paged_bytes = 0;
+// where run_experiments writes its rows; see --out and --format
+warthog::result_sink* results = 0;
 
 void
 help()
@@ -51,7 +84,48 @@ help()
         << "map/scenario format from the 2014 Grid-based Path Planning Competition\n\n";
 
 	std::cerr 
-    << "Check README.md\n";
+    << "Check README.md\n\n"
+    << "Several algorithms can be compared in one process by giving a\n"
+    << "comma-separated list, e.g. --alg jps2,jps2-prune2. All algorithms\n"
+    << "share one map and run round-robin on every query; each row reports\n"
+    << "the speedup over the first algorithm in the list.\n\n"
+    << "--tick-budget <us> and/or --tick-expansions <n> run every query\n"
+    << "as a resumable search stepped once per tick, with each step\n"
+    << "limited to that many microseconds and/or expansions.\n\n"
+    << "--batch <order> answers all queries as one batch run in the given\n"
+    << "order (hilbert, random or input) and compares its wall time with\n"
+    << "running the same batch in input order, best of --batch-rounds <n>\n"
+    << "(default: 3) runs each; rows stay in input order.\n\n"
+    << "--format <tsv|csv|bin> and --out <file> choose how and where the\n"
+    << "rows of a single algorithm run are written (default: tsv on stdout);\n"
+    << "sliced runs add ticks and maxtick columns. They cannot be used when\n"
+    << "comparing several algorithms.\n"
+    << "Rows are written by a background thread; bin is a columnar binary\n"
+    << "format that resultcat turns back into text.\n\n"
+    << "--summary lets jps2 and jps2-prune2 skip open strips of 64 tiles\n"
+    << "in one step when jumping (see gridmap::enable_summary).\n"
+    << "--diagonals also lets jps2 measure diagonals on sheared copies of\n"
+    << "the map and skip the straight scans that cannot find a jump point\n"
+    << "(see gridmap::enable_diagonals).\n"
+    << "--dead-ends keeps astar, jps, jps2 and jps2-prune2 out of rooms and\n"
+    << "cul-de-sacs behind a single tile that hold neither the start nor the\n"
+    << "target (see dead_end_regions).\n"
+    << "--goal-bounds <file> lets jps2 and jps2-prune2 skip the moves whose\n"
+    << "goal bounding box excludes the target. The boxes are read from the\n"
+    << "file or, if it does not hold boxes for the map, computed (one\n"
+    << "Dijkstra search per tile, in parallel) and written to it.\n"
+    << "astar-lm, jps-lm and jps2-lm use the larger of the octile distance\n"
+    << "and a differential heuristic over --landmarks <k> (default: 8)\n"
+    << "landmarks (see landmark_heuristic).\n"
+    << "hpa searches an abstract graph of square clusters of --cluster <n>\n"
+    << "(default: 64) tiles a side and refines the path it finds with jps2\n"
+    << "(see hpa_search). Its paths are not optimal, so --checkopt does not\n"
+    << "apply. With --lazy only the first segment is refined and the rows\n"
+    << "report the abstract cost.\n"
+    << "--paged <MB> lets jps2 search a binary map (see gridmap::save)\n"
+    << "without reading it into memory: the map and its rotated copy, kept\n"
+    << "next to it as <map>.rmap, are paged in on demand with at most <MB>\n"
+    << "megabytes of each resident (see gridmap_pager).\n";
 }
 
 bool
@@ -79,68 +153,288 @@ check_optimality(warthog::solution& sol, warthog::experiment* exp)
 		std::cerr << strpathlen.str()<<std::endl;
 		std::cerr << "precision: " << precision << " epsilon: "<<epsilon<<std::endl;
 		std::cerr<< "delta: "<< delta << std::endl;
+        // keep the rows of the queries before this one
+        if(results) { results->finish(); }
 		exit(1);
 	}
     return true;
 }
 
+#ifdef PHASE_TIMING
+// cycles per search phase, summed over all queries; see phase_timer.h
+uint64_t phase_sum[warthog::phase::NUM_PHASES+2] = {0};
+
+// the phase counters are extra columns of the results
+void
+phase_columns(std::vector<std::string>& cols)
+{
+    for(uint32_t i = 0; i < warthog::phase::NUM_PHASES; i++)
+    { cols.push_back(warthog::phase::names[i]); }
+    cols.push_back("other");
+    cols.push_back("cycles");
+}
+
+// record the counters of the last query and add them to the totals
+void
+phase_row(warthog::query_result& r)
+{
+    for(uint32_t i = 0; i < warthog::phase::NUM_PHASES; i++)
+    {
+        r.extra_[i] = warthog::phase::cycles[i];
+        phase_sum[i] += warthog::phase::cycles[i];
+    }
+    r.extra_[warthog::phase::NUM_PHASES] = warthog::phase::other();
+    r.extra_[warthog::phase::NUM_PHASES+1] =
+        warthog::phase::cycles[warthog::phase::TOTAL];
+    phase_sum[warthog::phase::NUM_PHASES] += warthog::phase::other();
+    phase_sum[warthog::phase::NUM_PHASES+1] +=
+        warthog::phase::cycles[warthog::phase::TOTAL];
+}
+
+void
+print_phase_summary(std::ostream& out)
+{
+    uint64_t total = phase_sum[warthog::phase::NUM_PHASES+1];
+    out << "phase\tcycles\tshare\n";
+    for(uint32_t i = 0; i <= warthog::phase::NUM_PHASES; i++)
+    {
+        out << (i < warthog::phase::NUM_PHASES ?
+                    warthog::phase::names[i] : "other")
+            << "\t" << phase_sum[i] << "\t"
+            << std::fixed << std::setprecision(1)
+            << (total ? 100.0 * phase_sum[i] / total : 0) << "%\n";
+    }
+    out << "total\t" << total << "\t100.0%\n";
+    out.unsetf(std::ios_base::floatfield);
+}
+#endif
+
 void
 run_experiments(warthog::search* algo, std::string alg_name,
         warthog::scenario_manager& scenmgr, bool verbose, bool checkopt,
-        std::ostream& out)
+        warthog::result_sink& out, global::search_context* ctx = 0)
 {
-	/* std::cout  */
-  /*       << "id\talg\texpanded\tinserted\tupdated\ttouched\tsurplus" */
-  /*       << "\tnanos\tpcost\tplen\tmap\n"; */
-	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tscnt\tsfile\n";
+    warthog::result_header header;
+    header.alg_ = alg_name;
+    header.scenario_ = scenmgr.last_file_loaded();
+#ifdef PHASE_TIMING
+    phase_columns(header.extra_);
+#endif
+    out.begin(header);
   tot = 0;
 	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
-		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		warthog::grid_id_t startid =
+			(warthog::grid_id_t)exp->starty() * exp->mapwidth() + exp->startx();
+		warthog::grid_id_t goalid =
+			(warthog::grid_id_t)exp->goaly() * exp->mapwidth() + exp->goalx();
         warthog::problem_instance pi(startid, goalid, verbose);
         warthog::solution sol;
         G::statis::clear();
+        if(ctx) { ctx->scan_cnt = 0; }
+#ifdef PHASE_TIMING
+        warthog::phase::clear();
+#endif
         algo->get_path(pi, sol);
 
-		out
-            << i<<"\t" 
-            << alg_name << "\t" 
-            << sol.nodes_expanded_ << "\t" 
-            << sol.nodes_inserted_ << "\t"
-            << sol.nodes_touched_ << "\t"
-            << sol.time_elapsed_nano_ << "\t"
-            << sol.sum_of_edge_costs_ << "\t" 
-            << G::statis::scan_cnt << "\t"
-            << scenmgr.last_file_loaded() 
-            << std::endl;
-
-    tot += G::statis::scan_cnt;
+        warthog::query_result r;
+        r.id_ = i;
+        r.expanded_ = sol.nodes_expanded_;
+        r.inserted_ = sol.nodes_inserted_;
+        r.touched_ = sol.nodes_touched_;
+        r.time_nano_ = sol.time_elapsed_nano_;
+        r.cost_ = sol.sum_of_edge_costs_;
+        r.scans_ = ctx ? ctx->scan_cnt : 0;
+#ifdef PHASE_TIMING
+        phase_row(r);
+#endif
+        out.write(r);
+
+    tot += r.scans_;
         if(checkopt) { check_optimality(sol, exp); }
 	}
+    out.finish();
+#ifdef PHASE_TIMING
+    print_phase_summary(std::cerr);
+#endif
+}
+
+// the dead-end regions of a map, found before the first query if
+// --dead-ends was given; the build time is reported separately and not
+// included in the rows
+struct dead_end_pruning
+{
+    std::unique_ptr<warthog::dead_end_regions> regions_;
+    std::unique_ptr<warthog::dead_end_filter> filter_;
+
+    dead_end_pruning(warthog::gridmap& map)
+    {
+        if(!dead_ends) { return; }
+        warthog::timer t;
+        t.start();
+        regions_.reset(new warthog::dead_end_regions(&map));
+        filter_.reset(new warthog::dead_end_filter(regions_.get()));
+        t.stop();
+        std::cerr << "dead-end regions: " << regions_->num_regions() - 1
+            << ", build time (ns): " << t.elapsed_time_nano() << "\n";
+    }
+
+    warthog::dead_end_filter*
+    get() { return filter_.get(); }
+};
+
+// the goal bounding boxes of a map if --goal-bounds was given; loading or
+// building them is reported separately and not included in the rows
+struct goal_bounding
+{
+    std::unique_ptr<warthog::label::grid_bb_labelling> bounds_;
+
+    goal_bounding(warthog::gridmap& map)
+    {
+        if(goal_bounds_file == "") { return; }
+        warthog::timer t;
+        t.start();
+        bounds_.reset(new warthog::label::grid_bb_labelling(&map));
+        bool loaded = bounds_->load(goal_bounds_file.c_str());
+        if(!loaded)
+        {
+            bounds_->precompute();
+            if(!bounds_->save(goal_bounds_file.c_str()))
+            {
+                std::cerr << "err; cannot write goal bounds to "
+                    << goal_bounds_file << "\n";
+            }
+        }
+        t.stop();
+        std::cerr << "goal bounds " << (loaded ? "loaded" : "built")
+            << ", time (ns): " << t.elapsed_time_nano() << "\n";
+    }
+
+    warthog::label::grid_bb_labelling*
+    get() { return bounds_.get(); }
+};
+
+// the heuristic of the grid searches; the landmark tables are built
+// before the first query and reported separately
+template<class H>
+H*
+new_heuristic(warthog::gridmap& map);
+
+template<>
+warthog::octile_heuristic*
+new_heuristic(warthog::gridmap& map)
+{
+    return new warthog::octile_heuristic(map.width(), map.height());
+}
+
+template<>
+warthog::landmark_heuristic*
+new_heuristic(warthog::gridmap& map)
+{
+    warthog::timer t;
+    t.start();
+    warthog::landmark_heuristic* h =
+        new warthog::landmark_heuristic(&map, num_landmarks);
+    t.stop();
+    std::cerr << "landmarks: " << h->num_landmarks()
+        << ", build time (ns): " << t.elapsed_time_nano() << "\n";
+    return h;
+}
+
+// the map of run_jps2: read in full, or with --paged mapped from a binary
+// map file
+warthog::gridmap*
+load_map(const std::string& mapname)
+{
+    if(!paged_bytes)
+    {
+        if(!warthog::gridmap::is_binary(mapname.c_str()))
+        {
+            return new warthog::gridmap(mapname.c_str());
+        }
+        warthog::gridmap* map = warthog::gridmap::load(mapname.c_str());
+        if(!map)
+        {
+            std::cerr << "err; cannot read binary map " << mapname << "\n";
+            exit(1);
+        }
+        return map;
+    }
+    warthog::gridmap* map =
+        warthog::gridmap::load_paged(mapname.c_str(), paged_bytes);
+    if(!map)
+    {
+        std::cerr << "err; cannot page binary map " << mapname << "\n";
+        exit(1);
+    }
+    return map;
+}
+
+// with --paged, the rotated copy of @param map that jps2 jumps north and
+// south on; it is paged too. 0 lets the expansion policy make its own
+warthog::gridmap*
+load_rmap(warthog::gridmap& map, const std::string& mapname)
+{
+    if(!paged_bytes) { return 0; }
+    warthog::timer t;
+    t.start();
+    std::string filename = mapname + ".rmap";
+    warthog::gridmap* rmap = warthog::jps::create_paged_rmap(
+            &map, filename.c_str(), paged_bytes);
+    t.stop();
+    if(!rmap)
+    {
+        std::cerr << "err; cannot write rotated map " << filename << "\n";
+        exit(1);
+    }
+    std::cerr << "rotated map: " << filename
+        << ", time (ns): " << t.elapsed_time_nano() << "\n";
+    return rmap;
 }
 
+void
+print_paging(const char* name, warthog::gridmap* map)
+{
+    warthog::gridmap_pager* pager = map ? map->get_pager() : 0;
+    if(!pager) { return; }
+    std::cerr << name << " bands: " << pager->num_bands()
+        << ", resident at most: " << pager->max_resident_bands()
+        << ", faults: " << pager->faults()
+        << ", reactivations: " << pager->reactivations()
+        << ", evictions: " << pager->evictions() << "\n";
+}
 
+template<class H = warthog::octile_heuristic>
 void
 run_jps2(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
-    warthog::gridmap map(mapname.c_str());
-	warthog::jps2_expansion_policy expander(&map);
-	warthog::octile_heuristic heuristic(map.width(), map.height());
+    std::unique_ptr<warthog::gridmap> mapptr(load_map(mapname));
+    warthog::gridmap& map = *mapptr;
+    if(summary) { map.enable_summary(); }
+    if(diagonals) { map.enable_diagonals(); }
+    std::unique_ptr<warthog::gridmap> rmap(load_rmap(map, mapname));
+    dead_end_pruning pruning(map);
+    goal_bounding bounding(map);
+	warthog::jps2_expansion_policy expander(&map, rmap.get());
+    expander.set_dead_end_filter(pruning.get());
+    expander.set_goal_bounds(bounding.get());
+    std::unique_ptr<H> heuristic(new_heuristic<H>(map));
     warthog::pqueue_min open;
 
 	warthog::flexible_astar<
-		warthog::octile_heuristic,
+		H,
 	   	warthog::jps2_expansion_policy,
         warthog::pqueue_min> 
-            astar(&heuristic, &expander, &open);
+            astar(heuristic.get(), &expander, &open);
 
     tot = 0;
     G::nodepool = expander.get_nodepool();
     run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
+            verbose, checkopt, *results, expander.get_context());
+    print_paging("map", &map);
+    print_paging("rotated map", rmap.get());
 	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
             << ", tot scan: " << tot << "\n";
 }
@@ -148,7 +442,12 @@ void
 run_jps2_prune2(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
   warthog::gridmap map(mapname.c_str());
+  if(summary) { map.enable_summary(); }
+  dead_end_pruning pruning(map);
+  goal_bounding bounding(map);
 	warthog::jps2_expansion_policy_prune2 expander(&map);
+  expander.set_dead_end_filter(pruning.get());
+  expander.set_goal_bounds(bounding.get());
 	warthog::octile_heuristic heuristic(map.width(), map.height());
   warthog::pqueue_min open;
 
@@ -159,47 +458,54 @@ run_jps2_prune2(warthog::scenario_manager& scenmgr, std::string mapname, std::st
 
   tot = 0;
   G::query::map = &map;
-  G::query::open = &open;
   G::nodepool = expander.get_nodepool();
-  run_experiments(&astar, alg_name, scenmgr, verbose, checkopt, std::cout);
+  expander.get_context()->open = &open;
+  run_experiments(&astar, alg_name, scenmgr, verbose, checkopt, *results,
+          expander.get_context());
   std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << ", tot scan: " << tot << "\n";
 }
 
+template<class H = warthog::octile_heuristic>
 void
 run_jps(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
     warthog::gridmap map(mapname.c_str());
+    dead_end_pruning pruning(map);
 	warthog::jps_expansion_policy expander(&map);
-	warthog::octile_heuristic heuristic(map.width(), map.height());
+    expander.set_dead_end_filter(pruning.get());
+    std::unique_ptr<H> heuristic(new_heuristic<H>(map));
     warthog::pqueue_min open;
 
 	warthog::flexible_astar<
-		warthog::octile_heuristic,
+		H,
 	   	warthog::jps_expansion_policy,
         warthog::pqueue_min> 
-            astar(&heuristic, &expander, &open);
+            astar(heuristic.get(), &expander, &open);
 
     run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
+            verbose, checkopt, *results, expander.get_context());
 	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
 }
 
+template<class H = warthog::octile_heuristic>
 void
 run_astar(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
     warthog::gridmap map(mapname.c_str());
+    dead_end_pruning pruning(map);
 	warthog::gridmap_expansion_policy expander(&map);
-	warthog::octile_heuristic heuristic(map.width(), map.height());
+    expander.set_dead_end_filter(pruning.get());
+    std::unique_ptr<H> heuristic(new_heuristic<H>(map));
     warthog::pqueue_min open;
 
 	warthog::flexible_astar<
-		warthog::octile_heuristic,
+		H,
 	   	warthog::gridmap_expansion_policy, 
         warthog::pqueue_min> 
-            astar(&heuristic, &expander, &open);
+            astar(heuristic.get(), &expander, &open);
 
     run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
+            verbose, checkopt, *results);
 	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
 }
 
@@ -218,10 +524,374 @@ run_dijkstra(warthog::scenario_manager& scenmgr, std::string mapname, std::strin
             astar(&heuristic, &expander, &open);
 
     run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
+            verbose, checkopt, *results);
 	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
 }
 
+// subgoal graphs are built before the first query; the build time is
+// reported separately and not included in the rows
+void
+run_subgoal(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::gridmap map(mapname.c_str());
+    warthog::timer t;
+    t.start();
+	warthog::subgoal_expansion_policy expander(&map);
+    t.stop();
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+    warthog::pqueue_min open;
+
+	warthog::flexible_astar<
+		warthog::octile_heuristic,
+	   	warthog::subgoal_expansion_policy,
+        warthog::pqueue_min> 
+            astar(&heuristic, &expander, &open);
+
+    std::cerr << "subgoals: " << expander.get_graph()->num_subgoals()
+        << ", edges: " << expander.get_graph()->num_edges()
+        << ", build time (ns): " << t.elapsed_time_nano() << "\n";
+    run_experiments(&astar, alg_name, scenmgr, 
+            verbose, checkopt, *results);
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+}
+
+// hierarchical path-finding A*; the abstract graph is reported separately
+// and not included in the rows
+void
+run_hpa(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::gridmap map(mapname.c_str());
+    warthog::timer t;
+    t.start();
+    warthog::hpa_search hpa(&map, cluster_size);
+    t.stop();
+    hpa.set_lazy(lazy);
+
+    std::cerr << "clusters: " << hpa.get_graph()->num_clusters()
+        << ", nodes: " << hpa.get_graph()->num_nodes()
+        << ", edges: " << hpa.get_graph()->num_edges()
+        << ", build time (ns): " << t.elapsed_time_nano() << "\n";
+    if(checkopt)
+    {
+        std::cerr << "warning; hpa paths are not optimal; ignoring --checkopt\n";
+    }
+    run_experiments(&hpa, alg_name, scenmgr, verbose, false, *results);
+	std::cerr << "done. total memory: "<< hpa.mem() + scenmgr.mem() << "\n";
+}
+
+// rectangular symmetry reduction; the decomposition is reported
+// separately and not included in the rows
+void
+run_rsr(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::gridmap map(mapname.c_str());
+    warthog::timer t;
+    t.start();
+	warthog::rsr_expansion_policy expander(&map);
+    t.stop();
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+    warthog::pqueue_min open;
+
+	warthog::flexible_astar<
+		warthog::octile_heuristic,
+	   	warthog::rsr_expansion_policy,
+        warthog::pqueue_min> 
+            astar(&heuristic, &expander, &open);
+
+    std::cerr << "rectangles: " << expander.get_decomposition()->num_rects()
+        << ", build time (ns): " << t.elapsed_time_nano() << "\n";
+    run_experiments(&astar, alg_name, scenmgr, 
+            verbose, checkopt, *results);
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+}
+
+// split a comma-separated list of algorithm names
+std::vector<std::string>
+split_algs(const std::string& alg)
+{
+    std::vector<std::string> algs;
+    std::stringstream ss(alg);
+    std::string name;
+    while(std::getline(ss, name, ','))
+    {
+        if(name != "") { algs.push_back(name); }
+    }
+    return algs;
+}
+
+// runs several algorithms on the same map, interleaving them query by
+// query so that all of them see the same cache state and cpu frequency.
+// the order in which algorithms run is rotated on every query to avoid
+// favouring the one which always goes first (or last).
+// each row reports the speedup of the algorithm over the first one in
+// @param algs (i.e. time of algs[0] / time of algs[j])
+void
+run_interleaved(warthog::scenario_manager& scenmgr, std::string mapname,
+        const std::vector<std::string>& algs)
+{
+    warthog::gridmap map(mapname.c_str());
+    std::vector<warthog::grid_searcher*> searchers;
+    for(const std::string& name : algs)
+    {
+        warthog::grid_searcher* s = warthog::create_grid_searcher(name, &map);
+        if(!s)
+        {
+            std::cerr << "err; invalid search algorithm: " << name << "\n";
+            exit(1);
+        }
+        searchers.push_back(s);
+    }
+
+    uint32_t nalgs = (uint32_t)searchers.size();
+    uint32_t nexps = scenmgr.num_experiments();
+    std::vector<std::vector<double>> speedups(nalgs);
+    std::vector<double> tot_time(nalgs, 0);
+    std::vector<uint32_t> wins(nalgs, 0);
+    std::vector<uint32_t> mismatches(nalgs, 0);
+    std::vector<warthog::solution> sols(nalgs);
+    std::vector<uint32_t> scans(nalgs, 0);
+
+	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tscnt\tspeedup\tsfile\n";
+    for(uint32_t i = 0; i < nexps; i++)
+    {
+		warthog::experiment* exp = scenmgr.get_experiment(i);
+		warthog::grid_id_t startid =
+			(warthog::grid_id_t)exp->starty() * exp->mapwidth() + exp->startx();
+		warthog::grid_id_t goalid =
+			(warthog::grid_id_t)exp->goaly() * exp->mapwidth() + exp->goalx();
+
+        for(uint32_t k = 0; k < nalgs; k++)
+        {
+            uint32_t j = (i + k) % nalgs;
+            warthog::problem_instance pi(startid, goalid, verbose);
+            G::statis::clear();
+            searchers.at(j)->get_path(pi, sols.at(j));
+            scans.at(j) = searchers.at(j)->get_scan_count();
+            if(checkopt) { check_optimality(sols.at(j), exp); }
+        }
+
+        double base_time = sols.at(0).time_elapsed_nano_;
+        for(uint32_t j = 0; j < nalgs; j++)
+        {
+            warthog::solution& sol = sols.at(j);
+            double speedup = sol.time_elapsed_nano_ > 0 ?
+                base_time / sol.time_elapsed_nano_ : 1;
+            speedups.at(j).push_back(speedup);
+            tot_time.at(j) += sol.time_elapsed_nano_;
+            if(j != 0 && speedup > 1) { wins.at(j)++; }
+            if(fabs(sol.sum_of_edge_costs_ - sols.at(0).sum_of_edge_costs_)
+                    > 0.005)
+            { mismatches.at(j)++; }
+
+            std::cout
+                << i << "\t"
+                << algs.at(j) << "\t"
+                << sol.nodes_expanded_ << "\t"
+                << sol.nodes_inserted_ << "\t"
+                << sol.nodes_touched_ << "\t"
+                << sol.time_elapsed_nano_ << "\t"
+                << sol.sum_of_edge_costs_ << "\t"
+                << scans.at(j) << "\t"
+                << speedup << "\t"
+                << scenmgr.last_file_loaded()
+                << "\n";
+        }
+    }
+
+    // summary; the geometric mean and median are robust to the few
+    // queries whose run time is dominated by timer noise
+    std::cerr << "alg\ttotal_ns\tgeomean_speedup\tmedian_speedup\twins"
+        << "\tcost_mismatches\tmem\n";
+    for(uint32_t j = 0; j < nalgs; j++)
+    {
+        std::vector<double>& su = speedups.at(j);
+        double log_sum = 0;
+        for(double s : su) { log_sum += log(s); }
+        double geomean = su.empty() ? 1 : exp(log_sum / su.size());
+        std::sort(su.begin(), su.end());
+        double median = su.empty() ? 1 : su.at(su.size() / 2);
+
+        std::cerr << algs.at(j) << "\t"
+            << (uint64_t)tot_time.at(j) << "\t"
+            << geomean << "\t"
+            << median << "\t"
+            << wins.at(j) << "/" << nexps << "\t"
+            << mismatches.at(j) << "\t"
+            << searchers.at(j)->mem() << "\n";
+        if(mismatches.at(j))
+        {
+            std::cerr << "warning; " << algs.at(j) << " path costs differ from "
+                << algs.at(0) << " on " << mismatches.at(j) << " queries\n";
+        }
+    }
+
+    for(warthog::grid_searcher* s : searchers) { delete s; }
+}
+
+// answers every query with a resumable search that is stepped once per
+// simulated game tick, each step limited to @param tick_nanos (if not zero)
+// and @param tick_exps expansions. rows report the number of ticks a query
+// took and the longest tick; the summary shows how well the steps keep to
+// the budget (a step overshoots by at most one expansion, or 16 when only
+// the time is limited, since the clock is not read after every expansion)
+void
+run_sliced(warthog::scenario_manager& scenmgr, std::string mapname,
+        std::string alg_name, double tick_nanos, uint32_t tick_exps,
+        warthog::result_sink& out)
+{
+    warthog::gridmap map(mapname.c_str());
+    warthog::grid_searcher* searcher =
+        warthog::create_grid_searcher(alg_name, &map);
+    if(!searcher)
+    {
+        std::cerr << "err; invalid search algorithm: " << alg_name << "\n";
+        exit(1);
+    }
+
+    std::vector<double> tick_time;
+    uint64_t tot_ticks = 0;
+    warthog::timer t;
+    warthog::result_header header;
+    header.alg_ = alg_name;
+    header.scenario_ = scenmgr.last_file_loaded();
+    header.extra_ = {"ticks", "maxtick"};
+    out.begin(header);
+	for(uint32_t i = 0; i < scenmgr.num_experiments(); i++)
+	{
+		warthog::experiment* exp = scenmgr.get_experiment(i);
+		warthog::grid_id_t startid =
+			(warthog::grid_id_t)exp->starty() * exp->mapwidth() + exp->startx();
+		warthog::grid_id_t goalid =
+			(warthog::grid_id_t)exp->goaly() * exp->mapwidth() + exp->goalx();
+        warthog::problem_instance pi(startid, goalid, verbose);
+        warthog::solution sol;
+        G::statis::clear();
+
+        uint32_t ticks = 0;
+        double max_tick = 0;
+        warthog::search_status status = searcher->begin(pi, sol);
+        while(status == warthog::SEARCH_IN_PROGRESS)
+        {
+            t.start();
+            status = searcher->step(sol, tick_exps, tick_nanos);
+            t.stop();
+            tick_time.push_back(t.elapsed_time_nano());
+            max_tick = std::max(max_tick, t.elapsed_time_nano());
+            ticks++;
+        }
+        tot_ticks += ticks;
+
+        warthog::query_result r;
+        r.id_ = i;
+        r.expanded_ = sol.nodes_expanded_;
+        r.inserted_ = sol.nodes_inserted_;
+        r.touched_ = sol.nodes_touched_;
+        r.time_nano_ = sol.time_elapsed_nano_;
+        r.cost_ = sol.sum_of_edge_costs_;
+        r.scans_ = searcher->get_scan_count();
+        r.extra_[0] = ticks;
+        r.extra_[1] = (uint64_t)max_tick;
+        out.write(r);
+        if(checkopt) { check_optimality(sol, exp); }
+	}
+    out.finish();
+
+    std::sort(tick_time.begin(), tick_time.end());
+    size_t n = tick_time.size();
+    std::cerr << "queries=" << scenmgr.num_experiments()
+        << " ticks=" << tot_ticks
+        << " tick_p50_ns=" << (n ? tick_time[n / 2] : 0)
+        << " tick_p99_ns=" << (n ? tick_time[std::min(n - 1, n * 99 / 100)] : 0)
+        << " tick_max_ns=" << (n ? tick_time[n - 1] : 0)
+        << " over_budget=";
+    if(tick_nanos > 0)
+    {
+        std::cerr << (tick_time.end() - std::upper_bound(
+                    tick_time.begin(), tick_time.end(), tick_nanos));
+    }
+    else { std::cerr << "-"; }
+    std::cerr << "\n";
+    delete searcher;
+}
+
+// answers all queries as one batch, scheduled by warthog::batch_scheduler
+// in @param order. to measure what the order buys, the batch is run
+// alternately in @param order and in input order, @param rounds times
+// each, and the fastest wall time of each is reported. rows come from
+// the last scheduled run and are written in input order
+void
+run_batch(warthog::scenario_manager& scenmgr, std::string mapname,
+        std::string alg_name, warthog::batch_order order, uint32_t rounds,
+        warthog::result_sink& out)
+{
+    warthog::gridmap map(mapname.c_str());
+    warthog::grid_searcher* searcher =
+        warthog::create_grid_searcher(alg_name, &map);
+    if(!searcher)
+    {
+        std::cerr << "err; invalid search algorithm: " << alg_name << "\n";
+        exit(1);
+    }
+
+    std::vector<warthog::problem_instance> queries;
+	for(uint32_t i = 0; i < scenmgr.num_experiments(); i++)
+	{
+		warthog::experiment* exp = scenmgr.get_experiment(i);
+		warthog::grid_id_t startid =
+			(warthog::grid_id_t)exp->starty() * exp->mapwidth() + exp->startx();
+		warthog::grid_id_t goalid =
+			(warthog::grid_id_t)exp->goaly() * exp->mapwidth() + exp->goalx();
+        queries.push_back(warthog::problem_instance(startid, goalid, verbose));
+    }
+
+    warthog::batch_scheduler scheduled(
+            map.header_width(), map.header_height(), order);
+    warthog::batch_scheduler unordered(
+            map.header_width(), map.header_height(), warthog::BATCH_INPUT);
+    std::vector<warthog::solution> sols, base_sols;
+    double best = DBL_MAX, base_best = DBL_MAX;
+    warthog::timer t;
+    for(uint32_t r = 0; r < rounds; r++)
+    {
+        t.start();
+        unordered.run(searcher, queries, base_sols);
+        t.stop();
+        base_best = std::min(base_best, t.elapsed_time_nano());
+
+        t.start();
+        scheduled.run(searcher, queries, sols);
+        t.stop();
+        best = std::min(best, t.elapsed_time_nano());
+    }
+
+    warthog::result_header header;
+    header.alg_ = alg_name;
+    header.scenario_ = scenmgr.last_file_loaded();
+    out.begin(header);
+	for(uint32_t i = 0; i < sols.size(); i++)
+	{
+        warthog::solution& sol = sols.at(i);
+        warthog::query_result r;
+        r.id_ = i;
+        r.expanded_ = sol.nodes_expanded_;
+        r.inserted_ = sol.nodes_inserted_;
+        r.touched_ = sol.nodes_touched_;
+        r.time_nano_ = sol.time_elapsed_nano_;
+        r.cost_ = sol.sum_of_edge_costs_;
+        r.scans_ = 0;
+        out.write(r);
+        if(checkopt) { check_optimality(sol, scenmgr.get_experiment(i)); }
+	}
+    out.finish();
+
+    std::cerr << "queries=" << queries.size()
+        << " rounds=" << rounds
+        << " wall_ns=" << (uint64_t)best
+        << " input_order_wall_ns=" << (uint64_t)base_best
+        << " speedup=" << (best > 0 ? base_best / best : 1) << "\n";
+    delete searcher;
+}
+
 int 
 main(int argc, char** argv)
 {
@@ -232,9 +902,25 @@ main(int argc, char** argv)
 		{"scen",  required_argument, 0, 0},
 		{"map",  required_argument, 0, 1},
 		{"gen", required_argument, 0, 3},
+		{"queries", required_argument, 0, 1},
+		{"goals-per-start", required_argument, 0, 1},
+		{"tick-budget", required_argument, 0, 1},
+		{"tick-expansions", required_argument, 0, 1},
+		{"batch", required_argument, 0, 1},
+		{"batch-rounds", required_argument, 0, 1},
+		{"format", required_argument, 0, 1},
+		{"out", required_argument, 0, 1},
+		{"goal-bounds", required_argument, 0, 1},
+		{"landmarks", required_argument, 0, 1},
+		{"cluster", required_argument, 0, 1},
+		{"paged", required_argument, 0, 1},
 		{"help", no_argument, &print_help, 1},
 		{"checkopt",  no_argument, &checkopt, 1},
 		{"verbose",  no_argument, &verbose, 1},
+		{"summary",  no_argument, &summary, 1},
+		{"diagonals",  no_argument, &diagonals, 1},
+		{"dead-ends",  no_argument, &dead_ends, 1},
+		{"lazy",  no_argument, &lazy, 1},
 		{0,  0, 0, 0}
 	};
 
@@ -254,9 +940,14 @@ main(int argc, char** argv)
 
 	if(gen != "")
 	{
+        std::string queries = cfg.get_param_value("queries");
+        std::string gps = cfg.get_param_value("goals-per-start");
 		warthog::scenario_manager sm;
 		warthog::gridmap gm(gen.c_str());
-		sm.generate_experiments(&gm, 1000) ;
+		sm.generate_experiments_by_start(&gm,
+                queries == "" ? 1000 : (uint32_t)atoi(queries.c_str()),
+                gps == "" ? 10 : (uint32_t)atoi(gps.c_str()));
+        sm.sort();
 		sm.write_scenario(std::cout);
         exit(0);
 	}
@@ -281,6 +972,73 @@ main(int argc, char** argv)
     // the map filename can be given or (default) taken from the scenario file
     if(mapname == "")
     { mapname = scenmgr.get_experiment(0)->map().c_str(); }
+
+    std::string format = cfg.get_param_value("format");
+    std::string outfile = cfg.get_param_value("out");
+    std::string err;
+    warthog::result_sink* sink = warthog::create_result_sink(
+            format == "" ? "tsv" : format, outfile, err);
+    if(!sink)
+    {
+        std::cerr << "err; " << err << "\n";
+        exit(1);
+    }
+    results = new warthog::async_result_sink(sink);
+
+    goal_bounds_file = cfg.get_param_value("goal-bounds");
+    std::string landmarks = cfg.get_param_value("landmarks");
+    if(landmarks != "")
+    {
+        num_landmarks = (uint32_t)strtoul(landmarks.c_str(), 0, 10);
+    }
+    std::string paged = cfg.get_param_value("paged");
+    if(paged != "")
+    {
+        paged_bytes = (size_t)strtoul(paged.c_str(), 0, 10) << 20;
+    }
+    std::string cluster = cfg.get_param_value("cluster");
+    if(cluster != "")
+    {
+        cluster_size = std::max(1ul, strtoul(cluster.c_str(), 0, 10));
+    }
+
+    std::string tick_budget = cfg.get_param_value("tick-budget");
+    std::string tick_exps = cfg.get_param_value("tick-expansions");
+
+    std::string batch = cfg.get_param_value("batch");
+    std::string batch_rounds = cfg.get_param_value("batch-rounds");
+
+    if(alg.find(',') != std::string::npos)
+    {
+        // rows of several algorithms, with a fractional speedup column,
+        // do not fit a result_sink run
+        if(format != "" || outfile != "")
+        {
+            std::cerr << "err; --format and --out do not apply when "
+                << "comparing algorithms\n";
+            exit(1);
+        }
+        run_interleaved(scenmgr, mapname, split_algs(alg));
+    }
+    else if(batch != "")
+    {
+        warthog::batch_order order;
+        if(!warthog::parse_batch_order(batch, order))
+        {
+            std::cerr << "err; invalid batch order: " << batch << "\n";
+            exit(1);
+        }
+        run_batch(scenmgr, mapname, alg, order, batch_rounds == "" ? 3 :
+                std::max(1, atoi(batch_rounds.c_str())), *results);
+    }
+    else if(tick_budget != "" || tick_exps != "")
+    {
+        // --tick-budget is in microseconds
+        run_sliced(scenmgr, mapname, alg,
+                tick_budget == "" ? 0 : atof(tick_budget.c_str()) * 1e3,
+                tick_exps == "" ? UINT32_MAX :
+                    (uint32_t)strtoul(tick_exps.c_str(), 0, 10), *results);
+    }
     else if(alg == "jps2")
     {
         run_jps2(scenmgr, mapname, alg);
@@ -289,10 +1047,18 @@ main(int argc, char** argv)
     {
       run_jps2_prune2(scenmgr, mapname, alg);
     }
+    else if(alg == "jps2-lm")
+    {
+        run_jps2<warthog::landmark_heuristic>(scenmgr, mapname, alg);
+    }
     else if(alg == "jps")
     {
         run_jps(scenmgr, mapname, alg);
     }
+    else if(alg == "jps-lm")
+    {
+        run_jps<warthog::landmark_heuristic>(scenmgr, mapname, alg);
+    }
     else if(alg == "dijkstra")
     {
         run_dijkstra(scenmgr, mapname, alg); 
@@ -302,10 +1068,28 @@ main(int argc, char** argv)
     {
         run_astar(scenmgr, mapname, alg); 
     }
+    else if(alg == "astar-lm")
+    {
+        run_astar<warthog::landmark_heuristic>(scenmgr, mapname, alg);
+    }
+    else if(alg == "subgoal")
+    {
+        run_subgoal(scenmgr, mapname, alg);
+    }
+    else if(alg == "rsr")
+    {
+        run_rsr(scenmgr, mapname, alg);
+    }
+    else if(alg == "hpa")
+    {
+        run_hpa(scenmgr, mapname, alg);
+    }
     else
     {
         std::cerr << "err; invalid search algorithm: " << alg << "\n";
     }
+    delete results;
+    delete sink;
 }
 
 
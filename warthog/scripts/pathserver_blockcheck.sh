@@ -0,0 +1,59 @@
+#!/bin/bash
+# Checks that block and unblock invalidate cached paths in pathserver,
+# including paths whose diagonal steps only pass a blocked tile at a corner.
+#
+# Syntax: ./pathserver_blockcheck.sh [path to pathserver]
+
+server=${1:-build/fast/bin/pathserver}
+if [ ! -x "$server" ]
+then
+	echo "Error: cannot run $server"
+	exit 1
+fi
+
+dir=`mktemp -d`
+trap "rm -rf $dir" EXIT
+printf 'type octile\nheight 5\nwidth 5\nmap\n.....\n.....\n.....\n.....\n.....\n' > $dir/open.map
+
+# one request per line; the expected cost of each path request follows it.
+# (1 0) and (0 1) are the corners of the first step of the open-map path
+checks=(
+	"path m jps2 0 0 4 4|5.65685415268"
+	"block m 1 0|"
+	"path m jps2 0 0 4 4|6.24264061451"
+	"unblock m 1 0|"
+	"path m jps2 0 0 4 4|5.65685415268"
+	"block m 0 1|"
+	"path m jps2 4 4 0 0|6.24264061451"
+	"unblock m 0 1|"
+	"path m jps2 4 4 0 0|5.65685415268"
+	"block m 2 2|"
+	"path m jps2 0 0 4 4|6.82842707634"
+	"unblock m 2 2|"
+	"path m jps2 0 0 4 4|5.65685415268"
+)
+
+# queries do not wait for updates, so every response is read before the
+# next request is sent
+coproc server { "$server" --path-cache 16 --workers 2 2>/dev/null; }
+echo "load m $dir/open.map" >&${server[1]}
+read -r got <&${server[0]}
+
+failed=0
+for c in "${checks[@]}"
+do
+	request=${c%%|*}
+	expected=${c#*|}
+	echo "$request" >&${server[1]}
+	read -r got <&${server[0]}
+	if [ "$expected" != "" ] && [ "`echo $got | cut -d' ' -f2`" != "$expected" ]
+	then
+		echo "fail; $request expected $expected got $got"
+		failed=1
+	fi
+done
+echo "shutdown" >&${server[1]}
+wait
+
+if [ $failed -eq 0 ]; then echo "ok"; fi
+exit $failed
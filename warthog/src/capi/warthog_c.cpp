@@ -0,0 +1,383 @@
+#include "warthog_c.h"
+
+#include "batch_scheduler.h"
+#include "gridmap.h"
+#include "grid_searcher.h"
+#include "jps.h"
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct warthog_map
+{
+    warthog::gridmap* map_;
+    // rotated copy shared by the jump point searchers; made on first use
+    warthog::gridmap* rmap_;
+    std::mutex mutex_;
+};
+
+struct warthog_searcher
+{
+    warthog::grid_searcher* searcher_;
+    warthog_map* map_;
+    std::vector<warthog::problem_instance> batch_;
+    std::vector<uint32_t> batch_index_;
+    std::vector<warthog::solution> batch_sols_;
+};
+
+namespace
+{
+
+thread_local std::string last_error;
+
+template<class T>
+T
+fail(const std::string& why, T ret)
+{
+    last_error = why;
+    return ret;
+}
+
+// the text map format read by gm_parser: three header fields in any
+// order (type, height, width), "map", then one character per tile
+warthog::gridmap*
+parse_map(const char* text, size_t length)
+{
+    std::istringstream in(std::string(text, length));
+    std::string type;
+    uint32_t height = 0, width = 0;
+    for(int i = 0; i < 3; i++)
+    {
+        std::string field;
+        if(!(in >> field)) { return fail("truncated header", (warthog::gridmap*)0); }
+        if(field == "type") { in >> type; }
+        else if(field == "height") { in >> height; }
+        else if(field == "width") { in >> width; }
+        else { return fail("unknown header field " + field, (warthog::gridmap*)0); }
+    }
+    std::string keyword;
+    in >> keyword;
+    if(!in || type != "octile" || height == 0 || width == 0 ||
+       keyword != "map")
+    {
+        return fail("not an octile map", (warthog::gridmap*)0);
+    }
+
+    warthog::gridmap* map = new warthog::gridmap(height, width);
+    warthog::grid_id_t tiles = (warthog::grid_id_t)height * width;
+    warthog::grid_id_t index = 0;
+    for(char c; in.get(c); )
+    {
+        if(c == ' ' || c == '\t' || c == '\n' || c == '\r') { continue; }
+        if(index >= tiles) { index++; break; }
+        // as in warthog::gridmap::gridmap(const char*)
+        bool obstacle = c == 'S' || c == 'W' || c == 'T' || c == '@' ||
+            c == 'O';
+        map->set_label(map->to_padded_id(index), !obstacle);
+        index++;
+    }
+    if(index != tiles)
+    {
+        delete map;
+        return fail("wrong number of tiles", (warthog::gridmap*)0);
+    }
+    return map;
+}
+
+warthog_map*
+wrap(warthog::gridmap* map)
+{
+    if(!map) { return 0; }
+    warthog_map* m = new warthog_map();
+    m->map_ = map;
+    m->rmap_ = 0;
+    return m;
+}
+
+// check @param q lies on the map and convert it to unpadded ids
+warthog_status
+to_ids(warthog::gridmap* map, const warthog_query* q,
+        warthog::grid_id_t& start, warthog::grid_id_t& goal)
+{
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    if(q->sx >= w || q->gx >= w || q->sy >= h || q->gy >= h)
+    {
+        return fail("coordinates outside the map", WARTHOG_ERR_INVALID);
+    }
+    start = (warthog::grid_id_t)q->sy * w + q->sx;
+    goal = (warthog::grid_id_t)q->gy * w + q->gx;
+    if(!map->get_label(map->to_padded_id(start)) ||
+       !map->get_label(map->to_padded_id(goal)))
+    {
+        return fail("start or goal is not traversable", WARTHOG_ERR_BLOCKED);
+    }
+    return WARTHOG_OK;
+}
+
+}
+
+uint32_t
+warthog_version(void)
+{
+    return WARTHOG_C_VERSION;
+}
+
+const char*
+warthog_last_error(void)
+{
+    return last_error.c_str();
+}
+
+warthog_map*
+warthog_map_load(const char* filename)
+{
+    if(!filename) { return fail("no file name", (warthog_map*)0); }
+    try
+    {
+        if(warthog::gridmap::is_binary(filename))
+        {
+            warthog::gridmap* map = warthog::gridmap::load(filename);
+            if(!map)
+            {
+                return fail(std::string("cannot read ") + filename,
+                        (warthog_map*)0);
+            }
+            return wrap(map);
+        }
+
+        std::ifstream in(filename, std::ios::binary);
+        if(!in) { return fail(std::string("cannot open ") + filename, (warthog_map*)0); }
+        std::stringstream text;
+        text << in.rdbuf();
+        std::string s = text.str();
+        return wrap(parse_map(s.c_str(), s.size()));
+    }
+    catch(const std::exception& e) { return fail(e.what(), (warthog_map*)0); }
+}
+
+warthog_map*
+warthog_map_parse(const char* text, size_t length)
+{
+    if(!text) { return fail("no map text", (warthog_map*)0); }
+    try { return wrap(parse_map(text, length)); }
+    catch(const std::exception& e) { return fail(e.what(), (warthog_map*)0); }
+}
+
+warthog_map*
+warthog_map_create(uint32_t width, uint32_t height, const uint8_t* cells)
+{
+    if(!cells || width == 0 || height == 0)
+    {
+        return fail("empty map", (warthog_map*)0);
+    }
+    try
+    {
+        warthog::gridmap* map = new warthog::gridmap(height, width);
+        warthog::grid_id_t tiles = (warthog::grid_id_t)width * height;
+        for(warthog::grid_id_t i = 0; i < tiles; i++)
+        {
+            map->set_label(map->to_padded_id(i), cells[i] != 0);
+        }
+        return wrap(map);
+    }
+    catch(const std::exception& e) { return fail(e.what(), (warthog_map*)0); }
+}
+
+void
+warthog_map_free(warthog_map* map)
+{
+    if(!map) { return; }
+    delete map->rmap_;
+    delete map->map_;
+    delete map;
+}
+
+uint32_t
+warthog_map_width(const warthog_map* map)
+{
+    return map ? map->map_->header_width() : 0;
+}
+
+uint32_t
+warthog_map_height(const warthog_map* map)
+{
+    return map ? map->map_->header_height() : 0;
+}
+
+int
+warthog_map_traversable(const warthog_map* map, uint32_t x, uint32_t y)
+{
+    if(!map || x >= map->map_->header_width() ||
+       y >= map->map_->header_height())
+    {
+        return 0;
+    }
+    return map->map_->get_label(map->map_->to_padded_id(x, y)) ? 1 : 0;
+}
+
+warthog_searcher*
+warthog_searcher_create(warthog_map* map, const char* alg)
+{
+    if(!map || !alg) { return fail("no map or algorithm", (warthog_searcher*)0); }
+    try
+    {
+        // only the jump point searchers use the rotated map, but making
+        // it for all of them keeps this simple
+        warthog::gridmap* rmap;
+        {
+            std::lock_guard<std::mutex> lock(map->mutex_);
+            if(!map->rmap_) { map->rmap_ = warthog::jps::create_rmap(map->map_); }
+            rmap = map->rmap_;
+        }
+
+        warthog::grid_searcher* s =
+            warthog::create_grid_searcher(alg, map->map_, rmap);
+        if(!s)
+        {
+            return fail(std::string("unknown algorithm ") + alg,
+                    (warthog_searcher*)0);
+        }
+        warthog_searcher* ws = new warthog_searcher();
+        ws->searcher_ = s;
+        ws->map_ = map;
+        return ws;
+    }
+    catch(const std::exception& e) { return fail(e.what(), (warthog_searcher*)0); }
+}
+
+void
+warthog_searcher_free(warthog_searcher* searcher)
+{
+    if(!searcher) { return; }
+    delete searcher->searcher_;
+    delete searcher;
+}
+
+warthog_status
+warthog_query_cost(warthog_searcher* searcher, const warthog_query* query,
+        double* cost)
+{
+    if(!searcher || !query || !cost)
+    {
+        return fail("null argument", WARTHOG_ERR_INVALID);
+    }
+    *cost = -1;
+    warthog::grid_id_t start, goal;
+    warthog_status status = to_ids(searcher->map_->map_, query, start, goal);
+    if(status != WARTHOG_OK) { return status; }
+
+    try
+    {
+        warthog::problem_instance pi(start, goal);
+        warthog::solution sol;
+        searcher->searcher_->get_pathcost(pi, sol);
+        if(sol.sum_of_edge_costs_ == warthog::COST_MAX) { return WARTHOG_NO_PATH; }
+        *cost = sol.sum_of_edge_costs_;
+        return WARTHOG_OK;
+    }
+    catch(const std::exception& e) { return fail(e.what(), WARTHOG_ERR_INTERNAL); }
+}
+
+warthog_status
+warthog_query_path(warthog_searcher* searcher, const warthog_query* query,
+        double* cost, uint32_t* xy, uint32_t capacity, uint32_t* length)
+{
+    if(!searcher || !query || !cost || !length || (!xy && capacity))
+    {
+        return fail("null argument", WARTHOG_ERR_INVALID);
+    }
+    *cost = -1;
+    *length = 0;
+    warthog::grid_id_t start, goal;
+    warthog::gridmap* map = searcher->map_->map_;
+    warthog_status status = to_ids(map, query, start, goal);
+    if(status != WARTHOG_OK) { return status; }
+
+    try
+    {
+        warthog::problem_instance pi(start, goal);
+        warthog::solution sol;
+        searcher->searcher_->get_path(pi, sol);
+        if(sol.sum_of_edge_costs_ == warthog::COST_MAX) { return WARTHOG_NO_PATH; }
+        *cost = sol.sum_of_edge_costs_;
+        *length = (uint32_t)sol.path_.size();
+        if(sol.path_.size() > capacity)
+        {
+            return fail("path buffer too small", WARTHOG_ERR_BUFFER);
+        }
+        for(size_t i = 0; i < sol.path_.size(); i++)
+        {
+            map->to_unpadded_xy((warthog::grid_id_t)sol.path_[i], xy[2*i], xy[2*i+1]);
+        }
+        return WARTHOG_OK;
+    }
+    catch(const std::exception& e) { return fail(e.what(), WARTHOG_ERR_INTERNAL); }
+}
+
+size_t
+warthog_query_batch(warthog_searcher* searcher,
+        const warthog_query* queries, size_t count, double* costs,
+        int32_t* status)
+{
+    if(!searcher || (count && (!queries || !costs)))
+    {
+        return fail("null argument", (size_t)0);
+    }
+
+    // bad queries are answered right away, the rest are run as one batch.
+    // the buffers are kept by the searcher so repeated batches of similar
+    // size do not allocate
+    warthog::gridmap* map = searcher->map_->map_;
+    searcher->batch_.clear();
+    searcher->batch_index_.clear();
+    for(size_t i = 0; i < count; i++)
+    {
+        warthog::grid_id_t start, goal;
+        warthog_status st = to_ids(map, &queries[i], start, goal);
+        costs[i] = -1;
+        if(status) { status[i] = st; }
+        if(st != WARTHOG_OK) { continue; }
+        searcher->batch_.push_back(warthog::problem_instance(start, goal));
+        searcher->batch_index_.push_back((uint32_t)i);
+    }
+
+    size_t found = 0;
+    try
+    {
+        warthog::batch_scheduler scheduler(
+                map->header_width(), map->header_height());
+        scheduler.run(searcher->searcher_, searcher->batch_,
+                searcher->batch_sols_, false);
+        for(size_t j = 0; j < searcher->batch_.size(); j++)
+        {
+            size_t i = searcher->batch_index_[j];
+            double c = searcher->batch_sols_[j].sum_of_edge_costs_;
+            if(c == warthog::COST_MAX)
+            {
+                if(status) { status[i] = WARTHOG_NO_PATH; }
+                continue;
+            }
+            costs[i] = c;
+            found++;
+        }
+    }
+    catch(const std::exception& e)
+    {
+        last_error = e.what();
+        if(status)
+        {
+            for(size_t j = 0; j < searcher->batch_.size(); j++)
+            {
+                status[searcher->batch_index_[j]] = WARTHOG_ERR_INTERNAL;
+            }
+        }
+        return 0;
+    }
+    return found;
+}
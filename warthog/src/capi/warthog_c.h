@@ -0,0 +1,136 @@
+#ifndef WARTHOG_C_H
+#define WARTHOG_C_H
+
+/*
+ * capi/warthog_c.h
+ *
+ * A small C interface to the grid searchers, for programs that embed
+ * warthog without depending on its C++ ABI. It is built as the shared
+ * library lib/libwarthog_c.so, which exports nothing but the functions
+ * below.
+ *
+ * Maps are loaded from a file (text or binary, see gridmap::save), parsed
+ * from a text map held in memory or built from an array of cells. A
+ * searcher runs one algorithm (any name accepted by create_grid_searcher,
+ * e.g. "jps2") on one map. Several searchers may share a map and be used
+ * from different threads, but each searcher must only be used by one
+ * thread at a time. A map must outlive the searchers created on it.
+ *
+ * Coordinates are in the unpadded space of the map, as in .map and .scen
+ * files. Large workloads should use warthog_query_batch, which answers
+ * thousands of queries per call and runs them in an order that is kind
+ * to the caches (see batch_scheduler.h).
+ *
+ * Functions that fail return NULL or a negative status; the reason is then
+ * available from warthog_last_error, per thread.
+ *
+ * @author: shizhe
+ * @created: 2026-10-18
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define WARTHOG_C_API __attribute__((visibility("default")))
+#else
+#define WARTHOG_C_API
+#endif
+
+/* bumped whenever the interface changes incompatibly */
+#define WARTHOG_C_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct warthog_map warthog_map;
+typedef struct warthog_searcher warthog_searcher;
+
+typedef enum
+{
+    WARTHOG_OK = 0,
+    WARTHOG_NO_PATH = 1,
+    WARTHOG_ERR_INVALID = -1,   /* bad argument or coordinates off the map */
+    WARTHOG_ERR_BLOCKED = -2,   /* start or goal is an obstacle */
+    WARTHOG_ERR_BUFFER = -3,    /* path longer than the buffer */
+    WARTHOG_ERR_INTERNAL = -4
+} warthog_status;
+
+typedef struct
+{
+    uint32_t sx, sy;
+    uint32_t gx, gy;
+} warthog_query;
+
+/* WARTHOG_C_VERSION of the library */
+WARTHOG_C_API uint32_t
+warthog_version(void);
+
+/* why the last failed call on this thread failed */
+WARTHOG_C_API const char*
+warthog_last_error(void);
+
+/* a map read from a text (.map) or binary map file */
+WARTHOG_C_API warthog_map*
+warthog_map_load(const char* filename);
+
+/* a map parsed from the contents of a text .map file */
+WARTHOG_C_API warthog_map*
+warthog_map_parse(const char* text, size_t length);
+
+/* a width x height map; cells[y * width + x] != 0 is traversable */
+WARTHOG_C_API warthog_map*
+warthog_map_create(uint32_t width, uint32_t height, const uint8_t* cells);
+
+WARTHOG_C_API void
+warthog_map_free(warthog_map* map);
+
+WARTHOG_C_API uint32_t
+warthog_map_width(const warthog_map* map);
+
+WARTHOG_C_API uint32_t
+warthog_map_height(const warthog_map* map);
+
+/* 1 if the cell is traversable, 0 if not or if it is off the map */
+WARTHOG_C_API int
+warthog_map_traversable(const warthog_map* map, uint32_t x, uint32_t y);
+
+/* a searcher running @alg on @map */
+WARTHOG_C_API warthog_searcher*
+warthog_searcher_create(warthog_map* map, const char* alg);
+
+WARTHOG_C_API void
+warthog_searcher_free(warthog_searcher* searcher);
+
+/* the cost of an optimal path, or -1 if there is none */
+WARTHOG_C_API warthog_status
+warthog_query_cost(warthog_searcher* searcher, const warthog_query* query,
+        double* cost);
+
+/*
+ * the cost (-1 if there is no path) and waypoints of an optimal path,
+ * start and goal included. waypoint i is at (xy[2i], xy[2i+1]); between
+ * two waypoints the path moves diagonally first, then straight. at most
+ * @capacity waypoints are written; @length receives their number, or the
+ * number needed if it is more than @capacity (WARTHOG_ERR_BUFFER)
+ */
+WARTHOG_C_API warthog_status
+warthog_query_path(warthog_searcher* searcher, const warthog_query* query,
+        double* cost, uint32_t* xy, uint32_t capacity, uint32_t* length);
+
+/*
+ * the costs of @count queries: costs[i] and, if not NULL, status[i]
+ * answer queries[i] as warthog_query_cost would. @return the number of
+ * queries that have a path
+ */
+WARTHOG_C_API size_t
+warthog_query_batch(warthog_searcher* searcher,
+        const warthog_query* queries, size_t count, double* costs,
+        int32_t* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,134 @@
+#include "dead_end_regions.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// tiles [first_, last_) in depth-first order hang off a cut vertex
+struct span
+{
+    uint32_t first_, last_;
+
+    bool
+    operator<(const span& other) const { return first_ < other.first_; }
+};
+
+// a region open during the labelling, up to tile last_ in depth-first order
+struct open_region
+{
+    uint32_t last_;
+    uint32_t region_;
+};
+
+struct frame
+{
+    uint32_t id_;
+    uint32_t next_;
+};
+
+// Tarjan's depth-first search from @param root. tiles are numbered in the
+// order they are reached; @param order lists them and @param spans gets
+// every subtree cut off by its parent. padding keeps the neighbours of
+// traversable tiles inside the map
+void
+cut_subtrees(warthog::gridmap* map, uint32_t root,
+        std::vector<uint32_t>& disc, std::vector<uint32_t>& low,
+        std::vector<uint32_t>& order, std::vector<span>& spans)
+{
+    int32_t w = (int32_t)map->width();
+    const int32_t offsets[4] = { -w, 1, w, -1 };
+
+    std::vector<frame> stack;
+    disc[root] = low[root] = (uint32_t)order.size();
+    order.push_back(root);
+    stack.push_back({root, 0});
+    while(!stack.empty())
+    {
+        frame& f = stack.back();
+        if(f.next_ < 4)
+        {
+            uint32_t n = (uint32_t)((int32_t)f.id_ + offsets[f.next_++]);
+            if(!map->get_label(n)) { continue; }
+            if(disc[n] == warthog::INF32)
+            {
+                disc[n] = low[n] = (uint32_t)order.size();
+                order.push_back(n);
+                stack.push_back({n, 0});
+            }
+            else { low[f.id_] = std::min(low[f.id_], disc[n]); }
+            continue;
+        }
+
+        uint32_t v = f.id_;
+        stack.pop_back();
+        if(stack.empty()) { break; }
+        uint32_t a = stack.back().id_;
+        low[a] = std::min(low[a], low[v]);
+        if(low[v] >= disc[a])
+        {
+            spans.push_back({disc[v], (uint32_t)order.size()});
+        }
+    }
+}
+
+}
+
+warthog::dead_end_regions::dead_end_regions(warthog::gridmap* map)
+{
+    uint32_t size = map->padded_mapsize();
+    region_of_.assign(size, 0);
+    parent_.push_back(0);
+
+    std::vector<uint32_t> disc(size, warthog::INF32);
+    std::vector<uint32_t> low(size);
+    std::vector<uint32_t> order;
+    std::vector<span> spans;
+    std::vector<open_region> open;
+    for(uint32_t id = 0; id < size; id++)
+    {
+        if(disc[id] != warthog::INF32 || !map->get_label(id)) { continue; }
+
+        uint32_t first = (uint32_t)order.size();
+        cut_subtrees(map, id, disc, low, order, spans);
+        uint32_t tiles = (uint32_t)order.size() - first;
+
+        // root the search again inside the smallest subtree that holds
+        // more than half of the component, if there is one
+        uint32_t root = warthog::INF32;
+        uint32_t best = tiles;
+        for(const span& s : spans)
+        {
+            uint32_t n = s.last_ - s.first_;
+            if(2 * n > tiles && n < best) { best = n; root = order[s.first_]; }
+        }
+        if(root != warthog::INF32)
+        {
+            for(uint32_t i = first; i < order.size(); i++)
+            {
+                disc[order[i]] = warthog::INF32;
+            }
+            order.resize(first);
+            spans.clear();
+            cut_subtrees(map, root, disc, low, order, spans);
+        }
+
+        // the spans nest; each opens a region inside the innermost open
+        // one. the rest of the component is core
+        std::sort(spans.begin(), spans.end());
+        open.clear();
+        std::vector<span>::iterator next = spans.begin();
+        for(uint32_t i = first; i < order.size(); i++)
+        {
+            while(!open.empty() && open.back().last_ <= i) { open.pop_back(); }
+            if(next != spans.end() && next->first_ == i)
+            {
+                parent_.push_back(open.empty() ? 0 : open.back().region_);
+                open.push_back({next->last_, (uint32_t)parent_.size() - 1});
+                ++next;
+            }
+            if(!open.empty()) { region_of_[order[i]] = open.back().region_; }
+        }
+        spans.clear();
+    }
+}
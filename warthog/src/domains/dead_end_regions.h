@@ -0,0 +1,73 @@
+#ifndef WARTHOG_DEAD_END_REGIONS_H
+#define WARTHOG_DEAD_END_REGIONS_H
+
+// domains/dead_end_regions.h
+//
+// Dead-end (swamp) regions of a gridmap: rooms and cul-de-sacs that are
+// joined to the rest of the map through a single tile. Such a tile is a
+// cut vertex of the grid graph; a shortest path that enters the region
+// behind it must leave through the same tile, so no optimal path enters
+// the region unless the start or the target is inside.
+//
+// The cut vertices are found with one depth-first search (Tarjan's
+// algorithm) per connected component. As in warthog::grid_components,
+// diagonal moves need both adjacent cardinal tiles, so the 4-connected
+// graph has the same cut vertices as the 8-connected one.
+//
+// Regions nest: a room behind a door can itself have closets. Each region
+// records the region that encloses it; region 0 is the core of the map,
+// which is never pruned. The search is rooted, where possible, inside the
+// part of the map that holds more than half of its tiles, so that the
+// large open areas are core and the small pockets are regions.
+//
+// The labels describe the map at construction; they must be rebuilt after
+// the map changes.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "constants.h"
+#include "gridmap.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class dead_end_regions
+{
+    public:
+        // label every tile of @param map; the map is only read during
+        // construction
+        dead_end_regions(warthog::gridmap* map);
+        ~dead_end_regions() { }
+
+        // the innermost region of the tile with padded id @param id;
+        // 0 for the core and for obstacles
+        inline uint32_t
+        get_region(warthog::grid_id_t id) { return region_of_[id]; }
+
+        // the region enclosing region @param r; the core encloses itself
+        inline uint32_t
+        get_parent(uint32_t r) { return parent_[r]; }
+
+        // the number of regions, including the core
+        inline uint32_t
+        num_regions() { return (uint32_t)parent_.size(); }
+
+        inline size_t
+        mem()
+        {
+            return sizeof(*this) + sizeof(uint32_t) *
+                (region_of_.capacity() + parent_.capacity());
+        }
+
+    private:
+        std::vector<uint32_t> region_of_;
+        std::vector<uint32_t> parent_;
+};
+
+}
+
+#endif
@@ -0,0 +1,46 @@
+#include "grid_components.h"
+
+warthog::grid_components::grid_components(warthog::gridmap* map)
+    : num_components_(0)
+{
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    labels_.assign((size_t)w * h, warthog::INF32);
+
+    std::vector<uint32_t> stack;
+    for(uint32_t id = 0; id < labels_.size(); id++)
+    {
+        if(labels_[id] != warthog::INF32 ||
+           !map->get_label(map->to_padded_id(id)))
+        {
+            continue;
+        }
+
+        uint32_t label = num_components_++;
+        labels_[id] = label;
+        stack.push_back(id);
+        while(!stack.empty())
+        {
+            uint32_t cur = stack.back();
+            stack.pop_back();
+            uint32_t x = cur % w;
+            uint32_t y = cur / w;
+
+            uint32_t nei[4];
+            uint32_t num = 0;
+            if(x > 0) { nei[num++] = cur - 1; }
+            if(x + 1 < w) { nei[num++] = cur + 1; }
+            if(y > 0) { nei[num++] = cur - w; }
+            if(y + 1 < h) { nei[num++] = cur + w; }
+            for(uint32_t i = 0; i < num; i++)
+            {
+                if(labels_[nei[i]] == warthog::INF32 &&
+                   map->get_label(map->to_padded_id(nei[i])))
+                {
+                    labels_[nei[i]] = label;
+                    stack.push_back(nei[i]);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef WARTHOG_GRID_COMPONENTS_H
+#define WARTHOG_GRID_COMPONENTS_H
+
+// domains/grid_components.h
+//
+// Connected component labels for the traversable tiles of a gridmap.
+// Two tiles with different labels have no path between them, which lets
+// a caller reject such queries without searching.
+//
+// Diagonal moves on a gridmap require both adjacent cardinal tiles to be
+// traversable, so 8-connected components are the same as 4-connected
+// ones and a cardinal flood fill is enough.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "gridmap.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class grid_components
+{
+    public:
+        // label every tile of @param map; the map is only read during
+        // construction
+        grid_components(warthog::gridmap* map);
+        ~grid_components() { }
+
+        // label of the tile with unpadded id @param id;
+        // obstacles have the label warthog::INF32
+        inline uint32_t
+        get_label(uint32_t id) { return labels_.at(id); }
+
+        // true if there is a path between the tiles with unpadded ids
+        // @param a and @param b
+        inline bool
+        connected(uint32_t a, uint32_t b)
+        {
+            return labels_.at(a) != warthog::INF32 &&
+                labels_.at(a) == labels_.at(b);
+        }
+
+        inline uint32_t
+        num_components() { return num_components_; }
+
+        inline size_t
+        mem()
+        { return sizeof(*this) + sizeof(uint32_t) * labels_.capacity(); }
+
+    private:
+        std::vector<uint32_t> labels_;
+        uint32_t num_components_;
+};
+
+}
+
+#endif
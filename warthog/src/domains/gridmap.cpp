@@ -1,15 +1,56 @@
 #include "gridmap.h"
+#include "gridmap_pager.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <fstream>
+
+#include <unistd.h>
+
+namespace
+{
+
+const char GRIDMAP_MAGIC[8] = {'W', 'G', 'R', 'I', 'D', 'M', 'A', 'P'};
+const uint32_t GRIDMAP_VERSION = 1;
+
+warthog::gridmap_binary_header
+binary_header(uint32_t height, uint32_t width, uint32_t dbheight,
+		uint32_t dbwidth, uint32_t num_traversable)
+{
+	warthog::gridmap_binary_header hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic_, GRIDMAP_MAGIC, sizeof(hdr.magic_));
+	hdr.version_ = GRIDMAP_VERSION;
+	hdr.height_ = height;
+	hdr.width_ = width;
+	hdr.dbheight_ = dbheight;
+	hdr.dbwidth_ = dbwidth;
+	hdr.num_traversable_ = num_traversable;
+	return hdr;
+}
+
+}
 
 warthog::gridmap::gridmap(unsigned int h, unsigned int w)
-	: header_(h, w, "octile")
+	: header_(h, w, "octile"), pager_(0)
 {	
+	filename_[0] = '\0';
+	num_traversable_ = 0;
+	this->init_db();
+}
+
+warthog::gridmap::gridmap(unsigned int h, unsigned int w,
+		warthog::gridmap_pager* pager)
+	: header_(h, w, "octile"), pager_(pager)
+{
+	filename_[0] = '\0';
+	num_traversable_ = 0;
 	this->init_db();
 }
 
 warthog::gridmap::gridmap(const char* filename)
+	: pager_(0)
 {
 	strcpy(filename_, filename);
 	warthog::gm_parser parser(filename);
@@ -48,36 +89,389 @@ warthog::gridmap::init_db()
 	// fetching the neighbours of a node. 
 	this->padded_rows_before_first_row_ = 3;
 	this->padded_rows_after_last_row_ = 3;
-	this->padded_height_ = this->header_.height_ + 
-		padded_rows_after_last_row_ +
-		padded_rows_before_first_row_;
-
-	// calculate # of extra/redundant padding bits required,
-	// per row, to align map width with dbword size
-	this->padded_width_  = this->header_.width_ + 1;
-    if((padded_width_ % 32) != 0) 
-    {
-        padded_width_ = (this->header_.width_ / 32 + 1) * 32;
-    }
+	padded_dims(header_.height_, header_.width_, dbheight_, dbwidth_);
+	this->padded_height_ = dbheight_;
+	this->padded_width_ = dbwidth_ << warthog::LOG2_DBWORD_BITS;
 	this->padding_per_row_ = this->padded_width_ - this->header_.width_;
+	this->db_size_ = (warthog::grid_id_t)this->dbwidth_ * this->dbheight_;
 
-    this->dbheight_ = padded_height_;
-    this->dbwidth_ = padded_width_ >> warthog::LOG2_DBWORD_BITS;
-	this->db_size_ = this->dbwidth_ * this->dbheight_;
-
-	// create a one dimensional dbword array to store the grid
-	this->db_ = new warthog::dbword[db_size_];
-	for(unsigned int i=0; i < db_size_; i++)
+	// create a one dimensional dbword array to store the grid, unless
+	// the rows are mapped from a file
+	if(pager_)
 	{
-		db_[i] = 0;
+		this->db_ = (warthog::dbword*)
+			(pager_->data() + sizeof(warthog::gridmap_binary_header));
+	}
+	else
+	{
+		this->db_ = new warthog::dbword[db_size_];
+		for(warthog::grid_id_t i=0; i < db_size_; i++)
+		{
+			db_[i] = 0;
+		}
 	}
 
 	max_id_ = db_size_-1;
+
+	summary_ = 0;
+	summary_width_ = 0;
+	strips_per_row_ = padded_width_ >> 6;
+	forced_east_ = forced_west_ = 0;
+	diag_[0] = diag_[1] = 0;
+	diag_width_ = (padded_width_ + 63) / 64 + 2;
+	diag_height_ = padded_width_ + padded_height_ + 1;
+}
+
+void
+warthog::gridmap::padded_dims(uint32_t height, uint32_t width,
+		uint32_t& dbheight, uint32_t& dbwidth)
+{
+	// 3 padded rows before the first row and after the last (cf.
+	// init_db), and enough padding bits per row to align its width with
+	// dbword size; at least one
+	uint32_t padded_width = width + 1;
+	if((padded_width % 32) != 0)
+	{
+		padded_width = (width / 32 + 1) * 32;
+	}
+	dbheight = height + 6;
+	dbwidth = padded_width >> warthog::LOG2_DBWORD_BITS;
 }
 
 warthog::gridmap::~gridmap()
 {
-	delete [] db_;
+	if(pager_) { delete pager_; }
+	else { delete [] db_; }
+	delete [] summary_;
+	delete [] forced_east_;
+	delete [] forced_west_;
+	delete [] diag_[0];
+	delete [] diag_[1];
+}
+
+void
+warthog::gridmap::enable_summary()
+{
+	if(!summary_)
+	{
+		summary_width_ = (strips_per_row_ + 63) / 64;
+		summary_ = new uint64_t[summary_width_ * padded_height_];
+		forced_east_ = new uint32_t[padded_height_];
+		forced_west_ = new uint32_t[padded_height_];
+	}
+	memset(summary_, 0, sizeof(uint64_t) * summary_width_ * padded_height_);
+
+	// the padded rows above and below the map stay empty
+	for(uint32_t y = padded_rows_before_first_row_;
+			y < padded_height_ - padded_rows_after_last_row_; y++)
+	{
+		for(uint32_t strip = 0; strip < strips_per_row_; strip++)
+		{
+			summarise(y, strip);
+		}
+	}
+	for(uint32_t y = 0; y < padded_height_; y++) { bound_forced(y); }
+}
+
+void
+warthog::gridmap::update_summary(warthog::grid_id_t grid_id_p)
+{
+	uint32_t x, y;
+	to_padded_xy(grid_id_p, x, y);
+
+	// the tile is in the strips about x (counting the tiles either side
+	// of each) of its own row and the rows above and below
+	uint32_t first = x == 0 ? 0 : (x - 1) >> 6;
+	uint32_t last = (x + 1) >> 6;
+	uint32_t y0 = std::max(y, padded_rows_before_first_row_ + 1) - 1;
+	uint32_t y1 = std::min(y + 1,
+			padded_height_ - padded_rows_after_last_row_ - 1);
+	for(uint32_t sy = y0; sy <= y1; sy++)
+	{
+		for(uint32_t strip = first; strip <= last &&
+				strip < strips_per_row_; strip++)
+		{
+			summarise(sy, strip);
+		}
+	}
+
+	// it is a neighbour of the tiles in the rows above and below
+	if(y > 0) { bound_forced(y - 1); }
+	if(y + 1 < padded_height_) { bound_forced(y + 1); }
+
+	if(diag_[0]) { set_diagonal_label(x, y, get_label(grid_id_p)); }
+}
+
+void
+warthog::gridmap::bound_forced(uint32_t y)
+{
+	forced_east_[y] = 0;
+	forced_west_[y] = UINT32_MAX;
+	if(y == 0 || y + 1 >= padded_height_) { return; }
+
+	// forced neighbours of a jump east are traversable tiles, in the rows
+	// above and below, just after an obstacle; those of a jump west are
+	// just before one. cf. online_jump_point_locator2::__jump_east
+	uint32_t words = dbwidth_ >> 2;
+	for(uint32_t row = y - 1; row <= y + 1; row += 2)
+	{
+		const warthog::dbword* tiles = db_ + row * dbwidth_;
+		uint32_t prev = 0;
+		for(uint32_t i = 0; i < words; i++)
+		{
+			uint32_t w, next = 0;
+			memcpy(&w, tiles + (i << 2), sizeof(w));
+			if(i + 1 < words) { memcpy(&next, tiles + ((i + 1) << 2), 1); }
+
+			uint32_t east = w & ~((w << 1) | (prev >> 31));
+			uint32_t west = w & ~((w >> 1) | (next << 31));
+			if(east)
+			{
+				forced_east_[y] = std::max(forced_east_[y],
+						(i << 5) + 31 - (uint32_t)__builtin_clz(east));
+			}
+			if(west)
+			{
+				forced_west_[y] = std::min(forced_west_[y],
+						(i << 5) + (uint32_t)__builtin_ctz(west));
+			}
+			prev = w;
+		}
+	}
+}
+
+void
+warthog::gridmap::enable_diagonals()
+{
+	if(!summary_) { enable_summary(); }
+	for(int i = 0; i < 2; i++)
+	{
+		if(!diag_[i]) { diag_[i] = new uint64_t[diag_width_ * diag_height_]; }
+		memset(diag_[i], 0, sizeof(uint64_t) * diag_width_ * diag_height_);
+	}
+	for(warthog::grid_id_t id = 0; id < padded_mapsize(); id++)
+	{
+		if(!get_label(id)) { continue; }
+		uint32_t x, y;
+		to_padded_xy(id, x, y);
+		set_diagonal_label(x, y, true);
+	}
+}
+
+void
+warthog::gridmap::set_diagonal_label(uint32_t x, uint32_t y, bool label)
+{
+	uint32_t col = x + 64;
+	uint64_t bit = 1ull << (col & 63);
+	uint64_t& anti = diag_[0][(x + y + 1) * diag_width_ + (col >> 6)];
+	uint64_t& diag =
+		diag_[1][(x + padded_height_ - y) * diag_width_ + (col >> 6)];
+	anti = label ? (anti | bit) : (anti & ~bit);
+	diag = label ? (diag | bit) : (diag & ~bit);
+}
+
+namespace
+{
+
+// 64 tiles of a row of a sheared map, from column c up
+inline uint64_t
+tiles_from(const uint64_t* row, uint32_t c)
+{
+	uint64_t lo = row[c >> 6] >> (c & 63);
+	return (c & 63) ? lo | (row[(c >> 6) + 1] << (64 - (c & 63))) : lo;
+}
+
+}
+
+uint32_t
+warthog::gridmap::diagonal_run(warthog::grid_id_t grid_id_p, int32_t dx,
+		int32_t dy)
+{
+	uint32_t x, y;
+	to_padded_xy(grid_id_p, x, y);
+
+	// a step from column t - dx to t needs the next tile on the diagonal
+	// (row m, column t) and the two it cuts past: the tile beside the
+	// current one (row s, column t) and the one above or below it (row p,
+	// column t - dx)
+	const uint64_t* sheared = diag_[dx == dy];
+	uint32_t m = dx == dy ? x + padded_height_ - y : x + y + 1;
+	uint32_t s = dx > 0 ? m + 1 : m - 1;
+	uint32_t p = dx > 0 ? m - 1 : m + 1;
+	const uint64_t* mrow = sheared + m * diag_width_;
+	const uint64_t* srow = sheared + s * diag_width_;
+	const uint64_t* prow = sheared + p * diag_width_;
+
+	// the first word of every row is empty, which ends runs to the west
+	uint32_t run = 0;
+	uint32_t t = x + 64 + dx;
+	while(true)
+	{
+		uint64_t open;
+		if(dx > 0)
+		{
+			open = tiles_from(mrow, t) & tiles_from(srow, t) &
+				tiles_from(prow, t - 1);
+			if(~open) { return run + (uint32_t)__builtin_ctzll(~open); }
+			t += 64;
+		}
+		else
+		{
+			open = tiles_from(mrow, t - 63) & tiles_from(srow, t - 63) &
+				tiles_from(prow, t - 62);
+			if(~open) { return run + (uint32_t)__builtin_clzll(~open); }
+			t -= 64;
+		}
+		run += 64;
+	}
+}
+
+void
+warthog::gridmap::summarise(uint32_t y, uint32_t strip)
+{
+	bool open = true;
+	for(uint32_t sy = y - 1; sy <= y + 1 && open; sy++)
+	{
+		// the strip is 8 whole dbwords; the tiles either side are the high
+		// bit of the word before and the low bit of the word after
+		warthog::dbword* word = db_ + sy * dbwidth_ + (strip << 3);
+		uint64_t tiles;
+		memcpy(&tiles, word, sizeof(tiles));
+		open = tiles == UINT64_MAX && (word[-1] & 0x80) && (word[8] & 1);
+	}
+
+	uint64_t bit = 1ull << (strip & 63);
+	uint64_t& dest = summary_[y * summary_width_ + (strip >> 6)];
+	dest = open ? (dest | bit) : (dest & ~bit);
+}
+
+bool
+warthog::gridmap::save(const char* filename)
+{
+	warthog::gridmap_binary_header hdr = binary_header(header_.height_,
+			header_.width_, dbheight_, dbwidth_, num_traversable_);
+
+	std::ofstream out(filename, std::ios::binary);
+	out.write((const char*)&hdr, sizeof(hdr));
+	out.write((const char*)db_, sizeof(warthog::dbword) * db_size_);
+	return out.good();
+}
+
+warthog::gridmap*
+warthog::gridmap::load(const char* filename)
+{
+	std::ifstream in(filename, std::ios::binary);
+	warthog::gridmap_binary_header hdr;
+	if(!in.read((char*)&hdr, sizeof(hdr)) ||
+	   memcmp(hdr.magic_, GRIDMAP_MAGIC, sizeof(hdr.magic_)) != 0 ||
+	   hdr.version_ != GRIDMAP_VERSION)
+	{
+		return 0;
+	}
+
+	warthog::gridmap* map = new warthog::gridmap(hdr.height_, hdr.width_);
+	if(map->dbheight_ != hdr.dbheight_ || map->dbwidth_ != hdr.dbwidth_ ||
+	   !in.read((char*)map->db_, sizeof(warthog::dbword) * map->db_size_))
+	{
+		delete map;
+		return 0;
+	}
+	strncpy(map->filename_, filename, sizeof(map->filename_) - 1);
+	map->filename_[sizeof(map->filename_) - 1] = '\0';
+	map->num_traversable_ = hdr.num_traversable_;
+	return map;
+}
+
+warthog::gridmap*
+warthog::gridmap::load_paged(const char* filename, size_t resident_bytes,
+		bool writable)
+{
+	std::ifstream in(filename, std::ios::binary);
+	warthog::gridmap_binary_header hdr;
+	if(!in.read((char*)&hdr, sizeof(hdr)) ||
+	   memcmp(hdr.magic_, GRIDMAP_MAGIC, sizeof(hdr.magic_)) != 0 ||
+	   hdr.version_ != GRIDMAP_VERSION)
+	{
+		return 0;
+	}
+	in.close();
+
+	// every padded tile needs an id
+	uint32_t dbheight, dbwidth;
+	padded_dims(hdr.height_, hdr.width_, dbheight, dbwidth);
+	if(dbheight != hdr.dbheight_ || dbwidth != hdr.dbwidth_ ||
+	   (uint64_t)dbheight * dbwidth * warthog::DBWORD_BITS >
+	   warthog::GRID_ID_MAX)
+	{
+		return 0;
+	}
+
+	warthog::gridmap_pager* pager = new warthog::gridmap_pager(filename,
+			sizeof(hdr) + sizeof(warthog::dbword) * (size_t)dbheight * dbwidth,
+			resident_bytes, writable);
+	if(!pager->good())
+	{
+		delete pager;
+		return 0;
+	}
+	warthog::gridmap* map =
+		new warthog::gridmap(hdr.height_, hdr.width_, pager);
+	strncpy(map->filename_, filename, sizeof(map->filename_) - 1);
+	map->filename_[sizeof(map->filename_) - 1] = '\0';
+	map->num_traversable_ = hdr.num_traversable_;
+	return map;
+}
+
+warthog::gridmap*
+warthog::gridmap::create_paged(const char* filename, uint32_t height,
+		uint32_t width, uint32_t num_traversable, size_t resident_bytes)
+{
+	uint32_t dbheight, dbwidth;
+	padded_dims(height, width, dbheight, dbwidth);
+	warthog::gridmap_binary_header hdr = binary_header(
+			height, width, dbheight, dbwidth, num_traversable);
+
+	std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+	out.write((const char*)&hdr, sizeof(hdr));
+	out.close();
+	if(!out.good() || truncate(filename, (off_t)(sizeof(hdr) +
+			sizeof(warthog::dbword) * (size_t)dbheight * dbwidth)) != 0)
+	{
+		return 0;
+	}
+	return load_paged(filename, resident_bytes, true);
+}
+
+bool
+warthog::gridmap::is_binary(const char* filename)
+{
+	std::ifstream in(filename, std::ios::binary);
+	char magic[sizeof(GRIDMAP_MAGIC)];
+	return in.read(magic, sizeof(magic)) &&
+		memcmp(magic, GRIDMAP_MAGIC, sizeof(magic)) == 0;
+}
+
+warthog::gridmap*
+warthog::gridmap::clone()
+{
+	warthog::gridmap* map =
+		new warthog::gridmap(header_.height_, header_.width_);
+	memcpy(map->db_, db_, sizeof(warthog::dbword) * db_size_);
+	memcpy(map->filename_, filename_, sizeof(filename_));
+	map->num_traversable_ = num_traversable_;
+	if(summary_) { map->enable_summary(); }
+	if(diag_[0]) { map->enable_diagonals(); }
+	return map;
+}
+
+size_t
+warthog::gridmap::mem()
+{
+	return sizeof(*this) +
+		(pager_ ? pager_->mem() : sizeof(warthog::dbword) * db_size_) +
+		(summary_ ? sizeof(uint64_t) * summary_width_ * padded_height_ +
+		 sizeof(uint32_t) * 2 * padded_height_ : 0) +
+		(diag_[0] ? sizeof(uint64_t) * 2 * diag_width_ * diag_height_ : 0);
 }
 
 void 
@@ -93,7 +487,7 @@ warthog::gridmap::print(std::ostream& out)
 	{
 		for(unsigned int x=0; x < this->width(); x++)
 		{
-			warthog::dbword c = this->get_label(y*this->width()+x);
+			warthog::dbword c = this->get_label(x, y);
 			out << (c ? '.' : '@');
 		}
 		out << std::endl;
@@ -29,7 +29,25 @@
 namespace warthog
 {
 
-const uint32_t GRID_ID_MAX = (uint32_t)warthog::SN_ID_MAX;
+const grid_id_t GRID_ID_MAX = (grid_id_t)warthog::SN_ID_MAX;
+
+// header of the binary map format written by gridmap::save. it is followed
+// by dbheight_ rows of dbwidth_ words each, exactly as they are laid out in
+// memory, so a row band of the file can be read (or mapped) on its own.
+// the header is padded to 64 bytes to keep the rows aligned.
+struct gridmap_binary_header
+{
+    char magic_[8];             // "WGRIDMAP"
+    uint32_t version_;
+    uint32_t height_;           // unpadded
+    uint32_t width_;
+    uint32_t dbheight_;         // rows of data
+    uint32_t dbwidth_;          // words per row
+    uint32_t num_traversable_;
+    uint32_t reserved_[8];
+};
+
+class gridmap_pager;
 class gridmap
 {
 	public:
@@ -39,8 +57,8 @@ class gridmap
 
 		// here we convert from the coordinate space of 
 		// the original grid to the coordinate space of db_. 
-		inline uint32_t
-		to_padded_id(uint32_t node_id)
+		inline warthog::grid_id_t
+		to_padded_id(warthog::grid_id_t node_id)
 		{
 			return node_id + 
 				// padded rows before the actual map data starts
@@ -51,33 +69,34 @@ class gridmap
 
 		// here we convert from the coordinate space of 
 		// the original grid to the coordinate space of db_. 
-		inline uint32_t
+		inline warthog::grid_id_t
 		to_padded_id(uint32_t x, uint32_t y)
 		{
-			return to_padded_id(y * this->header_width() + x);
+			return to_padded_id(
+					(warthog::grid_id_t)y * this->header_width() + x);
 		}
 
 		inline void
-		to_padded_xy(uint32_t grid_id_p, uint32_t& x, uint32_t& y)
+		to_padded_xy(warthog::grid_id_t grid_id_p, uint32_t& x, uint32_t& y)
 		{
-			y = grid_id_p / padded_width_;
-			x = grid_id_p % padded_width_;
+			y = (uint32_t)(grid_id_p / padded_width_);
+			x = (uint32_t)(grid_id_p % padded_width_);
 		}
 
 		inline void
-		to_unpadded_xy(uint32_t grid_id_p, uint32_t& x, uint32_t& y)
+		to_unpadded_xy(warthog::grid_id_t grid_id_p, uint32_t& x, uint32_t& y)
 		{
 			grid_id_p -= padded_rows_before_first_row_* padded_width_;
-			y = grid_id_p / padded_width_;
-			x = grid_id_p % padded_width_;
+			y = (uint32_t)(grid_id_p / padded_width_);
+			x = (uint32_t)(grid_id_p % padded_width_);
 		}
 
-        inline uint32_t 
-        to_unpadded_id(uint32_t padded_id)
+        inline warthog::grid_id_t
+        to_unpadded_id(warthog::grid_id_t padded_id)
         {
             uint32_t x, y;
             to_unpadded_xy(padded_id, x, y);
-            return y * header_.width_ + x;
+            return (warthog::grid_id_t)y * header_.width_ + x;
         }
 
 		// get the immediately adjacent neighbours of @param node_id
@@ -88,18 +107,18 @@ class gridmap
 		// lowest positions of the byte.
 		// position :0 is the nei in direction NW, :1 is N and :2 is NE 
 		inline void
-		get_neighbours(uint32_t grid_id_p, uint8_t tiles[3])
+		get_neighbours(warthog::grid_id_t grid_id_p, uint8_t tiles[3])
 		{
 			// 1. calculate the dbword offset for the node at index grid_id_p
 			// 2. convert grid_id_p into a dbword index.
-			uint32_t bit_offset = (grid_id_p & warthog::DBWORD_BITS_MASK);
-			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+			uint32_t bit_offset = (uint32_t)(grid_id_p & warthog::DBWORD_BITS_MASK);
+			warthog::grid_id_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
 
 			// compute dbword indexes for tiles immediately above 
 			// and immediately below node_id
-			uint32_t pos1 = dbindex - dbwidth_;
-			uint32_t pos2 = dbindex;
-			uint32_t pos3 = dbindex + dbwidth_;
+			warthog::grid_id_t pos1 = dbindex - dbwidth_;
+			warthog::grid_id_t pos2 = dbindex;
+			warthog::grid_id_t pos3 = dbindex + dbwidth_;
 
 			// read from the byte just before node_id and shift down until the
 			// nei adjacent to node_id is in the lowest position
@@ -112,18 +131,18 @@ class gridmap
 		// 32 tiles long. the middle row begins with tile grid_id_p. the other tiles
 		// are from the row immediately above and immediately below grid_id_p.
 		void
-		get_neighbours_32bit(uint32_t grid_id_p, uint32_t tiles[3])
+		get_neighbours_32bit(warthog::grid_id_t grid_id_p, uint32_t tiles[3])
 		{
 			// 1. calculate the dbword offset for the node at index grid_id_p
 			// 2. convert grid_id_p into a dbword index.
-			uint32_t bit_offset = (grid_id_p & warthog::DBWORD_BITS_MASK);
-			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+			uint32_t bit_offset = (uint32_t)(grid_id_p & warthog::DBWORD_BITS_MASK);
+			warthog::grid_id_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
 
 			// compute dbword indexes for tiles immediately above 
 			// and immediately below node_id
-			uint32_t pos1 = dbindex - dbwidth_;
-			uint32_t pos2 = dbindex;
-			uint32_t pos3 = dbindex + dbwidth_;
+			warthog::grid_id_t pos1 = dbindex - dbwidth_;
+			warthog::grid_id_t pos2 = dbindex;
+			warthog::grid_id_t pos3 = dbindex + dbwidth_;
 
 			// read 32bits of memory; grid_id_p is in the 
 			// lowest bit position of tiles[1]
@@ -136,12 +155,12 @@ class gridmap
 		// upper bit of the return value. this variant is useful when jumping
 		// toward smaller memory addresses (i.e. west instead of east).
 		inline void
-		get_neighbours_upper_32bit(uint32_t grid_id_p, uint32_t tiles[3])
+		get_neighbours_upper_32bit(warthog::grid_id_t grid_id_p, uint32_t tiles[3])
 		{
 			// 1. calculate the dbword offset for the node at index grid_id_p
 			// 2. convert grid_id_p into a dbword index.
-			uint32_t bit_offset = (grid_id_p & warthog::DBWORD_BITS_MASK);
-			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+			uint32_t bit_offset = (uint32_t)(grid_id_p & warthog::DBWORD_BITS_MASK);
+			warthog::grid_id_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
 			
 			// start reading from a prior index. this way everything
 			// up to grid_id_p is cached.
@@ -149,9 +168,9 @@ class gridmap
 
 			// compute dbword indexes for tiles immediately above 
 			// and immediately below node_id
-			uint32_t pos1 = dbindex - dbwidth_;
-			uint32_t pos2 = dbindex;
-			uint32_t pos3 = dbindex + dbwidth_;
+			warthog::grid_id_t pos1 = dbindex - dbwidth_;
+			warthog::grid_id_t pos2 = dbindex;
+			warthog::grid_id_t pos3 = dbindex + dbwidth_;
 
 			// read 32bits of memory; grid_id_p is in the 
 			// highest bit position of tiles[1]
@@ -164,25 +183,25 @@ class gridmap
 		inline bool
 		get_label(uint32_t x, unsigned int y)
 		{
-			return this->get_label(y*padded_width_+x);
+			return this->get_label((warthog::grid_id_t)y*padded_width_+x);
 		}
 
 		inline warthog::dbword 
-		get_label(uint32_t grid_id_p)
+		get_label(warthog::grid_id_t grid_id_p)
 		{
 			// now we can fetch the label
 			uint32_t bitmask = 1;
-			bitmask <<=  (grid_id_p & warthog::DBWORD_BITS_MASK);
-			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+			bitmask <<=  (uint32_t)(grid_id_p & warthog::DBWORD_BITS_MASK);
+			warthog::grid_id_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
 			if(dbindex > max_id_) { return 0; }
 			return (db_[dbindex] & bitmask) != 0;
 		}
 
         // get a pointer to the word that contains the label of node @grid_id_p
         inline warthog::dbword*
-        get_mem_ptr(uint32_t grid_id_p)
+        get_mem_ptr(warthog::grid_id_t grid_id_p)
         {
-			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+			warthog::grid_id_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
 			if(dbindex > max_id_) { return 0; }
 			return &db_[dbindex];
         }
@@ -191,14 +210,15 @@ class gridmap
 		inline void
 		set_label(uint32_t x, unsigned int y, bool label)
 		{
-			this->set_label(y*padded_width_+x, label);
+			this->set_label((warthog::grid_id_t)y*padded_width_+x, label);
 		}
 
 		inline void 
-		set_label(uint32_t grid_id_p, bool label)
+		set_label(warthog::grid_id_t grid_id_p, bool label)
 		{
-			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
-			uint32_t bitmask = 1u << (grid_id_p & warthog::DBWORD_BITS_MASK);
+			warthog::grid_id_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+			uint32_t bitmask =
+				1u << (uint32_t)(grid_id_p & warthog::DBWORD_BITS_MASK);
 
 			if(dbindex > max_id_) { return; }
 
@@ -210,8 +230,95 @@ class gridmap
 			{
 				db_[dbindex] &= (warthog::dbword)~bitmask;
 			}
+			if(summary_) { update_summary(grid_id_p); }
+		}
+
+		// the strip summary is off by default. it has one bit per strip of
+		// 64 tiles (aligned to 64 columns) of every row, set when the
+		// strip and one tile either side of it are traversable in its row
+		// and in the rows above and below. a jump east or west can never
+		// stop inside such a strip, so the JPS2 locators cross runs of them
+		// in one step. once enabled, set_label keeps it up to date
+		void
+		enable_summary();
+
+		inline bool
+		has_summary() { return summary_ != 0; }
+
+		// @return the padded id of the last tile of the run of summarised
+		// strips that starts with tile grid_id_p + 1 (or grid_id_p, if no
+		// run does). grid_id_p must be traversable
+		inline warthog::grid_id_t
+		skip_east(warthog::grid_id_t grid_id_p)
+		{
+			uint32_t y = (uint32_t)(grid_id_p / padded_width_);
+			uint32_t x = (uint32_t)(grid_id_p % padded_width_);
+			uint32_t strip = (x + 1) >> 6;
+			uint64_t* row = summary_ + y * summary_width_;
+
+			uint32_t end = strip;
+			while(end < strips_per_row_)
+			{
+				uint64_t gaps = ~(row[end >> 6] >> (end & 63));
+				uint32_t run = gaps ? (uint32_t)__builtin_ctzll(gaps) : 64;
+				end += run;
+				if(run == 0 || (end & 63)) { break; }
+			}
+			if(end == strip) { return grid_id_p; }
+			return grid_id_p - x + (end << 6) - 1;
+		}
+
+		// as skip_east, but @return the first tile of the run of strips
+		// that ends with tile grid_id_p - 1
+		inline warthog::grid_id_t
+		skip_west(warthog::grid_id_t grid_id_p)
+		{
+			uint32_t y = (uint32_t)(grid_id_p / padded_width_);
+			uint32_t x = (uint32_t)(grid_id_p % padded_width_);
+			uint32_t strip = (x - 1) >> 6;
+			if(x == 0 || strip >= strips_per_row_) { return grid_id_p; }
+			uint64_t* row = summary_ + y * summary_width_;
+
+			// the run is [begin, strip]
+			uint32_t begin = strip + 1;
+			while(begin > 0)
+			{
+				uint32_t last = begin - 1;
+				uint64_t gaps = ~(row[last >> 6] << (63 - (last & 63)));
+				uint32_t run = gaps ? (uint32_t)__builtin_clzll(gaps) : 64;
+				begin -= run;
+				if(run == 0 || (begin & 63)) { break; }
+			}
+			if(begin == strip + 1) { return grid_id_p; }
+			return grid_id_p - x + (begin << 6);
 		}
 
+		// the summary also bounds, for each row, where a jump along it can
+		// stop at a forced neighbour: a jump east from padded column x of
+		// row y can only do so if x < last_forced_east(y), and a jump west
+		// only if x > first_forced_west(y)
+		inline uint32_t
+		last_forced_east(uint32_t y) { return forced_east_[y]; }
+
+		inline uint32_t
+		first_forced_west(uint32_t y) { return forced_west_[y]; }
+
+		// two more copies of the map, sheared so that each diagonal (and
+		// each anti-diagonal) is a contiguous row of bits. off by default;
+		// enabling them enables the summary too. set_label keeps them up to
+		// date
+		void
+		enable_diagonals();
+
+		inline bool
+		has_diagonals() { return diag_[0] != 0; }
+
+		// @return how many steps can be taken from grid_id_p in the
+		// diagonal direction (@param dx, @param dy), each +1 or -1, before
+		// reaching an obstacle or cutting a corner. needs the diagonals
+		uint32_t
+		diagonal_run(warthog::grid_id_t grid_id_p, int32_t dx, int32_t dy);
+
     inline bool
     is_corner(uint32_t px, uint64_t py) {
       // px: padded x, py: padded y
@@ -243,10 +350,10 @@ class gridmap
       return true;
       else return false;
     }
-		inline uint32_t
+		inline warthog::grid_id_t
 		padded_mapsize()
 		{
-			return padded_width_ * padded_height_;
+			return (warthog::grid_id_t)padded_width_ * padded_height_;
 		}
 
 		inline uint32_t 
@@ -289,13 +396,56 @@ class gridmap
         inline void
         invert()
         {
-            for(unsigned int i=0; i < db_size_; i++)
+            for(warthog::grid_id_t i=0; i < db_size_; i++)
             {
                 db_[i] = (warthog::dbword)~db_[i];
             }
+            if(summary_) { enable_summary(); }
+            if(diag_[0]) { enable_diagonals(); }
         }
 
 
+		// write the map in the binary format described by
+		// warthog::gridmap_binary_header. @return false on error
+		bool
+		save(const char* filename);
+
+		// @return a new map read from the binary file @param filename, or 0
+		// if the file cannot be read or is not a binary map
+		static warthog::gridmap*
+		load(const char* filename);
+
+		// @return true if @param filename starts with the binary map magic
+		static bool
+		is_binary(const char* filename);
+
+		// @return a map backed by the binary file @param filename, which
+		// is mapped into memory rather than read, with at most
+		// @param resident_bytes of it resident (see warthog::gridmap_pager),
+		// or 0 if the file cannot be mapped or the map has more padded
+		// tiles than warthog::grid_id_t can number (see constants.h). the
+		// map can only be changed (set_label, invert) if @param writable,
+		// and changes are written to the file
+		static warthog::gridmap*
+		load_paged(const char* filename, size_t resident_bytes,
+				bool writable = false);
+
+		// create the binary file @param filename for a map of @param height
+		// by @param width obstacles, which records @param num_traversable
+		// traversable tiles, and @return it loaded writable as by
+		// load_paged, or 0 on error. the file is sparse until written
+		static warthog::gridmap*
+		create_paged(const char* filename, uint32_t height, uint32_t width,
+				uint32_t num_traversable, size_t resident_bytes);
+
+		// the pager of a map from load_paged; 0 if the map is in memory
+		inline warthog::gridmap_pager*
+		get_pager() { return pager_; }
+
+		// @return a new map with the same dimensions and labels
+		warthog::gridmap*
+		clone();
+
 		void 
 		print(std::ostream&);
 		
@@ -303,11 +453,7 @@ class gridmap
 		printdb(std::ostream& out);
 
 		size_t 
-		mem()
-		{
-			return sizeof(*this) +
-			sizeof(warthog::dbword) * db_size_;
-		}
+		mem();
 
 
 	private:
@@ -317,19 +463,59 @@ class gridmap
 
 		uint32_t dbwidth_;
 		uint32_t dbheight_;
-		uint32_t db_size_;
+		warthog::grid_id_t db_size_;
 		uint32_t padded_width_;
 		uint32_t padded_height_;
 		uint32_t padding_per_row_;
 		uint32_t padding_column_above_;
 		uint32_t padded_rows_before_first_row_;
 		uint32_t padded_rows_after_last_row_;
-		uint32_t max_id_;
+		warthog::grid_id_t max_id_;
         uint32_t num_traversable_;
 
+		// see enable_summary; summary_width_ words of bits per row
+		uint64_t* summary_;
+		uint32_t summary_width_;
+		uint32_t strips_per_row_;
+		uint32_t* forced_east_;
+		uint32_t* forced_west_;
+
+		// see enable_diagonals. tile (x, y) is at row x + y + 1 of diag_[0]
+		// and row x - y + padded_height_ of diag_[1], in column x + 64 (the
+		// first word of each row is all obstacles); diag_width_ words per row
+		uint64_t* diag_[2];
+		uint32_t diag_width_;
+		uint32_t diag_height_;
+
+		// see load_paged. db_ points into its mapping
+		warthog::gridmap_pager* pager_;
+
+		gridmap(uint32_t height, uint32_t width,
+				warthog::gridmap_pager* pager);
+
+		// the rows of data (@param dbheight) and words per row
+		// (@param dbwidth) of a map of @param height by @param width tiles
+		static void
+		padded_dims(uint32_t height, uint32_t width, uint32_t& dbheight,
+				uint32_t& dbwidth);
+
 		gridmap(const warthog::gridmap& other) {}
 		gridmap& operator=(const warthog::gridmap& other) { return *this; }
 		void init_db();
+
+		void
+		update_summary(warthog::grid_id_t grid_id_p);
+
+		// set the summary bit of strip @param strip in padded row @param y
+		void
+		summarise(uint32_t y, uint32_t strip);
+
+		// set the forced neighbour bounds of padded row @param y
+		void
+		bound_forced(uint32_t y);
+
+		void
+		set_diagonal_label(uint32_t x, uint32_t y, bool label);
 };
 
 }
@@ -0,0 +1,250 @@
+#include "gridmap_pager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+namespace
+{
+
+const uint32_t NO_BAND = UINT32_MAX;
+
+// the pagers a fault may belong to; slots are claimed under the lock
+const uint32_t MAX_PAGERS = 64;
+warthog::gridmap_pager* pagers[MAX_PAGERS];
+std::atomic_flag lock = ATOMIC_FLAG_INIT;
+
+struct sigaction previous;
+std::once_flag installed;
+
+inline void
+acquire() { while(lock.test_and_set(std::memory_order_acquire)) { } }
+
+inline void
+release() { lock.clear(std::memory_order_release); }
+
+// true if the fault described by @param context was a write. only x86-64
+// reports it; elsewhere every fault is taken to be a read
+inline bool
+is_write(void* context)
+{
+#if defined(__x86_64__) && defined(REG_ERR)
+    // bit 1 of the page fault error code
+    return (((ucontext_t*)context)->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+#else
+    (void)context;
+    return false;
+#endif
+}
+
+void
+on_segv(int, siginfo_t* info, void* context)
+{
+    if(warthog::gridmap_pager::handle_fault(info->si_addr, is_write(context)))
+    {
+        return;
+    }
+
+    // not a band: the faulting access runs again under the previous
+    // handler, which by default ends the process
+    sigaction(SIGSEGV, &previous, 0);
+}
+
+void
+install_handler()
+{
+    struct sigaction action;
+    action.sa_sigaction = on_segv;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_SIGINFO;
+    sigaction(SIGSEGV, &action, &previous);
+}
+
+}
+
+const size_t warthog::gridmap_pager::BAND_BYTES;
+const uint32_t warthog::gridmap_pager::MIN_BANDS;
+
+warthog::gridmap_pager::gridmap_pager(const char* filename, size_t length,
+        size_t resident_bytes, bool writable)
+    : base_(0), length_(0), fd_(-1), prot_(PROT_READ), writable_(writable),
+      num_bands_(0), max_bands_(0), max_active_(0),
+      faults_(0), reactivations_(0), evictions_(0)
+{
+    active_ = inactive_ = {NO_BAND, NO_BAND, 0};
+    fd_ = open(filename, writable ? O_RDWR : O_RDONLY);
+    struct stat st;
+    if(fd_ < 0 || fstat(fd_, &st) != 0 || (size_t)st.st_size < length)
+    {
+        return;
+    }
+
+    // the mapping is followed by a readable page of zeros, as reads of
+    // the last row may run a few bytes past it
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    length_ = (length + page - 1) / page * page;
+    void* reserve = mmap(0, length_ + page, PROT_READ,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(reserve == MAP_FAILED) { return; }
+    if(mmap(reserve, length_, PROT_NONE,
+            (writable ? MAP_SHARED : MAP_PRIVATE) | MAP_FIXED, fd_, 0)
+            == MAP_FAILED)
+    {
+        munmap(reserve, length_ + page);
+        return;
+    }
+
+    prot_ = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    num_bands_ = (uint32_t)((length_ + BAND_BYTES - 1) / BAND_BYTES);
+    max_bands_ = std::min(num_bands_,
+            std::max(MIN_BANDS, (uint32_t)(resident_bytes / BAND_BYTES)));
+    // with room for every band nothing is evicted, and bands need not
+    // pass through the inactive list
+    max_active_ = max_bands_ == num_bands_ ?
+        max_bands_ : max_bands_ - max_bands_ / 4;
+    state_.assign(num_bands_, UNMAPPED);
+    prev_.assign(num_bands_, NO_BAND);
+    next_.assign(num_bands_, NO_BAND);
+
+    std::call_once(installed, install_handler);
+    acquire();
+    for(uint32_t i = 0; i < MAX_PAGERS; i++)
+    {
+        if(!pagers[i])
+        {
+            pagers[i] = this;
+            base_ = (char*)reserve;
+            break;
+        }
+    }
+    release();
+    if(!base_) { munmap(reserve, length_ + page); }
+}
+
+warthog::gridmap_pager::~gridmap_pager()
+{
+    if(base_)
+    {
+        acquire();
+        for(uint32_t i = 0; i < MAX_PAGERS; i++)
+        {
+            if(pagers[i] == this) { pagers[i] = 0; }
+        }
+        release();
+        munmap(base_, length_ + (size_t)sysconf(_SC_PAGESIZE));
+    }
+    if(fd_ >= 0) { close(fd_); }
+}
+
+bool
+warthog::gridmap_pager::handle_fault(void* addr, bool write)
+{
+    bool handled = false;
+    acquire();
+    for(uint32_t i = 0; i < MAX_PAGERS; i++)
+    {
+        warthog::gridmap_pager* p = pagers[i];
+        if(p && (char*)addr >= p->base_ && (char*)addr < p->base_ + p->length_)
+        {
+            handled = p->fault(
+                    (uint32_t)(((char*)addr - p->base_) / BAND_BYTES), write);
+            break;
+        }
+    }
+    release();
+    return handled;
+}
+
+bool
+warthog::gridmap_pager::fault(uint32_t b, bool write)
+{
+    // another thread faulted on the band too and mapped it in while this
+    // one waited for the lock: the access can be retried. only a write to
+    // a read-only map is a real fault
+    if(state_[b] == ACTIVE) { return !write || writable_; }
+
+    if(state_[b] == INACTIVE)
+    {
+        unlink(inactive_, b);
+        reactivations_++;
+    }
+    else
+    {
+        if(resident_bands() >= max_bands_)
+        {
+            if(inactive_.size_ == 0)
+            {
+                uint32_t oldest = pop_front(active_);
+                state_[oldest] = INACTIVE;
+                push_back(inactive_, oldest);
+            }
+            uint32_t victim = pop_front(inactive_);
+            size_t offset = (size_t)victim * BAND_BYTES;
+            size_t len = std::min(BAND_BYTES, length_ - offset);
+            protect(victim, PROT_NONE);
+            // the pages leave the process; the page cache keeps them
+            // until the kernel needs the memory, so a refault is cheap
+            madvise(base_ + offset, len, MADV_DONTNEED);
+            state_[victim] = UNMAPPED;
+            evictions_++;
+        }
+        faults_++;
+    }
+
+    protect(b, prot_);
+    state_[b] = ACTIVE;
+    push_back(active_, b);
+    while(active_.size_ > max_active_)
+    {
+        uint32_t oldest = pop_front(active_);
+        protect(oldest, PROT_NONE);
+        state_[oldest] = INACTIVE;
+        push_back(inactive_, oldest);
+    }
+    return true;
+}
+
+void
+warthog::gridmap_pager::push_back(band_list& list, uint32_t b)
+{
+    prev_[b] = list.tail_;
+    next_[b] = NO_BAND;
+    if(list.tail_ != NO_BAND) { next_[list.tail_] = b; }
+    else { list.head_ = b; }
+    list.tail_ = b;
+    list.size_++;
+}
+
+uint32_t
+warthog::gridmap_pager::pop_front(band_list& list)
+{
+    uint32_t b = list.head_;
+    unlink(list, b);
+    return b;
+}
+
+void
+warthog::gridmap_pager::unlink(band_list& list, uint32_t b)
+{
+    if(prev_[b] != NO_BAND) { next_[prev_[b]] = next_[b]; }
+    else { list.head_ = next_[b]; }
+    if(next_[b] != NO_BAND) { prev_[next_[b]] = prev_[b]; }
+    else { list.tail_ = prev_[b]; }
+    prev_[b] = next_[b] = NO_BAND;
+    list.size_--;
+}
+
+void
+warthog::gridmap_pager::protect(uint32_t b, int prot)
+{
+    size_t offset = (size_t)b * BAND_BYTES;
+    mprotect(base_ + offset, std::min(BAND_BYTES, length_ - offset), prot);
+}
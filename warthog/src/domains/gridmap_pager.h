@@ -0,0 +1,154 @@
+#ifndef WARTHOG_GRIDMAP_PAGER_H
+#define WARTHOG_GRIDMAP_PAGER_H
+
+// domains/gridmap_pager.h
+//
+// Keeps a file mapped into memory with at most a fixed number of bytes
+// resident, so that a gridmap larger than RAM can be read as if it were
+// in memory (see gridmap::load_paged).
+//
+// The mapping is split into bands of BAND_BYTES (a band holds a run of
+// whole rows, and a part row at either end). Bands are inaccessible until
+// touched: the first read of one faults, and a SIGSEGV handler maps it in.
+// Code that reads the map, such as the JPS scanning kernels, needs no
+// change and runs at full speed on resident bands.
+//
+// Eviction approximates LRU with two lists, as operating systems do for
+// page frames: bands are faulted into an active list; when it is full its
+// oldest band is made inaccessible again, but kept, on an inactive list. A
+// band touched while inactive moves back to the active list without
+// reading the file; a band reaching the end of the inactive list is
+// dropped. The handler allocates nothing and serialises faults from all
+// threads with a spin lock; a thread that faulted on a band that another
+// thread mapped in meanwhile just retries its access. Writes to a
+// read-only map are told apart on x86-64 only; elsewhere they are
+// retried forever rather than ending the process.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace warthog
+{
+
+class gridmap_pager
+{
+    public:
+        // a band is this many bytes; a multiple of the page size
+        static const size_t BAND_BYTES = 1 << 18;
+
+        // the fewest bands kept resident, whatever the budget. a read can
+        // span two bands, and each must stay mapped while the other faults
+        static const uint32_t MIN_BANDS = 4;
+
+        // map @param length bytes of @param filename, from the start of
+        // the file, with at most @param resident_bytes resident. the
+        // mapping is private and read-only unless @param writable, in
+        // which case writes go to the file. check ::good before use
+        gridmap_pager(const char* filename, size_t length,
+                size_t resident_bytes, bool writable);
+        ~gridmap_pager();
+
+        // false if the file could not be opened or mapped, or is shorter
+        // than the length asked for
+        inline bool
+        good() { return base_ != 0; }
+
+        // the start of the mapping
+        inline char*
+        data() { return base_; }
+
+        inline bool
+        writable() { return writable_; }
+
+        inline uint32_t
+        num_bands() { return num_bands_; }
+
+        inline uint32_t
+        max_resident_bands() { return max_bands_; }
+
+        inline uint32_t
+        resident_bands() { return active_.size_ + inactive_.size_; }
+
+        // bands read from the file, bands moved back from the inactive
+        // list, and bands dropped
+        inline uint64_t
+        faults() { return faults_; }
+
+        inline uint64_t
+        reactivations() { return reactivations_; }
+
+        inline uint64_t
+        evictions() { return evictions_; }
+
+        // the most memory the map can hold resident
+        inline size_t
+        mem()
+        {
+            return sizeof(*this) + BAND_BYTES * max_bands_ +
+                (sizeof(uint8_t) + 2 * sizeof(uint32_t)) * num_bands_;
+        }
+
+        // handles a fault at @param addr if it is in a band of a pager
+        // that is not resident, or that another thread has just made
+        // resident. @param write is true if the access was a write.
+        // @return false if no pager handles it
+        static bool
+        handle_fault(void* addr, bool write);
+
+    private:
+        enum band_state : uint8_t { UNMAPPED, ACTIVE, INACTIVE };
+
+        // a list of bands threaded through prev_ and next_
+        struct band_list
+        {
+            uint32_t head_, tail_, size_;
+        };
+
+        char* base_;
+        size_t length_;
+        int fd_;
+        int prot_;
+        bool writable_;
+        uint32_t num_bands_;
+        uint32_t max_bands_;
+        uint32_t max_active_;
+
+        std::vector<uint8_t> state_;
+        std::vector<uint32_t> prev_;
+        std::vector<uint32_t> next_;
+        band_list active_;
+        band_list inactive_;
+
+        uint64_t faults_;
+        uint64_t reactivations_;
+        uint64_t evictions_;
+
+        gridmap_pager(const gridmap_pager&) = delete;
+        gridmap_pager& operator=(const gridmap_pager&) = delete;
+
+        // make band @param b resident. @return false if the access, a
+        // write if @param write, cannot succeed on the band as it is
+        bool
+        fault(uint32_t b, bool write);
+
+        void
+        push_back(band_list& list, uint32_t b);
+
+        uint32_t
+        pop_front(band_list& list);
+
+        void
+        unlink(band_list& list, uint32_t b);
+
+        void
+        protect(uint32_t b, int prot);
+};
+
+}
+
+#endif
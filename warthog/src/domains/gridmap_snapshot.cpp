@@ -0,0 +1,63 @@
+#include "gridmap_snapshot.h"
+#include "jps.h"
+
+warthog::gridmap_snapshot::gridmap_snapshot(warthog::gridmap* map,
+        warthog::gridmap* rmap, warthog::grid_components* components,
+        uint64_t version)
+    : map_(map), rmap_(rmap), components_(components), version_(version)
+{ }
+
+warthog::gridmap_snapshot::~gridmap_snapshot()
+{
+    delete components_;
+    delete rmap_;
+    delete map_;
+}
+
+size_t
+warthog::gridmap_snapshot::mem() const
+{
+    size_t bytes = sizeof(*this) + map_->mem() + rmap_->mem();
+    if(components_) { bytes += components_->mem(); }
+    return bytes;
+}
+
+warthog::versioned_gridmap::versioned_gridmap(warthog::gridmap* map,
+        bool components)
+    : components_(components)
+{
+    current_.reset(new warthog::gridmap_snapshot(map,
+                warthog::jps::create_rmap(map),
+                components ? new warthog::grid_components(map) : 0, 0));
+}
+
+warthog::versioned_gridmap::~versioned_gridmap()
+{ }
+
+uint64_t
+warthog::versioned_gridmap::update(
+        const std::vector<warthog::cell_update>& changes)
+{
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    std::shared_ptr<const warthog::gridmap_snapshot> old = current();
+
+    warthog::gridmap* map = old->get_map()->clone();
+    warthog::gridmap* rmap = old->get_rmap()->clone();
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    for(const warthog::cell_update& c : changes)
+    {
+        if(c.x_ >= w || c.y_ >= h) { continue; }
+        map->set_label(map->to_padded_id(c.x_, c.y_), c.traversable_);
+        // as in warthog::jps::create_rmap
+        rmap->set_label(rmap->to_padded_id(h - c.y_ - 1, c.x_),
+                c.traversable_);
+    }
+
+    std::shared_ptr<const warthog::gridmap_snapshot> next(
+            new warthog::gridmap_snapshot(map, rmap,
+                components_ ? new warthog::grid_components(map) : 0,
+                old->get_version() + 1));
+    std::atomic_store(&current_, next);
+    return next->get_version();
+}
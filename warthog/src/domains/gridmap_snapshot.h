@@ -0,0 +1,110 @@
+#ifndef WARTHOG_GRIDMAP_SNAPSHOT_H
+#define WARTHOG_GRIDMAP_SNAPSHOT_H
+
+// domains/gridmap_snapshot.h
+//
+// Versioned gridmaps for maps that change while they are being queried.
+//
+// A gridmap_snapshot is one immutable version of a map: the gridmap, its
+// rotated copy (used by the online jump point locators; see
+// warthog::jps::create_rmap) and, optionally, connected component labels.
+// A versioned_gridmap publishes the current snapshot RCU style: readers
+// take a std::shared_ptr to it (a lock-free atomic load) and search on
+// it for as long as they like; a writer copies the current version,
+// applies its changes to the copy and swaps the pointer atomically.
+// Searches already running keep the version they started with, and each
+// old version is freed when its last reader lets go.
+//
+// Updates copy the whole map and rotated map (one memcpy each) rather
+// than individual blocks, which keeps the hot scan loops working on a
+// flat bitset. Batching several cells into one ::update amortises the
+// copy; component labels, if kept, are recomputed per update.
+//
+// Searchers are moved to a new version with grid_searcher::set_map.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "gridmap.h"
+#include "grid_components.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace warthog
+{
+
+class gridmap_snapshot
+{
+    public:
+        // takes ownership of all three; @param components may be null
+        gridmap_snapshot(warthog::gridmap* map, warthog::gridmap* rmap,
+                warthog::grid_components* components, uint64_t version);
+        ~gridmap_snapshot();
+
+        // the maps must not be modified once the snapshot is published
+        inline warthog::gridmap*
+        get_map() const { return map_; }
+
+        inline warthog::gridmap*
+        get_rmap() const { return rmap_; }
+
+        inline warthog::grid_components*
+        get_components() const { return components_; }
+
+        inline uint64_t
+        get_version() const { return version_; }
+
+        size_t
+        mem() const;
+
+    private:
+        warthog::gridmap* map_;
+        warthog::gridmap* rmap_;
+        warthog::grid_components* components_;
+        uint64_t version_;
+
+        gridmap_snapshot(const gridmap_snapshot&);
+        gridmap_snapshot& operator=(const gridmap_snapshot&);
+};
+
+// a change of one tile, in unpadded coordinates
+struct cell_update
+{
+    uint32_t x_;
+    uint32_t y_;
+    bool traversable_;
+};
+
+class versioned_gridmap
+{
+    public:
+        // version 0 is @param map, which is now owned
+        versioned_gridmap(warthog::gridmap* map, bool components = false);
+        ~versioned_gridmap();
+
+        // the current version; never blocks
+        inline std::shared_ptr<const warthog::gridmap_snapshot>
+        current() const { return std::atomic_load(&current_); }
+
+        // publish a new version with @param changes applied. updates are
+        // serialised; readers are never blocked. tiles outside the map are
+        // ignored. @return the new version number
+        uint64_t
+        update(const std::vector<warthog::cell_update>& changes);
+
+        inline uint64_t
+        get_version() const { return current()->get_version(); }
+
+    private:
+        std::shared_ptr<const warthog::gridmap_snapshot> current_;
+        bool components_;
+        std::mutex update_mutex_;
+};
+
+}
+
+#endif
@@ -0,0 +1,292 @@
+#include "hpa_graph.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace
+{
+
+// the grid moves: the tiles that must be traversable (bits of
+// gridmap::get_neighbours) and the offset
+struct grid_move
+{
+    uint32_t tiles_;
+    int32_t dx_, dy_;
+};
+
+const grid_move moves[8] =
+{
+    {514, 0, -1}, {1536, 1, 0}, {131584, 0, 1}, {768, -1, 0},
+    {1542, 1, -1}, {394752, 1, 1}, {197376, -1, 1}, {771, -1, -1}
+};
+
+const warthog::cost_t UNREACHED = std::numeric_limits<double>::max();
+
+}
+
+warthog::hpa_graph::hpa_graph(warthog::gridmap* map, uint32_t cluster_size)
+    : map_(map), size_(cluster_size)
+{
+    clusters_x_ = (map->header_width() + size_ - 1) / size_;
+    clusters_y_ = (map->header_height() + size_ - 1) / size_;
+    cluster_nodes_.resize(num_clusters());
+
+    for(uint32_t c = 0; c < num_clusters(); c++)
+    {
+        add_border(c, false);
+        add_border(c, true);
+    }
+    for(uint32_t c = 0; c < num_clusters(); c++) { link_cluster(c); }
+}
+
+void
+warthog::hpa_graph::add_border(uint32_t c, bool south)
+{
+    uint32_t cx = c % clusters_x_;
+    uint32_t cy = c / clusters_x_;
+    if(south ? cy + 1 >= clusters_y_ : cx + 1 >= clusters_x_) { return; }
+
+    // the tiles on this side of the border run from (x, y) in steps of
+    // (dx, dy); those across it are one step further east or south
+    uint32_t x = south ? cx * size_ : cx * size_ + size_ - 1;
+    uint32_t y = south ? cy * size_ + size_ - 1 : cy * size_;
+    uint32_t len = south ?
+        std::min(size_, map_->header_width() - x) :
+        std::min(size_, map_->header_height() - y);
+    uint32_t step = south ? 1 : map_->width();
+    uint32_t across = south ? map_->width() : 1;
+
+    uint32_t first = map_->to_padded_id(x, y);
+    uint32_t run = 0;
+    for(uint32_t i = 0; i <= len; i++)
+    {
+        uint32_t id = first + i * step;
+        if(i < len && map_->get_label(id) && map_->get_label(id + across))
+        {
+            run++;
+            continue;
+        }
+        if(run == 0) { continue; }
+
+        // the run ends before tile i
+        uint32_t end = first + (i - 1) * step;
+        uint32_t begin = end - (run - 1) * step;
+        if(run < ENTRANCE_SPLIT)
+        {
+            uint32_t mid = begin + (run / 2) * step;
+            add_inter(mid, mid + across);
+            add_inter(mid + across, mid);
+        }
+        else
+        {
+            add_inter(begin, begin + across);
+            add_inter(begin + across, begin);
+            add_inter(end, end + across);
+            add_inter(end + across, end);
+        }
+        run = 0;
+    }
+}
+
+void
+warthog::hpa_graph::remove_border(uint32_t c, bool south)
+{
+    uint32_t other = south ? c + clusters_x_ : c + 1;
+    if(other >= num_clusters()) { return; }
+
+    uint32_t pairs[2][2] = { {c, other}, {other, c} };
+    for(uint32_t p = 0; p < 2; p++)
+    {
+        // copied: nodes left without inter edges are removed as we go
+        std::vector<uint32_t> ids = cluster_nodes_[pairs[p][0]];
+        for(uint32_t id : ids)
+        {
+            uint32_t index = node_of_[id];
+            std::vector<edge>& inter = nodes_[index].inter_;
+            inter.erase(std::remove_if(inter.begin(), inter.end(),
+                [&](const edge& e)
+                { return cluster_of(e.id_) == pairs[p][1]; }),
+                inter.end());
+            if(!inter.empty()) { continue; }
+
+            node_of_.erase(id);
+            std::vector<uint32_t>& cn = cluster_nodes_[pairs[p][0]];
+            cn.erase(std::find(cn.begin(), cn.end(), id));
+            nodes_[index].intra_.clear();
+            free_.push_back(index);
+        }
+    }
+}
+
+void
+warthog::hpa_graph::add_inter(uint32_t id, uint32_t other)
+{
+    uint32_t index = add_node(id);
+    nodes_[index].inter_.push_back({other, 1});
+}
+
+uint32_t
+warthog::hpa_graph::add_node(uint32_t id)
+{
+    std::unordered_map<uint32_t, uint32_t>::iterator it = node_of_.find(id);
+    if(it != node_of_.end()) { return it->second; }
+
+    uint32_t index;
+    if(free_.empty())
+    {
+        index = (uint32_t)nodes_.size();
+        nodes_.push_back(node());
+    }
+    else
+    {
+        index = free_.back();
+        free_.pop_back();
+    }
+    nodes_[index].id_ = id;
+    nodes_[index].cluster_ = cluster_of(id);
+    node_of_[id] = index;
+    cluster_nodes_[nodes_[index].cluster_].push_back(id);
+    return index;
+}
+
+void
+warthog::hpa_graph::link_cluster(uint32_t c)
+{
+    for(uint32_t id : cluster_nodes_[c])
+    {
+        std::vector<edge>& intra = nodes_[node_of_[id]].intra_;
+        intra.clear();
+        connect(id, intra);
+    }
+}
+
+void
+warthog::hpa_graph::connect(uint32_t id, std::vector<edge>& out,
+        uint32_t target)
+{
+    typedef std::pair<warthog::cost_t, uint32_t> entry;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> open;
+
+    uint32_t c = cluster_of(id);
+    uint32_t x0 = (c % clusters_x_) * size_;
+    uint32_t y0 = (c / clusters_x_) * size_;
+    uint32_t x1 = std::min(x0 + size_, map_->header_width()) - 1;
+    uint32_t y1 = std::min(y0 + size_, map_->header_height()) - 1;
+
+    // tiles of the cluster are indexed from its top left corner
+    uint32_t first = map_->to_padded_id(x0, y0);
+    uint32_t w = map_->width();
+    dist_.assign(size_ * size_, UNREACHED);
+    auto local = [&](uint32_t t)
+    { return ((t - first) / w) * size_ + (t - first) % w; };
+
+    dist_[local(id)] = 0;
+    open.push(entry(0, id));
+    while(!open.empty())
+    {
+        entry top = open.top();
+        open.pop();
+        uint32_t t = top.second;
+        if(top.first != dist_[local(t)]) { continue; }
+
+        uint32_t x, y;
+        map_->to_unpadded_xy(t, x, y);
+        uint32_t tiles = 0;
+        map_->get_neighbours(t, (uint8_t*)&tiles);
+        for(const grid_move& m : moves)
+        {
+            if((tiles & m.tiles_) != m.tiles_) { continue; }
+            uint32_t nx = x + m.dx_;
+            uint32_t ny = y + m.dy_;
+            if(nx < x0 || nx > x1 || ny < y0 || ny > y1) { continue; }
+
+            uint32_t n = t + m.dy_ * (int32_t)w + m.dx_;
+            warthog::cost_t alt = top.first +
+                (m.dx_ && m.dy_ ? warthog::DBL_ROOT_TWO : 1);
+            if(alt < dist_[local(n)])
+            {
+                dist_[local(n)] = alt;
+                open.push(entry(alt, n));
+            }
+        }
+    }
+
+    for(uint32_t n : cluster_nodes_[c])
+    {
+        if(n != id && dist_[local(n)] != UNREACHED)
+        {
+            out.push_back({n, dist_[local(n)]});
+        }
+    }
+    if(target != warthog::INF32 && target != id && cluster_of(target) == c &&
+       dist_[local(target)] != UNREACHED)
+    {
+        out.push_back({target, dist_[local(target)]});
+    }
+}
+
+void
+warthog::hpa_graph::update(uint32_t id)
+{
+    uint32_t x, y;
+    map_->to_unpadded_xy(id, x, y);
+    uint32_t c = cluster_of(id);
+    uint32_t cx = c % clusters_x_;
+    uint32_t cy = c / clusters_x_;
+
+    // the borders the tile lies on, each named by the cluster west or
+    // north of it, and the cluster across each
+    struct border { uint32_t c_; bool south_; uint32_t across_; };
+    border borders[4];
+    uint32_t num = 0;
+    if(x % size_ == 0 && cx > 0)
+    { borders[num++] = {c - 1, false, c - 1}; }
+    if(x % size_ == size_ - 1 && cx + 1 < clusters_x_)
+    { borders[num++] = {c, false, c + 1}; }
+    if(y % size_ == 0 && cy > 0)
+    { borders[num++] = {c - clusters_x_, true, c - clusters_x_}; }
+    if(y % size_ == size_ - 1 && cy + 1 < clusters_y_)
+    { borders[num++] = {c, true, c + clusters_x_}; }
+
+    for(uint32_t i = 0; i < num; i++)
+    {
+        remove_border(borders[i].c_, borders[i].south_);
+        add_border(borders[i].c_, borders[i].south_);
+        link_cluster(borders[i].across_);
+    }
+    link_cluster(c);
+}
+
+uint32_t
+warthog::hpa_graph::num_edges()
+{
+    uint32_t num = 0;
+    for(std::unordered_map<uint32_t, uint32_t>::iterator it = node_of_.begin();
+            it != node_of_.end(); it++)
+    {
+        num += (uint32_t)(nodes_[it->second].intra_.size() +
+                nodes_[it->second].inter_.size());
+    }
+    return num;
+}
+
+size_t
+warthog::hpa_graph::mem()
+{
+    size_t retval = sizeof(*this) + sizeof(node) * nodes_.capacity() +
+        sizeof(warthog::cost_t) * dist_.capacity() +
+        sizeof(uint32_t) * free_.capacity() +
+        // a rough size of the hash table's entries and buckets
+        (sizeof(uint32_t) * 2 + sizeof(void*) * 2) * node_of_.size();
+    for(node& n : nodes_)
+    {
+        retval += sizeof(edge) * (n.intra_.capacity() + n.inter_.capacity());
+    }
+    for(std::vector<uint32_t>& cn : cluster_nodes_)
+    {
+        retval += sizeof(std::vector<uint32_t>) + sizeof(uint32_t) * cn.capacity();
+    }
+    return retval;
+}
@@ -0,0 +1,143 @@
+#ifndef WARTHOG_HPA_GRAPH_H
+#define WARTHOG_HPA_GRAPH_H
+
+// domains/hpa_graph.h
+//
+// The abstract graph of hierarchical path-finding A* (Botea, Mueller and
+// Schaeffer, 2004). The gridmap is split into square clusters, as
+// warthog::blockmap splits it into blocks. Along each border between
+// two clusters, every maximal run of tiles that can cross it gets
+// entrances: one pair of tiles in the middle of a short run, or one at
+// each end of a run of at least ENTRANCE_SPLIT tiles. The two tiles of a
+// pair are nodes, joined by an inter edge of cost 1. The nodes of each
+// cluster are joined by intra edges, whose costs are distances inside the
+// cluster, from one Dijkstra search per node.
+//
+// Nodes are identified by their padded tile ids. A tile that changes is
+// handled locally: only the borders it lies on are searched for entrances
+// again, and only the clusters next to them get new intra edges.
+//
+// Paths through the graph cross clusters only at entrances, so they are
+// a little longer than optimal.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "constants.h"
+#include "gridmap.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace warthog
+{
+
+class hpa_graph
+{
+    public:
+        // runs of at least this many tiles get an entrance at each end
+        static const uint32_t ENTRANCE_SPLIT = 6;
+
+        struct edge
+        {
+            uint32_t id_;               // padded tile id
+            warthog::cost_t cost_;
+        };
+
+        // build the graph of @param map with clusters of
+        // @param cluster_size tiles a side. the map is not owned; it is
+        // read by ::connect and ::update and must outlive the graph
+        hpa_graph(warthog::gridmap* map, uint32_t cluster_size);
+        ~hpa_graph() { }
+
+        // true if the tile with padded id @param id is a node
+        inline bool
+        is_node(uint32_t id) { return node_of_.find(id) != node_of_.end(); }
+
+        // edges to the nodes of the same cluster and to those across a
+        // border from the node with padded id @param id
+        inline const std::vector<edge>&
+        intra_edges(uint32_t id) { return nodes_[node_of_[id]].intra_; }
+
+        inline const std::vector<edge>&
+        inter_edges(uint32_t id) { return nodes_[node_of_[id]].inter_; }
+
+        // the cluster of the tile with padded id @param id
+        inline uint32_t
+        cluster_of(uint32_t id)
+        {
+            uint32_t x, y;
+            map_->to_unpadded_xy(id, x, y);
+            return (y / size_) * clusters_x_ + x / size_;
+        }
+
+        // append to @param out the distances, inside its cluster, from the
+        // tile with padded id @param id to the nodes of the cluster and to
+        // @param target, if it lies in the cluster
+        void
+        connect(uint32_t id, std::vector<edge>& out,
+                uint32_t target = warthog::INF32);
+
+        // call after the tile with padded id @param id changes on the map
+        void
+        update(uint32_t id);
+
+        inline uint32_t
+        num_nodes() { return (uint32_t)node_of_.size(); }
+
+        uint32_t
+        num_edges();
+
+        inline uint32_t
+        num_clusters() { return clusters_x_ * clusters_y_; }
+
+        inline uint32_t
+        cluster_size() { return size_; }
+
+        size_t
+        mem();
+
+    private:
+        struct node
+        {
+            uint32_t id_;
+            uint32_t cluster_;
+            std::vector<edge> intra_;
+            std::vector<edge> inter_;
+        };
+
+        warthog::gridmap* map_;
+        uint32_t size_;
+        uint32_t clusters_x_, clusters_y_;
+
+        std::vector<node> nodes_;
+        std::vector<uint32_t> free_;
+        std::unordered_map<uint32_t, uint32_t> node_of_;
+        std::vector<std::vector<uint32_t>> cluster_nodes_;
+
+        // scratch space of the searches inside a cluster
+        std::vector<warthog::cost_t> dist_;
+
+        // entrances on the border between cluster @param c and the one
+        // east of it (@param south false) or south of it
+        void
+        add_border(uint32_t c, bool south);
+
+        void
+        remove_border(uint32_t c, bool south);
+
+        void
+        add_inter(uint32_t id, uint32_t other);
+
+        uint32_t
+        add_node(uint32_t id);
+
+        // intra edges of every node of cluster @param c
+        void
+        link_cluster(uint32_t c);
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include "rect_decomposition.h"
+
+namespace
+{
+
+// tiles that are traversable and not yet in a rectangle
+struct free_tiles
+{
+    warthog::gridmap* map_;
+    std::vector<uint32_t>& rect_of_;
+
+    inline bool
+    at(uint32_t x, uint32_t y)
+    {
+        uint32_t id = y * map_->width() + x;
+        return map_->get_label(id) && rect_of_[id] == warthog::INF32;
+    }
+
+    inline bool
+    row(uint32_t x0, uint32_t x1, uint32_t y)
+    {
+        for(uint32_t x = x0; x <= x1; x++) { if(!at(x, y)) { return false; } }
+        return true;
+    }
+
+    inline bool
+    column(uint32_t x, uint32_t y0, uint32_t y1)
+    {
+        for(uint32_t y = y0; y <= y1; y++) { if(!at(x, y)) { return false; } }
+        return true;
+    }
+};
+
+inline uint64_t
+area(const warthog::rect_decomposition::rect& r)
+{
+    return (uint64_t)(r.x1_ - r.x0_ + 1) * (r.y1_ - r.y0_ + 1);
+}
+
+}
+
+warthog::rect_decomposition::rect_decomposition(warthog::gridmap* map)
+{
+    rect_of_.assign(map->padded_mapsize(), warthog::INF32);
+    free_tiles tiles = {map, rect_of_};
+
+    // padding keeps every scan below inside the map
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    for(uint32_t id = 0; id < w * h; id++)
+    {
+        uint32_t x, y;
+        map->to_padded_xy(map->to_padded_id(id), x, y);
+        if(!tiles.at(x, y)) { continue; }
+
+        // right, then down
+        rect a = {x, y, x, y};
+        while(tiles.at(a.x1_ + 1, y)) { a.x1_++; }
+        while(tiles.row(x, a.x1_, a.y1_ + 1)) { a.y1_++; }
+
+        // down, then right
+        rect b = {x, y, x, y};
+        while(tiles.at(x, b.y1_ + 1)) { b.y1_++; }
+        while(tiles.column(b.x1_ + 1, y, b.y1_)) { b.x1_++; }
+
+        // the largest square, then right or down
+        rect c = {x, y, x, y};
+        while(tiles.row(x, c.x1_ + 1, c.y1_ + 1) &&
+                tiles.column(c.x1_ + 1, y, c.y1_))
+        {
+            c.x1_++; c.y1_++;
+        }
+        rect d = c;
+        while(tiles.column(c.x1_ + 1, y, c.y1_)) { c.x1_++; }
+        while(tiles.row(x, d.x1_, d.y1_ + 1)) { d.y1_++; }
+
+        rect r = a;
+        for(const rect& o : {b, c, d}) { if(area(o) > area(r)) { r = o; } }
+
+        uint32_t index = (uint32_t)rects_.size();
+        rects_.push_back(r);
+        for(uint32_t ry = r.y0_; ry <= r.y1_; ry++)
+        {
+            for(uint32_t rx = r.x0_; rx <= r.x1_; rx++)
+            {
+                rect_of_[ry * map->width() + rx] = index;
+            }
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef WARTHOG_RECT_DECOMPOSITION_H
+#define WARTHOG_RECT_DECOMPOSITION_H
+
+// domains/rect_decomposition.h
+//
+// A partition of the traversable tiles of a gridmap into empty rectangles,
+// for rectangular symmetry reduction (Harabor and Botea, 2010). Between
+// two tiles of an empty rectangle every path of octile length is optimal,
+// so a search only needs the tiles on the perimeter of each rectangle and
+// macro edges across it; see warthog::rsr_expansion_policy.
+//
+// Rectangles are grown greedily in row-major order: from the first tile
+// not yet covered, four rectangles are grown (right then down, down then
+// right, and the largest square extended right or down) and the largest
+// is kept.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "constants.h"
+#include "gridmap.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class rect_decomposition
+{
+    public:
+        // a rectangle from (x0_, y0_) to (x1_, y1_), inclusive, in padded
+        // coordinates
+        struct rect
+        {
+            uint32_t x0_, y0_, x1_, y1_;
+
+            inline bool
+            on_perimeter(uint32_t x, uint32_t y) const
+            { return x == x0_ || x == x1_ || y == y0_ || y == y1_; }
+
+            // true if the rectangle has tiles off its perimeter
+            inline bool
+            has_interior() const
+            { return x1_ - x0_ >= 2 && y1_ - y0_ >= 2; }
+        };
+
+        // decompose @param map; the map is only read during construction
+        rect_decomposition(warthog::gridmap* map);
+        ~rect_decomposition() { }
+
+        // the rectangle of the tile with padded id @param id, or
+        // warthog::INF32 for obstacles
+        inline uint32_t
+        get_rect_id(uint32_t id) { return rect_of_[id]; }
+
+        inline const rect&
+        get_rect(uint32_t r) { return rects_[r]; }
+
+        inline uint32_t
+        num_rects() { return (uint32_t)rects_.size(); }
+
+        inline size_t
+        mem()
+        {
+            return sizeof(*this) + sizeof(uint32_t) * rect_of_.capacity() +
+                sizeof(rect) * rects_.capacity();
+        }
+
+    private:
+        std::vector<uint32_t> rect_of_;
+        std::vector<rect> rects_;
+};
+
+}
+
+#endif
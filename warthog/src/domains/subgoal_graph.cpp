@@ -0,0 +1,277 @@
+#include "subgoal_graph.h"
+#include "jps.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+// the scans of subgoal_graph::scan on @param map, east and west, stopping
+// at obstacles, at the subgoals of @param sub and at @param target
+uint32_t
+scan_east(warthog::gridmap* map, warthog::gridmap* sub, uint32_t id,
+        uint32_t limit, uint32_t target, bool& hit)
+{
+    uint32_t m[3], s[3];
+    for(uint32_t from = id + 1; from - id <= limit; from += 32)
+    {
+        map->get_neighbours_32bit(from, m);
+        sub->get_neighbours_32bit(from, s);
+        uint32_t stop = ~m[1] | s[1];
+        if(target - from < 32) { stop |= 1u << (target - from); }
+        if(stop)
+        {
+            uint32_t to = from + (uint32_t)__builtin_ctz(stop);
+            hit = to - id <= limit && map->get_label(to);
+            return to - id;
+        }
+    }
+    hit = false;
+    return limit + 1;
+}
+
+uint32_t
+scan_west(warthog::gridmap* map, warthog::gridmap* sub, uint32_t id,
+        uint32_t limit, uint32_t target, bool& hit)
+{
+    uint32_t m[3], s[3];
+    for(uint32_t from = id - 1; id - from <= limit; from -= 32)
+    {
+        map->get_neighbours_upper_32bit(from, m);
+        sub->get_neighbours_upper_32bit(from, s);
+        uint32_t stop = ~m[1] | s[1];
+        if(from - target < 32) { stop |= 1u << (31 - (from - target)); }
+        if(stop)
+        {
+            uint32_t to = from - (uint32_t)__builtin_clz(stop);
+            hit = id - to <= limit && map->get_label(to);
+            return id - to;
+        }
+    }
+    hit = false;
+    return limit + 1;
+}
+
+}
+
+warthog::subgoal_graph::subgoal_graph(warthog::gridmap* map,
+        warthog::gridmap* rmap)
+    : map_(map), owns_rmap_(rmap == 0)
+{
+    rmap_ = owns_rmap_ ? warthog::jps::create_rmap(map_) : rmap;
+
+    // subgoals, in order of padded id
+    uint32_t w = map_->header_width();
+    uint32_t h = map_->header_height();
+    std::vector<uint32_t> subgoals;
+    sub_ = new warthog::gridmap(h, w);
+    for(uint32_t id = 0; id < w * h; id++)
+    {
+        uint32_t pid = map_->to_padded_id(id);
+        uint32_t px, py;
+        map_->to_padded_xy(pid, px, py);
+        if(map_->get_label(pid) && map_->is_corner(px, py))
+        {
+            sub_->set_label(pid, true);
+            subgoals.push_back(pid);
+        }
+    }
+    rsub_ = warthog::jps::create_rmap(sub_);
+
+    // padded rows are a multiple of 32 tiles long
+    uint32_t words = sub_->padded_mapsize() / 32;
+    rank_.resize(words);
+    uint32_t count = 0;
+    for(uint32_t i = 0; i < words; i++)
+    {
+        rank_[i] = count;
+        count += (uint32_t)__builtin_popcount(
+                *(uint32_t*)sub_->get_mem_ptr(i * 32));
+    }
+
+    std::vector<uint32_t> neis;
+    first_edge_.reserve(subgoals.size() + 1);
+    for(uint32_t s : subgoals)
+    {
+        first_edge_.push_back((uint32_t)edge_target_.size());
+        neis.clear();
+        connect(s, neis);
+        for(uint32_t t : neis)
+        {
+            edge_target_.push_back(t);
+            edge_cost_.push_back(distance(s, t));
+        }
+    }
+    first_edge_.push_back((uint32_t)edge_target_.size());
+}
+
+warthog::subgoal_graph::~subgoal_graph()
+{
+    delete rsub_;
+    delete sub_;
+    if(owns_rmap_) { delete rmap_; }
+}
+
+uint32_t
+warthog::subgoal_graph::scan(uint32_t dir, uint32_t id, uint32_t rid,
+        uint32_t limit, uint32_t target, uint32_t rtarget, bool& hit)
+{
+    switch(dir)
+    {
+        case 0: return scan_east(map_, sub_, id, limit, target, hit);
+        case 1: return scan_west(map_, sub_, id, limit, target, hit);
+        // north and south are east and west on the rotated map
+        case 2: return scan_east(rmap_, rsub_, rid, limit, rtarget, hit);
+        default: return scan_west(rmap_, rsub_, rid, limit, rtarget, hit);
+    }
+}
+
+void
+warthog::subgoal_graph::connect(uint32_t id, std::vector<uint32_t>& out,
+        uint32_t target)
+{
+    uint32_t rid = to_rmap_id(id);
+    uint32_t rtarget = target == warthog::INF32 ?
+        warthog::INF32 : to_rmap_id(target);
+
+    // moves east, west, north and south on map_ and on rmap_
+    uint32_t w = map_->width();
+    uint32_t rw = rmap_->width();
+    uint32_t step[4] = {1, (uint32_t)-1, (uint32_t)-w, w};
+    uint32_t rstep[4] = {rw, (uint32_t)-rw, 1, (uint32_t)-1};
+
+    // lim[d] is how far the scans along d from the diagonals may go
+    uint32_t lim[4];
+    for(uint32_t d = 0; d < 4; d++)
+    {
+        bool hit;
+        uint32_t k = scan(d, id, rid, warthog::INF32, target, rtarget, hit);
+        if(hit) { out.push_back(id + step[d] * k); }
+        lim[d] = hit ? k - 1 : k;
+    }
+
+    // every diagonal is the combination of a horizontal move d1 and a
+    // vertical one d2. as in GetDirectHReachable of Uras et al., a scan
+    // along d1 that ends k tiles away at an obstacle limits the scans
+    // along d1 from the following diagonal tiles to k tiles, and one that
+    // ends at a subgoal to k - 1, since the tiles beyond a subgoal are
+    // reached through it. likewise for d2
+    for(uint32_t d1 = 0; d1 < 2; d1++)
+    {
+        for(uint32_t d2 = 2; d2 < 4; d2++)
+        {
+            uint32_t lim1 = lim[d1];
+            uint32_t lim2 = lim[d2];
+            uint32_t p = id;
+            uint32_t rp = rid;
+            while(true)
+            {
+                // no corner cutting
+                if(!map_->get_label(p + step[d1]) ||
+                   !map_->get_label(p + step[d2]) ||
+                   !map_->get_label(p + step[d1] + step[d2]))
+                {
+                    break;
+                }
+                p += step[d1] + step[d2];
+                rp += rstep[d1] + rstep[d2];
+                if(sub_->get_label(p) || p == target)
+                {
+                    out.push_back(p);
+                    break;
+                }
+
+                bool hit;
+                uint32_t k = scan(d1, p, rp, lim1, target, rtarget, hit);
+                if(hit) { out.push_back(p + step[d1] * k); }
+                if(k <= lim1) { lim1 = hit ? k - 1 : k; }
+
+                k = scan(d2, p, rp, lim2, target, rtarget, hit);
+                if(hit) { out.push_back(p + step[d2] * k); }
+                if(k <= lim2) { lim2 = hit ? k - 1 : k; }
+            }
+        }
+    }
+}
+
+warthog::cost_t
+warthog::subgoal_graph::distance(uint32_t a, uint32_t b)
+{
+    uint32_t ax, ay, bx, by;
+    map_->to_padded_xy(a, ax, ay);
+    map_->to_padded_xy(b, bx, by);
+    uint32_t dx = ax > bx ? ax - bx : bx - ax;
+    uint32_t dy = ay > by ? ay - by : by - ay;
+    uint32_t diag = std::min(dx, dy);
+    return diag * warthog::DBL_ROOT_TWO + (std::max(dx, dy) - diag);
+}
+
+void
+warthog::subgoal_graph::refine(std::vector<warthog::sn_id_t>& path)
+{
+    if(path.size() < 2) { return; }
+
+    path_.clear();
+    path_.push_back((uint32_t)path[0]);
+    for(size_t i = 1; i < path.size(); i++)
+    {
+        uint32_t a = (uint32_t)path[i-1];
+        uint32_t b = (uint32_t)path[i];
+        size_t mark = path_.size();
+        if(!walk(a, b, true))
+        {
+            path_.resize(mark);
+            walk(a, b, false);
+        }
+    }
+    path.assign(path_.begin(), path_.end());
+}
+
+bool
+warthog::subgoal_graph::walk(uint32_t a, uint32_t b, bool diagonal_first)
+{
+    uint32_t ax, ay, bx, by;
+    map_->to_padded_xy(a, ax, ay);
+    map_->to_padded_xy(b, bx, by);
+    uint32_t w = map_->width();
+    uint32_t sx = bx > ax ? 1 : (bx < ax ? (uint32_t)-1 : 0);
+    uint32_t sy = by > ay ? w : (by < ay ? (uint32_t)-w : 0);
+    uint32_t dx = ax > bx ? ax - bx : bx - ax;
+    uint32_t dy = ay > by ? ay - by : by - ay;
+    uint32_t diag = std::min(dx, dy);
+    uint32_t card = std::max(dx, dy) - diag;
+    uint32_t cstep = dx > dy ? sx : sy;
+
+    uint32_t p = a;
+    for(uint32_t pass = 0; pass < 2; pass++)
+    {
+        bool diagonal = (pass == 0) == diagonal_first;
+        uint32_t moves = diagonal ? diag : card;
+        for(uint32_t i = 0; i < moves; i++)
+        {
+            if(diagonal)
+            {
+                if(!map_->get_label(p + sx) || !map_->get_label(p + sy))
+                {
+                    return false;
+                }
+                p += sx + sy;
+            }
+            else { p += cstep; }
+            if(!map_->get_label(p)) { return false; }
+            path_.push_back(p);
+        }
+    }
+    return true;
+}
+
+size_t
+warthog::subgoal_graph::mem()
+{
+    return sizeof(*this) + sub_->mem() + rsub_->mem() +
+        (owns_rmap_ ? rmap_->mem() : 0) +
+        sizeof(uint32_t) * (rank_.capacity() + first_edge_.capacity() +
+                edge_target_.capacity() + path_.capacity()) +
+        sizeof(warthog::cost_t) * edge_cost_.capacity();
+}
@@ -0,0 +1,143 @@
+#ifndef WARTHOG_SUBGOAL_GRAPH_H
+#define WARTHOG_SUBGOAL_GRAPH_H
+
+// domains/subgoal_graph.h
+//
+// A simple subgoal graph (Uras, Koenig and Hernandez, 2013) over the
+// traversable tiles of a gridmap.
+//
+// Subgoals are the tiles next to a convex obstacle corner (see
+// gridmap::is_corner). Two tiles are h-reachable if there is a path
+// between them whose length is the octile distance, and directly
+// h-reachable if no subgoal lies on such a path. Edges join every subgoal
+// to the subgoals directly h-reachable from it; any optimal grid path can
+// be rebuilt from an optimal path through the graph, so a query connects
+// its start and target to the graph the same way, searches the (much
+// smaller) graph and refines the result.
+//
+// Directly h-reachable tiles are found by clearance scans: from the tile,
+// cardinal scans run to the first obstacle or subgoal, 32 tiles at a time
+// (north and south on a rotated copy of the map, as the jump point
+// locators do), and from every tile on each diagonal two more cardinal
+// scans run, each no further than the one before it.
+//
+// Every edge can be walked as diagonal moves followed by cardinal moves
+// from one of its ends (::refine tries both).
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "constants.h"
+#include "gridmap.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class subgoal_graph
+{
+    public:
+        // build the graph of @param map. @param rmap is its rotated copy
+        // (see warthog::jps::create_rmap), which is not owned; if not
+        // given the graph makes its own. both maps are read by ::connect
+        // and ::refine and must outlive the graph
+        subgoal_graph(warthog::gridmap* map, warthog::gridmap* rmap = 0);
+        ~subgoal_graph();
+
+        // true if the tile with padded id @param id is a subgoal
+        inline bool
+        is_subgoal(uint32_t id) { return sub_->get_label(id); }
+
+        // @return the index of the subgoal with padded id @param id, from
+        // 0 to ::num_subgoals() - 1 in order of id
+        inline uint32_t
+        index_of(uint32_t id)
+        {
+            uint32_t word = id >> 5;
+            uint32_t bits =
+                *(uint32_t*)sub_->get_mem_ptr(word << 5) & ((1u << (id & 31)) - 1);
+            return rank_[word] + (uint32_t)__builtin_popcount(bits);
+        }
+
+        // the edges of the subgoal with index @param index are
+        // ::edge_target(i) and ::edge_cost(i) for i from ::first_edge(index)
+        // up to ::first_edge(index+1)
+        inline uint32_t
+        first_edge(uint32_t index) { return first_edge_[index]; }
+
+        inline uint32_t
+        edge_target(uint32_t i) { return edge_target_[i]; }
+
+        inline warthog::cost_t
+        edge_cost(uint32_t i) { return edge_cost_[i]; }
+
+        inline uint32_t
+        num_subgoals() { return (uint32_t)first_edge_.size() - 1; }
+
+        inline uint32_t
+        num_edges() { return (uint32_t)edge_target_.size(); }
+
+        // append to @param out the padded ids of the subgoals directly
+        // h-reachable from the tile with padded id @param id. the tile
+        // @param target, if given, is treated as one more subgoal
+        void
+        connect(uint32_t id, std::vector<uint32_t>& out,
+                uint32_t target = warthog::INF32);
+
+        // octile distance between two padded ids
+        warthog::cost_t
+        distance(uint32_t a, uint32_t b);
+
+        // replace the subgoals of @param path (padded ids, each directly
+        // h-reachable from the one before) by every tile on the way
+        void
+        refine(std::vector<warthog::sn_id_t>& path);
+
+        size_t
+        mem();
+
+    private:
+        warthog::gridmap* map_;
+        warthog::gridmap* rmap_;
+        bool owns_rmap_;
+        // subgoals of map_ and of rmap_
+        warthog::gridmap* sub_;
+        warthog::gridmap* rsub_;
+
+        // number of subgoals before each 32 bit word of sub_
+        std::vector<uint32_t> rank_;
+        std::vector<uint32_t> first_edge_;
+        std::vector<uint32_t> edge_target_;
+        std::vector<warthog::cost_t> edge_cost_;
+        std::vector<uint32_t> path_;
+
+        inline uint32_t
+        to_rmap_id(uint32_t id)
+        {
+            uint32_t x, y;
+            map_->to_unpadded_xy(id, x, y);
+            return rmap_->to_padded_id(map_->header_height() - y - 1, x);
+        }
+
+        // distance from @param id to the nearest obstacle or subgoal in
+        // cardinal direction @param dir (0 to 3 for east, west, north and
+        // south); @param rid is the same tile on rmap_. scans stop once
+        // they pass @param limit, returning a larger distance.
+        // @param hit is set if the scan ended at a subgoal
+        uint32_t
+        scan(uint32_t dir, uint32_t id, uint32_t rid, uint32_t limit,
+                uint32_t target, uint32_t rtarget, bool& hit);
+
+        // walk from @param a to @param b in a straight line of diagonal
+        // moves and then cardinal ones, or cardinal moves first if
+        // @param diagonal_first is false, appending every tile after
+        // @param a to path_. @return false if the walk is blocked
+        bool
+        walk(uint32_t a, uint32_t b, bool diagonal_first);
+};
+
+}
+
+#endif
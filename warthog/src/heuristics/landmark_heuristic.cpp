@@ -0,0 +1,175 @@
+#include "grid_components.h"
+#include "helpers.h"
+#include "landmark_heuristic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace
+{
+
+// the grid moves: the tiles that must be traversable (bits of
+// gridmap::get_neighbours) and the offset
+struct grid_move
+{
+    uint32_t tiles_;
+    int32_t dx_, dy_;
+};
+
+const grid_move moves[8] =
+{
+    {514, 0, -1}, {1536, 1, 0}, {131584, 0, 1}, {768, -1, 0},
+    {1542, 1, -1}, {394752, 1, 1}, {197376, -1, 1}, {771, -1, -1}
+};
+
+const double UNREACHED = std::numeric_limits<double>::max();
+
+// the largest value of a table; it also stands for longer distances and
+// for tiles the landmark cannot reach
+const uint32_t CAP = UINT16_MAX;
+
+// the most units per tile
+const uint32_t MAX_UNIT = 64;
+
+// distances from padded tile @param source with moves costing
+// @param straight and @param diagonal
+void
+dijkstra(warthog::gridmap* map, uint32_t source, double straight,
+        double diagonal, std::vector<double>& dist)
+{
+    typedef std::pair<double, uint32_t> entry;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> open;
+    int32_t w = (int32_t)map->width();
+
+    dist.assign(map->padded_mapsize(), UNREACHED);
+    dist[source] = 0;
+    open.push(entry(0, source));
+    while(!open.empty())
+    {
+        entry top = open.top();
+        open.pop();
+        uint32_t id = top.second;
+        if(top.first != dist[id]) { continue; }
+
+        uint32_t tiles = 0;
+        map->get_neighbours(id, (uint8_t*)&tiles);
+        for(const grid_move& m : moves)
+        {
+            if((tiles & m.tiles_) != m.tiles_) { continue; }
+            uint32_t n = (uint32_t)((int32_t)id + m.dy_ * w + m.dx_);
+            double alt = top.first + (m.dx_ && m.dy_ ? diagonal : straight);
+            if(alt < dist[n])
+            {
+                dist[n] = alt;
+                open.push(entry(alt, n));
+            }
+        }
+    }
+}
+
+struct shared_data
+{
+    warthog::gridmap* map_;
+    std::vector<uint32_t>* landmarks_;
+    std::vector<uint32_t>* units_;
+    std::vector<uint16_t>* dist_;
+};
+
+}
+
+warthog::landmark_heuristic::landmark_heuristic(
+        warthog::gridmap* map, uint32_t num_landmarks)
+    : octile_(map->width(), map->height()), num_landmarks_(0), hscale_(1.0)
+{
+    // seed the selection in the largest component
+    warthog::grid_components comps(map);
+    std::vector<uint32_t> sizes(comps.num_components(), 0);
+    uint32_t mapsize = map->header_width() * map->header_height();
+    for(uint32_t id = 0; id < mapsize; id++)
+    {
+        uint32_t label = comps.get_label(id);
+        if(label != warthog::INF32) { sizes[label]++; }
+    }
+    uint32_t seed = warthog::INF32;
+    uint32_t largest = (uint32_t)(std::max_element(sizes.begin(),
+                sizes.end()) - sizes.begin());
+    for(uint32_t id = 0; id < mapsize && seed == warthog::INF32; id++)
+    {
+        if(comps.get_label(id) == largest) { seed = map->to_padded_id(id); }
+    }
+
+    // farthest-point selection, measured with exact octile costs. the
+    // longest distance from each landmark sets its units
+    std::vector<uint32_t> units;
+    if(seed != warthog::INF32)
+    {
+        std::vector<double> dist;
+        std::vector<double> nearest;
+        dijkstra(map, seed, 1, warthog::DBL_ROOT_TWO, nearest);
+        while(landmarks_.size() < num_landmarks)
+        {
+            uint32_t far = warthog::INF32;
+            double far_dist = 0;
+            for(uint32_t id = 0; id < nearest.size(); id++)
+            {
+                if(nearest[id] != UNREACHED && nearest[id] > far_dist)
+                {
+                    far_dist = nearest[id];
+                    far = id;
+                }
+            }
+            if(far == warthog::INF32) { break; } // every tile is a landmark
+
+            dijkstra(map, far, 1, warthog::DBL_ROOT_TWO, dist);
+            double longest = 0;
+            for(uint32_t id = 0; id < dist.size(); id++)
+            {
+                if(dist[id] == UNREACHED) { continue; }
+                if(dist[id] > longest) { longest = dist[id]; }
+                // the first landmark replaces the seed
+                if(landmarks_.empty() || dist[id] < nearest[id])
+                {
+                    nearest[id] = dist[id];
+                }
+            }
+            uint32_t unit = (uint32_t)((CAP - 1) / (longest + 1));
+            units.push_back(std::min(std::max(unit, 1u), MAX_UNIT));
+            landmarks_.push_back(far);
+        }
+    }
+    num_landmarks_ = (uint32_t)landmarks_.size();
+    for(uint32_t unit : units) { inv_unit_.push_back(1.0 / unit); }
+
+    // the tables, one landmark per task
+    void*(*thread_compute_fn)(void*) =
+    [] (void* args_in) -> void*
+    {
+        warthog::helpers::thread_params* par =
+            (warthog::helpers::thread_params*) args_in;
+        shared_data* shared = (shared_data*) par->shared_;
+        uint32_t num = (uint32_t)shared->landmarks_->size();
+
+        std::vector<double> dist;
+        for(uint32_t i = par->thread_id_; i < num; i += par->max_threads_)
+        {
+            uint32_t unit = shared->units_->at(i);
+            dijkstra(shared->map_, shared->landmarks_->at(i), unit,
+                    floor(warthog::DBL_ROOT_TWO * unit), dist);
+            for(uint32_t id = 0; id < dist.size(); id++)
+            {
+                shared->dist_->at((size_t)id * num + i) =
+                    (uint16_t)std::min(dist[id], (double)CAP);
+            }
+            par->nprocessed_++;
+        }
+        return 0;
+    };
+
+    dist_.assign((size_t)map->padded_mapsize() * num_landmarks_, CAP);
+    shared_data shared = {map, &landmarks_, &units, &dist_};
+    warthog::helpers::parallel_compute(
+            thread_compute_fn, &shared, num_landmarks_);
+}
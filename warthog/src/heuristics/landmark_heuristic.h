@@ -0,0 +1,96 @@
+#ifndef WARTHOG_LANDMARK_HEURISTIC_H
+#define WARTHOG_LANDMARK_HEURISTIC_H
+
+// heuristics/landmark_heuristic.h
+//
+// Differential heuristic for gridmaps: the octile distance, raised by the
+// triangle inequality over the distances to a few landmark tiles,
+// |d(L, n) - d(L, t)| <= d(n, t) (Goldberg and Harrelson, 2005; Sturtevant
+// et al., 2009, Memory-Based Heuristics for Explicit State Spaces).
+//
+// Landmarks are chosen by farthest-point selection: the first is the tile
+// farthest from the largest connected component's first tile, each next
+// one the tile farthest from all landmarks so far.
+//
+// Each landmark stores one 16-bit value per padded tile, in units of 1/k
+// tiles with k as large as the map's longest distance allows (k >= 1,
+// longer distances are capped). The values are exact distances where
+// every move cost is rounded down to a whole number of units, which makes
+// them a lower bound whose difference across a move never exceeds its
+// cost; the heuristic stays admissible and consistent. The tables are
+// built with one Dijkstra search per landmark, in parallel.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "constants.h"
+#include "gridmap.h"
+#include "octile_heuristic.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace warthog
+{
+
+class landmark_heuristic
+{
+    public:
+        // choose up to @param num_landmarks landmarks on @param map and
+        // build their tables; the map is only read during construction.
+        // ids are padded ids of @param map
+        landmark_heuristic(warthog::gridmap* map, uint32_t num_landmarks);
+        ~landmark_heuristic() { }
+
+        inline double
+        h(warthog::sn_id_t id, warthog::sn_id_t id2)
+        {
+            const uint16_t* a = &dist_[(size_t)id * num_landmarks_];
+            const uint16_t* b = &dist_[(size_t)id2 * num_landmarks_];
+            double best = octile_.h(id, id2);
+            for(uint32_t i = 0; i < num_landmarks_; i++)
+            {
+                double d = abs((int32_t)a[i] - (int32_t)b[i]) * inv_unit_[i];
+                if(d > best) { best = d; }
+            }
+            return best * hscale_;
+        }
+
+        inline void
+        set_hscale(double hscale) { hscale_ = hscale; }
+
+        inline double
+        get_hscale() { return hscale_; }
+
+        inline uint32_t
+        num_landmarks() { return num_landmarks_; }
+
+        // padded id of landmark @param i
+        inline uint32_t
+        get_landmark(uint32_t i) { return landmarks_.at(i); }
+
+        inline size_t
+        mem()
+        {
+            return sizeof(*this) + sizeof(uint16_t) * dist_.capacity() +
+                sizeof(double) * inv_unit_.capacity() +
+                sizeof(uint32_t) * landmarks_.capacity();
+        }
+
+    private:
+        warthog::octile_heuristic octile_;
+        uint32_t num_landmarks_;
+        double hscale_;
+
+        // the values of all landmarks for padded tile id start at
+        // dist_[id * num_landmarks_]
+        std::vector<uint16_t> dist_;
+        std::vector<double> inv_unit_;
+        std::vector<uint32_t> landmarks_;
+};
+
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include "online_jump_point_locator2.h"
 #include "xy_graph.h"
 
+#include <algorithm>
+
 // computes the forced neighbours of a node.
 // for a neighbour to be forced we must check that 
 // (a) the alt path from the parent is blocked and
@@ -162,24 +164,25 @@ warthog::jps::create_jump_point_graph(warthog::gridmap* gm)
     warthog::jps::online_jump_point_locator2 jpl(gm);
     uint32_t mapwidth = gm->header_width();
     uint32_t mapheight = gm->header_height();
-    std::unordered_map<uint32_t, uint32_t> id_map;
+    std::unordered_map<warthog::grid_id_t, uint32_t> id_map;
 
     // add nodes to graph
     for(uint32_t y = 0; y < mapheight; y++)
     {
         for(uint32_t x = 0; x < mapwidth; x++)
         {
-            uint32_t from_id = gm->to_padded_id(y*mapwidth+x);
+            warthog::grid_id_t from_id =
+                gm->to_padded_id((warthog::grid_id_t)y*mapwidth+x);
             if(!gm->get_label(gm->to_padded_id(x, y))) { continue; } 
 
-            uint32_t w_id = from_id - 1;
-            uint32_t e_id = from_id + 1;
-            uint32_t s_id = from_id + gm->width();
-            uint32_t n_id = from_id - gm->width();
-            uint32_t nw_id = (from_id - gm->width()) - 1;
-            uint32_t ne_id = (from_id - gm->width()) + 1;
-            uint32_t sw_id = (from_id + gm->width()) - 1;
-            uint32_t se_id = (from_id + gm->width()) + 1;
+            warthog::grid_id_t w_id = from_id - 1;
+            warthog::grid_id_t e_id = from_id + 1;
+            warthog::grid_id_t s_id = from_id + gm->width();
+            warthog::grid_id_t n_id = from_id - gm->width();
+            warthog::grid_id_t nw_id = (from_id - gm->width()) - 1;
+            warthog::grid_id_t ne_id = (from_id - gm->width()) + 1;
+            warthog::grid_id_t sw_id = (from_id + gm->width()) - 1;
+            warthog::grid_id_t se_id = (from_id + gm->width()) + 1;
             
             // detect all corner turning points (== jump points) 
             // and add them to the jump point graph
@@ -195,8 +198,8 @@ warthog::jps::create_jump_point_graph(warthog::gridmap* gm)
                     gm->get_label(w_id) && gm->get_label(s_id)) )
             {
                 uint32_t graph_id = graph->add_node((int32_t)x, (int32_t)y);
-                id_map.insert(
-                        std::pair<uint32_t, uint32_t>(from_id, graph_id));
+                id_map.insert(std::pair<warthog::grid_id_t, uint32_t>(
+                            from_id, graph_id));
             }
         }
     }
@@ -206,20 +209,22 @@ warthog::jps::create_jump_point_graph(warthog::gridmap* gm)
     {
         int32_t x, y;
         graph->get_xy(from_id, x, y);
-        uint32_t gm_id = gm->to_padded_id((uint32_t)y*mapwidth+(uint32_t)x);
+        warthog::grid_id_t gm_id = gm->to_padded_id(
+                (warthog::grid_id_t)y*mapwidth+(uint32_t)x);
         warthog::graph::node* from = graph->get_node(from_id);
 
         for(uint32_t i = 0; i < 8; i++)
         {
             warthog::jps::direction d = (warthog::jps::direction)(1 << i);
-            std::vector<uint32_t> jpoints;
+            std::vector<warthog::grid_id_t> jpoints;
             std::vector<double> jcosts;
-            jpl.jump(d, gm_id, warthog::INF32, jpoints, jcosts);
+            jpl.jump(d, gm_id, warthog::GRID_ID_MAX, jpoints, jcosts);
             for(uint32_t idx = 0; idx < jpoints.size(); idx++)
             {
-                uint32_t jp_id = jpoints[idx] & ((1 << 24) - 1);
-                //warthog::jps::direction d = (warthog::jps::direction)(jpoints[idx] >> 24);
-                std::unordered_map<uint32_t, uint32_t>::iterator it_to_id; 
+                // the online locator returns whole ids; nothing is packed
+                // into the upper bits
+                warthog::grid_id_t jp_id = jpoints[idx];
+                std::unordered_map<warthog::grid_id_t, uint32_t>::iterator it_to_id; 
                 it_to_id = id_map.find(jp_id);
                 assert(it_to_id != id_map.end());
                 uint32_t to_id = it_to_id->second;
@@ -276,6 +281,79 @@ warthog::jps::create_corner_map(warthog::gridmap* gm)
     return corner_map;
 }
 
+warthog::gridmap*
+warthog::jps::create_rmap(warthog::gridmap* gm)
+{
+	uint32_t maph = gm->header_height();
+	uint32_t mapw = gm->header_width();
+	uint32_t rmaph = mapw;
+	uint32_t rmapw = maph;
+	warthog::gridmap* rmap = new warthog::gridmap(rmaph, rmapw);
+
+	for(uint32_t x = 0; x < mapw; x++) 
+	{
+		for(uint32_t y = 0; y < maph; y++)
+		{
+			uint32_t label = gm->get_label(gm->to_padded_id(x, y));
+			uint32_t rx = ((rmapw-1) - y);
+			uint32_t ry = x;
+			uint32_t rid = rmap->to_padded_id(rx, ry);
+			rmap->set_label(rid, label);
+		}
+	}
+	if(gm->has_summary()) { rmap->enable_summary(); }
+	return rmap;
+}
+
+warthog::gridmap*
+warthog::jps::create_paged_rmap(warthog::gridmap* gm, const char* filename,
+        size_t resident_bytes)
+{
+	uint32_t maph = gm->header_height();
+	uint32_t mapw = gm->header_width();
+	uint32_t rmaph = mapw;
+	uint32_t rmapw = maph;
+
+	warthog::gridmap* rmap =
+		warthog::gridmap::load_paged(filename, resident_bytes);
+	if(rmap && rmap->header_height() == rmaph &&
+	   rmap->header_width() == rmapw &&
+	   rmap->get_num_traversable_tiles() == gm->get_num_traversable_tiles())
+	{
+		if(gm->has_summary()) { rmap->enable_summary(); }
+		return rmap;
+	}
+	delete rmap;
+
+	rmap = warthog::gridmap::create_paged(filename, rmaph, rmapw,
+			gm->get_num_traversable_tiles(), resident_bytes);
+	if(!rmap) { return 0; }
+
+	// rotated row ry is column x = ry of gm. each pass writes as many
+	// rotated rows as half the budget holds, reading gm row by row
+	uint32_t rows = std::max<size_t>(1,
+			resident_bytes / 2 / (rmap->width() / 8));
+	for(uint32_t x0 = 0; x0 < mapw; x0 += rows)
+	{
+		uint32_t x1 = std::min(mapw, x0 + rows);
+		for(uint32_t y = 0; y < maph; y++)
+		{
+			uint32_t id = gm->to_padded_id(x0, y);
+			for(uint32_t x = x0; x < x1; x++, id++)
+			{
+				if(!gm->get_label(id)) { continue; }
+				rmap->set_label(rmap->to_padded_id((rmapw-1) - y, x), true);
+			}
+		}
+	}
+
+	// reopen read-only
+	delete rmap;
+	rmap = warthog::gridmap::load_paged(filename, resident_bytes);
+	if(rmap && gm->has_summary()) { rmap->enable_summary(); }
+	return rmap;
+}
+
 //warthog::jps::direction
 //warthog::jps::compute_direction(
 //        uint32_t px, uint32_t py, uint32_t x, uint32_t y)
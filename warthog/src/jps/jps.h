@@ -41,8 +41,9 @@ typedef enum
     ALL = 255
 } direction;
 
-// we sometimes store the id of a node in the lower 3 bytes of a word and 
-// use the upper byte to store something else (e.g. the parent direction)
+// the offline (jps+ and jps2+) tables store the id of a node in the lower
+// 3 bytes of a word and use the upper byte to store something else (e.g.
+// the parent direction). the online searches do not pack ids this way
 const uint32_t JPS_ID_MASK = (1 << 24)-1;
 
 // compute the diagonal-first direction of travel, 
@@ -196,6 +197,29 @@ create_jump_point_graph(warthog::gridmap* gm);
 warthog::gridmap*
 create_corner_map(warthog::gridmap* gm);
 
+// create a copy of the grid map which is rotated by 90 degrees clockwise.
+// the online jump point locators use it when jumping North or South.
+// a rotated map can be shared by any number of locators on the same map
+//
+// the rotated map has a strip summary if gm has one (see
+// warthog::gridmap::enable_summary)
+//
+// @param: gm; the input grid
+// @return the rotated gridmap
+warthog::gridmap*
+create_rmap(warthog::gridmap* gm);
+
+// as create_rmap, but the rotated map is kept in the binary map file
+// @param filename and paged like gm (see warthog::gridmap::load_paged),
+// with at most @param resident_bytes resident. the file is reused if it
+// holds a map of the right size and number of traversable tiles;
+// otherwise it is written, one band of rotated rows per pass over gm
+//
+// @return the rotated gridmap, or 0 if the file cannot be written
+warthog::gridmap*
+create_paged_rmap(warthog::gridmap* gm, const char* filename,
+        size_t resident_bytes);
+
 }
 }
 
@@ -11,7 +11,9 @@
 // @author: dharabor
 // @created: 06/01/2010
 
+#include "dead_end_filter.h"
 #include "expansion_policy.h"
+#include "grid_bb_labelling.h"
 #include "gridmap.h"
 #include "helpers.h"
 #include "jps.h"
@@ -27,9 +29,34 @@ namespace warthog
 class jps2_expansion_policy : public expansion_policy
 {
 	public:
-		jps2_expansion_policy(warthog::gridmap* map);
+		// @param rmap is a rotated copy of @param map shared with other
+		// searchers (see warthog::jps::create_rmap); if not given the
+		// policy makes its own
+		jps2_expansion_policy(warthog::gridmap* map,
+				warthog::gridmap* rmap = 0);
 		virtual ~jps2_expansion_policy();
 
+		// switch to another version of the map with the same dimensions
+		// (e.g. a newer warthog::gridmap_snapshot) between searches.
+		// @param rmap is its rotated copy, which is not owned; if null
+		// one is created
+		void
+		set_map(warthog::gridmap* map, warthog::gridmap* rmap = 0);
+
+		// skip the dead-end regions that a query never needs to enter
+		// (see warthog::dead_end_filter); null, the default, prunes none.
+		// the filter is not owned
+		inline void
+		set_dead_end_filter(warthog::dead_end_filter* filter)
+		{ dead_ends_ = filter; }
+
+		// skip moves whose goal bounding box (see
+		// warthog::label::grid_bb_labelling) does not hold the target;
+		// null, the default, skips none. the boxes are not owned
+		inline void
+		set_goal_bounds(warthog::label::grid_bb_labelling* bounds)
+		{ bounds_ = bounds; }
+
 		virtual void 
 		expand(warthog::search_node*, warthog::problem_instance*);
 
@@ -40,6 +67,11 @@ class jps2_expansion_policy : public expansion_policy
                 sizeof(*this) + map_->mem() + jpl_->mem();
 		}
 
+		// the state its jump point locator reads while it scans (see
+		// global::search_context); ::expand binds each query to it
+		inline global::search_context*
+		get_context() { return jpl_->get_context(); }
+
         virtual void
         get_xy(warthog::sn_id_t node_id, int32_t& x, int32_t& y); 
 
@@ -71,7 +103,9 @@ class jps2_expansion_policy : public expansion_policy
 	private:
 		warthog::gridmap* map_;
         warthog::jps::online_jump_point_locator2* jpl_;
-		std::vector<uint32_t> jp_ids_;
+		warthog::dead_end_filter* dead_ends_;
+		warthog::label::grid_bb_labelling* bounds_;
+		std::vector<grid_id_t> jp_ids_;
         std::vector<warthog::cost_t> jp_costs_;
 
 		// computes the direction of travel; from a node n1
@@ -79,7 +113,7 @@ class jps2_expansion_policy : public expansion_policy
         // NB: since JPS2 prunes intermediate diagonals the parent
         // directions are always cardinal.
 		inline warthog::jps::direction
-		compute_direction(uint32_t n1_id, uint32_t n2_id);
+		compute_direction(grid_id_t n1_id, grid_id_t n2_id);
 };
 
 }
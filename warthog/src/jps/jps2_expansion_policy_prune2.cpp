@@ -1,4 +1,5 @@
 #include "jps2_expansion_policy_prune2.h"
+#include "phase_timer.h"
 #include "constants.h"
 #include "forward.h"
 #include "global.h"
@@ -6,12 +7,16 @@ namespace G = global;
 
 typedef warthog::jps2_expansion_policy_prune2 jps2_exp_prune2;
 
-jps2_exp_prune2::jps2_expansion_policy_prune2(warthog::gridmap* map)
-  : expansion_policy(map->height() * map->width())
+jps2_exp_prune2::jps2_expansion_policy_prune2(warthog::gridmap* map,
+        warthog::gridmap* rmap)
+  : expansion_policy((size_t)map->height() * map->width())
 {
 	map_ = map;
-	jpl_ = new warthog::online_jump_point_locator2_prune2(map, &jpruner);
+	jpl_ = new warthog::online_jump_point_locator2_prune2(map, &jpruner, rmap);
+  jpl_->get_context()->nodepool = get_nodepool();
   jpl_->init_tables();
+	dead_ends_ = 0;
+	bounds_ = 0;
 	reset();
   costs_.clear();
   jp_ids_.clear();
@@ -24,22 +29,31 @@ jps2_exp_prune2::~jps2_expansion_policy_prune2()
 	delete jpl_;
 }
 
+void
+jps2_exp_prune2::set_map(warthog::gridmap* map, warthog::gridmap* rmap)
+{
+	map_ = map;
+	jpl_->set_map(map, rmap);
+}
+
 void
 warthog::jps2_expansion_policy_prune2::get_xy(warthog::sn_id_t sn_id, int32_t& x, int32_t& y)
 {
-    map_->to_unpadded_xy((uint32_t)sn_id, (uint32_t&)x, (uint32_t&)y);
+    map_->to_unpadded_xy((grid_id_t)sn_id, (uint32_t&)x, (uint32_t&)y);
 }
 
 warthog::search_node* 
 warthog::jps2_expansion_policy_prune2::generate_start_node(
         warthog::problem_instance* pi)
 { 
-    uint32_t start_id = (uint32_t)pi->start_id_;
-    uint32_t max_id = map_->header_width() * map_->header_height();
+    grid_id_t start_id = (grid_id_t)pi->start_id_;
+    grid_id_t max_id =
+        (grid_id_t)map_->header_width() * map_->header_height();
 
     if(start_id >= max_id) { return 0; }
-    uint32_t padded_id = map_->to_padded_id(start_id);
+    grid_id_t padded_id = map_->to_padded_id(start_id);
     if(map_->get_label(padded_id) == 0) { return 0; }
+    if(dead_ends_) { dead_ends_->set_start(padded_id); }
     return generate(padded_id);
 }
 
@@ -47,12 +61,14 @@ warthog::search_node*
 warthog::jps2_expansion_policy_prune2::generate_target_node(
         warthog::problem_instance* pi)
 {
-    uint32_t target_id = (uint32_t)pi->target_id_;
-    uint32_t max_id = map_->header_width() * map_->header_height();
+    grid_id_t target_id = (grid_id_t)pi->target_id_;
+    grid_id_t max_id =
+        (grid_id_t)map_->header_width() * map_->header_height();
 
     if(target_id  >= max_id) { return 0; }
-    uint32_t padded_id = map_->to_padded_id(target_id);
+    grid_id_t padded_id = map_->to_padded_id(target_id);
     if(map_->get_label(padded_id) == 0) { return 0; }
+    if(dead_ends_) { dead_ends_->set_target(padded_id); }
     return generate(padded_id);
 }
 
@@ -63,6 +79,7 @@ jps2_exp_prune2::expand(
 	reset();
   jp_ids_.clear();
   costs_.clear();
+  jpl_->get_context()->bind(problem);
   if (current->get_g() > 0 && current->get_parent() == NO_PARENT) {
     return;
   }
@@ -78,28 +95,42 @@ jps2_exp_prune2::expand(
 
 	// get the tiles around the current node c
 	uint32_t c_tiles;
-	uint32_t current_id = current->get_id();
+	grid_id_t current_id = current->get_id();
 	map_->get_neighbours(current_id, (uint8_t*)&c_tiles);
 
 	// look for jump points in the direction of each natural 
 	// and forced neighbour
-	uint32_t succ_dirs = warthog::jps::compute_successors(dir_c, c_tiles);
-	uint32_t goal_id = problem->target_id_;
+	uint32_t succ_dirs;
+	{
+		PHASE_SCOPE(SUCCESSORS);
+		succ_dirs = warthog::jps::compute_successors(dir_c, c_tiles);
+	}
+	grid_id_t goal_id = problem->target_id_;
+
+	// goal bounding: skip the moves that start no optimal path to the goal
+	if(bounds_ && goal_id != warthog::GRID_ID_MAX)
+	{
+		uint32_t gx, gy;
+		map_->to_padded_xy(goal_id, gx, gy);
+		succ_dirs &= bounds_->moves_towards(current_id, gx, gy);
+	}
 
 	for(uint32_t i = 0; i < 8; i++)
 	{
 		warthog::jps::direction d = (warthog::jps::direction) (1 << i);
 		if(succ_dirs & d)
 		{
+			PHASE_SCOPE(SCAN);
 			jpl_->jump(d, current_id, goal_id, jp_ids_, costs_);
 		}
 	}
 
 	for(uint32_t i = 0; i < jp_ids_.size(); i++)
 	{
-		// bits 0-23 store the id of the jump point
-		// bits 24-31 store the direction to the parent
-		uint32_t jp_id = jp_ids_.at(i);
+		// the whole id of the jump point; the direction to the parent is
+		// recomputed when it is expanded (see ::compute_direction)
+		grid_id_t jp_id = jp_ids_.at(i);
+		if(dead_ends_ && dead_ends_->filter(jp_id)) { continue; }
 		warthog::search_node* mynode = generate(jp_id);
     add_neighbour(mynode, costs_.at(i));
 
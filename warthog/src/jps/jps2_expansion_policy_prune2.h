@@ -5,9 +5,11 @@
 // @created: 30/06/2021
 
 #include "node_pool.h"
+#include "grid_bb_labelling.h"
 #include "gridmap.h"
 #include "helpers.h"
 #include "jps.h"
+#include "dead_end_filter.h"
 #include "expansion_policy.h"
 #include "online_jump_point_locator2_prune2.h"
 #include "problem_instance.h"
@@ -22,9 +24,33 @@ namespace warthog
 class jps2_expansion_policy_prune2: public expansion_policy
 {
 	public:
-		jps2_expansion_policy_prune2(warthog::gridmap* map);
+		// @param rmap is a rotated copy of @param map (see
+		// warthog::jps::create_rmap); if not given the locator makes its
+		// own. searches do not modify either map, so both can be shared
+		jps2_expansion_policy_prune2(warthog::gridmap* map,
+				warthog::gridmap* rmap = 0);
 		~jps2_expansion_policy_prune2();
 
+		// switch to another version of the map with the same dimensions
+		// (e.g. a newer warthog::gridmap_snapshot) between searches.
+		// @param rmap is its rotated copy, as in the constructor
+		void
+		set_map(warthog::gridmap* map, warthog::gridmap* rmap = 0);
+
+		// skip the dead-end regions that a query never needs to enter
+		// (see warthog::dead_end_filter); null, the default, prunes none.
+		// the filter is not owned
+		inline void
+		set_dead_end_filter(warthog::dead_end_filter* filter)
+		{ dead_ends_ = filter; }
+
+		// skip moves whose goal bounding box (see
+		// warthog::label::grid_bb_labelling) does not hold the target;
+		// null, the default, skips none. the boxes are not owned
+		inline void
+		set_goal_bounds(warthog::label::grid_bb_labelling* bounds)
+		{ bounds_ = bounds; }
+
 		virtual void 
 		expand(warthog::search_node*, warthog::problem_instance*);
 
@@ -35,6 +61,13 @@ class jps2_expansion_policy_prune2: public expansion_policy
                 sizeof(*this) + map_->mem() + jpl_->mem();
 		}
 
+		// the state its jump point locator and pruner read while they
+		// scan (see global::search_context); ::expand binds each query
+		// to it. the search using this policy must also set the open
+		// list, whose nodes the pruner checks
+		inline global::search_context*
+		get_context() { return jpl_->get_context(); }
+
     virtual void
     get_xy(warthog::sn_id_t node_id, int32_t& x, int32_t& y); 
 
@@ -68,12 +101,14 @@ class jps2_expansion_policy_prune2: public expansion_policy
 	private:
 		warthog::gridmap* map_;
 		online_jump_point_locator2_prune2* jpl_;
+		warthog::dead_end_filter* dead_ends_;
+		warthog::label::grid_bb_labelling* bounds_;
 		std::vector<warthog::cost_t> costs_;
-		std::vector<uint32_t> jp_ids_;
+		std::vector<grid_id_t> jp_ids_;
     online_jps_pruner2 jpruner;
 
     inline warthog::jps::direction compute_direction (
-            uint32_t n1_id, uint32_t n2_id)
+            grid_id_t n1_id, grid_id_t n2_id)
     {
         if(n1_id == warthog::GRID_ID_MAX) { return warthog::jps::NONE; }
 
@@ -18,6 +18,7 @@
 // @author: dharabor
 // @created: 06/01/2010
 
+#include "dead_end_filter.h"
 #include "expansion_policy.h"
 #include "gridmap.h"
 #include "helpers.h"
@@ -34,9 +35,27 @@ namespace warthog
 class jps_expansion_policy : public expansion_policy
 {
 	public:
-		jps_expansion_policy(warthog::gridmap* map);
+		// @param rmap is a rotated copy of @param map shared with other
+		// searchers (see warthog::jps::create_rmap); if not given the
+		// policy makes its own
+		jps_expansion_policy(warthog::gridmap* map,
+				warthog::gridmap* rmap = 0);
 		virtual ~jps_expansion_policy();
 
+		// switch to another version of the map with the same dimensions
+		// (e.g. a newer warthog::gridmap_snapshot) between searches.
+		// @param rmap is its rotated copy, which is not owned; if null
+		// one is created
+		void
+		set_map(warthog::gridmap* map, warthog::gridmap* rmap = 0);
+
+		// skip the dead-end regions that a query never needs to enter
+		// (see warthog::dead_end_filter); null, the default, prunes none.
+		// the filter is not owned
+		inline void
+		set_dead_end_filter(warthog::dead_end_filter* filter)
+		{ dead_ends_ = filter; }
+
 		virtual void 
 		expand(warthog::search_node*, warthog::problem_instance*);
 
@@ -56,14 +75,20 @@ class jps_expansion_policy : public expansion_policy
                 sizeof(*this) + map_->mem() + jpl_->mem();
 		}
 
+		// the state its jump point locator reads while it scans (see
+		// global::search_context); ::expand binds each query to it
+		inline global::search_context*
+		get_context() { return jpl_->get_context(); }
+
 	private:
 		warthog::gridmap* map_;
 		warthog::online_jump_point_locator* jpl_;
+		warthog::dead_end_filter* dead_ends_;
 
 		// computes the direction of travel; from a node n1
 		// to a node n2.
 		inline warthog::jps::direction
-		compute_direction(uint32_t n1_id, uint32_t n2_id);
+		compute_direction(grid_id_t n1_id, grid_id_t n2_id);
 };
 
 }
@@ -50,10 +50,10 @@ warthog::offline_jump_point_locator2::preproc()
 				warthog::jps::direction dir = 
 					(warthog::jps::direction)(1 << i);
 //				std::cout << dir << ": ";
-				uint32_t jumpnode_id;
+				warthog::grid_id_t jumpnode_id;
 				double jumpcost;
 				jpl.jump(dir, mapid,
-						warthog::INF32, jumpnode_id, jumpcost);
+						warthog::GRID_ID_MAX, jumpnode_id, jumpcost);
 				
 				// convert from cost to number of steps
 				if(dir > 8)
@@ -64,7 +64,7 @@ warthog::offline_jump_point_locator2::preproc()
 //				std::cout << (jumpnode_id == warthog::INF ? 0 : num_steps) << " ";
 
 				// set the leading bit if the jump leads to a dead-end
-				if(jumpnode_id == warthog::INF32)
+				if(jumpnode_id == warthog::GRID_ID_MAX)
 				{
 					db_[mapid*8 + i] |= 32768;
 				}
@@ -126,9 +126,12 @@ public:
     }
     else c.deactivate();
   }
-  bool t_labelv, t_labelh; // store the original label before setting artificial obstacle
-  int t_mapid, t_rmapid;
+  // the scan in progress stops, as at an obstacle, this many steps from
+  // where it starts; UINT32_MAX unless a constraint is active
+  uint32_t scan_limit = UINT32_MAX;
   uint32_t jump_step;      // the step of previous cardinal scanning
+  // the search state of the locator this pruner belongs to
+  global::search_context* ctx = nullptr;
   cost_t jumpcost;         // the cost (step) of previous scanning
 
   void reset_constraints() {
@@ -163,45 +166,42 @@ public:
   }
 
   /*
-   * before scan: if the constraint is active, set temp obstacle based on jlimt
+   * before scan: if the constraint is active, the scan ends at a temp
+   * obstacle based on jlimt. the obstacle is not written to the map: it is
+   * in the scanned row, where it can only end the scan, so the scan is
+   * limited instead (see online_jump_point_locator2_prune2::__jump_east)
    */
-  inline void before_scanv(gridmap* rmap, int rmapid, int direct) {
+  inline void before_scanv() {
     if (v.i>0) {
-      t_rmapid = rmapid + direct * (v.jlimt() + 1);
-      assert(t_rmapid >= 0);
-      t_labelv = rmap->get_label(t_rmapid);
-      rmap->set_label(t_rmapid, false);
+      scan_limit = (uint32_t)(v.jlimt() + 1);
     }
   }
 
-  inline void before_scanh(gridmap* map, int mapid, int direct) {
+  inline void before_scanh() {
     if (h.i>0){
-      t_mapid = mapid + direct * (h.jlimt() + 1);
-      assert(t_mapid >= 0);
-      t_labelh = map->get_label(t_mapid);
-      map->set_label(t_mapid, false);
+      scan_limit = (uint32_t)(h.jlimt() + 1);
     }
   }
 
   /*
    * after scan:
    * 1. if the constraint is active: 
-   *  1.1 unset the temp obstacle;
+   *  1.1 lift the temp obstacle;
    *  1.2 try to resue the current constraint if we stop before hitting jlimit;
    * 2. update the constraint if we can have a stronger bound on node_id,
    *   e.g. it has a smaller gvalue due to the previous expansion;
    * return true if continue, false terminate the expansion
    */
-  inline bool after_scanv(gridmap* rmap, uint32_t node_id, 
-      uint32_t &jpid, cost_t& cost) {
+  inline bool after_scanv(grid_id_t node_id, 
+      grid_id_t &jpid, cost_t& cost) {
     if (v.i>0) { // the constraint is active
-      rmap->set_label(t_rmapid, t_labelv); // 1.1
+      scan_limit = UINT32_MAX; // 1.1
       if ((int)jump_step < v.jlimt()) {
         if (v.better_from_b(jump_step)) {
           int dy = v.i-1;
           int dx = v.d-v.i-jump_step;
-          update_constraint(v, dx, dy, (cost_t)jump_step, global::query::gval(node_id));
-          jpid = INF32;
+          update_constraint(v, dx, dy, (cost_t)jump_step, ctx->gval(node_id));
+          jpid = GRID_ID_MAX;
           if (v.dominated()) return false;
         }
         else { // the constraint is no longer applicable
@@ -211,24 +211,24 @@ public:
       }
     }
     else { // 2
-      cost_t gb = global::query::gval(node_id);
-      if (global::query::cur_diag_gval+cost > gb) {
-        setup(v, global::query::cur_diag_gval, gb, cost);
+      cost_t gb = ctx->gval(node_id);
+      if (ctx->cur_diag_gval+cost > gb) {
+        setup(v, ctx->cur_diag_gval, gb, cost);
       }
     }
     return true;
   }
 
-  inline bool after_scanh(gridmap* map, uint32_t node_id, 
-      uint32_t &jpid, cost_t& cost) {
+  inline bool after_scanh(grid_id_t node_id, 
+      grid_id_t &jpid, cost_t& cost) {
     if (h.i>0) {
-      map->set_label(t_mapid, t_labelh);
+      scan_limit = UINT32_MAX;
       if ((int)jump_step < h.jlimt()) {
         if (h.better_from_b(jump_step)) {
           int dy = h.i-1;
           int dx = h.d-h.i-jump_step;
-          update_constraint(h, dx, dy, (cost_t)jump_step, global::query::gval(node_id));
-          jpid = INF32;
+          update_constraint(h, dx, dy, (cost_t)jump_step, ctx->gval(node_id));
+          jpid = GRID_ID_MAX;
           if (h.dominated()) return false;
         }
         else {
@@ -238,9 +238,9 @@ public:
       }
     }
     else {
-      cost_t gb = global::query::gval(node_id);
-      if (global::query::cur_diag_gval+cost > gb) {
-        setup(h, global::query::cur_diag_gval, gb, cost);
+      cost_t gb = ctx->gval(node_id);
+      if (ctx->cur_diag_gval+cost > gb) {
+        setup(h, ctx->cur_diag_gval, gb, cost);
       }
     }
     return true;
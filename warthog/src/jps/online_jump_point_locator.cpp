@@ -1,44 +1,30 @@
 #include "gridmap.h"
+#include "global.h"
 #include "jps.h"
 #include "online_jump_point_locator.h"
 
 #include <cassert>
 #include <climits>
 
-warthog::online_jump_point_locator::online_jump_point_locator(warthog::gridmap* map)
-	: map_(map)//, jumplimit_(UINT32_MAX)
+warthog::online_jump_point_locator::online_jump_point_locator(
+		warthog::gridmap* map, warthog::gridmap* rmap)
+	: map_(map), owns_rmap_(rmap == 0)//, jumplimit_(UINT32_MAX)
 {
-	rmap_ = create_rmap();
+	rmap_ = owns_rmap_ ? warthog::jps::create_rmap(map_) : rmap;
 }
 
 warthog::online_jump_point_locator::~online_jump_point_locator()
 {
-	delete rmap_;
+	if(owns_rmap_) { delete rmap_; }
 }
 
-// create a copy of the grid map which is rotated by 90 degrees clockwise.
-// this version will be used when jumping North or South. 
-warthog::gridmap*
-warthog::online_jump_point_locator::create_rmap()
+void
+warthog::online_jump_point_locator::set_map(warthog::gridmap* map, warthog::gridmap* rmap)
 {
-	uint32_t maph = map_->header_height();
-	uint32_t mapw = map_->header_width();
-	uint32_t rmaph = mapw;
-	uint32_t rmapw = maph;
-	warthog::gridmap* rmap = new warthog::gridmap(rmaph, rmapw);
-
-	for(uint32_t x = 0; x < mapw; x++) 
-	{
-		for(uint32_t y = 0; y < maph; y++)
-		{
-			uint32_t label = map_->get_label(map_->to_padded_id(x, y));
-			uint32_t rx = ((rmapw-1) - y);
-			uint32_t ry = x;
-			uint32_t rid = rmap->to_padded_id(rx, ry);
-			rmap->set_label(rid, label);
-		}
-	}
-	return rmap;
+	if(owns_rmap_) { delete rmap_; }
+	map_ = map;
+	owns_rmap_ = rmap == 0;
+	rmap_ = owns_rmap_ ? warthog::jps::create_rmap(map_) : rmap;
 }
 
 
@@ -47,10 +33,10 @@ warthog::online_jump_point_locator::create_rmap()
 // search instance. If encountered, the goal node is always returned as a 
 // jump point successor.
 //
-// @return: the id of a jump point successor or warthog::INF32 if no jp exists.
+// @return: the id of a jump point successor or warthog::GRID_ID_MAX if no jp exists.
 void
 warthog::online_jump_point_locator::jump(warthog::jps::direction d,
-	   	uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
+	   	grid_id_t node_id, grid_id_t goal_id, grid_id_t& jumpnode_id, 
 		warthog::cost_t& jumpcost)
 {
 	switch(d)
@@ -85,8 +71,8 @@ warthog::online_jump_point_locator::jump(warthog::jps::direction d,
 }
 
 void
-warthog::online_jump_point_locator::jump_north(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+warthog::online_jump_point_locator::jump_north(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	node_id = this->map_id_to_rmap_id(node_id);
 	goal_id = this->map_id_to_rmap_id(goal_id);
@@ -95,8 +81,8 @@ warthog::online_jump_point_locator::jump_north(uint32_t node_id,
 }
 
 void
-warthog::online_jump_point_locator::__jump_north(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+warthog::online_jump_point_locator::__jump_north(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 		warthog::gridmap* mymap)
 {
 	// jumping north in the original map is the same as jumping
@@ -105,8 +91,8 @@ warthog::online_jump_point_locator::__jump_north(uint32_t node_id,
 }
 
 void
-warthog::online_jump_point_locator::jump_south(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+warthog::online_jump_point_locator::jump_south(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	node_id = this->map_id_to_rmap_id(node_id);
 	goal_id = this->map_id_to_rmap_id(goal_id);
@@ -115,8 +101,8 @@ warthog::online_jump_point_locator::jump_south(uint32_t node_id,
 }
 
 void
-warthog::online_jump_point_locator::__jump_south(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+warthog::online_jump_point_locator::__jump_south(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 		warthog::gridmap* mymap)
 {
 	// jumping north in the original map is the same as jumping
@@ -125,16 +111,16 @@ warthog::online_jump_point_locator::__jump_south(uint32_t node_id,
 }
 
 void
-warthog::online_jump_point_locator::jump_east(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+warthog::online_jump_point_locator::jump_east(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	__jump_east(node_id, goal_id, jumpnode_id, jumpcost, map_);
 }
 
 
 void
-warthog::online_jump_point_locator::__jump_east(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+warthog::online_jump_point_locator::__jump_east(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
 	jumpnode_id = node_id;
@@ -177,8 +163,8 @@ warthog::online_jump_point_locator::__jump_east(uint32_t node_id,
 		jumpnode_id += 31;
 	}
 
-	uint32_t num_steps = jumpnode_id - node_id;
-	uint32_t goal_dist = goal_id - node_id;
+	grid_id_t num_steps = jumpnode_id - node_id;
+	grid_id_t goal_dist = goal_id - node_id;
 	if(num_steps > goal_dist)
 	{
 		jumpnode_id = goal_id;
@@ -192,7 +178,7 @@ warthog::online_jump_point_locator::__jump_east(uint32_t node_id,
 		// correct here since we just inverted neis[1] and then
 		// looked for the first set bit. need -1 to fix it.
 		num_steps -= (1 && num_steps);
-		jumpnode_id = warthog::INF32;
+		jumpnode_id = warthog::GRID_ID_MAX;
 	}
 	jumpcost = num_steps ;
 	
@@ -200,15 +186,15 @@ warthog::online_jump_point_locator::__jump_east(uint32_t node_id,
 
 // analogous to ::jump_east 
 void
-warthog::online_jump_point_locator::jump_west(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+warthog::online_jump_point_locator::jump_west(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	__jump_west(node_id, goal_id, jumpnode_id, jumpcost, map_);
 }
 
 void
-warthog::online_jump_point_locator::__jump_west(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+warthog::online_jump_point_locator::__jump_west(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
 	bool deadend = false;
@@ -243,8 +229,8 @@ warthog::online_jump_point_locator::__jump_west(uint32_t node_id,
 	
 	}
 
-	uint32_t num_steps = node_id - jumpnode_id;
-	uint32_t goal_dist = node_id - goal_id;
+	grid_id_t num_steps = node_id - jumpnode_id;
+	grid_id_t goal_dist = node_id - goal_id;
 	if(num_steps > goal_dist)
 	{
 		jumpnode_id = goal_id;
@@ -258,49 +244,54 @@ warthog::online_jump_point_locator::__jump_west(uint32_t node_id,
 		// correct here since we just inverted neis[1] and then
 		// counted leading zeroes. need -1 to fix it.
 		num_steps -= (1 && num_steps);
-		jumpnode_id = warthog::INF32;
+		jumpnode_id = warthog::GRID_ID_MAX;
 	}
 	jumpcost = num_steps ;
 }
 
 void
-warthog::online_jump_point_locator::jump_northeast(uint32_t node_id,
-	   	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+warthog::online_jump_point_locator::jump_northeast(grid_id_t node_id,
+	   	grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t num_steps = 0;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. next_id at centre. Assume little endian format.
-	uint32_t next_id = node_id;
+	grid_id_t next_id = node_id;
 	uint32_t mapw = map_->width();
 
 	// early return if the first diagonal step is invalid
 	// (validity of subsequent steps is checked by straight jump functions)
 	uint32_t neis;
 	map_->get_neighbours(next_id, (uint8_t*)&neis);
-	if((neis & 1542) != 1542) { jumpnode_id = warthog::INF32; jumpcost=0; return; }
+	if((neis & 1542) != 1542) { jumpnode_id = warthog::GRID_ID_MAX; jumpcost=0; return; }
 
 	// jump a single step at a time (no corner cutting)
-	uint32_t rnext_id = map_id_to_rmap_id(next_id);
-	uint32_t rgoal_id = map_id_to_rmap_id(goal_id);
+	grid_id_t rnext_id = map_id_to_rmap_id(next_id);
+	grid_id_t rgoal_id = map_id_to_rmap_id(goal_id);
 	uint32_t rmapw = rmap_->width();
 	while(true)
 	{
 		num_steps++;
+		if(ctx_.stop_scan(num_steps))
+		{
+			next_id = warthog::GRID_ID_MAX;
+			break;
+		}
 		next_id = next_id - mapw + 1;
 		rnext_id = rnext_id + rmapw + 1;
 
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-		uint32_t jp_id1, jp_id2;
+		grid_id_t jp_id1, jp_id2;
         warthog::cost_t cost1, cost2;
 		__jump_north(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
-		if(jp_id1 != warthog::INF32) { break; }
+		if(jp_id1 != warthog::GRID_ID_MAX) { break; }
 		__jump_east(next_id, goal_id, jp_id2, cost2, map_);
-		if(jp_id2 != warthog::INF32) { break; }
+		if(jp_id2 != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
-		if(!((uint64_t)cost1 && (uint64_t)cost2)) { next_id = warthog::INF32; break; }
+		if(!((uint64_t)cost1 && (uint64_t)cost2)) { next_id = warthog::GRID_ID_MAX; break; }
 
 	}
 	jumpnode_id = next_id;
@@ -308,127 +299,142 @@ warthog::online_jump_point_locator::jump_northeast(uint32_t node_id,
 }
 
 void
-warthog::online_jump_point_locator::jump_northwest(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+warthog::online_jump_point_locator::jump_northwest(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t num_steps = 0;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. next_id at centre. Assume little endian format.
-	uint32_t next_id = node_id;
+	grid_id_t next_id = node_id;
 	uint32_t mapw = map_->width();
 
 	// early termination (invalid first step)
 	uint32_t neis;
 	map_->get_neighbours(next_id, (uint8_t*)&neis);
-	if((neis & 771) != 771) { jumpnode_id = warthog::INF32; jumpcost = 0; return; }
+	if((neis & 771) != 771) { jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return; }
 
 	// jump a single step at a time (no corner cutting)
-	uint32_t rnext_id = map_id_to_rmap_id(next_id);
-	uint32_t rgoal_id = map_id_to_rmap_id(goal_id);
+	grid_id_t rnext_id = map_id_to_rmap_id(next_id);
+	grid_id_t rgoal_id = map_id_to_rmap_id(goal_id);
 	uint32_t rmapw = rmap_->width();
 	while(true)
 	{
 		num_steps++;
+		if(ctx_.stop_scan(num_steps))
+		{
+			next_id = warthog::GRID_ID_MAX;
+			break;
+		}
 		next_id = next_id - mapw - 1;
 		rnext_id = rnext_id - (rmapw - 1);
 
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-		uint32_t jp_id1, jp_id2;
+		grid_id_t jp_id1, jp_id2;
         warthog::cost_t cost1, cost2;
 		__jump_north(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
-		if(jp_id1 != warthog::INF32) { break; }
+		if(jp_id1 != warthog::GRID_ID_MAX) { break; }
 		__jump_west(next_id, goal_id, jp_id2, cost2, map_);
-		if(jp_id2 != warthog::INF32) { break; }
+		if(jp_id2 != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
-		if(!((uint64_t)cost1 && (uint64_t)cost2)) { next_id = warthog::INF32; break; }
+		if(!((uint64_t)cost1 && (uint64_t)cost2)) { next_id = warthog::GRID_ID_MAX; break; }
 	}
 	jumpnode_id = next_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
 void
-warthog::online_jump_point_locator::jump_southeast(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+warthog::online_jump_point_locator::jump_southeast(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t num_steps = 0;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. next_id at centre. Assume little endian format.
-	uint32_t next_id = node_id;
+	grid_id_t next_id = node_id;
 	uint32_t mapw = map_->width();
 	
 	// early return if the first diagonal step is invalid
 	// (validity of subsequent steps is checked by straight jump functions)
 	uint32_t neis;
 	map_->get_neighbours(next_id, (uint8_t*)&neis);
-	if((neis & 394752) != 394752) { jumpnode_id = warthog::INF32; jumpcost = 0; return; }
+	if((neis & 394752) != 394752) { jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return; }
 
 	// jump a single step at a time (no corner cutting)
-	uint32_t rnext_id = map_id_to_rmap_id(next_id);
-	uint32_t rgoal_id = map_id_to_rmap_id(goal_id);
+	grid_id_t rnext_id = map_id_to_rmap_id(next_id);
+	grid_id_t rgoal_id = map_id_to_rmap_id(goal_id);
 	uint32_t rmapw = rmap_->width();
 	while(true)
 	{
 		num_steps++;
+		if(ctx_.stop_scan(num_steps))
+		{
+			next_id = warthog::GRID_ID_MAX;
+			break;
+		}
 		next_id = next_id + mapw + 1;
 		rnext_id = rnext_id + rmapw - 1;
 
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-		uint32_t jp_id1, jp_id2;
+		grid_id_t jp_id1, jp_id2;
         warthog::cost_t cost1, cost2;
 		__jump_south(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
-		if(jp_id1 != warthog::INF32) { break; }
+		if(jp_id1 != warthog::GRID_ID_MAX) { break; }
 		__jump_east(next_id, goal_id, jp_id2, cost2, map_);
-		if(jp_id2 != warthog::INF32) { break; }
+		if(jp_id2 != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
-		if(!((uint64_t)cost1 && (uint64_t)cost2)) { next_id = warthog::INF32; break; }
+		if(!((uint64_t)cost1 && (uint64_t)cost2)) { next_id = warthog::GRID_ID_MAX; break; }
 	}
 	jumpnode_id = next_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
 void
-warthog::online_jump_point_locator::jump_southwest(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+warthog::online_jump_point_locator::jump_southwest(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t num_steps = 0;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. next_id at centre. Assume little endian format.
 	uint32_t neis;
-	uint32_t next_id = node_id;
+	grid_id_t next_id = node_id;
 	uint32_t mapw = map_->width();
 
 	// early termination (first step is invalid)
 	map_->get_neighbours(next_id, (uint8_t*)&neis);
-	if((neis & 197376) != 197376) { jumpnode_id = warthog::INF32; jumpcost = 0; return; }
+	if((neis & 197376) != 197376) { jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return; }
 
 	// jump a single step (no corner cutting)
-	uint32_t rnext_id = map_id_to_rmap_id(next_id);
-	uint32_t rgoal_id = map_id_to_rmap_id(goal_id);
+	grid_id_t rnext_id = map_id_to_rmap_id(next_id);
+	grid_id_t rgoal_id = map_id_to_rmap_id(goal_id);
 	uint32_t rmapw = rmap_->width();
 	while(true)
 	{
 		num_steps++;
+		if(ctx_.stop_scan(num_steps))
+		{
+			next_id = warthog::GRID_ID_MAX;
+			break;
+		}
 		next_id = next_id + mapw - 1;
 		rnext_id = rnext_id - (rmapw + 1);
 
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-		uint32_t jp_id1, jp_id2;
+		grid_id_t jp_id1, jp_id2;
         warthog::cost_t cost1, cost2;
 		__jump_south(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
-		if(jp_id1 != warthog::INF32) { break; }
+		if(jp_id1 != warthog::GRID_ID_MAX) { break; }
 		__jump_west(next_id, goal_id, jp_id2, cost2, map_);
-		if(jp_id2 != warthog::INF32) { break; }
+		if(jp_id2 != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
-		if(!((uint64_t)cost1 && (uint64_t)cost2)) { next_id = warthog::INF32; break; }
+		if(!((uint64_t)cost1 && (uint64_t)cost2)) { next_id = warthog::GRID_ID_MAX; break; }
 	}
 	jumpnode_id = next_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
@@ -14,6 +14,7 @@
 // @created: 03/09/2012
 //
 
+#include "global.h"
 #include "jps.h"
 #include "gridmap.h"
 
@@ -23,69 +24,83 @@ namespace warthog
 class online_jump_point_locator 
 {
 	public: 
-		online_jump_point_locator(warthog::gridmap* map);
+		// @param rmap is a rotated copy of @param map (see
+		// warthog::jps::create_rmap); if not given the locator makes and
+		// owns its own
+		online_jump_point_locator(warthog::gridmap* map,
+				warthog::gridmap* rmap = 0);
 		~online_jump_point_locator();
 
+		// jump on @param map and its rotated copy @param rmap from now on.
+		// as in the constructor, rmap is not owned and is created if null
 		void
-		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		set_map(warthog::gridmap* map, warthog::gridmap* rmap = 0);
+
+		void
+		jump(warthog::jps::direction d, grid_id_t node_id, grid_id_t goalid, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 
 		size_t 
 		mem()
 		{
-			return sizeof(this) + rmap_->mem();
+			return sizeof(this) + (owns_rmap_ ? rmap_->mem() : 0);
 		}
 
+		// the state of the running search that the scans read (see
+		// global::search_context); bound by the expansion policy
+		inline global::search_context*
+		get_context() { return &ctx_; }
+
 	private:
 		void
-		jump_northwest(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		jump_northwest(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
-		jump_northeast(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		jump_northeast(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
-		jump_southwest(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		jump_southwest(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
-		jump_southeast(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		jump_southeast(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
-		jump_north(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		jump_north(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
-		jump_south(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		jump_south(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
-		jump_east(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		jump_east(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
-		jump_west(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		jump_west(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost);
 
 		// these versions can be passed a map parameter to
 		// use when jumping. they allow switching between
 		// map_ and rmap_ (a rotated counterpart).
 		void
-		__jump_east(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_east(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 		void
-		__jump_west(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_west(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 		void
-		__jump_north(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+		__jump_north(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 				warthog::gridmap* mymap);
 		void
-		__jump_south(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_south(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 
-		inline uint32_t
-		map_id_to_rmap_id(uint32_t mapid)
+		inline grid_id_t
+		map_id_to_rmap_id(grid_id_t mapid)
 		{
-			if(mapid == warthog::INF32) { return mapid; }
+			if(mapid == warthog::GRID_ID_MAX) { return mapid; }
 
 			uint32_t x, y;
 			uint32_t rx, ry;
@@ -95,10 +110,10 @@ class online_jump_point_locator
 			return rmap_->to_padded_id(rx, ry);
 		}
 
-		inline uint32_t
-		rmap_id_to_map_id(uint32_t rmapid)
+		inline grid_id_t
+		rmap_id_to_map_id(grid_id_t rmapid)
 		{
-			if(rmapid == warthog::INF32) { return rmapid; }
+			if(rmapid == warthog::GRID_ID_MAX) { return rmapid; }
 
 			uint32_t x, y;
 			uint32_t rx, ry;
@@ -108,12 +123,11 @@ class online_jump_point_locator
 			return map_->to_padded_id(x, y);
 		}
 
-		warthog::gridmap*
-		create_rmap();
-
 		warthog::gridmap* map_;
 		warthog::gridmap* rmap_;
+		bool owns_rmap_;
 		//uint32_t jumplimit_;
+		global::search_context ctx_;
 };
 
 }
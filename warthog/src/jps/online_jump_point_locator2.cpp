@@ -6,44 +6,28 @@
 #include <cassert>
 #include <climits>
 
-namespace G = global::statis;
 
 warthog::jps::online_jump_point_locator2::online_jump_point_locator2(
-        warthog::gridmap* map) : map_(map)//, jumplimit_(UINT32_MAX)
+        warthog::gridmap* map, warthog::gridmap* rmap)
+    : map_(map), owns_rmap_(rmap == 0)//, jumplimit_(UINT32_MAX)
 {
-	rmap_ = create_rmap();
-	current_node_id_ = current_rnode_id_ = warthog::INF32;
-	current_goal_id_ = current_rgoal_id_ = warthog::INF32;
+	rmap_ = owns_rmap_ ? warthog::jps::create_rmap(map_) : rmap;
+	current_node_id_ = current_rnode_id_ = warthog::GRID_ID_MAX;
+	current_goal_id_ = current_rgoal_id_ = warthog::GRID_ID_MAX;
 }
 
 warthog::jps::online_jump_point_locator2::~online_jump_point_locator2()
 {
-	delete rmap_;
+	if(owns_rmap_) { delete rmap_; }
 }
 
-// create a copy of the grid map which is rotated by 90 degrees clockwise.
-// this version will be used when jumping North or South. 
-warthog::gridmap*
-warthog::jps::online_jump_point_locator2::create_rmap()
+void
+warthog::jps::online_jump_point_locator2::set_map(warthog::gridmap* map, warthog::gridmap* rmap)
 {
-	uint32_t maph = map_->header_height();
-	uint32_t mapw = map_->header_width();
-	uint32_t rmaph = mapw;
-	uint32_t rmapw = maph;
-	warthog::gridmap* rmap = new warthog::gridmap(rmaph, rmapw);
-
-	for(uint32_t x = 0; x < mapw; x++) 
-	{
-		for(uint32_t y = 0; y < maph; y++)
-		{
-			uint32_t label = map_->get_label(map_->to_padded_id(x, y));
-			uint32_t rx = ((rmapw-1) - y);
-			uint32_t ry = x;
-			uint32_t rid = rmap->to_padded_id(rx, ry);
-			rmap->set_label(rid, label);
-		}
-	}
-	return rmap;
+	if(owns_rmap_) { delete rmap_; }
+	map_ = map;
+	owns_rmap_ = rmap == 0;
+	rmap_ = owns_rmap_ ? warthog::jps::create_rmap(map_) : rmap;
 }
 
 
@@ -55,8 +39,8 @@ warthog::jps::online_jump_point_locator2::create_rmap()
 // @return: the id of a jump point successor or warthog::INF if no jp exists.
 void
 warthog::jps::online_jump_point_locator2::jump(warthog::jps::direction d,
-	   	uint32_t node_id, uint32_t goal_id, 
-		std::vector<uint32_t>& jpoints,
+	   	grid_id_t node_id, grid_id_t goal_id, 
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
     __jump_east_fp = &warthog::jps::online_jump_point_locator2::__jump_east;
@@ -113,8 +97,8 @@ warthog::jps::online_jump_point_locator2::jump(warthog::jps::direction d,
 // @return: the id of a jump point successor or warthog::INF if no jp exists.
 void
 warthog::jps::online_jump_point_locator2::rjump(warthog::jps::direction d,
-	   	uint32_t node_id, uint32_t goal_id, 
-		std::vector<uint32_t>& jpoints,
+	   	grid_id_t node_id, grid_id_t goal_id, 
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
     __jump_east_fp = &warthog::jps::online_jump_point_locator2::__rjump_east;
@@ -166,19 +150,19 @@ warthog::jps::online_jump_point_locator2::rjump(warthog::jps::direction d,
 
 void
 warthog::jps::online_jump_point_locator2::jump_north(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
-	uint32_t jumpnode_id;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
+	grid_id_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
 	__jump_north(rnode_id, rgoal_id, jumpnode_id, jumpcost, rmap_);
 
-	if(jumpnode_id != warthog::INF32)
+	if(jumpnode_id != warthog::GRID_ID_MAX)
 	{
-		jumpnode_id = current_node_id_ - (uint32_t)(jumpcost) * map_->width();
+		jumpnode_id = current_node_id_ - (grid_id_t)(jumpcost) * map_->width();
 		//*(((uint8_t*)&jumpnode_id)+3) = warthog::jps::NORTH;
 		jpoints.push_back(jumpnode_id);
 		costs.push_back(jumpcost);
@@ -186,8 +170,8 @@ warthog::jps::online_jump_point_locator2::jump_north(
 }
 
 void
-warthog::jps::online_jump_point_locator2::__jump_north(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+warthog::jps::online_jump_point_locator2::__jump_north(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 		warthog::gridmap* mymap)
 {
 	// jumping north in the original map is the same as jumping
@@ -197,19 +181,19 @@ warthog::jps::online_jump_point_locator2::__jump_north(uint32_t node_id,
 
 void
 warthog::jps::online_jump_point_locator2::jump_south(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<grid_id_t>& jpoints, 
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
-	uint32_t jumpnode_id;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
+	grid_id_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
 	__jump_south(rnode_id, rgoal_id, jumpnode_id, jumpcost, rmap_);
 
-	if(jumpnode_id != warthog::INF32)
+	if(jumpnode_id != warthog::GRID_ID_MAX)
 	{
-		jumpnode_id = current_node_id_ + (uint32_t)(jumpcost ) * map_->width();
+		jumpnode_id = current_node_id_ + (grid_id_t)(jumpcost) * map_->width();
 		//*(((uint8_t*)&jumpnode_id)+3) = warthog::jps::SOUTH;
 		jpoints.push_back(jumpnode_id);
 		costs.push_back(jumpcost);
@@ -217,8 +201,8 @@ warthog::jps::online_jump_point_locator2::jump_south(
 }
 
 void
-warthog::jps::online_jump_point_locator2::__jump_south(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+warthog::jps::online_jump_point_locator2::__jump_south(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 		warthog::gridmap* mymap)
 {
 	// jumping north in the original map is the same as jumping
@@ -228,17 +212,17 @@ warthog::jps::online_jump_point_locator2::__jump_south(uint32_t node_id,
 
 void
 warthog::jps::online_jump_point_locator2::jump_east(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<grid_id_t>& jpoints, 
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t jumpnode_id;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
 	(this->*(__jump_east_fp))(node_id, goal_id, jumpnode_id, jumpcost, map_);
 
-	if(jumpnode_id != warthog::INF32)
+	if(jumpnode_id != warthog::GRID_ID_MAX)
 	{
 		//*(((uint8_t*)&jumpnode_id)+3) = warthog::jps::EAST;
 		jpoints.push_back(jumpnode_id);
@@ -248,8 +232,8 @@ warthog::jps::online_jump_point_locator2::jump_east(
 
 
 void
-warthog::jps::online_jump_point_locator2::__jump_east(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+warthog::jps::online_jump_point_locator2::__jump_east(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
 	jumpnode_id = node_id;
@@ -290,12 +274,15 @@ warthog::jps::online_jump_point_locator2::__jump_east(uint32_t node_id,
 		// Such a tile, followed by a non-obstacle tile, would yield a forced 
 		// neighbour that we don't want to miss.
 		jumpnode_id += 31;
+
+		// and from there past any strips of open ground in the summary
+		if(mymap->has_summary()) { jumpnode_id = mymap->skip_east(jumpnode_id); }
 	}
 
-	uint32_t num_steps = jumpnode_id - node_id;
-	uint32_t goal_dist = goal_id - node_id;
+	grid_id_t num_steps = jumpnode_id - node_id;
+	grid_id_t goal_dist = goal_id - node_id;
 #ifdef CNT
-  G::scan_cnt += (num_steps >> 5);
+  ctx_.scan_cnt += (num_steps >> 5);
 #endif
 	if(num_steps > goal_dist)
 	{
@@ -310,15 +297,15 @@ warthog::jps::online_jump_point_locator2::__jump_east(uint32_t node_id,
 		// correct here since we just inverted neis[1] and then
 		// looked for the first set bit. need -1 to fix it.
 		num_steps -= (1 && num_steps);
-		jumpnode_id = warthog::INF32;
+		jumpnode_id = warthog::GRID_ID_MAX;
 	}
 	jumpcost = num_steps ;
 	
 }
 
 void
-warthog::jps::online_jump_point_locator2::__rjump_east(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+warthog::jps::online_jump_point_locator2::__rjump_east(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
 	jumpnode_id = node_id;
@@ -363,12 +350,15 @@ warthog::jps::online_jump_point_locator2::__rjump_east(uint32_t node_id,
 		// Such a tile, followed by a non-obstacle tile, would yield a forced 
 		// neighbour that we don't want to miss.
 		jumpnode_id += 31;
+
+		// and from there past any strips of open ground in the summary
+		if(mymap->has_summary()) { jumpnode_id = mymap->skip_east(jumpnode_id); }
 	}
 
-	uint32_t num_steps = jumpnode_id - node_id;
-	uint32_t goal_dist = goal_id - node_id;
+	grid_id_t num_steps = jumpnode_id - node_id;
+	grid_id_t goal_dist = goal_id - node_id;
 #ifdef CNT
-  G::scan_cnt += (num_steps >> 5);
+  ctx_.scan_cnt += (num_steps >> 5);
 #endif
 	if(num_steps > goal_dist)
 	{
@@ -384,7 +374,7 @@ warthog::jps::online_jump_point_locator2::__rjump_east(uint32_t node_id,
 		// looked for the first set bit. need -1 to fix it.
 		num_steps -= (1 && num_steps);
         //num_steps++; // fix sideeffect of previous hacky fix
-		jumpnode_id = warthog::INF32;
+		jumpnode_id = warthog::GRID_ID_MAX;
 	}
 	jumpcost = num_steps ;
 	
@@ -393,17 +383,17 @@ warthog::jps::online_jump_point_locator2::__rjump_east(uint32_t node_id,
 // analogous to ::jump_east 
 void
 warthog::jps::online_jump_point_locator2::jump_west(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<grid_id_t>& jpoints, 
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t jumpnode_id;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
 	(this->*(__jump_west_fp))(node_id, goal_id, jumpnode_id, jumpcost, map_);
 
-	if(jumpnode_id != warthog::INF32)
+	if(jumpnode_id != warthog::GRID_ID_MAX)
 	{
 		//*(((uint8_t*)&jumpnode_id)+3) = warthog::jps::WEST;
 		jpoints.push_back(jumpnode_id);
@@ -412,8 +402,8 @@ warthog::jps::online_jump_point_locator2::jump_west(
 }
 
 void
-warthog::jps::online_jump_point_locator2::__jump_west(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+warthog::jps::online_jump_point_locator2::__jump_west(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
 	bool deadend = false;
@@ -445,11 +435,14 @@ warthog::jps::online_jump_point_locator2::__jump_west(uint32_t node_id,
 		// jump to the end of cache. jumping +32 involves checking
 		// for forced neis between adjacent sets of contiguous tiles
 		jumpnode_id -= 31;
+
+		// and from there past any strips of open ground in the summary
+		if(mymap->has_summary()) { jumpnode_id = mymap->skip_west(jumpnode_id); }
 	
 	}
 
-	uint32_t num_steps = node_id - jumpnode_id;
-	uint32_t goal_dist = node_id - goal_id;
+	grid_id_t num_steps = node_id - jumpnode_id;
+	grid_id_t goal_dist = node_id - goal_id;
 	if(num_steps > goal_dist)
 	{
 		jumpnode_id = goal_id;
@@ -463,14 +456,14 @@ warthog::jps::online_jump_point_locator2::__jump_west(uint32_t node_id,
 		// correct here since we just inverted neis[1] and then
 		// counted leading zeroes. need -1 to fix it.
 		num_steps -= (1 && num_steps);
-		jumpnode_id = warthog::INF32;
+		jumpnode_id = warthog::GRID_ID_MAX;
 	}
 	jumpcost = num_steps ;
 }
 
 void
-warthog::jps::online_jump_point_locator2::__rjump_west(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+warthog::jps::online_jump_point_locator2::__rjump_west(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
 	bool deadend = false;
@@ -505,10 +498,13 @@ warthog::jps::online_jump_point_locator2::__rjump_west(uint32_t node_id,
 		// jump to the end of cache. jumping +32 involves checking
 		// for forced neis between adjacent sets of contiguous tiles
 		jumpnode_id -= 31;
+
+		// and from there past any strips of open ground in the summary
+		if(mymap->has_summary()) { jumpnode_id = mymap->skip_west(jumpnode_id); }
 	}
 
-	uint32_t num_steps = node_id - jumpnode_id;
-	uint32_t goal_dist = node_id - goal_id;
+	grid_id_t num_steps = node_id - jumpnode_id;
+	grid_id_t goal_dist = node_id - goal_id;
 	if(num_steps > goal_dist)
 	{
 		jumpnode_id = goal_id;
@@ -523,25 +519,25 @@ warthog::jps::online_jump_point_locator2::__rjump_west(uint32_t node_id,
 		// counted leading zeroes. need -1 to fix it.
 		num_steps -= (1 && num_steps);
         //num_steps++;  // fix sideeffect of hacky fix
-		jumpnode_id = warthog::INF32;
+		jumpnode_id = warthog::GRID_ID_MAX;
 	}
 	jumpcost = num_steps ;
 }
 
 void
 warthog::jps::online_jump_point_locator2::jump_northeast(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t jumpnode_id, jp1_id, jp2_id;
+	grid_id_t jumpnode_id, jp1_id, jp2_id;
 	warthog::cost_t jumpcost, jp1_cost, jp2_cost, cost_to_nodeid;
 	jumpnode_id = jp1_id = jp2_id = 0;
 	jumpcost = jp1_cost = jp2_cost = cost_to_nodeid = 0;
 
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. node_id at centre. Assume little endian format.
@@ -552,7 +548,7 @@ warthog::jps::online_jump_point_locator2::jump_northeast(
 	// (validity of subsequent steps is checked by straight jump functions)
 	if((neis & 1542) != 1542) { return; }
 
-	while(node_id != warthog::INF32)
+	while(node_id != warthog::GRID_ID_MAX)
 	{
 		__jump_northeast(
 				node_id, rnode_id,
@@ -560,16 +556,16 @@ warthog::jps::online_jump_point_locator2::jump_northeast(
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
 				jp2_id, jp2_cost);
 
-		if(jp1_id != warthog::INF32)
+		if(jp1_id != warthog::GRID_ID_MAX)
 		{
-			jp1_id = node_id - (uint32_t)(jp1_cost ) * map_->width();
+			jp1_id = node_id - (grid_id_t)(jp1_cost) * map_->width();
 			//*(((uint8_t*)&jp1_id)+3) = warthog::jps::NORTH;
 			jpoints.push_back(jp1_id);
 			costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
-		if(jp2_id != warthog::INF32)
+		if(jp2_id != warthog::GRID_ID_MAX)
 		{
 			//*(((uint8_t*)&jp2_id)+3) = warthog::jps::EAST;
 			jpoints.push_back(jp2_id);
@@ -583,12 +579,19 @@ warthog::jps::online_jump_point_locator2::jump_northeast(
 
 void
 warthog::jps::online_jump_point_locator2::__jump_northeast(
-		uint32_t& node_id, uint32_t& rnode_id, 
-		uint32_t goal_id, uint32_t rgoal_id,
-		uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
-		uint32_t& jp_id1, warthog::cost_t& cost1,
-		uint32_t& jp_id2, warthog::cost_t& cost2)
+		grid_id_t& node_id, grid_id_t& rnode_id, 
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		grid_id_t& jp_id1, warthog::cost_t& cost1,
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
 {
+	if(sheared_scans())
+	{
+		__jump_diagonal(1, -1, node_id, rnode_id, goal_id, rgoal_id,
+				jumpnode_id, jumpcost, jp_id1, cost1, jp_id2, cost2);
+		return;
+	}
+
 	uint32_t num_steps = 0;
 
 	// jump a single step at a time (no corner cutting)
@@ -597,6 +600,11 @@ warthog::jps::online_jump_point_locator2::__jump_northeast(
 	while(true)
 	{
 		num_steps++;
+		if(ctx_.stop_scan(num_steps))
+		{
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
+			break;
+		}
 		node_id = node_id - mapw + 1;
 		rnode_id = rnode_id + rmapw + 1;
 
@@ -604,18 +612,18 @@ warthog::jps::online_jump_point_locator2::__jump_northeast(
 		// (ensures we do not miss any optimal turning points)
 		__jump_north(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
 		(this->*(__jump_east_fp))(node_id, goal_id, jp_id2, cost2, map_);
-		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
+		if((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in a straight dir; next step is an obstacle
 		if(!((uint64_t)cost1 && (uint64_t)cost2)) 
 		{ 
-			node_id = jp_id1 = jp_id2 = warthog::INF32; 
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX; 
 			break; 
 		}
 
 	}
 #ifdef CNT
-  G::scan_cnt += num_steps;
+  ctx_.scan_cnt += num_steps;
 #endif
 	jumpnode_id = node_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
@@ -623,18 +631,18 @@ warthog::jps::online_jump_point_locator2::__jump_northeast(
 
 void
 warthog::jps::online_jump_point_locator2::jump_northwest(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t jumpnode_id, jp1_id, jp2_id;
+	grid_id_t jumpnode_id, jp1_id, jp2_id;
 	warthog::cost_t jumpcost, jp1_cost, jp2_cost, cost_to_nodeid;
 	jumpnode_id = jp1_id = jp2_id = 0;
 	jumpcost = jp1_cost = jp2_cost = cost_to_nodeid = 0;
 
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. node_id at centre. Assume little endian format.
@@ -645,7 +653,7 @@ warthog::jps::online_jump_point_locator2::jump_northwest(
 	// (validity of subsequent steps is checked by straight jump functions)
 	if((neis & 771) != 771) { return; }
 
-	while(node_id != warthog::INF32)
+	while(node_id != warthog::GRID_ID_MAX)
 	{
 		__jump_northwest(
 				node_id, rnode_id,
@@ -653,16 +661,16 @@ warthog::jps::online_jump_point_locator2::jump_northwest(
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
 				jp2_id, jp2_cost);
 
-		if(jp1_id != warthog::INF32)
+		if(jp1_id != warthog::GRID_ID_MAX)
 		{
-			jp1_id = node_id - (uint32_t)(jp1_cost ) * map_->width();
+			jp1_id = node_id - (grid_id_t)(jp1_cost) * map_->width();
 			//*(((uint8_t*)&jp1_id)+3) = warthog::jps::NORTH;
 			jpoints.push_back(jp1_id);
 			costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
-		if(jp2_id != warthog::INF32)
+		if(jp2_id != warthog::GRID_ID_MAX)
 		{
 			//*(((uint8_t*)&jp2_id)+3) = warthog::jps::WEST;
 			jpoints.push_back(jp2_id);
@@ -676,13 +684,20 @@ warthog::jps::online_jump_point_locator2::jump_northwest(
 
 void
 warthog::jps::online_jump_point_locator2::__jump_northwest(
-		uint32_t& node_id, uint32_t& rnode_id, 
-		uint32_t goal_id, uint32_t rgoal_id,
-		uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-		uint32_t& jp_id1, warthog::cost_t& cost1, 
-		uint32_t& jp_id2, warthog::cost_t& cost2)
+		grid_id_t& node_id, grid_id_t& rnode_id, 
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+		grid_id_t& jp_id1, warthog::cost_t& cost1, 
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
 
 {
+	if(sheared_scans())
+	{
+		__jump_diagonal(-1, -1, node_id, rnode_id, goal_id, rgoal_id,
+				jumpnode_id, jumpcost, jp_id1, cost1, jp_id2, cost2);
+		return;
+	}
+
 	uint32_t num_steps = 0;
 
 	// jump a single step at a time (no corner cutting)
@@ -691,6 +706,11 @@ warthog::jps::online_jump_point_locator2::__jump_northwest(
 	while(true)
 	{
 		num_steps++;
+		if(ctx_.stop_scan(num_steps))
+		{
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
+			break;
+		}
 		node_id = node_id - mapw - 1;
 		rnode_id = rnode_id - (rmapw - 1);
 
@@ -698,17 +718,17 @@ warthog::jps::online_jump_point_locator2::__jump_northwest(
 		// (ensures we do not miss any optimal turning points)
 		__jump_north(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
 		(this->*(__jump_west_fp))(node_id, goal_id, jp_id2, cost2, map_);
-		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
+		if((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in a straight dir; next step is an obstacle
 		if(!((uint64_t)cost1 && (uint64_t)cost2)) 
 		{ 
-			node_id = jp_id1 = jp_id2 = warthog::INF32;
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
 		   	break; 
 		}
 	}
 #ifdef CNT
-  G::scan_cnt += num_steps;
+  ctx_.scan_cnt += num_steps;
 #endif
 	jumpnode_id = node_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
@@ -716,18 +736,18 @@ warthog::jps::online_jump_point_locator2::__jump_northwest(
 
 void
 warthog::jps::online_jump_point_locator2::jump_southeast(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t jumpnode_id, jp1_id, jp2_id;
+	grid_id_t jumpnode_id, jp1_id, jp2_id;
 	warthog::cost_t jumpcost, jp1_cost, jp2_cost, cost_to_nodeid;
 	jumpnode_id = jp1_id = jp2_id = 0;
 	jumpcost = jp1_cost = jp2_cost = cost_to_nodeid = 0;
 
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. next_id at centre. Assume little endian format.
@@ -738,7 +758,7 @@ warthog::jps::online_jump_point_locator2::jump_southeast(
 	// (validity of subsequent steps is checked by straight jump functions)
 	if((neis & 394752) != 394752) { return; }
 
-	while(node_id != warthog::INF32)
+	while(node_id != warthog::GRID_ID_MAX)
 	{
 		__jump_southeast(
 				node_id, rnode_id,
@@ -746,16 +766,16 @@ warthog::jps::online_jump_point_locator2::jump_southeast(
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
 				jp2_id, jp2_cost);
 
-		if(jp1_id != warthog::INF32)
+		if(jp1_id != warthog::GRID_ID_MAX)
 		{
-			jp1_id = node_id + (uint32_t)(jp1_cost ) * map_->width();
+			jp1_id = node_id + (grid_id_t)(jp1_cost) * map_->width();
 			//*(((uint8_t*)&jp1_id)+3) = warthog::jps::SOUTH;
 			jpoints.push_back(jp1_id);
 			costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
-		if(jp2_id != warthog::INF32)
+		if(jp2_id != warthog::GRID_ID_MAX)
 		{
 			//*(((uint8_t*)&jp2_id)+3) = warthog::jps::EAST;
 			jpoints.push_back(jp2_id);
@@ -769,13 +789,20 @@ warthog::jps::online_jump_point_locator2::jump_southeast(
 
 void
 warthog::jps::online_jump_point_locator2::__jump_southeast(
-		uint32_t& node_id, uint32_t& rnode_id, 
-		uint32_t goal_id, uint32_t rgoal_id,
-		uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-		uint32_t& jp_id1, warthog::cost_t& cost1, 
-		uint32_t& jp_id2, warthog::cost_t& cost2)
+		grid_id_t& node_id, grid_id_t& rnode_id, 
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+		grid_id_t& jp_id1, warthog::cost_t& cost1, 
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
 
 {
+	if(sheared_scans())
+	{
+		__jump_diagonal(1, 1, node_id, rnode_id, goal_id, rgoal_id,
+				jumpnode_id, jumpcost, jp_id1, cost1, jp_id2, cost2);
+		return;
+	}
+
 	uint32_t num_steps = 0;
 
 	// jump a single step at a time (no corner cutting)
@@ -784,6 +811,11 @@ warthog::jps::online_jump_point_locator2::__jump_southeast(
 	while(true)
 	{
 		num_steps++;
+		if(ctx_.stop_scan(num_steps))
+		{
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
+			break;
+		}
 		node_id = node_id + mapw + 1;
 		rnode_id = rnode_id + rmapw - 1;
 
@@ -791,17 +823,17 @@ warthog::jps::online_jump_point_locator2::__jump_southeast(
 		// (ensures we do not miss any optimal turning points)
 		__jump_south(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
 		(this->*(__jump_east_fp))(node_id, goal_id, jp_id2, cost2, map_);
-		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
+		if((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in a straight dir; next step is an obstacle
 		if(!((uint64_t)cost1 && (uint64_t)cost2)) 
 		{ 
-			node_id = jp_id1 = jp_id2 = warthog::INF32; 
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX; 
 			break; 
 		}
 	}
 #ifdef CNT
-  G::scan_cnt += num_steps;
+  ctx_.scan_cnt += num_steps;
 #endif
 	jumpnode_id = node_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
@@ -809,18 +841,18 @@ warthog::jps::online_jump_point_locator2::__jump_southeast(
 
 void
 warthog::jps::online_jump_point_locator2::jump_southwest(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t jumpnode_id, jp1_id, jp2_id;
+	grid_id_t jumpnode_id, jp1_id, jp2_id;
 	warthog::cost_t jumpcost, jp1_cost, jp2_cost, cost_to_nodeid;
 	jumpnode_id = jp1_id = jp2_id = 0;
 	jumpcost = jp1_cost = jp2_cost = cost_to_nodeid = 0;
 
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
 	
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. next_id at centre. Assume little endian format.
@@ -830,7 +862,7 @@ warthog::jps::online_jump_point_locator2::jump_southwest(
 	// early termination (first step is invalid)
 	if((neis & 197376) != 197376) { return; }
 
-	while(node_id != warthog::INF32)
+	while(node_id != warthog::GRID_ID_MAX)
 	{
 		__jump_southwest(
 				node_id, rnode_id,
@@ -838,16 +870,16 @@ warthog::jps::online_jump_point_locator2::jump_southwest(
 				jumpnode_id, jumpcost, 
 				jp1_id, jp1_cost, jp2_id, jp2_cost);
 
-		if(jp1_id != warthog::INF32)
+		if(jp1_id != warthog::GRID_ID_MAX)
 		{
-			jp1_id = node_id + (uint32_t)(jp1_cost ) * map_->width();
+			jp1_id = node_id + (grid_id_t)(jp1_cost) * map_->width();
 			//*(((uint8_t*)&jp1_id)+3) = warthog::jps::SOUTH;
 			jpoints.push_back(jp1_id);
 			costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
 			if(jp2_cost == 0) { break; }
 		}
 
-		if(jp2_id != warthog::INF32)
+		if(jp2_id != warthog::GRID_ID_MAX)
 		{
 			//*(((uint8_t*)&jp2_id)+3) = warthog::jps::WEST;
 			jpoints.push_back(jp2_id);
@@ -861,12 +893,19 @@ warthog::jps::online_jump_point_locator2::jump_southwest(
 
 void
 warthog::jps::online_jump_point_locator2::__jump_southwest(
-		uint32_t& node_id, uint32_t& rnode_id, 
-		uint32_t goal_id, uint32_t rgoal_id,
-		uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-		uint32_t& jp_id1, warthog::cost_t& cost1, 
-		uint32_t& jp_id2, warthog::cost_t& cost2)
+		grid_id_t& node_id, grid_id_t& rnode_id, 
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+		grid_id_t& jp_id1, warthog::cost_t& cost1, 
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
 {
+	if(sheared_scans())
+	{
+		__jump_diagonal(-1, 1, node_id, rnode_id, goal_id, rgoal_id,
+				jumpnode_id, jumpcost, jp_id1, cost1, jp_id2, cost2);
+		return;
+	}
+
 	// jump a single step (no corner cutting)
 	uint32_t num_steps = 0;
 	uint32_t mapw = map_->width();
@@ -874,6 +913,11 @@ warthog::jps::online_jump_point_locator2::__jump_southwest(
 	while(true)
 	{
 		num_steps++;
+		if(ctx_.stop_scan(num_steps))
+		{
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
+			break;
+		}
 		node_id = node_id + mapw - 1;
 		rnode_id = rnode_id - (rmapw + 1);
 
@@ -881,18 +925,94 @@ warthog::jps::online_jump_point_locator2::__jump_southwest(
 		// (ensures we do not miss any optimal turning points)
 		__jump_south(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
 		(this->*(__jump_west_fp))(node_id, goal_id, jp_id2, cost2, map_);
-		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
+		if((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in a straight dir; next step is an obstacle
 		if(!((uint64_t)cost1 && (uint64_t)cost2)) 
 		{ 
-			node_id = jp_id1 = jp_id2 = warthog::INF32;
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
 		   	break; 
 		}
 	}
 #ifdef CNT
-  G::scan_cnt += num_steps;
+  ctx_.scan_cnt += num_steps;
 #endif
 	jumpnode_id = node_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
+
+void
+warthog::jps::online_jump_point_locator2::__jump_diagonal(
+		int32_t dx, int32_t dy,
+		grid_id_t& node_id, grid_id_t& rnode_id,
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+		grid_id_t& jp_id1, warthog::cost_t& cost1,
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
+{
+	// the diagonal is free for this many steps
+	uint32_t run = map_->diagonal_run(node_id, dx, dy);
+
+	uint32_t x, y, rx, ry, gx, gy, rgx, rgy;
+	map_->to_padded_xy(node_id, x, y);
+	map_->to_padded_xy(goal_id, gx, gy);
+	rmap_->to_padded_xy(rnode_id, rx, ry);
+	rmap_->to_padded_xy(rgoal_id, rgx, rgy);
+
+	uint32_t mapw = map_->width();
+	uint32_t rmapw = rmap_->width();
+	uint32_t num_steps = 0;
+	while(true)
+	{
+		num_steps++;
+		if(num_steps > run || ctx_.stop_scan(num_steps))
+		{
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
+			break;
+		}
+		x += dx; y += dy;
+		rx -= dy; ry += dx;
+		node_id = (grid_id_t)y * mapw + x;
+		rnode_id = (grid_id_t)ry * rmapw + rx;
+
+		// only scan where a forced neighbour or the goal lies ahead (or
+		// here, on the diagonal); the other scans would find nothing. the last step scans regardless,
+		// since the caller reads from the costs which way the diagonal is
+		// blocked (before then both ways are open)
+		bool last = num_steps == run;
+		jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
+		cost1 = cost2 = 1;
+
+		// north and south are east and west on the rotated map
+		if(dy < 0 && (last || rmap_->last_forced_east(ry) > rx ||
+					(rgy == ry && rgx >= rx)))
+		{
+			__jump_north(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
+		}
+		else if(dy > 0 && (last || rmap_->first_forced_west(ry) < rx ||
+					(rgy == ry && rgx <= rx)))
+		{
+			__jump_south(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
+		}
+
+		if(dx > 0 && (last || map_->last_forced_east(y) > x ||
+					(gy == y && gx >= x)))
+		{
+			(this->*(__jump_east_fp))(node_id, goal_id, jp_id2, cost2, map_);
+		}
+		else if(dx < 0 && (last || map_->first_forced_west(y) < x ||
+					(gy == y && gx <= x)))
+		{
+			(this->*(__jump_west_fp))(node_id, goal_id, jp_id2, cost2, map_);
+		}
+
+		if((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) { break; }
+		if(!(cost1 && cost2))
+		{
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX;
+			break;
+		}
+	}
+	jumpnode_id = node_id;
+	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
+}
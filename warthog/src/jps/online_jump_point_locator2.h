@@ -14,6 +14,7 @@
 // @created: 03/09/2012
 //
 
+#include "global.h"
 #include "jps.h"
 #include <vector>
 #include "gridmap.h"
@@ -27,82 +28,96 @@ namespace jps
 class online_jump_point_locator2
 {
 	public: 
-		online_jump_point_locator2(warthog::gridmap* map);
+		// @param rmap is a rotated copy of @param map (see
+		// warthog::jps::create_rmap); if not given the locator makes and
+		// owns its own
+		online_jump_point_locator2(warthog::gridmap* map,
+				warthog::gridmap* rmap = 0);
 		~online_jump_point_locator2();
 
+		// jump on @param map and its rotated copy @param rmap from now on.
+		// as in the constructor, rmap is not owned and is created if null
 		void
-		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
-				std::vector<uint32_t>& jpoints,
+		set_map(warthog::gridmap* map, warthog::gridmap* rmap = 0);
+
+		void
+		jump(warthog::jps::direction d, grid_id_t node_id, grid_id_t goalid, 
+				std::vector<grid_id_t>& jpoints,
 				std::vector<warthog::cost_t>& costs);
 
         // similar to ::jump but assuming the parent is in the opposite 
         // direction to @param d
 		void
-		rjump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
-				std::vector<uint32_t>& jpoints,
+		rjump(warthog::jps::direction d, grid_id_t node_id, grid_id_t goalid, 
+				std::vector<grid_id_t>& jpoints,
 				std::vector<warthog::cost_t>& costs);
 
 		size_t 
 		mem()
 		{
-			return sizeof(this) + rmap_->mem();
+			return sizeof(this) + (owns_rmap_ ? rmap_->mem() : 0);
 		}
 
     inline warthog::gridmap* get_rmap() { return rmap_; }
     inline warthog::gridmap* get_map() { return map_; }
 
+		// the state of the running search that the scans read (see
+		// global::search_context); bound by the expansion policy
+		inline global::search_context*
+		get_context() { return &ctx_; }
+
 	private:
 		void
 		jump_north(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_south(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_east(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_west(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_northeast(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_northwest(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_southeast(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_southwest(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 
 		// these versions can be passed a map parameter to
 		// use when jumping. they allow switching between
 		// map_ and rmap_ (a rotated counterpart).
 		void
-		__jump_north(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+		__jump_north(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 				warthog::gridmap* mymap);
 		void
-		__jump_south(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_south(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 		void
-		__jump_east(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_east(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 		void
-		__jump_west(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_west(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 
 		// these versions perform a single diagonal jump, returning
@@ -110,51 +125,73 @@ class online_jump_point_locator2
 		// jump points that caused the jumping process to stop
 		void
 		__jump_northeast(
-				uint32_t& node_id, uint32_t& rnode_id, 
-				uint32_t goal_id, uint32_t rgoal_id,
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
-				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+				grid_id_t& node_id, grid_id_t& rnode_id, 
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
 		void
 		__jump_northwest(
-				uint32_t& node_id, uint32_t& rnode_id, 
-				uint32_t goal_id, uint32_t rgoal_id,
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
-				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+				grid_id_t& node_id, grid_id_t& rnode_id, 
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
 		void
 		__jump_southeast(
-				uint32_t& node_id, uint32_t& rnode_id, 
-				uint32_t goal_id, uint32_t rgoal_id,
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
-				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+				grid_id_t& node_id, grid_id_t& rnode_id, 
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
 		void
 		__jump_southwest(
-				uint32_t& node_id, uint32_t& rnode_id, 
-				uint32_t goal_id, uint32_t rgoal_id,
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
-				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+				grid_id_t& node_id, grid_id_t& rnode_id, 
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
+
+		// a diagonal jump in direction (@param dx, @param dy) for maps
+		// with diagonals (see warthog::gridmap::enable_diagonals): the
+		// length of the diagonal comes from the sheared copies of the map,
+		// and straight scans are only made from the steps where the
+		// summaries of the map and rmap say one could stop at a jump point
+		void
+		__jump_diagonal(int32_t dx, int32_t dy,
+				grid_id_t& node_id, grid_id_t& rnode_id,
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
+
+		// the bounds on forced neighbours only hold for forward jumps
+		inline bool
+		sheared_scans()
+		{
+			return map_->has_diagonals() && rmap_->has_summary() &&
+				__jump_east_fp ==
+					&warthog::jps::online_jump_point_locator2::__jump_east;
+		}
 
         // these jump functions assume the parent is in
         // the opposite direction to the jump direction
 		void
-		__rjump_east(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__rjump_east(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 
 		void
-		__rjump_west(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__rjump_west(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 
 
 		// functions to convert map indexes to rmap indexes
-		inline uint32_t
-		map_id_to_rmap_id(uint32_t mapid)
+		inline grid_id_t
+		map_id_to_rmap_id(grid_id_t mapid)
 		{
-            if(mapid == warthog::INF32) { return mapid; }
+            if(mapid == warthog::GRID_ID_MAX) { return mapid; }
 
 			uint32_t x, y;
 			uint32_t rx, ry;
@@ -165,10 +202,10 @@ class online_jump_point_locator2
 		}
 
 		// convert rmap indexes to map indexes
-		inline uint32_t
-		rmap_id_to_map_id(uint32_t rmapid)
+		inline grid_id_t
+		rmap_id_to_map_id(grid_id_t rmapid)
 		{
-            if(rmapid == warthog::INF32) { return rmapid; }
+            if(rmapid == warthog::GRID_ID_MAX) { return rmapid; }
 
 			uint32_t x, y;
 			uint32_t rx, ry;
@@ -178,26 +215,25 @@ class online_jump_point_locator2
 			return map_->to_padded_id(x, y);
 		}
 
-		warthog::gridmap*
-		create_rmap();
-
 		warthog::gridmap* map_;
 		warthog::gridmap* rmap_;
+		bool owns_rmap_;
 		//uint32_t jumplimit_;
+		global::search_context ctx_;
 
-		uint32_t current_goal_id_;
-		uint32_t current_rgoal_id_;
-		uint32_t current_node_id_;
-		uint32_t current_rnode_id_;
+		grid_id_t current_goal_id_;
+		grid_id_t current_rgoal_id_;
+		grid_id_t current_node_id_;
+		grid_id_t current_rnode_id_;
 
         // these function pointers allow us to switch between forward jumping
         // and backward jumping (i.e. with the parent direction reversed)
         void (warthog::jps::online_jump_point_locator2::*__jump_east_fp)
-            (uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
+            (grid_id_t node_id, grid_id_t goal_id, grid_id_t& jumpnode_id, 
              warthog::cost_t& jumpcost, warthog::gridmap* mymap);
 
         void (warthog::jps::online_jump_point_locator2::*__jump_west_fp)
-            (uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
+            (grid_id_t node_id, grid_id_t goal_id, grid_id_t& jumpnode_id, 
              warthog::cost_t& jumpcost, warthog::gridmap* mymap);
 
 };
@@ -7,48 +7,32 @@
 #include <climits>
 
 typedef warthog::online_jump_point_locator2_prune2 jlp;
-namespace G = global::query;
-namespace S = global::statis;
 
 jlp::online_jump_point_locator2_prune2(
 gridmap* map,
-online_jps_pruner2* pruner)
-	: map_(map)//, jumplimit_(UINT32_MAX)
+online_jps_pruner2* pruner,
+gridmap* rmap)
+	: map_(map), owns_rmap_(rmap == 0)//, jumplimit_(UINT32_MAX)
 {
-	rmap_ = create_rmap();
+	rmap_ = owns_rmap_ ? warthog::jps::create_rmap(map_) : rmap;
   jp = pruner;
-	current_node_id_ = current_rnode_id_ = warthog::INF32;
-	current_goal_id_ = current_rgoal_id_ = warthog::INF32;
+  jp->ctx = &ctx_;
+	current_node_id_ = current_rnode_id_ = warthog::GRID_ID_MAX;
+	current_goal_id_ = current_rgoal_id_ = warthog::GRID_ID_MAX;
 }
 
 jlp::~online_jump_point_locator2_prune2()
 {
-	delete rmap_;
+	if(owns_rmap_) { delete rmap_; }
 }
 
-// create a copy of the grid map which is rotated by 90 degrees clockwise.
-// this version will be used when jumping North or South. 
-warthog::gridmap*
-jlp::create_rmap()
+void
+jlp::set_map(warthog::gridmap* map, warthog::gridmap* rmap)
 {
-	uint32_t maph = map_->header_height();
-	uint32_t mapw = map_->header_width();
-	uint32_t rmaph = mapw;
-	uint32_t rmapw = maph;
-	warthog::gridmap* rmap = new warthog::gridmap(rmaph, rmapw);
-
-	for(uint32_t x = 0; x < mapw; x++) 
-	{
-		for(uint32_t y = 0; y < maph; y++)
-		{
-			uint32_t label = map_->get_label(map_->to_padded_id(x, y));
-			uint32_t rx = ((rmapw-1) - y);
-			uint32_t ry = x;
-			uint32_t rid = rmap->to_padded_id(rx, ry);
-			rmap->set_label(rid, label);
-		}
-	}
-	return rmap;
+	if(owns_rmap_) { delete rmap_; }
+	map_ = map;
+	owns_rmap_ = rmap == 0;
+	rmap_ = owns_rmap_ ? warthog::jps::create_rmap(map_) : rmap;
 }
 
 
@@ -60,8 +44,8 @@ jlp::create_rmap()
 // @return: the id of a jump point successor or warthog::INF if no jp exists.
 void
 jlp::jump(warthog::jps::direction d,
-	   	uint32_t node_id, uint32_t goal_id, 
-		std::vector<uint32_t>& jpoints,
+	   	grid_id_t node_id, grid_id_t goal_id, 
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
 	// cache node and goal ids so we don't need to convert all the time
@@ -110,25 +94,25 @@ jlp::jump(warthog::jps::direction d,
 
 void
 jlp::jump_north(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
-	uint32_t jumpnode_id;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
+	grid_id_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
 	__jump_north(rnode_id, rgoal_id, jumpnode_id, jumpcost, rmap_);
 
-	if(jumpnode_id != warthog::INF32)
+	if(jumpnode_id != warthog::GRID_ID_MAX)
 	{
     // uint32_t rjp_id = jumpnode_id;
 		jumpnode_id = current_node_id_ - jp->jump_step * map_->width();
     // _backwards_gval_update(jumpnode_id, jumpcost, pa->get_g(), 1); // update south
     // backwards_gval_update_NS(jumpnode_id, rjp_id, jumpcost, pa->get_g(), jps::SOUTH);
-    jp->setup(jp->north, pa->get_g(), G::gval(jumpnode_id), jumpcost);
+    jp->setup(jp->north, pa->get_g(), ctx_.gval(jumpnode_id), jumpcost);
 
-    if (pa->get_g() + jumpcost <= G::gval(jumpnode_id)) {
+    if (pa->get_g() + jumpcost <= ctx_.gval(jumpnode_id)) {
       // *(((uint8_t*)&jumpnode_id)+3) = warthog::jps::NORTH;
       jpoints.push_back(jumpnode_id);
       costs.push_back(jumpcost);
@@ -137,8 +121,8 @@ jlp::jump_north(
 }
 
 void
-jlp::__jump_north(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+jlp::__jump_north(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 		warthog::gridmap* mymap)
 {
 	// jumping north in the original map is the same as jumping
@@ -148,25 +132,25 @@ jlp::__jump_north(uint32_t node_id,
 
 void
 jlp::jump_south(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<grid_id_t>& jpoints, 
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
-	uint32_t jumpnode_id;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
+	grid_id_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
 	__jump_south(rnode_id, rgoal_id, jumpnode_id, jumpcost, rmap_);
 
-	if(jumpnode_id != warthog::INF32)
+	if(jumpnode_id != warthog::GRID_ID_MAX)
 	{
     // uint32_t rjp_id = jumpnode_id;
     jumpnode_id = current_node_id_ + jp->jump_step * map_->width();
     // _backwards_gval_update(jumpnode_id, jumpcost, pa->get_g(), 0); // update north
     // backwards_gval_update_NS(jumpnode_id, rjp_id, jumpcost, pa->get_g(), jps::NORTH);
-    jp->setup(jp->south, pa->get_g(), G::gval(jumpnode_id), jumpcost);
+    jp->setup(jp->south, pa->get_g(), ctx_.gval(jumpnode_id), jumpcost);
 
-    if (pa->get_g() + jumpcost <= G::gval(jumpnode_id)) {
+    if (pa->get_g() + jumpcost <= ctx_.gval(jumpnode_id)) {
       // *(((uint8_t*)&jumpnode_id)+3) = warthog::jps::SOUTH;
       jpoints.push_back(jumpnode_id);
       costs.push_back(jumpcost);
@@ -175,8 +159,8 @@ jlp::jump_south(
 }
 
 void
-jlp::__jump_south(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+jlp::__jump_south(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 		warthog::gridmap* mymap)
 {
 	// jumping north in the original map is the same as jumping
@@ -186,22 +170,22 @@ jlp::__jump_south(uint32_t node_id,
 
 void
 jlp::jump_east(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<grid_id_t>& jpoints, 
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t jumpnode_id;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
 	__jump_east(node_id, goal_id, jumpnode_id, jumpcost, map_);
 
-	if(jumpnode_id != warthog::INF32)
+	if(jumpnode_id != warthog::GRID_ID_MAX)
 	{
     // _backwards_gval_update(jumpnode_id, jumpcost, pa->get_g(), 3); // update west
     // backwards_gval_update_EW(jumpnode_id, jumpcost, pa->get_g(), jps::WEST);
-    jp->setup(jp->east, pa->get_g(), G::gval(jumpnode_id), jumpcost);
-    if (pa->get_g() + jumpcost <= G::gval(jumpnode_id)) {
+    jp->setup(jp->east, pa->get_g(), ctx_.gval(jumpnode_id), jumpcost);
+    if (pa->get_g() + jumpcost <= ctx_.gval(jumpnode_id)) {
       // *(((uint8_t*)&jumpnode_id)+3) = warthog::jps::EAST;
       jpoints.push_back(jumpnode_id);
       costs.push_back(jumpcost);
@@ -211,14 +195,15 @@ jlp::jump_east(
 
 
 void
-jlp::__jump_east(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+jlp::__jump_east(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
 	jumpnode_id = node_id;
 
 	uint32_t neis[3] = {0, 0, 0};
 	bool deadend = false;
+	uint32_t limit = jp->scan_limit;
 
 	jumpnode_id = node_id;
 	while(true)
@@ -253,17 +238,28 @@ jlp::__jump_east(uint32_t node_id,
 		// Such a tile, followed by a non-obstacle tile, would yield a forced 
 		// neighbour that we don't want to miss.
 		jumpnode_id += 31;
+
+		// and from there past any strips of open ground in the summary
+		if(mymap->has_summary()) { jumpnode_id = mymap->skip_east(jumpnode_id); }
+		if(jumpnode_id - node_id >= limit) { break; }
+	}
+
+	// the pruner's temp obstacle, if any, ends the scan as a dead-end
+	if(jumpnode_id - node_id >= limit)
+	{
+		jumpnode_id = node_id + limit;
+		deadend = true;
 	}
 
   uint32_t& num_steps = jp->jump_step;
-	num_steps = jumpnode_id - node_id;
+	num_steps = (uint32_t)(jumpnode_id - node_id);
 #ifdef CNT
-  S::scan_cnt += (num_steps >> 5) ;
+  ctx_.scan_cnt += (num_steps >> 5) ;
 #endif
-	uint32_t goal_dist = goal_id - node_id;
+	grid_id_t goal_dist = goal_id - node_id;
 	if(num_steps > goal_dist)
 	{
-    num_steps = goal_dist;
+    num_steps = (uint32_t)goal_dist;
 		jumpnode_id = goal_id;
 		jumpcost = goal_dist;
 		return;
@@ -275,7 +271,7 @@ jlp::__jump_east(uint32_t node_id,
 		// correct here since we just inverted neis[1] and then
 		// looked for the first set bit. need -1 to fix it.
 		num_steps -= (1 && num_steps);
-		jumpnode_id = warthog::INF32;
+		jumpnode_id = warthog::GRID_ID_MAX;
 	}
 	jumpcost = num_steps;
 	
@@ -284,23 +280,23 @@ jlp::__jump_east(uint32_t node_id,
 // analogous to ::jump_east 
 void
 jlp::jump_west(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<grid_id_t>& jpoints, 
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t jumpnode_id;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
 	__jump_west(node_id, goal_id, jumpnode_id, jumpcost, map_);
 
-	if(jumpnode_id != warthog::INF32)
+	if(jumpnode_id != warthog::GRID_ID_MAX)
 	{
     // _backwards_gval_update(jumpnode_id, jumpcost, pa->get_g(), 2); // update east
     // backwards_gval_update_EW(jumpnode_id, jumpcost, pa->get_g(), jps::EAST);
-    jp->setup(jp->west, pa->get_g(), G::gval(jumpnode_id), jumpcost);
+    jp->setup(jp->west, pa->get_g(), ctx_.gval(jumpnode_id), jumpcost);
 
-    if (pa->get_g() + jumpcost <= G::gval(jumpnode_id)) {
+    if (pa->get_g() + jumpcost <= ctx_.gval(jumpnode_id)) {
       // *(((uint8_t*)&jumpnode_id)+3) = warthog::jps::WEST;
       jpoints.push_back(jumpnode_id);
       costs.push_back(jumpcost);
@@ -309,12 +305,13 @@ jlp::jump_west(
 }
 
 void
-jlp::__jump_west(uint32_t node_id, 
-		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+jlp::__jump_west(grid_id_t node_id, 
+		grid_id_t goal_id, grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
 	bool deadend = false;
 	uint32_t neis[3] = {0, 0, 0};
+	uint32_t limit = jp->scan_limit;
 
 	jumpnode_id = node_id;
 	while(true)
@@ -342,18 +339,28 @@ jlp::__jump_west(uint32_t node_id,
 		// jump to the end of cache. jumping +32 involves checking
 		// for forced neis between adjacent sets of contiguous tiles
 		jumpnode_id -= 31;
-	
+
+		// and from there past any strips of open ground in the summary
+		if(mymap->has_summary()) { jumpnode_id = mymap->skip_west(jumpnode_id); }
+		if(node_id - jumpnode_id >= limit) { break; }
+	}
+
+	// the pruner's temp obstacle, if any, ends the scan as a dead-end
+	if(node_id - jumpnode_id >= limit)
+	{
+		jumpnode_id = node_id - limit;
+		deadend = true;
 	}
 
   uint32_t& num_steps = jp->jump_step;
-	num_steps = node_id - jumpnode_id;
-	uint32_t goal_dist = node_id - goal_id;
+	num_steps = (uint32_t)(node_id - jumpnode_id);
+	grid_id_t goal_dist = node_id - goal_id;
 #ifdef CNT
-  S::scan_cnt += (num_steps >> 5);
+  ctx_.scan_cnt += (num_steps >> 5);
 #endif
 	if(num_steps > goal_dist)
 	{
-    num_steps = goal_dist;
+    num_steps = (uint32_t)goal_dist;
 		jumpnode_id = goal_id;
 		jumpcost = goal_dist;
  		return;
@@ -365,25 +372,25 @@ jlp::__jump_west(uint32_t node_id,
 		// correct here since we just inverted neis[1] and then
 		// counted leading zeroes. need -1 to fix it.
 		num_steps -= (1 && num_steps);
-		jumpnode_id = warthog::INF32;
+		jumpnode_id = warthog::GRID_ID_MAX;
 	}
 	jumpcost = num_steps;
 }
 
 void
 jlp::jump_northeast(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t jumpnode_id, jp1_id, jp2_id;
+	grid_id_t jumpnode_id, jp1_id, jp2_id;
 	warthog::cost_t jumpcost, jp1_cost, jp2_cost, cost_to_nodeid;
 	jumpnode_id = jp1_id = jp2_id = 0;
 	jumpcost = jp1_cost = jp2_cost = cost_to_nodeid = 0;
 
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. node_id at centre. Assume little endian format.
@@ -394,29 +401,29 @@ jlp::jump_northeast(
 	// (validity of subsequent steps is checked by straight jump functions)
 	if((neis & 1542) != 1542) { return; }
 
-  G::cur_diag_gval = pa->get_g();
+  ctx_.cur_diag_gval = pa->get_g();
   jp->v.init_before_diag(jps::NORTH, jps::EAST);
   jp->h.init_before_diag(jps::EAST, jps::NORTH);
   jp->setup(jp->v, jp->north.ga, jp->north.gb, jp->north.dC);
   jp->setup(jp->h, jp->east.ga, jp->east.gb, jp->east.dC);
 
-	while(node_id != warthog::INF32)
+	while(node_id != warthog::GRID_ID_MAX)
 	{
-    jp1_id = jp2_id = warthog::INF32;
+    jp1_id = jp2_id = warthog::GRID_ID_MAX;
 		__jump_northeast(
 				node_id, rnode_id,
 				goal_id, rgoal_id,
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
 				jp2_id, jp2_cost);
 
-		if(jp1_id != warthog::INF32)
+		if(jp1_id != warthog::GRID_ID_MAX)
 		{
       // uint32_t rjp_id = jp1_id;
-			jp1_id = node_id - (uint32_t)(jp1_cost) * map_->width();
+			jp1_id = node_id - (grid_id_t)(jp1_cost) * map_->width();
       // update in south
-      // _backwards_gval_update(jp1_id, jp1_cost, G::cur_diag_gval, 1);
-      // backwards_gval_update_NS(jp1_id, rjp_id, jp1_cost, G::cur_diag_gval, jps::SOUTH);
-      if (G::cur_diag_gval+ jp1_cost <= G::gval(jp1_id)) {
+      // _backwards_gval_update(jp1_id, jp1_cost, ctx_.cur_diag_gval, 1);
+      // backwards_gval_update_NS(jp1_id, rjp_id, jp1_cost, ctx_.cur_diag_gval, jps::SOUTH);
+      if (ctx_.cur_diag_gval+ jp1_cost <= ctx_.gval(jp1_id)) {
 				// *(((uint8_t*)&jp1_id)+3) = warthog::jps::NORTH;
         jpoints.push_back(jp1_id);
         costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
@@ -424,13 +431,13 @@ jlp::jump_northeast(
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
-		if(jp2_id != warthog::INF32)
+		if(jp2_id != warthog::GRID_ID_MAX)
 		{
       cost_t gp = pa->get_g() + cost_to_nodeid + jumpcost;
       // update in west
       // _backwards_gval_update(jp2_id, jp2_cost, gp, 3);
       // backwards_gval_update_EW(jp2_id, jp2_cost, gp, jps::WEST);
-      if (gp + jp2_cost <= G::gval(jp2_id)) {
+      if (gp + jp2_cost <= ctx_.gval(jp2_id)) {
 				// *(((uint8_t*)&jp2_id)+3) = warthog::jps::EAST;
         jpoints.push_back(jp2_id);
         costs.push_back(cost_to_nodeid + jumpcost + jp2_cost);
@@ -444,11 +451,11 @@ jlp::jump_northeast(
 
 void
 jlp::__jump_northeast(
-		uint32_t& node_id, uint32_t& rnode_id, 
-		uint32_t goal_id, uint32_t rgoal_id,
-		uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
-		uint32_t& jp_id1, warthog::cost_t& cost1,
-		uint32_t& jp_id2, warthog::cost_t& cost2)
+		grid_id_t& node_id, grid_id_t& rnode_id, 
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		grid_id_t& jp_id1, warthog::cost_t& cost1,
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
 {
 	uint32_t num_steps = 0;
 
@@ -457,50 +464,53 @@ jlp::__jump_northeast(
 	uint32_t mapw = map_->width();
 
   if (jp->v.dominated() || jp->h.dominated()) {
-    jumpnode_id = warthog::INF32; jumpcost = 0; return;
+    jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
   }
 	while(true)
 	{
 		num_steps++;
-    G::cur_diag_gval += DBL_ROOT_TWO;
+    if (ctx_.stop_scan(num_steps)) {
+      jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
+    }
+    ctx_.cur_diag_gval += DBL_ROOT_TWO;
 		node_id = node_id - mapw + 1;
 		rnode_id = rnode_id + rmapw + 1;
     // if (iscorner[node_id])
-    //   global::query::set_corner_gv(node_id, G::cur_diag_gval);
+    //   ctx_.set_corner_gv(node_id, ctx_.cur_diag_gval);
 
     if ((!jp->v.next()) || (!jp->h.next())) {
-      jumpnode_id = warthog::INF32; jumpcost = 0; return;
+      jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
     }
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-    jp->before_scanv(rmap_, rnode_id, 1);
+    jp->before_scanv();
 		__jump_north(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
     jp->jumpcost = cost1;
-    if (!jp->after_scanv(rmap_, node_id-jp->jump_step*mapw, jp_id1, cost1)) {
-      jp_id1 = jp_id2 = jumpnode_id = INF32;
+    if (!jp->after_scanv(node_id-jp->jump_step*mapw, jp_id1, cost1)) {
+      jp_id1 = jp_id2 = jumpnode_id = warthog::GRID_ID_MAX;
       jumpcost = 0; return;
     }
 
 
-    jp->before_scanh(map_, node_id, 1);
+    jp->before_scanh();
 		__jump_east(node_id, goal_id, jp_id2, cost2, map_);
     jp->jumpcost = cost2;
-    if (!jp->after_scanh(map_, node_id+jp->jump_step, jp_id2, cost2)) {
-      jp_id1 = jp_id2 = jumpnode_id = INF32;
+    if (!jp->after_scanh(node_id+jp->jump_step, jp_id2, cost2)) {
+      jp_id1 = jp_id2 = jumpnode_id = warthog::GRID_ID_MAX;
       jumpcost = 0; return;
     }
-		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
+		if((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
 		if(!(cost1 && cost2)) 
 		{ 
-			node_id = jp_id1 = jp_id2 = warthog::INF32; 
+			node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX; 
 			break; 
 		}
 
 	}
 #ifdef CNT
-  S::scan_cnt += num_steps;
+  ctx_.scan_cnt += num_steps;
 #endif
 	jumpnode_id = node_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
@@ -508,18 +518,18 @@ jlp::__jump_northeast(
 
 void
 jlp::jump_northwest(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t jumpnode_id, jp1_id, jp2_id;
+	grid_id_t jumpnode_id, jp1_id, jp2_id;
 	warthog::cost_t jumpcost, jp1_cost, jp2_cost, cost_to_nodeid;
 	jumpnode_id = jp1_id = jp2_id = 0;
 	jumpcost = jp1_cost = jp2_cost = cost_to_nodeid = 0;
 
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. node_id at centre. Assume little endian format.
@@ -530,30 +540,30 @@ jlp::jump_northwest(
 	// (validity of subsequent steps is checked by straight jump functions)
 	if((neis & 771) != 771) { return; }
 
-  G::cur_diag_gval = pa->get_g();
+  ctx_.cur_diag_gval = pa->get_g();
   jp->v.init_before_diag(jps::NORTH, jps::WEST);
   jp->h.init_before_diag(jps::WEST, jps::NORTH);
 
   jp->setup(jp->v, jp->north.ga, jp->north.gb, jp->north.dC);
   jp->setup(jp->h, jp->west.ga, jp->west.gb, jp->west.dC);
 
-	while(node_id != warthog::INF32)
+	while(node_id != warthog::GRID_ID_MAX)
 	{
-    jp1_id = jp2_id = warthog::INF32;
+    jp1_id = jp2_id = warthog::GRID_ID_MAX;
 		__jump_northwest(
 				node_id, rnode_id,
 				goal_id, rgoal_id,
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
 				jp2_id, jp2_cost);
 
-		if(jp1_id != warthog::INF32)
+		if(jp1_id != warthog::GRID_ID_MAX)
 		{
       // uint32_t rjp_id = jp1_id;
-      jp1_id = node_id - (uint32_t)(jp1_cost) * map_->width();
+      jp1_id = node_id - (grid_id_t)(jp1_cost) * map_->width();
       // update in south
-      // _backwards_gval_update(jp1_id, jp1_cost, G::cur_diag_gval, 1);
-      // backwards_gval_update_NS(jp1_id, rjp_id, jp1_cost, G::cur_diag_gval, jps::SOUTH);
-      if (G::cur_diag_gval + jp1_cost <= G::gval(jp1_id)) {
+      // _backwards_gval_update(jp1_id, jp1_cost, ctx_.cur_diag_gval, 1);
+      // backwards_gval_update_NS(jp1_id, rjp_id, jp1_cost, ctx_.cur_diag_gval, jps::SOUTH);
+      if (ctx_.cur_diag_gval + jp1_cost <= ctx_.gval(jp1_id)) {
 				// *(((uint8_t*)&jp1_id)+3) = warthog::jps::NORTH;
         jpoints.push_back(jp1_id);
         costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
@@ -561,12 +571,12 @@ jlp::jump_northwest(
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
-		if(jp2_id != warthog::INF32)
+		if(jp2_id != warthog::GRID_ID_MAX)
 		{
       // update in east
-      // _backwards_gval_update(jp2_id, jp2_cost, G::cur_diag_gval, 2);
-      // backwards_gval_update_EW(jp2_id, jp2_cost, G::cur_diag_gval, jps::EAST);
-      if (G::cur_diag_gval + jp2_cost <= G::gval(jp2_id)) {
+      // _backwards_gval_update(jp2_id, jp2_cost, ctx_.cur_diag_gval, 2);
+      // backwards_gval_update_EW(jp2_id, jp2_cost, ctx_.cur_diag_gval, jps::EAST);
+      if (ctx_.cur_diag_gval + jp2_cost <= ctx_.gval(jp2_id)) {
         // *(((uint8_t*)&jp2_id)+3) = warthog::jps::WEST;
         jpoints.push_back(jp2_id);
         costs.push_back(cost_to_nodeid + jumpcost + jp2_cost);
@@ -580,11 +590,11 @@ jlp::jump_northwest(
 
 void
 jlp::__jump_northwest(
-		uint32_t& node_id, uint32_t& rnode_id, 
-		uint32_t goal_id, uint32_t rgoal_id,
-		uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-		uint32_t& jp_id1, warthog::cost_t& cost1, 
-		uint32_t& jp_id2, warthog::cost_t& cost2)
+		grid_id_t& node_id, grid_id_t& rnode_id, 
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+		grid_id_t& jp_id1, warthog::cost_t& cost1, 
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
 
 {
 	uint32_t num_steps = 0;
@@ -594,45 +604,48 @@ jlp::__jump_northwest(
 	uint32_t mapw = map_->width();
 
   if (jp->v.dominated() || jp->h.dominated()) {
-    jumpnode_id = warthog::INF32; jumpcost = 0; return;
+    jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
   }
 	while(true)
 	{
 		num_steps++;
-    G::cur_diag_gval += DBL_ROOT_TWO;
+    if (ctx_.stop_scan(num_steps)) {
+      jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
+    }
+    ctx_.cur_diag_gval += DBL_ROOT_TWO;
 		node_id = node_id - mapw - 1;
 		rnode_id = rnode_id - (rmapw - 1);
     // if (iscorner[node_id])
-    //   global::query::set_corner_gv(node_id, G::cur_diag_gval);
+    //   ctx_.set_corner_gv(node_id, ctx_.cur_diag_gval);
 
     if ((!jp->v.next()) || (!jp->h.next())) {
-      jumpnode_id = warthog::INF32; jumpcost = 0; return;
+      jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
     }
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-    jp->before_scanv(rmap_,  rnode_id, 1);
+    jp->before_scanv();
 		__jump_north(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
     jp->jumpcost = cost1;
-    if (!jp->after_scanv(rmap_, node_id-jp->jump_step*mapw, jp_id1, cost1)) {
-      jp_id1 = jp_id2 = jumpnode_id = INF32;
+    if (!jp->after_scanv(node_id-jp->jump_step*mapw, jp_id1, cost1)) {
+      jp_id1 = jp_id2 = jumpnode_id = warthog::GRID_ID_MAX;
       jumpcost = 0; return;
     }
 
-    jp->before_scanh(map_, node_id, -1);
+    jp->before_scanh();
 		__jump_west(node_id, goal_id, jp_id2, cost2, map_);
     jp->jumpcost = cost2;
-    if (!jp->after_scanh(map_, node_id-jp->jump_step, jp_id2, cost2)) {
-      jp_id1 = jp_id2 = jumpnode_id = INF32;
+    if (!jp->after_scanh(node_id-jp->jump_step, jp_id2, cost2)) {
+      jp_id1 = jp_id2 = jumpnode_id = warthog::GRID_ID_MAX;
       jumpcost = 0; return;
     }
 
-		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
+		if((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) { break; }
 		// couldn't move in either straight dir; node_id is an obstacle
-		if(!(cost1 && cost2)) { node_id = jp_id1 = jp_id2 = warthog::INF32; break; 
+		if(!(cost1 && cost2)) { node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX; break; 
 		}
 	}
 #ifdef CNT
-  S::scan_cnt += num_steps;
+  ctx_.scan_cnt += num_steps;
 #endif
 	jumpnode_id = node_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
@@ -640,19 +653,19 @@ jlp::__jump_northwest(
 
 void
 jlp::jump_southeast(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t jumpnode_id, jp1_id, jp2_id;
+	grid_id_t jumpnode_id, jp1_id, jp2_id;
 	warthog::cost_t jumpcost, jp1_cost, jp2_cost, cost_to_nodeid;
 	jumpnode_id = jp1_id = jp2_id = 0;
 	jumpcost = jp1_cost = jp2_cost = cost_to_nodeid = 0;
 
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
-  G::cur_diag_gval = pa->get_g();
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
+  ctx_.cur_diag_gval = pa->get_g();
 
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. next_id at centre. Assume little endian format.
@@ -663,29 +676,29 @@ jlp::jump_southeast(
 	// (validity of subsequent steps is checked by straight jump functions)
 	if((neis & 394752) != 394752) { return; }
 
-  G::cur_diag_gval = pa->get_g();
+  ctx_.cur_diag_gval = pa->get_g();
   jp->v.init_before_diag(jps::SOUTH, jps::EAST);
   jp->h.init_before_diag(jps::EAST, jps::SOUTH);
   jp->setup(jp->v, jp->south.ga, jp->south.gb, jp->south.dC);
   jp->setup(jp->h, jp->east.ga, jp->east.gb, jp->east.dC);
 
-	while(node_id != warthog::INF32)
+	while(node_id != warthog::GRID_ID_MAX)
 	{
-    jp1_id = jp2_id = warthog::INF32;
+    jp1_id = jp2_id = warthog::GRID_ID_MAX;
 		__jump_southeast(
 				node_id, rnode_id,
 				goal_id, rgoal_id,
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
 				jp2_id, jp2_cost);
 
-		if(jp1_id != warthog::INF32)
+		if(jp1_id != warthog::GRID_ID_MAX)
     {
       // uint32_t rjp_id = jp1_id;
-			jp1_id = node_id + (uint32_t)(jp1_cost) * map_->width();
+			jp1_id = node_id + (grid_id_t)(jp1_cost) * map_->width();
       // update in north
-      // _backwards_gval_update(jp1_id, jp1_cost, G::cur_diag_gval, 0);
-      // backwards_gval_update_NS(jp1_id, rjp_id, jp1_cost, G::cur_diag_gval, jps::NORTH);
-      if (G::cur_diag_gval + jp1_cost <= G::gval(jp1_id)) {
+      // _backwards_gval_update(jp1_id, jp1_cost, ctx_.cur_diag_gval, 0);
+      // backwards_gval_update_NS(jp1_id, rjp_id, jp1_cost, ctx_.cur_diag_gval, jps::NORTH);
+      if (ctx_.cur_diag_gval + jp1_cost <= ctx_.gval(jp1_id)) {
         // *(((uint8_t*)&jp1_id)+3) = warthog::jps::SOUTH;
         jpoints.push_back(jp1_id);
         costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
@@ -693,12 +706,12 @@ jlp::jump_southeast(
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
-		if(jp2_id != warthog::INF32)
+		if(jp2_id != warthog::GRID_ID_MAX)
 		{
       // update in west
-      // _backwards_gval_update(jp2_id, jp2_cost, G::cur_diag_gval, 3);
-      // backwards_gval_update_EW(jp2_id, jp2_cost, G::cur_diag_gval, jps::WEST);
-      if (G::cur_diag_gval + jp2_cost <= G::gval(jp2_id)) {
+      // _backwards_gval_update(jp2_id, jp2_cost, ctx_.cur_diag_gval, 3);
+      // backwards_gval_update_EW(jp2_id, jp2_cost, ctx_.cur_diag_gval, jps::WEST);
+      if (ctx_.cur_diag_gval + jp2_cost <= ctx_.gval(jp2_id)) {
         // *(((uint8_t*)&jp2_id)+3) = warthog::jps::EAST;
         jpoints.push_back(jp2_id);
         costs.push_back(cost_to_nodeid + jumpcost + jp2_cost);
@@ -712,11 +725,11 @@ jlp::jump_southeast(
 
 void
 jlp::__jump_southeast(
-		uint32_t& node_id, uint32_t& rnode_id, 
-		uint32_t goal_id, uint32_t rgoal_id,
-		uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-		uint32_t& jp_id1, warthog::cost_t& cost1, 
-		uint32_t& jp_id2, warthog::cost_t& cost2)
+		grid_id_t& node_id, grid_id_t& rnode_id, 
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+		grid_id_t& jp_id1, warthog::cost_t& cost1, 
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
 
 {
 	uint32_t num_steps = 0;
@@ -726,44 +739,47 @@ jlp::__jump_southeast(
 	uint32_t mapw = map_->width();
 
   if (jp->v.dominated() || jp->h.dominated()) {
-    jumpnode_id = warthog::INF32; jumpcost = 0; return;
+    jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
   }
 	while(true)
 	{
 		num_steps++;
-    G::cur_diag_gval += DBL_ROOT_TWO;
+    if (ctx_.stop_scan(num_steps)) {
+      jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
+    }
+    ctx_.cur_diag_gval += DBL_ROOT_TWO;
 		node_id = node_id + mapw + 1;
 		rnode_id = rnode_id + rmapw - 1;
     // if (iscorner[node_id])
-    //   global::query::set_corner_gv(node_id, G::cur_diag_gval);
+    //   ctx_.set_corner_gv(node_id, ctx_.cur_diag_gval);
 
     if ((!jp->v.next()) || (!jp->h.next())) {
-      jumpnode_id = warthog::INF32; jumpcost = 0; return;
+      jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
     }
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-    jp->before_scanv(rmap_, rnode_id, -1);
+    jp->before_scanv();
 		__jump_south(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
     jp->jumpcost = cost1;
-    if (!jp->after_scanv(rmap_, node_id+jp->jump_step*mapw, jp_id1, cost1)) {
-      jp_id1 = jp_id2 = jumpnode_id = INF32;
+    if (!jp->after_scanv(node_id+jp->jump_step*mapw, jp_id1, cost1)) {
+      jp_id1 = jp_id2 = jumpnode_id = warthog::GRID_ID_MAX;
       jumpcost = 0; return;
     }
 
-    jp->before_scanh(map_, node_id, 1);
+    jp->before_scanh();
 		__jump_east(node_id, goal_id, jp_id2, cost2, map_);
     jp->jumpcost = cost2;
-    if (!jp->after_scanh(map_, node_id+jp->jump_step, jp_id2, cost2)) {
-      jp_id1 = jp_id2 = jumpnode_id = INF32;
+    if (!jp->after_scanh(node_id+jp->jump_step, jp_id2, cost2)) {
+      jp_id1 = jp_id2 = jumpnode_id = warthog::GRID_ID_MAX;
       jumpcost = 0; return;
     }
-    if ((jp_id1 & jp_id2) != warthog::INF32) break;
+    if ((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) break;
 		// couldn't move in either straight dir; node_id is an obstacle
-		if(!(cost1 && cost2)) { node_id = jp_id1 = jp_id2 = warthog::INF32; break; 
+		if(!(cost1 && cost2)) { node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX; break; 
 		}
 	}
 #ifdef CNT
-  S::scan_cnt += num_steps;
+  ctx_.scan_cnt += num_steps;
 #endif
 	jumpnode_id = node_id;
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
@@ -771,19 +787,19 @@ jlp::__jump_southeast(
 
 void
 jlp::jump_southwest(
-		std::vector<uint32_t>& jpoints,
+		std::vector<grid_id_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-	uint32_t jumpnode_id, jp1_id, jp2_id;
+	grid_id_t jumpnode_id, jp1_id, jp2_id;
 	warthog::cost_t jumpcost, jp1_cost, jp2_cost, cost_to_nodeid;
 	jumpnode_id = jp1_id = jp2_id = 0;
 	jumpcost = jp1_cost = jp2_cost = cost_to_nodeid = 0;
 
-	uint32_t node_id = current_node_id_;
-	uint32_t goal_id = current_goal_id_;
-	uint32_t rnode_id = current_rnode_id_;
-	uint32_t rgoal_id = current_rgoal_id_;
-  G::cur_diag_gval = pa->get_g();
+	grid_id_t node_id = current_node_id_;
+	grid_id_t goal_id = current_goal_id_;
+	grid_id_t rnode_id = current_rnode_id_;
+	grid_id_t rgoal_id = current_rgoal_id_;
+  ctx_.cur_diag_gval = pa->get_g();
 	
 	// first 3 bits of first 3 bytes represent a 3x3 cell of tiles
 	// from the grid. next_id at centre. Assume little endian format.
@@ -793,31 +809,31 @@ jlp::jump_southwest(
 	// early termination (first step is invalid)
 	if((neis & 197376) != 197376) { return; }
 
-  G::cur_diag_gval = pa->get_g();
+  ctx_.cur_diag_gval = pa->get_g();
   jp->v.init_before_diag(jps::SOUTH, jps::WEST);
   jp->h.init_before_diag(jps::WEST, jps::SOUTH);
 
   jp->setup(jp->v, jp->south.ga, jp->south.gb, jp->south.dC);
   jp->setup(jp->h, jp->west.ga, jp->west.gb, jp->west.dC);
 
-	while(node_id != warthog::INF32)
+	while(node_id != warthog::GRID_ID_MAX)
 	{
 
-    jp1_id = jp2_id = warthog::INF32;
+    jp1_id = jp2_id = warthog::GRID_ID_MAX;
 		__jump_southwest(
 				node_id, rnode_id,
 				goal_id, rgoal_id,
 				jumpnode_id, jumpcost, 
 				jp1_id, jp1_cost, jp2_id, jp2_cost);
 
-		if(jp1_id != warthog::INF32)
+		if(jp1_id != warthog::GRID_ID_MAX)
 		{
       // uint32_t rjp_id = jp1_id;
-      jp1_id = node_id + (uint32_t)(jp1_cost) * map_->width();
+      jp1_id = node_id + (grid_id_t)(jp1_cost) * map_->width();
       // update in north
-      // _backwards_gval_update(jp1_id, jp1_cost, G::cur_diag_gval, 0);
-      // backwards_gval_update_NS(jp1_id, rjp_id, jp1_cost, G::cur_diag_gval, jps::NORTH);
-      if (G::cur_diag_gval + jp1_cost <= G::gval(jp1_id)) {
+      // _backwards_gval_update(jp1_id, jp1_cost, ctx_.cur_diag_gval, 0);
+      // backwards_gval_update_NS(jp1_id, rjp_id, jp1_cost, ctx_.cur_diag_gval, jps::NORTH);
+      if (ctx_.cur_diag_gval + jp1_cost <= ctx_.gval(jp1_id)) {
         // *(((uint8_t*)&jp1_id)+3) = warthog::jps::SOUTH;
         jpoints.push_back(jp1_id);
         costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
@@ -825,12 +841,12 @@ jlp::jump_southwest(
 			if(jp2_cost == 0) { break; }
 		}
 
-		if(jp2_id != warthog::INF32)
+		if(jp2_id != warthog::GRID_ID_MAX)
 		{
       // update in east
-      // _backwards_gval_update(jp2_id, jp2_cost, G::cur_diag_gval, 2);
-      // backwards_gval_update_EW(jp2_id, jp2_cost, G::cur_diag_gval, jps::EAST);
-      if (G::cur_diag_gval + jp2_cost <= G::gval(jp2_id)) {
+      // _backwards_gval_update(jp2_id, jp2_cost, ctx_.cur_diag_gval, 2);
+      // backwards_gval_update_EW(jp2_id, jp2_cost, ctx_.cur_diag_gval, jps::EAST);
+      if (ctx_.cur_diag_gval + jp2_cost <= ctx_.gval(jp2_id)) {
         // *(((uint8_t*)&jp2_id)+3) = warthog::jps::WEST;
         jpoints.push_back(jp2_id);
         costs.push_back(cost_to_nodeid + jumpcost + jp2_cost);
@@ -844,11 +860,11 @@ jlp::jump_southwest(
 
 void
 jlp::__jump_southwest(
-		uint32_t& node_id, uint32_t& rnode_id, 
-		uint32_t goal_id, uint32_t rgoal_id,
-		uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-		uint32_t& jp_id1, warthog::cost_t& cost1, 
-		uint32_t& jp_id2, warthog::cost_t& cost2)
+		grid_id_t& node_id, grid_id_t& rnode_id, 
+		grid_id_t goal_id, grid_id_t rgoal_id,
+		grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+		grid_id_t& jp_id1, warthog::cost_t& cost1, 
+		grid_id_t& jp_id2, warthog::cost_t& cost2)
 {
 	// jump a single step (no corner cutting)
 	uint32_t num_steps = 0;
@@ -856,41 +872,44 @@ jlp::__jump_southwest(
 	uint32_t rmapw = rmap_->width();
 
   if (jp->v.dominated() || jp->h.dominated()) {
-    jumpnode_id = warthog::INF32; jumpcost = 0; return;
+    jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
   }
 	while(true)
 	{
 		num_steps++;
-    G::cur_diag_gval += DBL_ROOT_TWO;
+    if (ctx_.stop_scan(num_steps)) {
+      jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
+    }
+    ctx_.cur_diag_gval += DBL_ROOT_TWO;
 		node_id = node_id + mapw - 1;
 		rnode_id = rnode_id - (rmapw + 1);
     // if (iscorner[node_id])
-    //   global::query::set_corner_gv(node_id, G::cur_diag_gval);
+    //   ctx_.set_corner_gv(node_id, ctx_.cur_diag_gval);
 
     if ((!jp->v.next()) || (!jp->h.next())) {
-      jumpnode_id = warthog::INF32; jumpcost = 0; return;
+      jumpnode_id = warthog::GRID_ID_MAX; jumpcost = 0; return;
     }
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-    jp->before_scanv(rmap_, rnode_id, -1);
+    jp->before_scanv();
 		__jump_south(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
     jp->jumpcost = cost1;
-    if (!jp->after_scanv(rmap_, node_id+jp->jump_step*mapw, jp_id1, cost1)) {
-      jp_id1 = jp_id2 = jumpnode_id = INF32;
+    if (!jp->after_scanv(node_id+jp->jump_step*mapw, jp_id1, cost1)) {
+      jp_id1 = jp_id2 = jumpnode_id = warthog::GRID_ID_MAX;
       jumpcost = 0; return;
     }
 
-    jp->before_scanh(map_, node_id, -1);
+    jp->before_scanh();
 		__jump_west(node_id, goal_id, jp_id2, cost2, map_);
     jp->jumpcost = cost2;
-    if (!jp->after_scanh(map_, node_id-jp->jump_step, jp_id2, cost2)) {
-      jp_id1 = jp_id2 = jumpnode_id = INF32;
+    if (!jp->after_scanh(node_id-jp->jump_step, jp_id2, cost2)) {
+      jp_id1 = jp_id2 = jumpnode_id = warthog::GRID_ID_MAX;
       jumpcost = 0; return;
     }
 
-		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
+		if((jp_id1 & jp_id2) != warthog::GRID_ID_MAX) { break; }
 		// couldn't move in either straight dir; node_id is an obstacle
-		if(!(cost1 && cost2)) { node_id = jp_id1 = jp_id2 = warthog::INF32; break; 
+		if(!(cost1 && cost2)) { node_id = jp_id1 = jp_id2 = warthog::GRID_ID_MAX; break; 
 		}
 	}
 	jumpnode_id = node_id;
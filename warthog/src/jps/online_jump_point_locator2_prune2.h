@@ -18,18 +18,28 @@ namespace warthog
 class online_jump_point_locator2_prune2
 {
 	public: 
-		online_jump_point_locator2_prune2(gridmap* map, online_jps_pruner2* pruner);
+		// @param rmap is a rotated copy of @param map (see
+		// warthog::jps::create_rmap); if not given the locator makes and
+		// owns its own. the pruner bounds scans instead of writing to
+		// the maps, so neither is modified and both can be shared
+		online_jump_point_locator2_prune2(gridmap* map,
+				online_jps_pruner2* pruner, gridmap* rmap = 0);
 		~online_jump_point_locator2_prune2();
 
+		// jump on @param map and its rotated copy @param rmap from now on.
+		// as in the constructor, rmap is not owned and is created if null
 		void
-		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
-				std::vector<uint32_t>& jpoints,
+		set_map(gridmap* map, gridmap* rmap = 0);
+
+		void
+		jump(warthog::jps::direction d, grid_id_t node_id, grid_id_t goalid, 
+				std::vector<grid_id_t>& jpoints,
 				std::vector<warthog::cost_t>& costs);
 
 		uint32_t 
 		mem()
 		{
-			return sizeof(*this) + rmap_->mem();
+			return sizeof(*this) + (owns_rmap_ ? rmap_->mem() : 0);
 		}
     online_jps_pruner2* jp;
     search_node* pa;
@@ -37,58 +47,63 @@ class online_jump_point_locator2_prune2
     inline warthog::gridmap* get_rmap() { return rmap_; }
     inline warthog::gridmap* get_map() { return map_; }
 
+		// the state of the running search that the scans and the pruner
+		// read (see global::search_context); bound by the expansion policy
+		inline global::search_context*
+		get_context() { return &ctx_; }
+
 	private:
 		void
 		jump_north(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_south(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_east(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_west(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_northeast(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_northwest(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_southeast(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_southwest(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<grid_id_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
 
 		// these versions can be passed a map parameter to
 		// use when jumping. they allow switching between
 		// map_ and rmap_ (a rotated counterpart).
 		void
-		__jump_north(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
+		__jump_north(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
 				warthog::gridmap* mymap);
 		void
-		__jump_south(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_south(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 		void
-		__jump_east(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_east(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 		void
-		__jump_west(uint32_t node_id, uint32_t goal_id, 
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		__jump_west(grid_id_t node_id, grid_id_t goal_id, 
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 
 		// these versions perform a single diagonal jump, returning
@@ -96,38 +111,38 @@ class online_jump_point_locator2_prune2
 		// jump points that caused the jumping process to stop
 		void
 		__jump_northeast(
-				uint32_t& node_id, uint32_t& rnode_id, 
-				uint32_t goal_id, uint32_t rgoal_id,
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
-				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+				grid_id_t& node_id, grid_id_t& rnode_id, 
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
 		void
 		__jump_northwest(
-				uint32_t& node_id, uint32_t& rnode_id, 
-				uint32_t goal_id, uint32_t rgoal_id,
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
-				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+				grid_id_t& node_id, grid_id_t& rnode_id, 
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
 		void
 		__jump_southeast(
-				uint32_t& node_id, uint32_t& rnode_id, 
-				uint32_t goal_id, uint32_t rgoal_id,
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
-				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+				grid_id_t& node_id, grid_id_t& rnode_id, 
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
 		void
 		__jump_southwest(
-				uint32_t& node_id, uint32_t& rnode_id, 
-				uint32_t goal_id, uint32_t rgoal_id,
-				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
-				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
-				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+				grid_id_t& node_id, grid_id_t& rnode_id, 
+				grid_id_t goal_id, grid_id_t rgoal_id,
+				grid_id_t& jumpnode_id, warthog::cost_t& jumpcost,
+				grid_id_t& jp1_id, warthog::cost_t& jp1_cost,
+				grid_id_t& jp2_id, warthog::cost_t& jp2_cost);
 
 		// functions to convert map indexes to rmap indexes
-		inline uint32_t
-		map_id_to_rmap_id(uint32_t mapid)
+		inline grid_id_t
+		map_id_to_rmap_id(grid_id_t mapid)
 		{
-			if(mapid == warthog::INF32) { return mapid; }
+			if(mapid == warthog::GRID_ID_MAX) { return mapid; }
 
 			uint32_t x, y;
 			uint32_t rx, ry;
@@ -138,10 +153,10 @@ class online_jump_point_locator2_prune2
 		}
 
 		// convert rmap indexes to map indexes
-		inline uint32_t
-		rmap_id_to_map_id(uint32_t rmapid)
+		inline grid_id_t
+		rmap_id_to_map_id(grid_id_t rmapid)
 		{
-			if(rmapid == warthog::INF32) { return rmapid; }
+			if(rmapid == warthog::GRID_ID_MAX) { return rmapid; }
 
 			uint32_t x, y;
 			uint32_t rx, ry;
@@ -151,17 +166,16 @@ class online_jump_point_locator2_prune2
 			return map_->to_padded_id(x, y);
 		}
 
-		warthog::gridmap*
-		create_rmap();
-
 		warthog::gridmap* map_;
 		warthog::gridmap* rmap_;
+		bool owns_rmap_;
 		//uint32_t jumplimit_;
+		global::search_context ctx_;
 
-		uint32_t current_goal_id_;
-		uint32_t current_rgoal_id_;
-		uint32_t current_node_id_;
-		uint32_t current_rnode_id_;
+		grid_id_t current_goal_id_;
+		grid_id_t current_rgoal_id_;
+		grid_id_t current_node_id_;
+		grid_id_t current_rnode_id_;
     // vector<bool> iscorner;
 
     // nxtjp[d][id] stores next jump point in direction `d` (NSEW) at `id`
@@ -224,53 +238,53 @@ class online_jump_point_locator2_prune2
     //   cost_t cur_cost = 0;
     //   while (cur_cost + nxtjp[dirid][jpid].second < jpc) {
     //     cur_cost += nxtjp[dirid][jpid].second;
-    //     global::query::set_corner_gv(nxtjp[dirid][jpid].first, pgv+jpc-cur_cost);
+    //     ctx_.set_corner_gv(nxtjp[dirid][jpid].first, pgv+jpc-cur_cost);
     //     jpid = nxtjp[dirid][jpid].first;
     //   }
     // }
 
-    inline void backwards_gval_update_NS(uint32_t jpid, uint32_t r_jpid, 
+    inline void backwards_gval_update_NS(grid_id_t jpid, grid_id_t r_jpid, 
         cost_t jpc, cost_t pgv, jps::direction dir) {
       cost_t cur_cost = 0, nxt_cost;
-      uint32_t nxtjp;
+      grid_id_t nxtjp;
       while (true) {
         nxtjp = jpid;
         _backwards_gval_update_online_NS(nxtjp, r_jpid, nxt_cost, dir);
         if (cur_cost + nxt_cost >= jpc) break;
         cur_cost += nxt_cost;
-        global::query::set_corner_gv(nxtjp, pgv+jpc-cur_cost);
+        ctx_.set_corner_gv(nxtjp, pgv+jpc-cur_cost);
         jpid = nxtjp;
       }
     }
 
-    inline void backwards_gval_update_EW(uint32_t jpid,
+    inline void backwards_gval_update_EW(grid_id_t jpid,
         cost_t jpc, cost_t pgv, jps::direction dir) {
       cost_t cur_cost = 0, nxt_cost;
       int cnt = 0;
-      uint32_t nxtjp;
+      grid_id_t nxtjp;
       while (true) {
         nxtjp = jpid;
         _backwards_gval_update_online_EW(nxtjp, nxt_cost, dir);
         cnt++;
         if (cnt == 2 || cur_cost + nxt_cost >= jpc) break;
         cur_cost += nxt_cost;
-        global::query::set_corner_gv(nxtjp, pgv+jpc-cur_cost);
+        ctx_.set_corner_gv(nxtjp, pgv+jpc-cur_cost);
         jpid = nxtjp;
       }
     }
 
     inline void _backwards_gval_update_online_NS(
-        uint32_t& jpid, uint32_t& r_jpid, cost_t& jcost, jps::direction dir) {
+        grid_id_t& jpid, grid_id_t& r_jpid, cost_t& jcost, jps::direction dir) {
       switch (dir) {
-        uint32_t rid;
+        grid_id_t rid;
         case jps::NORTH: {
-                           __jump_north(r_jpid, INF32, rid, jcost, rmap_);
+                           __jump_north(r_jpid, GRID_ID_MAX, rid, jcost, rmap_);
                            jpid -= jp->jump_step * map_->width();
                            r_jpid = rid;
                            break;
                          }
         case jps::SOUTH: {
-                           __jump_south(r_jpid, INF32, rid, jcost, rmap_);
+                           __jump_south(r_jpid, GRID_ID_MAX, rid, jcost, rmap_);
                            jpid += jp->jump_step * map_->width();
                            r_jpid = rid;
                            break;
@@ -280,17 +294,17 @@ class online_jump_point_locator2_prune2
     }
 
     inline void _backwards_gval_update_online_EW(
-        uint32_t& jpid, cost_t& jcost, jps::direction dir) {
+        grid_id_t& jpid, cost_t& jcost, jps::direction dir) {
 
-      uint32_t id;
+      grid_id_t id;
       switch (dir) {
         case jps::EAST: {
-                          __jump_east(jpid, INF32, id, jcost, map_);
+                          __jump_east(jpid, GRID_ID_MAX, id, jcost, map_);
                           jpid += jp->jump_step;
                           break;
                         }
         case jps::WEST: {
-                          __jump_west(jpid, INF32, id, jcost, map_);
+                          __jump_west(jpid, GRID_ID_MAX, id, jcost, map_);
                           jpid -= jp->jump_step;
                           break;
                         }
@@ -0,0 +1,224 @@
+#include "constants.h"
+#include "grid_bb_labelling.h"
+#include "helpers.h"
+#include "jps.h"
+#include "timer.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+
+namespace
+{
+
+const char BB_MAGIC[8] = {'W', 'G', 'R', 'I', 'D', 'B', 'B', '\0'};
+const uint32_t BB_VERSION = 1;
+
+// header of the files written by grid_bb_labelling::save; it is followed
+// by the boxes of every padded tile, eight per tile
+struct bb_file_header
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t height_;           // unpadded
+    uint32_t width_;
+    uint32_t num_traversable_;
+};
+
+// the moves in the order of the warthog::jps::direction bits: the tiles
+// that must be traversable (bits of gridmap::get_neighbours) and the offset
+struct grid_move
+{
+    uint32_t tiles_;
+    int32_t dx_, dy_;
+};
+
+const grid_move moves[8] =
+{
+    {514, 0, -1}, {131584, 0, 1}, {1536, 1, 0}, {768, -1, 0},
+    {1542, 1, -1}, {771, -1, -1}, {394752, 1, 1}, {197376, -1, 1}
+};
+
+// octile distances are sums of ones and square roots of two; two sums
+// that differ are further apart than this on any map that fits in the
+// 16-bit boxes
+const double TIE_EPSILON = 1e-7;
+
+struct shared_data
+{
+    warthog::label::grid_bb_labelling* lab_;
+    std::vector<uint32_t>* sources_;
+};
+
+}
+
+warthog::label::grid_bb_labelling::grid_bb_labelling(warthog::gridmap* map)
+    : map_(map)
+{
+    box empty = {UINT16_MAX, UINT16_MAX, 0, 0};
+    boxes_.assign((size_t)map->padded_mapsize() * 8, empty);
+}
+
+void
+warthog::label::grid_bb_labelling::precompute()
+{
+    void*(*thread_compute_fn)(void*) =
+    [] (void* args_in) -> void*
+    {
+        warthog::helpers::thread_params* par =
+            (warthog::helpers::thread_params*) args_in;
+        shared_data* shared = (shared_data*) par->shared_;
+        warthog::label::grid_bb_labelling* lab = shared->lab_;
+
+        std::vector<double> dist;
+        std::vector<uint64_t> first;
+        std::vector<uint32_t>& sources = *shared->sources_;
+        for(uint32_t i = par->thread_id_; i < sources.size();
+                i += par->max_threads_)
+        {
+            lab->label_tile(sources[i], dist, first);
+            par->nprocessed_++;
+        }
+        return 0;
+    };
+
+    warthog::timer t;
+    t.start();
+
+    std::vector<uint32_t> sources;
+    for(uint32_t id = 0; id < map_->padded_mapsize(); id++)
+    {
+        if(map_->get_label(id)) { sources.push_back(id); }
+    }
+    shared_data shared = {this, &sources};
+
+    std::cerr << "computing goal bounding boxes\n";
+    warthog::helpers::parallel_compute(
+            thread_compute_fn, &shared, (uint32_t)sources.size());
+    t.stop();
+    std::cerr << "done. time " << t.elapsed_time_nano() / 1e9 << " s\n";
+}
+
+void
+warthog::label::grid_bb_labelling::label_tile(uint32_t source,
+        std::vector<double>& dist, std::vector<uint64_t>& first)
+{
+    typedef std::pair<double, uint32_t> entry;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> open;
+
+    dist.assign(map_->padded_mapsize(), std::numeric_limits<double>::max());
+    first.assign(map_->padded_mapsize(), 0);
+    box* boxes = &boxes_[(size_t)source * 8];
+    int32_t w = (int32_t)map_->width();
+
+    // only canonical paths are followed: each move is a natural or forced
+    // successor (warthog::jps::compute_successors) of the one before it.
+    // byte i of first[id] holds the first moves of the optimal canonical
+    // paths that reach tile id by move i; every optimal parent of a tile
+    // is settled before it is. jump point search follows canonical paths,
+    // so from any jump point it continues with one of these moves
+    dist[source] = 0;
+    open.push(entry(0, source));
+    while(!open.empty())
+    {
+        entry top = open.top();
+        open.pop();
+        uint32_t id = top.second;
+        if(top.first != dist[id]) { continue; }
+
+        uint32_t tiles = 0;
+        map_->get_neighbours(id, (uint8_t*)&tiles);
+
+        // the first moves of the paths that go on with each move
+        uint8_t via[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        if(id == source)
+        {
+            for(uint32_t i = 0; i < 8; i++) { via[i] = (uint8_t)(1 << i); }
+        }
+        uint8_t reached = 0;
+        for(uint32_t a = 0; a < 8; a++)
+        {
+            uint8_t moves_in = (uint8_t)(first[id] >> (a * 8));
+            if(!moves_in) { continue; }
+            reached |= moves_in;
+            uint32_t succ = warthog::jps::compute_successors(
+                    (warthog::jps::direction)(1 << a), tiles);
+            for(uint32_t i = 0; i < 8; i++)
+            {
+                if(succ & (1 << i)) { via[i] |= moves_in; }
+            }
+        }
+
+        uint32_t x, y;
+        map_->to_padded_xy(id, x, y);
+        for(uint32_t i = 0; i < 8; i++)
+        {
+            if(reached & (1 << i)) { boxes[i].grow(x, y); }
+        }
+
+        for(uint32_t i = 0; i < 8; i++)
+        {
+            const grid_move& m = moves[i];
+            if(!via[i] || (tiles & m.tiles_) != m.tiles_) { continue; }
+
+            uint32_t n = (uint32_t)((int32_t)id + m.dy_ * w + m.dx_);
+            double alt = dist[id] +
+                (m.dx_ && m.dy_ ? warthog::DBL_ROOT_TWO : 1);
+            if(alt < dist[n] - TIE_EPSILON)
+            {
+                dist[n] = alt;
+                first[n] = (uint64_t)via[i] << (i * 8);
+                open.push(entry(alt, n));
+            }
+            else if(fabs(alt - dist[n]) <= TIE_EPSILON)
+            {
+                first[n] |= (uint64_t)via[i] << (i * 8);
+            }
+        }
+    }
+}
+
+bool
+warthog::label::grid_bb_labelling::save(const char* filename)
+{
+    bb_file_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic_, BB_MAGIC, sizeof(hdr.magic_));
+    hdr.version_ = BB_VERSION;
+    hdr.height_ = map_->header_height();
+    hdr.width_ = map_->header_width();
+    hdr.num_traversable_ = map_->get_num_traversable_tiles();
+
+    std::ofstream out(filename, std::ios::binary);
+    out.write((const char*)&hdr, sizeof(hdr));
+    out.write((const char*)&boxes_[0], sizeof(box) * boxes_.size());
+    return out.good();
+}
+
+bool
+warthog::label::grid_bb_labelling::load(const char* filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    bb_file_header hdr;
+    if(!in.read((char*)&hdr, sizeof(hdr)) ||
+       memcmp(hdr.magic_, BB_MAGIC, sizeof(hdr.magic_)) != 0 ||
+       hdr.version_ != BB_VERSION ||
+       hdr.height_ != map_->header_height() ||
+       hdr.width_ != map_->header_width() ||
+       hdr.num_traversable_ != map_->get_num_traversable_tiles())
+    {
+        return false;
+    }
+    if(!in.read((char*)&boxes_[0], sizeof(box) * boxes_.size()))
+    {
+        // precompute only grows boxes; start it from empty ones
+        box empty = {UINT16_MAX, UINT16_MAX, 0, 0};
+        boxes_.assign(boxes_.size(), empty);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,119 @@
+#ifndef WARTHOG_GRID_BB_LABELLING_H
+#define WARTHOG_GRID_BB_LABELLING_H
+
+// label/grid_bb_labelling.h
+//
+// Goal bounding for gridmaps: warthog::label::bb_labelling for the eight
+// moves of every traversable tile. The box of a move holds every tile
+// that an optimal canonical path from the source (one that jump point
+// search can follow) reaches by starting with that move, so a jump point
+// search can skip a move whose box does not hold the target (Rabin and
+// Sturtevant, 2016, Combining Bounding Boxes and JPS to Prune Grid
+// Pathfinding, AAAI).
+//
+// Moves are indexed as warthog::jps::direction bits: move i is the
+// direction (1 << i). Boxes are in padded coordinates, 16 bits each, and
+// indexed by padded id, so a search reads them without converting ids.
+//
+// Boxes come from one Dijkstra search per tile, run in parallel. The
+// build is quadratic in the number of tiles; save and load let it be done
+// once per map.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "gridmap.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace warthog
+{
+
+namespace label
+{
+
+class grid_bb_labelling
+{
+    public:
+        // a box from (x0_, y0_) to (x1_, y1_), inclusive; empty if x0_ > x1_
+        struct box
+        {
+            uint16_t x0_, y0_, x1_, y1_;
+
+            inline bool
+            contains(uint32_t x, uint32_t y) const
+            { return x >= x0_ && x <= x1_ && y >= y0_ && y <= y1_; }
+
+            inline void
+            grow(uint32_t x, uint32_t y)
+            {
+                if(x < x0_) { x0_ = (uint16_t)x; }
+                if(x > x1_) { x1_ = (uint16_t)x; }
+                if(y < y0_) { y0_ = (uint16_t)y; }
+                if(y > y1_) { y1_ = (uint16_t)y; }
+            }
+        };
+
+        // boxes for @param map, all empty until precompute or load. the map
+        // is not owned; its padded height must be below 65536
+        grid_bb_labelling(warthog::gridmap* map);
+        ~grid_bb_labelling() { }
+
+        // compute the boxes of every traversable tile, with one thread
+        // per core
+        void
+        precompute();
+
+        // the moves from the tile with padded id @param id whose boxes hold
+        // the padded coordinates (@param x, @param y), as direction bits
+        inline uint32_t
+        moves_towards(warthog::grid_id_t id, uint32_t x, uint32_t y)
+        {
+            const box* b = &boxes_[(size_t)id * 8];
+            uint32_t moves = 0;
+            for(uint32_t i = 0; i < 8; i++)
+            {
+                moves |= (uint32_t)b[i].contains(x, y) << i;
+            }
+            return moves;
+        }
+
+        inline const box&
+        get_box(warthog::grid_id_t id, uint32_t move)
+        { return boxes_[(size_t)id * 8 + move]; }
+
+        inline warthog::gridmap*
+        get_map() { return map_; }
+
+        // write the boxes to @param filename. @return false on error
+        bool
+        save(const char* filename);
+
+        // read boxes written by save for a map of the same size and
+        // number of traversable tiles. @return false if the file cannot
+        // be read or belongs to another map
+        bool
+        load(const char* filename);
+
+        inline size_t
+        mem()
+        { return sizeof(*this) + sizeof(box) * boxes_.capacity(); }
+
+    private:
+        warthog::gridmap* map_;
+        std::vector<box> boxes_;
+
+        // the boxes of the tile with padded id @param source; @param dist
+        // and @param first are scratch space of one entry per padded tile
+        void
+        label_tile(uint32_t source, std::vector<double>& dist,
+                std::vector<uint64_t>& first);
+};
+
+}
+
+}
+
+#endif
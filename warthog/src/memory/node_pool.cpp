@@ -1,5 +1,6 @@
 #include "node_pool.h"
 #include "helpers.h"
+#include "phase_timer.h"
 #include "search_node.h"
 
 warthog::mem::node_pool::node_pool(size_t num_nodes)
@@ -12,11 +13,21 @@ void
 warthog::mem::node_pool::init(size_t num_nodes)
 {
 	num_blocks_ = ((num_nodes) >> warthog::mem::node_pool_ns::LOG2_NBS)+1;
-	blocks_ = new warthog::search_node*[num_blocks_];
-	for(size_t i=0; i < num_blocks_; i++)
-	{
-		blocks_[i] = 0;
-	}
+    last_block_id_ = warthog::SN_ID_MAX;
+    last_block_ = 0;
+    if(num_nodes > warthog::mem::node_pool_ns::SPARSE_NODES)
+    {
+        // too many blocks to keep a pointer for each
+        blocks_ = 0;
+    }
+    else
+    {
+        blocks_ = new warthog::search_node*[num_blocks_];
+        for(size_t i=0; i < num_blocks_; i++)
+        {
+            blocks_[i] = 0;
+        }
+    }
 
     // by default: 
     // allocate one chunk of memory of size
@@ -35,50 +46,62 @@ warthog::mem::node_pool::~node_pool()
 	blockspool_->reclaim();
 	delete blockspool_;
 
-	for(size_t i=0; i < num_blocks_; i++)
-	{
-		if(blocks_[i] != 0)
-		{
-			//std::cerr << "deleting block: "<<i<<std::endl;
-			blocks_[i] = 0;
-		}
-	}
-    delete [] blocks_;
+    if(blocks_)
+    {
+        for(size_t i=0; i < num_blocks_; i++)
+        {
+            if(blocks_[i] != 0)
+            {
+                //std::cerr << "deleting block: "<<i<<std::endl;
+                blocks_[i] = 0;
+            }
+        }
+        delete [] blocks_;
+    }
 }
 
 warthog::search_node*
 warthog::mem::node_pool::generate(sn_id_t node_id)
 {
+    PHASE_SCOPE(GENERATE);
 	sn_id_t block_id = node_id >> warthog::mem::node_pool_ns::LOG2_NBS;
 	sn_id_t list_id = node_id &  warthog::mem::node_pool_ns::NBS_MASK;
 
     // id outside the pool address range 
-	if(block_id > num_blocks_) { return 0; }
+	if(block_id >= num_blocks_) { return 0; }
 
     // add a new block of nodes if necessary
-	if(!blocks_[block_id])
+    warthog::search_node* block = find_block(block_id);
+	if(!block)
 	{
 		//std::cerr << "generating block: "<<block_id<<std::endl;
-        blocks_[block_id] = new (blockspool_->allocate())
+        block = new (blockspool_->allocate())
 		   	warthog::search_node[warthog::mem::node_pool_ns::NBS];
+        if(blocks_) { blocks_[block_id] = block; }
+        else
+        {
+            sparse_blocks_[block_id] = block;
+            last_block_id_ = block_id;
+            last_block_ = block;
+        }
 
         // initialise memory 
         sn_id_t current_id = node_id - list_id;
 		for( uint32_t i  = 0; i < warthog::mem::node_pool_ns::NBS; i+=8)
 		{
-            new (&blocks_[block_id][i]) warthog::search_node(current_id++);
-            new (&blocks_[block_id][i+1]) warthog::search_node(current_id++);
-            new (&blocks_[block_id][i+2]) warthog::search_node(current_id++);
-            new (&blocks_[block_id][i+3]) warthog::search_node(current_id++);
-            new (&blocks_[block_id][i+4]) warthog::search_node(current_id++);
-            new (&blocks_[block_id][i+5]) warthog::search_node(current_id++);
-            new (&blocks_[block_id][i+6]) warthog::search_node(current_id++);
-            new (&blocks_[block_id][i+7]) warthog::search_node(current_id++);
+            new (&block[i]) warthog::search_node(current_id++);
+            new (&block[i+1]) warthog::search_node(current_id++);
+            new (&block[i+2]) warthog::search_node(current_id++);
+            new (&block[i+3]) warthog::search_node(current_id++);
+            new (&block[i+4]) warthog::search_node(current_id++);
+            new (&block[i+5]) warthog::search_node(current_id++);
+            new (&block[i+6]) warthog::search_node(current_id++);
+            new (&block[i+7]) warthog::search_node(current_id++);
 		}
 	}
 
 	// return the node from its position in the assocated block 
-    return &(blocks_[block_id][list_id]);
+    return &(block[list_id]);
 }
 
 warthog::search_node*
@@ -88,13 +111,14 @@ warthog::mem::node_pool::get_ptr(sn_id_t node_id)
 	sn_id_t list_id = node_id &  warthog::mem::node_pool_ns::NBS_MASK;
 
     // id outside the pool address range 
-	if(block_id > num_blocks_) { return nullptr; }
+	if(block_id >= num_blocks_) { return nullptr; }
 
-	if(!blocks_[block_id])
+    warthog::search_node* block = find_block(block_id);
+	if(!block)
     {
         return nullptr;
     }
-    return &(blocks_[block_id][list_id]);
+    return &(block[list_id]);
 }
 
 size_t
@@ -103,7 +127,10 @@ warthog::mem::node_pool::mem()
 	size_t bytes = 
         sizeof(*this) + 
         blockspool_->mem() +
-		num_blocks_*sizeof(void*);
+		(blocks_ ? num_blocks_*sizeof(void*) : 0) +
+        // buckets, and a key, value and next pointer per entry
+        sparse_blocks_.bucket_count()*sizeof(void*) +
+        sparse_blocks_.size()*(sizeof(sn_id_t) + 2*sizeof(void*));
 
 	return bytes;
 }
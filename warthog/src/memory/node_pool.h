@@ -18,6 +18,11 @@
 // blocks which are adjacent spatially may not be located 
 // contiguously in memory.
 //
+// Pools of more than SPARSE_NODES nodes do not reserve a pointer for
+// every block; they keep the blocks that were generated in a hash table
+// instead, so that a search over a very large map pays only for the
+// nodes it touches. Lookups check the last block used before the table.
+//
 // @author: dharabor
 // @created: 02/09/2012
 // @updated: 2018-11-01
@@ -27,6 +32,7 @@
 #include "search_node.h"
 
 #include <stdint.h>
+#include <unordered_map>
 
 namespace warthog
 {
@@ -39,6 +45,9 @@ namespace node_pool_ns
 	static const uint64_t NBS = 8; // node block size; set this >= 8
 	static const uint64_t LOG2_NBS = 3;
 	static const uint64_t NBS_MASK = 7;
+
+	// pools larger than this are sparse
+	static const uint64_t SPARSE_NODES = 1ull << 27;
 }
 
 class node_pool
@@ -61,11 +70,31 @@ class node_pool
 		size_t
 		mem();
 
+        inline bool
+        sparse() { return blocks_ == 0; }
+
 	private:
         void init(size_t nblocks);
 
+        // the block @param block_id if it has been generated, else null
+        inline warthog::search_node*
+        find_block(sn_id_t block_id)
+        {
+            if(blocks_) { return blocks_[block_id]; }
+            if(block_id == last_block_id_) { return last_block_; }
+            std::unordered_map<sn_id_t, warthog::search_node*>::iterator it =
+                sparse_blocks_.find(block_id);
+            if(it == sparse_blocks_.end()) { return 0; }
+            last_block_id_ = block_id;
+            last_block_ = it->second;
+            return last_block_;
+        }
+
 		size_t num_blocks_;
 		warthog::search_node** blocks_;
+        std::unordered_map<sn_id_t, warthog::search_node*> sparse_blocks_;
+        sn_id_t last_block_id_;
+        warthog::search_node* last_block_;
 		warthog::mem::cpool* blockspool_;
 //        uint64_t* node_init_;
 //        uint64_t node_init_sz_;
@@ -0,0 +1,103 @@
+#include "batch_scheduler.h"
+
+#include <algorithm>
+#include <random>
+
+warthog::batch_scheduler::batch_scheduler(uint32_t width, uint32_t height,
+        warthog::batch_order order, uint32_t seed)
+    : width_(width), order_(order), seed_(seed)
+{
+    side_ = 1;
+    while(side_ < std::max(width, height)) { side_ <<= 1; }
+}
+
+void
+warthog::batch_scheduler::schedule(
+        const std::vector<warthog::problem_instance>& queries,
+        std::vector<uint32_t>& order)
+{
+    order.resize(queries.size());
+    for(uint32_t i = 0; i < order.size(); i++) { order[i] = i; }
+
+    switch(order_)
+    {
+        case warthog::BATCH_HILBERT:
+        {
+            // one key per query, (start, goal) packed into 128 bits
+            std::vector<std::pair<uint64_t, uint64_t>> keys(queries.size());
+            for(uint32_t i = 0; i < queries.size(); i++)
+            {
+                warthog::grid_id_t s = (warthog::grid_id_t)queries[i].start_id_;
+                warthog::grid_id_t g = (warthog::grid_id_t)queries[i].target_id_;
+                keys[i].first = hilbert_index((uint32_t)(s % width_),
+                        (uint32_t)(s / width_), side_);
+                keys[i].second = hilbert_index((uint32_t)(g % width_),
+                        (uint32_t)(g / width_), side_);
+            }
+            std::stable_sort(order.begin(), order.end(),
+                    [&keys](uint32_t a, uint32_t b)
+                    { return keys[a] < keys[b]; });
+            break;
+        }
+        case warthog::BATCH_RANDOM:
+        {
+            std::mt19937 rng(seed_);
+            std::shuffle(order.begin(), order.end(), rng);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void
+warthog::batch_scheduler::run(warthog::grid_searcher* searcher,
+        std::vector<warthog::problem_instance>& queries,
+        std::vector<warthog::solution>& sols, bool want_path)
+{
+    std::vector<uint32_t> order;
+    schedule(queries, order);
+    sols.resize(queries.size());
+    for(uint32_t i : order)
+    {
+        if(want_path) { searcher->get_path(queries[i], sols[i]); }
+        else { searcher->get_pathcost(queries[i], sols[i]); }
+    }
+}
+
+uint64_t
+warthog::batch_scheduler::hilbert_index(uint32_t x, uint32_t y,
+        uint32_t side)
+{
+    uint64_t d = 0;
+    for(uint32_t s = side / 2; s > 0; s /= 2)
+    {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant so the curve inside it has the
+        // orientation of the curve at the next level down
+        if(ry == 0)
+        {
+            if(rx == 1)
+            {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+bool
+warthog::parse_batch_order(const std::string& name,
+        warthog::batch_order& order)
+{
+    if(name == "input") { order = warthog::BATCH_INPUT; }
+    else if(name == "hilbert") { order = warthog::BATCH_HILBERT; }
+    else if(name == "random") { order = warthog::BATCH_RANDOM; }
+    else { return false; }
+    return true;
+}
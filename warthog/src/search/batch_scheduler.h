@@ -0,0 +1,82 @@
+#ifndef WARTHOG_BATCH_SCHEDULER_H
+#define WARTHOG_BATCH_SCHEDULER_H
+
+// search/batch_scheduler.h
+//
+// Answers a batch of grid queries in an order chosen for memory locality
+// rather than the order they were given in, for bulk workloads (e.g.
+// precomputing paths for many agents or validating spawn points) where
+// only the answers matter.
+//
+// By default queries are sorted by the Hilbert index of their start cell,
+// then of their goal cell, so successive searches start close to each
+// other and touch the same words of the map and the same blocks of the
+// node pool. Solutions are returned in input order regardless.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "grid_searcher.h"
+#include "problem_instance.h"
+#include "solution.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace warthog
+{
+
+typedef enum
+{
+    BATCH_INPUT = 0,    // as given
+    BATCH_HILBERT,      // Hilbert order of start, then goal
+    BATCH_RANDOM        // shuffled; a baseline without any locality
+} batch_order;
+
+class batch_scheduler
+{
+    public:
+        // queries are on a map of @param width x @param height cells;
+        // @param seed is used by BATCH_RANDOM
+        batch_scheduler(uint32_t width, uint32_t height,
+                warthog::batch_order order = warthog::BATCH_HILBERT,
+                uint32_t seed = 0);
+
+        // fill @param order with the indexes of @param queries in the
+        // order they should run. ids are unpadded (y * width + x)
+        void
+        schedule(const std::vector<warthog::problem_instance>& queries,
+                std::vector<uint32_t>& order);
+
+        // answer all @param queries with @param searcher; sols[i] is the
+        // answer to queries[i]. without @param want_path only costs are
+        // computed
+        void
+        run(warthog::grid_searcher* searcher,
+                std::vector<warthog::problem_instance>& queries,
+                std::vector<warthog::solution>& sols, bool want_path = true);
+
+        inline warthog::batch_order
+        get_order() { return order_; }
+
+        // position of cell (@param x, @param y) on the Hilbert curve
+        // filling a square of side @param side (a power of two)
+        static uint64_t
+        hilbert_index(uint32_t x, uint32_t y, uint32_t side);
+
+    private:
+        uint32_t width_;
+        uint32_t side_;
+        warthog::batch_order order_;
+        uint32_t seed_;
+};
+
+// @return false if @param name is not one of "input", "hilbert", "random"
+bool
+parse_batch_order(const std::string& name, warthog::batch_order& order);
+
+}
+
+#endif
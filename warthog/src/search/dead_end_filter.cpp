@@ -0,0 +1,41 @@
+#include "dead_end_filter.h"
+
+warthog::dead_end_filter::dead_end_filter(warthog::dead_end_regions* regions)
+    : regions_(regions), stamp_(0), start_(0), target_(0)
+{
+    open_.assign(regions->num_regions(), 0);
+}
+
+void
+warthog::dead_end_filter::set_start(warthog::grid_id_t id)
+{
+    start_ = regions_->get_region(id);
+    open_regions();
+}
+
+void
+warthog::dead_end_filter::set_target(warthog::grid_id_t id)
+{
+    target_ = regions_->get_region(id);
+    open_regions();
+}
+
+void
+warthog::dead_end_filter::open_regions()
+{
+    // the endpoint set earlier may belong to the last query; opening its
+    // regions too costs some pruning until the other endpoint is set
+    if(++stamp_ == 0)
+    {
+        open_.assign(open_.size(), 0);
+        stamp_ = 1;
+    }
+    for(uint32_t r = start_; r != 0; r = regions_->get_parent(r))
+    {
+        open_[r] = stamp_;
+    }
+    for(uint32_t r = target_; r != 0; r = regions_->get_parent(r))
+    {
+        open_[r] = stamp_;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef WARTHOG_DEAD_END_FILTER_H
+#define WARTHOG_DEAD_END_FILTER_H
+
+// search/dead_end_filter.h
+//
+// Filters the tiles of dead-end regions (see warthog::dead_end_regions)
+// that hold neither the start nor the target of the current query. The
+// regions that enclose the start or the target stay open; every other
+// region is skipped whole, since no optimal path enters it.
+//
+// The grid expansion policies call set_start and set_target when they
+// generate the start and target nodes, in either order; between two
+// queries only the regions of the endpoints are marked again.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "constants.h"
+#include "dead_end_regions.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class dead_end_filter
+{
+    public:
+        // @param regions is not owned
+        dead_end_filter(warthog::dead_end_regions* regions);
+        ~dead_end_filter() { }
+
+        // true if the tile with padded id @param id lies in a region that
+        // the current query never needs to enter
+        inline bool
+        filter(warthog::grid_id_t id)
+        {
+            uint32_t r = regions_->get_region(id);
+            return r != 0 && open_[r] != stamp_;
+        }
+
+        void
+        set_start(warthog::grid_id_t id);
+
+        void
+        set_target(warthog::grid_id_t id);
+
+        inline warthog::dead_end_regions*
+        get_regions() { return regions_; }
+
+        inline size_t
+        mem()
+        { return sizeof(*this) + sizeof(uint32_t) * open_.capacity(); }
+
+    private:
+        warthog::dead_end_regions* regions_;
+        std::vector<uint32_t> open_;
+        uint32_t stamp_;
+        uint32_t start_;
+        uint32_t target_;
+
+        // open the regions around the start and the target
+        void
+        open_regions();
+};
+
+}
+
+#endif
@@ -18,6 +18,7 @@
 
 #include "cpool.h"
 #include "search/dummy_listener.h"
+#include "phase_timer.h"
 #include "pqueue.h"
 #include "problem_instance.h"
 #include "search.h"
@@ -26,6 +27,7 @@
 #include "timer.h"
 #include "global.h"
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -50,6 +52,7 @@ class flexible_astar: public warthog::search
             cost_cutoff_ = warthog::COST_MAX;
             exp_cutoff_ = UINT32_MAX;
             pi_.instance_id_ = UINT32_MAX;
+            status_ = warthog::SEARCH_NO_PATH;
 		}
 
 		virtual ~flexible_astar() { }
@@ -58,7 +61,7 @@ class flexible_astar: public warthog::search
 		get_pathcost(
                 warthog::problem_instance& instance, warthog::solution& sol)
         {
-
+            PHASE_TOTAL_SCOPE();
             sol.reset();
             pi_ = instance;
 
@@ -69,9 +72,66 @@ class flexible_astar: public warthog::search
             }
         }
 
+        // resumable search for frame-budgeted callers. ::begin sets up a
+        // search for @param instance without expanding anything and ::step
+        // continues it until it ends or until the budget of the step runs
+        // out, in which case SEARCH_IN_PROGRESS is returned and the next
+        // call resumes where this one stopped.
+        //
+        // the state of a resumable search lives in the open list and node
+        // pool; neither they nor this object may be used for anything else
+        // until ::step returns a status other than SEARCH_IN_PROGRESS.
+        // counters and time accumulate in @param sol over all steps.
+        warthog::search_status
+        begin(warthog::problem_instance& instance, warthog::solution& sol)
+        {
+            PHASE_TOTAL_SCOPE();
+            warthog::timer mytimer;
+            mytimer.start();
+            sol.reset();
+            pi_ = instance;
+            status_ = start_search(sol) ?
+                warthog::SEARCH_IN_PROGRESS : warthog::SEARCH_NO_PATH;
+            mytimer.stop();
+            sol.time_elapsed_nano_ = mytimer.elapsed_time_nano();
+            sol.status_ = status_;
+            return status_;
+        }
+
+        // expand at most @param max_expansions nodes and, if
+        // @param max_nanos is not zero, stop after roughly that much time.
+        // every step expands at least one node. with @param want_path the
+        // path is extracted once the target is found (as ::get_path does)
+        warthog::search_status
+        step(warthog::solution& sol, uint32_t max_expansions,
+                double max_nanos = 0, bool want_path = true)
+        {
+            if(status_ != warthog::SEARCH_IN_PROGRESS) { return status_; }
+
+            PHASE_TOTAL_SCOPE();
+            warthog::timer mytimer;
+            mytimer.start();
+
+            warthog::search_node* target = 0;
+            status_ = expand_nodes(sol, target, max_expansions,
+                    max_nanos > 0 ? mytimer.get_time_nano() + max_nanos : 0);
+            if(target)
+            {
+                sol.sum_of_edge_costs_ = target->get_g();
+                if(want_path) { extract_path(target, sol); }
+            }
+
+            mytimer.stop();
+            sol.time_elapsed_nano_ += mytimer.elapsed_time_nano();
+            sol.nodes_surplus_ = open_->size();
+            sol.status_ = status_;
+            return status_;
+        }
+
         virtual void
 		get_path(warthog::problem_instance& instance, warthog::solution& sol)
 		{
+            PHASE_TOTAL_SCOPE();
             sol.reset();
             pi_ = instance;
 
@@ -79,35 +139,7 @@ class flexible_astar: public warthog::search
 			if(target)
 			{
                 sol.sum_of_edge_costs_ = target->get_g();
-
-				// follow backpointers to extract the path
-				assert(expander_->is_target(target, &pi_));
-                warthog::search_node* current = target;
-				while(true)
-                {
-                    sol.path_.push_back(current->get_id());
-                    if(current->get_parent() == warthog::SN_ID_MAX) break;
-                    current = expander_->generate(current->get_parent());
-				}
-                std::reverse(sol.path_.begin(), sol.path_.end());
-
-                #ifndef NDEBUG
-                if(pi_.verbose_)
-                {
-                    for(auto& state : sol.path_)
-                    {
-                        int32_t x, y;
-                        expander_->get_xy(state, x, y);
-                        std::cerr
-                            << "final path: (" << x << ", " << y << ")...";
-                        warthog::search_node* n =
-                            expander_->generate(state);
-                        assert(n->get_search_number() == pi_.instance_id_);
-                        n->print(std::cerr);
-                        std::cerr << std::endl;
-                    }
-                }
-                #endif
+                extract_path(target, sol);
             }
 		}
 
@@ -198,45 +230,122 @@ class flexible_astar: public warthog::search
         warthog::cost_t cost_cutoff_;
         uint32_t exp_cutoff_;
 
+        // outcome of the last (or current resumable) search
+        warthog::search_status status_;
+
 		// no copy ctor
 		flexible_astar(const flexible_astar& other) { }
 		flexible_astar&
 		operator=(const flexible_astar& other) { return *this; }
 
+		// follow backpointers from @param target to extract the path
+		void
+		extract_path(warthog::search_node* target, warthog::solution& sol)
+		{
+			PHASE_SCOPE(PATH);
+			assert(expander_->is_target(target, &pi_));
+			warthog::search_node* current = target;
+			while(true)
+			{
+				sol.path_.push_back(current->get_id());
+				if(current->get_parent() == warthog::SN_ID_MAX) break;
+				current = expander_->generate(current->get_parent());
+			}
+			std::reverse(sol.path_.begin(), sol.path_.end());
+
+			#ifndef NDEBUG
+			if(pi_.verbose_)
+			{
+				for(auto& state : sol.path_)
+				{
+					int32_t x, y;
+					expander_->get_xy(state, x, y);
+					std::cerr
+						<< "final path: (" << x << ", " << y << ")...";
+					warthog::search_node* n =
+						expander_->generate(state);
+					assert(n->get_search_number() == pi_.instance_id_);
+					n->print(std::cerr);
+					std::cerr << std::endl;
+				}
+			}
+			#endif
+		}
+
 		warthog::search_node*
 		search(warthog::solution& sol)
 		{
 			warthog::timer mytimer;
 			mytimer.start();
-			open_->clear();
+			status_ = warthog::SEARCH_NO_PATH;
+			if(!start_search(sol)) { return 0; }
 
-			warthog::search_node* start;
 			warthog::search_node* target = 0;
+			status_ = expand_nodes(sol, target, UINT32_MAX, 0);
+
+			mytimer.stop();
+			sol.time_elapsed_nano_ = mytimer.elapsed_time_nano();
+            sol.nodes_surplus_ = open_->size();
+            sol.status_ = status_;
+
+            #ifndef NDEBUG
+            if(pi_.verbose_)
+            {
+                if(target == 0)
+                {
+                    std::cerr
+                        << "search failed; no solution exists " << std::endl;
+                }
+                else
+                {
+                    int32_t x, y;
+                    expander_->get_xy(target->get_id(), x, y);
+                    std::cerr << "target found ("<<x<<", "<<y<<")...";
+                    target->print(std::cerr);
+                    std::cerr << std::endl;
+                }
+            }
+            #endif
+
+            return target;
+		}
+
+		// generate the start and target nodes and push the start node
+		// onto the open list. @return false if either is invalid
+		bool
+		start_search(warthog::solution& sol)
+		{
+			open_->clear();
+			warthog::search_node* start;
 
       // get the internal target id
       if(pi_.target_id_ != warthog::SN_ID_MAX)
       {
           warthog::search_node* target =
               expander_->generate_target_node(&pi_);
-          if(!target) { return 0; } // invalid target location
+          if(!target) { return false; } // invalid target location
           pi_.target_id_ = target->get_id();
 
       }
 
       // initialise and push the start node
-      if(pi_.start_id_ == warthog::SN_ID_MAX) { return 0; }
+      if(pi_.start_id_ == warthog::SN_ID_MAX) { return false; }
       start = expander_->generate_start_node(&pi_);
+      if(!start) { return false; } // invalid start location
       assert(start->get_search_number() != pi_.instance_id_);
-      if(!start) { return 0; } // invalid start location
       pi_.start_id_ = start->get_id();
 
-			start->init(pi_.instance_id_, warthog::SN_ID_MAX,
-                    0, heuristic_->h(pi_.start_id_, pi_.target_id_));
-      global::query::pi = &pi_;
-      global::query::startid = pi_.start_id_;
-      global::query::goalid = pi_.target_id_;
+			warthog::cost_t hval;
+			{
+				PHASE_SCOPE(HEURISTIC);
+				hval = heuristic_->h(pi_.start_id_, pi_.target_id_);
+			}
+			start->init(pi_.instance_id_, warthog::SN_ID_MAX, 0, hval);
 
-			open_->push(start);
+			{
+				PHASE_SCOPE(OPEN);
+				open_->push(start);
+			}
       sol.nodes_inserted_++;
 
       listener_->generate_node(0, start, 0, UINT32_MAX);
@@ -244,16 +353,55 @@ class flexible_astar: public warthog::search
 			#ifndef NDEBUG
 			if(pi_.verbose_) { pi_.print(std::cerr); std:: cerr << "\n";}
 			#endif
+			return true;
+		}
+
+		// expand nodes until the target is found (which is then stored
+		// in @param target), the open list runs empty, the query is
+		// cancelled or times out, or a limit is reached: a cutoff,
+		// @param max_expansions more expansions or the time
+		// @param deadline (in timer::get_time_nano units; 0 for none)
+		warthog::search_status
+		expand_nodes(warthog::solution& sol, warthog::search_node*& target,
+				uint32_t max_expansions, double deadline)
+		{
+			uint64_t first = sol.nodes_expanded_;
+			uint64_t step_limit = first + std::max<uint32_t>(1, max_expansions);
+			warthog::timer clock;
+			bool interruptible = pi_.interruptible();
 
             // begin expanding
 			while(open_->size())
 			{
                 // early termination: in case we want bounded-cost
                 // search or if we want to impose some memory limit
-                if(open_->peek()->get_f() > cost_cutoff_) { break; }
-                if(sol.nodes_expanded_ >= exp_cutoff_) { break; }
-
-				warthog::search_node* current = open_->pop();
+                if(open_->peek()->get_f() > cost_cutoff_)
+                { return warthog::SEARCH_CUTOFF; }
+                if(sol.nodes_expanded_ >= exp_cutoff_)
+                { return warthog::SEARCH_CUTOFF; }
+
+                // cooperative cancellation; the query is looked at every
+                // 64 expansions and right after a jump point locator has
+                // given up a scan because of it
+                if(interruptible &&
+                   ((sol.nodes_expanded_ & 63) == 0 || stopped()) &&
+                   pi_.should_stop())
+                { return stop_status(); }
+
+                // budget of a resumable step; the clock is read every
+                // 16 expansions and at least one node is always expanded
+                if(sol.nodes_expanded_ >= step_limit)
+                { return warthog::SEARCH_IN_PROGRESS; }
+                if(deadline > 0 && (sol.nodes_expanded_ & 15) == 0 &&
+                   sol.nodes_expanded_ != first &&
+                   clock.get_time_nano() >= deadline)
+                { return warthog::SEARCH_IN_PROGRESS; }
+
+				warthog::search_node* current;
+				{
+					PHASE_SCOPE(OPEN);
+					current = open_->pop();
+				}
 				current->set_expanded(true); // NB: set before generating
 				assert(current->get_expanded());
 				sol.nodes_expanded_++;
@@ -263,7 +411,7 @@ class flexible_astar: public warthog::search
                 if(expander_->is_target(current, &pi_))
                 {
                     target = current;
-                    break;
+                    return warthog::SEARCH_FOUND;
                 }
 
 				#ifndef NDEBUG
@@ -295,11 +443,18 @@ class flexible_astar: public warthog::search
                     if(n->get_search_number() != current->get_search_number())
                     {
 						warthog::cost_t gval = current->get_g() + cost_to_n;
+						warthog::cost_t hval;
+						{
+							PHASE_SCOPE(HEURISTIC);
+							hval = heuristic_->h(n->get_id(),pi_.target_id_);
+						}
                         n->init(current->get_search_number(), current->get_id(),
-                            gval,
-                            gval + heuristic_->h(n->get_id(),pi_.target_id_));
+                            gval, gval + hval);
 
-                        open_->push(n);
+                        {
+                            PHASE_SCOPE(OPEN);
+                            open_->push(n);
+                        }
                         sol.nodes_inserted_++;
                         #ifdef CNT
                         global::statis::update_subopt_insert(n->get_id(), n->get_g());
@@ -346,7 +501,10 @@ class flexible_astar: public warthog::search
 						if(gval < n->get_g())
 						{
 							n->relax(gval, current->get_id());
-							open_->decrease_key(n);
+							{
+								PHASE_SCOPE(OPEN);
+								open_->decrease_key(n);
+							}
                             sol.nodes_updated_++;
 
 							#ifndef NDEBUG
@@ -381,10 +539,17 @@ class flexible_astar: public warthog::search
 					}
           // set_corner_gv may set g-value in runtime without pushing to open
           else if (gval < n->get_g()) {
+            warthog::cost_t hval;
+            {
+              PHASE_SCOPE(HEURISTIC);
+              hval = heuristic_->h(n->get_id(), pi_.target_id_);
+            }
             n->init(current->get_search_number(), current->get_id(),
-              gval,
-              gval + heuristic_->h(n->get_id(), pi_.target_id_));
-            open_->push(n);
+              gval, gval + hval);
+            {
+              PHASE_SCOPE(OPEN);
+              open_->push(n);
+            }
             sol.nodes_inserted_++;
             #ifdef CNT
             global::statis::update_subopt_insert(n->get_id(), n->get_g());
@@ -408,31 +573,18 @@ class flexible_astar: public warthog::search
           }
 				}
 			}
+			// the last expansion may have been cut short
+			return stopped() ? stop_status() : warthog::SEARCH_NO_PATH;
+		}
 
-			mytimer.stop();
-			sol.time_elapsed_nano_ = mytimer.elapsed_time_nano();
-            sol.nodes_surplus_ = open_->size();
+		inline bool
+		stopped() { return pi_.cancelled() || pi_.timed_out(); }
 
-            #ifndef NDEBUG
-            if(pi_.verbose_)
-            {
-                if(target == 0)
-                {
-                    std::cerr
-                        << "search failed; no solution exists " << std::endl;
-                }
-                else
-                {
-                    int32_t x, y;
-                    expander_->get_xy(target->get_id(), x, y);
-                    std::cerr << "target found ("<<x<<", "<<y<<")...";
-                    target->print(std::cerr);
-                    std::cerr << std::endl;
-                }
-            }
-            #endif
-
-            return target;
+		inline warthog::search_status
+		stop_status()
+		{
+			return pi_.cancelled() ?
+				warthog::SEARCH_CANCELLED : warthog::SEARCH_TIMED_OUT;
 		}
 };
 
@@ -0,0 +1,225 @@
+#include "grid_searcher.h"
+#include "flexible_astar.h"
+#include "global.h"
+#include "gridmap_expansion_policy.h"
+#include "jps_expansion_policy.h"
+#include "jps2_expansion_policy.h"
+#include "jps2_expansion_policy_prune2.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+#include "rsr_expansion_policy.h"
+#include "subgoal_expansion_policy.h"
+#include "zero_heuristic.h"
+
+namespace
+{
+
+// heuristics differ in their constructor arguments; these helpers
+// let the searcher template below build either kind from a gridmap
+template<class H> H*
+make_heuristic(warthog::gridmap* map);
+
+template<> warthog::octile_heuristic*
+make_heuristic<warthog::octile_heuristic>(warthog::gridmap* map)
+{ return new warthog::octile_heuristic(map->width(), map->height()); }
+
+template<> warthog::zero_heuristic*
+make_heuristic<warthog::zero_heuristic>(warthog::gridmap* map)
+{ return new warthog::zero_heuristic(); }
+
+// likewise for expansion policies; only the jump point and subgoal
+// policies take a rotated map
+template<class E> E*
+make_expander(warthog::gridmap* map, warthog::gridmap* rmap)
+{ return new E(map, rmap); }
+
+template<> warthog::gridmap_expansion_policy*
+make_expander<warthog::gridmap_expansion_policy>(
+        warthog::gridmap* map, warthog::gridmap* rmap)
+{ return new warthog::gridmap_expansion_policy(map); }
+
+template<> warthog::rsr_expansion_policy*
+make_expander<warthog::rsr_expansion_policy>(
+        warthog::gridmap* map, warthog::gridmap* rmap)
+{ return new warthog::rsr_expansion_policy(map); }
+
+template<class E> void
+set_expander_map(E* expander, warthog::gridmap* map, warthog::gridmap* rmap)
+{ expander->set_map(map, rmap); }
+
+void
+set_expander_map(warthog::gridmap_expansion_policy* expander,
+        warthog::gridmap* map, warthog::gridmap* rmap)
+{ expander->set_map(map); }
+
+void
+set_expander_map(warthog::rsr_expansion_policy* expander,
+        warthog::gridmap* map, warthog::gridmap* rmap)
+{ expander->set_map(map); }
+
+// the jump point policies keep the state that their locators read in a
+// global::search_context; the other policies have none
+template<class E> global::search_context*
+get_context(E* expander) { return 0; }
+
+global::search_context*
+get_context(warthog::jps_expansion_policy* expander)
+{ return expander->get_context(); }
+
+global::search_context*
+get_context(warthog::jps2_expansion_policy* expander)
+{ return expander->get_context(); }
+
+global::search_context*
+get_context(warthog::jps2_expansion_policy_prune2* expander)
+{ return expander->get_context(); }
+
+// subgoal graph paths list only subgoals; the other policies give
+// complete paths already
+template<class E> void
+refine_path(E* expander, warthog::solution& sol) { }
+
+void
+refine_path(warthog::subgoal_expansion_policy* expander,
+        warthog::solution& sol)
+{ expander->refine(sol.path_); }
+
+template<class H, class E>
+class grid_searcher_impl : public warthog::grid_searcher
+{
+    public:
+        grid_searcher_impl(const std::string& name, warthog::gridmap* map,
+                warthog::gridmap* rmap)
+            : grid_searcher(name, map)
+        {
+            heuristic_ = make_heuristic<H>(map);
+            expander_ = make_expander<E>(map, rmap);
+            open_ = new warthog::pqueue_min();
+            astar_ = new warthog::flexible_astar<H, E, warthog::pqueue_min>
+                (heuristic_, expander_, open_);
+            ctx_ = get_context(expander_);
+            if(ctx_) { ctx_->open = open_; }
+        }
+
+        virtual ~grid_searcher_impl()
+        {
+            delete astar_;
+            delete open_;
+            delete expander_;
+            delete heuristic_;
+        }
+
+        virtual void
+        get_path(warthog::problem_instance& pi, warthog::solution& sol)
+        {
+            reset_scans();
+            astar_->get_path(pi, sol);
+            refine_path(expander_, sol);
+        }
+
+        virtual void
+        get_pathcost(warthog::problem_instance& pi, warthog::solution& sol)
+        {
+            reset_scans();
+            astar_->get_pathcost(pi, sol);
+        }
+
+        virtual warthog::search_status
+        begin(warthog::problem_instance& pi, warthog::solution& sol)
+        {
+            reset_scans();
+            return astar_->begin(pi, sol);
+        }
+
+        virtual warthog::search_status
+        step(warthog::solution& sol, uint32_t max_expansions,
+                double max_nanos, bool want_path)
+        {
+            warthog::search_status status =
+                astar_->step(sol, max_expansions, max_nanos, want_path);
+            if(status != warthog::SEARCH_IN_PROGRESS && want_path)
+            {
+                refine_path(expander_, sol);
+            }
+            return status;
+        }
+
+        virtual size_t
+        mem() { return astar_->mem(); }
+
+        virtual uint32_t
+        get_scan_count() { return ctx_ ? ctx_->scan_cnt : 0; }
+
+        virtual void
+        set_map(warthog::gridmap* map, warthog::gridmap* rmap)
+        {
+            map_ = map;
+            set_expander_map(expander_, map, rmap);
+        }
+
+    private:
+        H* heuristic_;
+        E* expander_;
+        warthog::pqueue_min* open_;
+        warthog::flexible_astar<H, E, warthog::pqueue_min>* astar_;
+        global::search_context* ctx_;
+
+        inline void
+        reset_scans()
+        {
+            if(ctx_) { ctx_->scan_cnt = 0; }
+        }
+};
+
+}
+
+warthog::grid_searcher*
+warthog::create_grid_searcher(const std::string& alg, warthog::gridmap* map,
+        warthog::gridmap* rmap)
+{
+    if(alg == "jps2")
+    {
+        return new grid_searcher_impl<warthog::octile_heuristic,
+               warthog::jps2_expansion_policy>(alg, map, rmap);
+    }
+    if(alg == "jps2-prune2")
+    {
+        return new grid_searcher_impl<warthog::octile_heuristic,
+               warthog::jps2_expansion_policy_prune2>(alg, map, rmap);
+    }
+    if(alg == "jps")
+    {
+        return new grid_searcher_impl<warthog::octile_heuristic,
+               warthog::jps_expansion_policy>(alg, map, rmap);
+    }
+    if(alg == "astar")
+    {
+        return new grid_searcher_impl<warthog::octile_heuristic,
+               warthog::gridmap_expansion_policy>(alg, map, rmap);
+    }
+    if(alg == "dijkstra")
+    {
+        return new grid_searcher_impl<warthog::zero_heuristic,
+               warthog::gridmap_expansion_policy>(alg, map, rmap);
+    }
+    if(alg == "subgoal")
+    {
+        return new grid_searcher_impl<warthog::octile_heuristic,
+               warthog::subgoal_expansion_policy>(alg, map, rmap);
+    }
+    if(alg == "rsr")
+    {
+        return new grid_searcher_impl<warthog::octile_heuristic,
+               warthog::rsr_expansion_policy>(alg, map, rmap);
+    }
+    return 0;
+}
+
+const std::vector<std::string>&
+warthog::grid_searcher_names()
+{
+    static const std::vector<std::string> names =
+        {"jps2", "jps2-prune2", "jps", "astar", "dijkstra",
+         "subgoal", "rsr"};
+    return names;
+}
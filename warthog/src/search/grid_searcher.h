@@ -0,0 +1,100 @@
+#ifndef WARTHOG_GRID_SEARCHER_H
+#define WARTHOG_GRID_SEARCHER_H
+
+// search/grid_searcher.h
+//
+// A grid_searcher bundles everything needed to answer queries with one of
+// the grid algorithms exposed by the warthog program: an expansion policy,
+// a heuristic, an open list and the search itself. Searchers are created by
+// name on top of a gridmap which is not owned and can be shared by several
+// searchers; each searcher keeps its own node pool. The rotated copy of
+// the map used by the jump point searches can be shared in the same way.
+//
+// The jump point searches keep the state their locators read during a
+// query in a global::search_context of their own, so searchers built on
+// the same map can be interleaved and run on different threads.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "gridmap.h"
+#include "problem_instance.h"
+#include "search.h"
+#include "solution.h"
+
+#include <string>
+#include <vector>
+
+namespace warthog
+{
+
+class grid_searcher : public warthog::search
+{
+    public:
+        grid_searcher(const std::string& name, warthog::gridmap* map)
+            : name_(name), map_(map) { }
+        virtual ~grid_searcher() { }
+
+        // start and target ids of @param pi are unpadded map indexes
+        // (i.e. y * header_width + x)
+        virtual void
+        get_path(warthog::problem_instance& pi, warthog::solution& sol) = 0;
+
+        virtual void
+        get_pathcost(warthog::problem_instance& pi, warthog::solution& sol) = 0;
+
+        // resumable queries for callers with a budget per frame or tick:
+        // ::begin starts the query @param pi and ::step expands at most
+        // @param max_expansions nodes (0 counts as 1) or, if @param max_nanos
+        // is not zero, runs for about that long. both return
+        // SEARCH_IN_PROGRESS until the query ends; the path (or, without
+        // @param want_path, only the cost) is then in @param sol. a searcher runs one query at a time
+        // and must not be used for anything else until that query ends.
+        virtual warthog::search_status
+        begin(warthog::problem_instance& pi, warthog::solution& sol) = 0;
+
+        virtual warthog::search_status
+        step(warthog::solution& sol, uint32_t max_expansions,
+                double max_nanos = 0, bool want_path = true) = 0;
+
+        virtual size_t
+        mem() = 0;
+
+        // the scanning steps of the jump point searches (see
+        // global::search_context) in the last query; 0 for the others
+        virtual uint32_t
+        get_scan_count() { return 0; }
+
+        // continue on another version of the map, with the same
+        // dimensions, and (optionally) its shared rotated copy @param rmap.
+        // not to be called while a resumable query is in progress
+        virtual void
+        set_map(warthog::gridmap* map, warthog::gridmap* rmap = 0) = 0;
+
+        inline const std::string&
+        get_name() { return name_; }
+
+        inline warthog::gridmap*
+        get_map() { return map_; }
+
+    protected:
+        std::string name_;
+        warthog::gridmap* map_;
+};
+
+// @return a new searcher running algorithm @param alg on @param map or
+// 0 if the algorithm name is not recognised. searchers that need a rotated
+// copy of the map use @param rmap if given (it is not owned; see
+// warthog::jps::create_rmap) and make their own otherwise
+warthog::grid_searcher*
+create_grid_searcher(const std::string& alg, warthog::gridmap* map,
+        warthog::gridmap* rmap = 0);
+
+// the list of algorithm names accepted by ::create_grid_searcher
+const std::vector<std::string>&
+grid_searcher_names();
+
+}
+
+#endif
@@ -5,7 +5,8 @@
 
 warthog::gridmap_expansion_policy::gridmap_expansion_policy(
 		warthog::gridmap* map, bool manhattan)
-: expansion_policy(map->height()*map->width()), map_(map), manhattan_(manhattan)
+: expansion_policy(map->height()*map->width()), map_(map), manhattan_(manhattan),
+  dead_ends_(0)
 {
 }
 
@@ -45,38 +46,38 @@ warthog::gridmap_expansion_policy::expand(warthog::search_node* current,
 	// generate cardinal moves
     if((tiles & 514) == 514) // N
 	{  
-		add_neighbour(this->generate(nid_m_w), 1);
+		add_tile(nid_m_w, 1);
 	} 
 	if((tiles & 1536) == 1536) // E
 	{
-		add_neighbour(this->generate(nodeid + 1), 1);
+		add_tile(nodeid + 1, 1);
 	}
 	if((tiles & 131584) == 131584) // S
 	{ 
-		add_neighbour(this->generate(nid_p_w), 1);
+		add_tile(nid_p_w, 1);
 	}
 	if((tiles & 768) == 768) // W
 	{ 
-		add_neighbour(this->generate(nodeid - 1), 1);
+		add_tile(nodeid - 1, 1);
 	}
     if(manhattan_) { return; }
 
     // generate diagonal moves
 	if((tiles & 1542) == 1542) // NE
 	{ 
-        add_neighbour(this->generate(nid_m_w + 1), warthog::DBL_ROOT_TWO);
+        add_tile(nid_m_w + 1, warthog::DBL_ROOT_TWO);
 	}
 	if((tiles & 394752) == 394752) // SE
 	{	
-        add_neighbour(this->generate(nid_p_w + 1), warthog::DBL_ROOT_TWO);
+        add_tile(nid_p_w + 1, warthog::DBL_ROOT_TWO);
 	}
 	if((tiles & 197376) == 197376) // SW
 	{ 
-        add_neighbour(this->generate(nid_p_w - 1), warthog::DBL_ROOT_TWO);
+        add_tile(nid_p_w - 1, warthog::DBL_ROOT_TWO);
 	}
 	if((tiles & 771) == 771) // NW
 	{ 
-		add_neighbour(this->generate(nid_m_w - 1), warthog::DBL_ROOT_TWO);
+		add_tile(nid_m_w - 1, warthog::DBL_ROOT_TWO);
 	}
 
 
@@ -97,6 +98,7 @@ warthog::gridmap_expansion_policy::generate_start_node(
     if((uint32_t)pi->start_id_ >= max_id) { return 0; }
     uint32_t padded_id = map_->to_padded_id((uint32_t)pi->start_id_);
     if(map_->get_label(padded_id) == 0) { return 0; }
+    if(dead_ends_) { dead_ends_->set_start(padded_id); }
     return generate(padded_id);
 }
 
@@ -108,6 +110,7 @@ warthog::gridmap_expansion_policy::generate_target_node(
     if((uint32_t)pi->target_id_ >= max_id) { return 0; }
     uint32_t padded_id = map_->to_padded_id((uint32_t)pi->target_id_);
     if(map_->get_label(padded_id) == 0) { return 0; }
+    if(dead_ends_) { dead_ends_->set_target(padded_id); }
     return generate(padded_id);
 }
 
@@ -20,6 +20,7 @@
 // @created: 28/10/2010
 //
 
+#include "dead_end_filter.h"
 #include "expansion_policy.h"
 #include "gridmap.h"
 #include "search_node.h"
@@ -50,10 +51,30 @@ class gridmap_expansion_policy : public expansion_policy
 
 		virtual size_t
 		mem();
+
+		// switch to another version of the map with the same dimensions
+		// (e.g. a newer warthog::gridmap_snapshot) between searches
+		inline void
+		set_map(warthog::gridmap* map) { map_ = map; }
+
+		// skip the dead-end regions that a query never needs to enter
+		// (see warthog::dead_end_filter); null, the default, prunes none.
+		// the filter is not owned
+		inline void
+		set_dead_end_filter(warthog::dead_end_filter* filter)
+		{ dead_ends_ = filter; }
 	
 	private:
 		warthog::gridmap* map_;
         bool manhattan_;
+		warthog::dead_end_filter* dead_ends_;
+
+		inline void
+		add_tile(uint32_t id, warthog::cost_t cost)
+		{
+			if(dead_ends_ && dead_ends_->filter(id)) { return; }
+			add_neighbour(this->generate(id), cost);
+		}
 };
 
 }
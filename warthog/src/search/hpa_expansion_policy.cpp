@@ -0,0 +1,107 @@
+#include "hpa_expansion_policy.h"
+#include "problem_instance.h"
+
+warthog::hpa_expansion_policy::hpa_expansion_policy(
+        warthog::gridmap* map, uint32_t cluster_size)
+    : expansion_policy(map->height() * map->width()), map_(map),
+      start_(warthog::INF32), target_cluster_(warthog::INF32)
+{
+    graph_ = new warthog::hpa_graph(map, cluster_size);
+}
+
+warthog::hpa_expansion_policy::~hpa_expansion_policy()
+{
+    delete graph_;
+}
+
+void
+warthog::hpa_expansion_policy::expand(
+        warthog::search_node* current, warthog::problem_instance* problem)
+{
+    reset();
+    uint32_t id = (uint32_t)current->get_id();
+    uint32_t target = (uint32_t)problem->target_id_;
+
+    if(id == start_)
+    {
+        neis_.clear();
+        graph_->connect(id, neis_, target);
+        for(const warthog::hpa_graph::edge& e : neis_)
+        {
+            add_neighbour(generate(e.id_), e.cost_);
+        }
+        if(!graph_->is_node(id)) { return; }
+    }
+    else
+    {
+        // only the start and the target are expanded without being
+        // nodes, and the target is never expanded
+        for(const warthog::hpa_graph::edge& e : graph_->intra_edges(id))
+        {
+            add_neighbour(generate(e.id_), e.cost_);
+        }
+        if(graph_->cluster_of(id) == target_cluster_)
+        {
+            for(const warthog::hpa_graph::edge& e : target_edges_)
+            {
+                if(e.id_ == id)
+                {
+                    add_neighbour(generate(target), e.cost_);
+                    break;
+                }
+            }
+        }
+    }
+    for(const warthog::hpa_graph::edge& e : graph_->inter_edges(id))
+    {
+        add_neighbour(generate(e.id_), e.cost_);
+    }
+}
+
+void
+warthog::hpa_expansion_policy::get_xy(warthog::sn_id_t node_id,
+        int32_t& x, int32_t& y)
+{
+    map_->to_unpadded_xy((uint32_t)node_id, (uint32_t&)x, (uint32_t&)y);
+}
+
+warthog::search_node*
+warthog::hpa_expansion_policy::generate_start_node(
+        warthog::problem_instance* pi)
+{
+    uint32_t start_id = (uint32_t)pi->start_id_;
+    uint32_t max_id = map_->header_width() * map_->header_height();
+
+    if(start_id >= max_id) { return 0; }
+    uint32_t padded_id = map_->to_padded_id(start_id);
+    if(map_->get_label(padded_id) == 0) { return 0; }
+    start_ = padded_id;
+    return generate(padded_id);
+}
+
+warthog::search_node*
+warthog::hpa_expansion_policy::generate_target_node(
+        warthog::problem_instance* pi)
+{
+    uint32_t target_id = (uint32_t)pi->target_id_;
+    uint32_t max_id = map_->header_width() * map_->header_height();
+
+    if(target_id >= max_id) { return 0; }
+    uint32_t padded_id = map_->to_padded_id(target_id);
+    if(map_->get_label(padded_id) == 0) { return 0; }
+
+    // distances inside a cluster are symmetric, so those from the target
+    // serve as the last edges of a path
+    target_edges_.clear();
+    graph_->connect(padded_id, target_edges_);
+    target_cluster_ = graph_->cluster_of(padded_id);
+    return generate(padded_id);
+}
+
+size_t
+warthog::hpa_expansion_policy::mem()
+{
+    return expansion_policy::mem() + sizeof(*this) + graph_->mem() +
+        sizeof(warthog::hpa_graph::edge) *
+            (target_edges_.capacity() + neis_.capacity());
+}
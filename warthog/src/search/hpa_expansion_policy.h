@@ -0,0 +1,70 @@
+#ifndef WARTHOG_HPA_EXPANSION_POLICY_H
+#define WARTHOG_HPA_EXPANSION_POLICY_H
+
+// search/hpa_expansion_policy.h
+//
+// An expansion policy for searching the abstract graph of hierarchical
+// path-finding A* (see warthog::hpa_graph). Nodes are padded map ids, so
+// the octile heuristic works unchanged. As with subgoal graphs, a query
+// connects its target to the nodes of its cluster when the target node is
+// generated and its start when the start is expanded; the start is
+// connected to the target directly if both share a cluster.
+//
+// Paths found this way list entrances only; warthog::hpa_search refines
+// them into grid paths.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "expansion_policy.h"
+#include "gridmap.h"
+#include "hpa_graph.h"
+#include "search_node.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class problem_instance;
+class hpa_expansion_policy : public expansion_policy
+{
+    public:
+        // clusters of @param cluster_size tiles a side
+        hpa_expansion_policy(warthog::gridmap* map, uint32_t cluster_size);
+        virtual ~hpa_expansion_policy();
+
+        virtual void
+        expand(warthog::search_node*, warthog::problem_instance*);
+
+        virtual void
+        get_xy(sn_id_t node_id, int32_t& x, int32_t& y);
+
+        virtual warthog::search_node*
+        generate_start_node(warthog::problem_instance* pi);
+
+        virtual warthog::search_node*
+        generate_target_node(warthog::problem_instance* pi);
+
+        virtual size_t
+        mem();
+
+        inline warthog::hpa_graph*
+        get_graph() { return graph_; }
+
+    private:
+        warthog::gridmap* map_;
+        warthog::hpa_graph* graph_;
+
+        // the start of the current query, and the distances between its
+        // target and the nodes of the target's cluster
+        uint32_t start_;
+        uint32_t target_cluster_;
+        std::vector<warthog::hpa_graph::edge> target_edges_;
+        std::vector<warthog::hpa_graph::edge> neis_;
+};
+
+}
+
+#endif
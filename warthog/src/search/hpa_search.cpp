@@ -0,0 +1,144 @@
+#include "hpa_search.h"
+#include "timer.h"
+
+namespace
+{
+
+// added to the cutoff of a refinement against rounding differences
+// between the abstract and grid costs
+const double CUTOFF_SLACK = 1e-4;
+
+}
+
+warthog::hpa_search::hpa_search(warthog::gridmap* map, uint32_t cluster_size)
+    : map_(map), lazy_(false)
+{
+    abstract_expander_ = new warthog::hpa_expansion_policy(map, cluster_size);
+    heuristic_ = new warthog::octile_heuristic(map->width(), map->height());
+    abstract_open_ = new warthog::pqueue_min();
+    abstract_ = new warthog::flexible_astar<warthog::octile_heuristic,
+        warthog::hpa_expansion_policy, warthog::pqueue_min>(
+            heuristic_, abstract_expander_, abstract_open_);
+
+    refine_expander_ = new warthog::jps2_expansion_policy(map);
+    refine_open_ = new warthog::pqueue_min();
+    refine_ = new warthog::flexible_astar<warthog::octile_heuristic,
+        warthog::jps2_expansion_policy, warthog::pqueue_min>(
+            heuristic_, refine_expander_, refine_open_);
+}
+
+warthog::hpa_search::~hpa_search()
+{
+    delete refine_;
+    delete refine_open_;
+    delete refine_expander_;
+    delete abstract_;
+    delete abstract_open_;
+    delete heuristic_;
+    delete abstract_expander_;
+}
+
+void
+warthog::hpa_search::get_path(warthog::problem_instance& pi,
+        warthog::solution& sol)
+{
+    search(pi, sol);
+}
+
+void
+warthog::hpa_search::get_pathcost(warthog::problem_instance& pi,
+        warthog::solution& sol)
+{
+    search(pi, sol);
+    sol.path_.clear();
+}
+
+void
+warthog::hpa_search::search(warthog::problem_instance& pi,
+        warthog::solution& sol)
+{
+    warthog::timer t;
+    t.start();
+    sol.reset();
+    segments_.clear();
+    g_.clear();
+
+    warthog::solution abstract_sol;
+    abstract_->get_path(pi, abstract_sol);
+    sol.nodes_expanded_ = abstract_sol.nodes_expanded_;
+    sol.nodes_inserted_ = abstract_sol.nodes_inserted_;
+    sol.nodes_updated_ = abstract_sol.nodes_updated_;
+    sol.nodes_touched_ = abstract_sol.nodes_touched_;
+    sol.status_ = abstract_sol.status_;
+
+    segments_ = abstract_sol.path_;
+    for(warthog::sn_id_t id : segments_)
+    {
+        g_.push_back(abstract_->get_generated_node(id)->get_g());
+    }
+
+    if(!segments_.empty())
+    {
+        if(lazy_)
+        {
+            if(num_segments() == 0) { sol.path_.push_back(segments_[0]); }
+            else { refine_segment(0, sol); }
+            sol.sum_of_edge_costs_ = abstract_sol.sum_of_edge_costs_;
+        }
+        else
+        {
+            sol.sum_of_edge_costs_ = 0;
+            sol.path_.push_back(segments_[0]);
+            for(uint32_t i = 0; i < num_segments(); i++)
+            {
+                sol.sum_of_edge_costs_ += refine_segment(i, sol);
+            }
+        }
+    }
+    t.stop();
+    sol.time_elapsed_nano_ = t.elapsed_time_nano();
+}
+
+warthog::cost_t
+warthog::hpa_search::refine_segment(uint32_t i, warthog::solution& sol)
+{
+    // the edge cost is an upper bound on the distance, so a search with
+    // that cutoff still finds an optimal path
+    uint32_t from = (uint32_t)segments_.at(i);
+    uint32_t to = (uint32_t)segments_.at(i + 1);
+    refine_->set_cost_cutoff(g_[i + 1] - g_[i] + CUTOFF_SLACK);
+
+    warthog::problem_instance pi(
+            map_->to_unpadded_id(from), map_->to_unpadded_id(to));
+    warthog::solution part;
+    refine_->get_path(pi, part);
+    sol.nodes_expanded_ += part.nodes_expanded_;
+    sol.nodes_inserted_ += part.nodes_inserted_;
+    sol.nodes_updated_ += part.nodes_updated_;
+    sol.nodes_touched_ += part.nodes_touched_;
+    sol.time_elapsed_nano_ += part.time_elapsed_nano_;
+
+    for(warthog::sn_id_t id : part.path_)
+    {
+        if(sol.path_.empty() || sol.path_.back() != id)
+        {
+            sol.path_.push_back(id);
+        }
+    }
+    return part.sum_of_edge_costs_;
+}
+
+void
+warthog::hpa_search::set_label(uint32_t id, bool traversable)
+{
+    refine_expander_->perturbation(id, traversable);
+    get_graph()->update(id);
+}
+
+size_t
+warthog::hpa_search::mem()
+{
+    return sizeof(*this) + abstract_->mem() + refine_->mem() +
+        sizeof(warthog::sn_id_t) * segments_.capacity() +
+        sizeof(warthog::cost_t) * g_.capacity();
+}
@@ -0,0 +1,107 @@
+#ifndef WARTHOG_HPA_SEARCH_H
+#define WARTHOG_HPA_SEARCH_H
+
+// search/hpa_search.h
+//
+// Hierarchical path-finding A* (Botea, Mueller and Schaeffer, 2004): an A*
+// search over the abstract graph of warthog::hpa_graph picks the entrances
+// a path crosses, then each segment between two consecutive entrances is
+// refined into a grid path by jump point search (jps2). The cost of a
+// segment's abstract edge bounds its refinement, so each refinement only
+// explores tiles that can lie on a path that short, which keeps it near
+// the one or two clusters the segment crosses.
+//
+// Paths are a little longer than optimal (see warthog::hpa_graph).
+//
+// In lazy mode a query refines only the first segment, which is enough to
+// start moving, and reports the abstract cost; the rest is refined on
+// demand by ::refine_segment. Otherwise every segment is refined and the
+// cost is that of the grid path. Either way the solution's path holds the
+// jump points of the refined segments, as padded ids, and its metrics sum
+// the abstract search and the refinements.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "flexible_astar.h"
+#include "gridmap.h"
+#include "hpa_expansion_policy.h"
+#include "jps2_expansion_policy.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+#include "search.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class hpa_search : public warthog::search
+{
+    public:
+        // search @param map, split into clusters of @param cluster_size
+        // tiles a side. the map is not owned
+        hpa_search(warthog::gridmap* map, uint32_t cluster_size);
+        virtual ~hpa_search();
+
+        virtual void
+        get_path(warthog::problem_instance&, warthog::solution&);
+
+        virtual void
+        get_pathcost(warthog::problem_instance&, warthog::solution&);
+
+        virtual size_t
+        mem();
+
+        inline void
+        set_lazy(bool lazy) { lazy_ = lazy; }
+
+        inline bool
+        get_lazy() { return lazy_; }
+
+        // the segments of the last path found, one per abstract edge
+        inline uint32_t
+        num_segments()
+        { return segments_.size() ? (uint32_t)segments_.size() - 1 : 0; }
+
+        // append to @param sol the refinement of segment @param i of the
+        // last path found. @return its cost
+        warthog::cost_t
+        refine_segment(uint32_t i, warthog::solution& sol);
+
+        // make the tile with padded id @param id traversable or not and
+        // update the abstract graph around it
+        void
+        set_label(uint32_t id, bool traversable);
+
+        inline warthog::hpa_graph*
+        get_graph() { return abstract_expander_->get_graph(); }
+
+    private:
+        warthog::gridmap* map_;
+        bool lazy_;
+
+        warthog::hpa_expansion_policy* abstract_expander_;
+        warthog::octile_heuristic* heuristic_;
+        warthog::pqueue_min* abstract_open_;
+        warthog::flexible_astar<warthog::octile_heuristic,
+            warthog::hpa_expansion_policy, warthog::pqueue_min>* abstract_;
+
+        warthog::jps2_expansion_policy* refine_expander_;
+        warthog::pqueue_min* refine_open_;
+        warthog::flexible_astar<warthog::octile_heuristic,
+            warthog::jps2_expansion_policy, warthog::pqueue_min>* refine_;
+
+        // the entrances of the last path found, as padded ids, and the
+        // abstract cost of reaching each
+        std::vector<warthog::sn_id_t> segments_;
+        std::vector<warthog::cost_t> g_;
+
+        void
+        search(warthog::problem_instance&, warthog::solution&);
+};
+
+}
+
+#endif
@@ -0,0 +1,283 @@
+#include "path_cache.h"
+#include "timer.h"
+
+#include <algorithm>
+
+warthog::path_cache::path_cache(warthog::gridmap* map, uint32_t capacity,
+        uint32_t num_shards, uint32_t bucket_size)
+    : hits_(0), misses_(0), invalidated_(0), epoch_(0), entry_bytes_(0)
+{
+    width_ = map->header_width();
+    padded_width_ = map->width();
+    padded_offset_ = map->to_padded_id(0);
+    uint32_t n = 1;
+    while(n < num_shards) { n <<= 1; }
+    shard_mask_ = n - 1;
+    shard_capacity_ = std::max<uint32_t>(1, (capacity + n - 1) / n);
+    bucket_size_ = std::max<uint32_t>(1, bucket_size);
+    buckets_per_row_ = (width_ + bucket_size_ - 1) / bucket_size_;
+    for(uint32_t i = 0; i < n; i++) { shards_.emplace_back(new shard()); }
+}
+
+warthog::path_cache::~path_cache()
+{ }
+
+bool
+warthog::path_cache::lookup(warthog::problem_instance& pi,
+        warthog::solution& sol)
+{
+    bool mirrored;
+    query_key key = make_key((warthog::grid_id_t)pi.start_id_,
+            (warthog::grid_id_t)pi.target_id_, mirrored);
+
+    shard& s = get_shard(key);
+    {
+        std::lock_guard<std::mutex> lock(s.mutex_);
+        auto it = s.entries_.find(key);
+        if(it == s.entries_.end())
+        {
+            misses_++;
+            return false;
+        }
+        s.lru_.splice(s.lru_.begin(), s.lru_, it->second.lru_pos_);
+        sol.sum_of_edge_costs_ = it->second.cost_;
+        sol.path_ = it->second.path_;
+    }
+    if(mirrored) { std::reverse(sol.path_.begin(), sol.path_.end()); }
+    hits_++;
+    return true;
+}
+
+void
+warthog::path_cache::insert(warthog::problem_instance& pi,
+        warthog::solution& sol, uint64_t epoch)
+{
+    if(sol.sum_of_edge_costs_ == warthog::COST_MAX || sol.path_.empty())
+    {
+        return;
+    }
+
+    bool mirrored;
+    query_key key = make_key((warthog::grid_id_t)pi.start_id_,
+            (warthog::grid_id_t)pi.target_id_, mirrored);
+
+    // everything but the index update is done outside the lock
+    entry e;
+    e.cost_ = sol.sum_of_edge_costs_;
+    e.path_ = sol.path_;
+    if(mirrored) { std::reverse(e.path_.begin(), e.path_.end()); }
+
+    std::vector<warthog::grid_id_t> cells;
+    path_cells(e.path_, cells);
+    for(warthog::grid_id_t cell : cells) { e.buckets_.push_back(bucket_of(cell)); }
+    std::sort(e.buckets_.begin(), e.buckets_.end());
+    e.buckets_.erase(std::unique(e.buckets_.begin(), e.buckets_.end()),
+            e.buckets_.end());
+    e.buckets_.shrink_to_fit();
+
+    shard& s = get_shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex_);
+    // ::invalidate and ::clear advance the epoch before they lock any
+    // shard, so a path found before either of them is either rejected
+    // here or inserted in time to be seen by it
+    if(epoch != epoch_) { return; }
+    if(s.entries_.find(key) != s.entries_.end()) { return; }
+    while(s.entries_.size() >= shard_capacity_) { erase(s, s.lru_.back()); }
+
+    s.lru_.push_front(key);
+    e.lru_pos_ = s.lru_.begin();
+    for(warthog::grid_id_t b : e.buckets_) { s.index_[b].insert(key); }
+    entry_bytes_ += entry_mem(e);
+    s.entries_.insert(std::make_pair(key, std::move(e)));
+}
+
+uint32_t
+warthog::path_cache::invalidate(warthog::grid_id_t cell)
+{
+    warthog::grid_id_t bucket = bucket_of(cell);
+
+    epoch_++;
+    uint32_t removed = 0;
+    std::vector<warthog::grid_id_t> cells;
+    for(std::unique_ptr<shard>& sp : shards_)
+    {
+        shard& s = *sp;
+        std::lock_guard<std::mutex> lock(s.mutex_);
+        auto b = s.index_.find(bucket);
+        if(b == s.index_.end()) { continue; }
+
+        // the bucket is coarser than a cell; check the paths themselves
+        std::vector<query_key> victims;
+        for(const query_key& key : b->second)
+        {
+            path_cells(s.entries_.at(key).path_, cells);
+            if(std::find(cells.begin(), cells.end(), cell) != cells.end())
+            {
+                victims.push_back(key);
+            }
+        }
+        for(const query_key& key : victims) { erase(s, key); }
+        removed += (uint32_t)victims.size();
+    }
+    invalidated_ += removed;
+    return removed;
+}
+
+void
+warthog::path_cache::clear()
+{
+    epoch_++;
+    for(std::unique_ptr<shard>& sp : shards_)
+    {
+        std::lock_guard<std::mutex> lock(sp->mutex_);
+        for(auto& e : sp->entries_) { entry_bytes_ -= entry_mem(e.second); }
+        sp->entries_.clear();
+        sp->lru_.clear();
+        sp->index_.clear();
+    }
+}
+
+uint32_t
+warthog::path_cache::size()
+{
+    uint32_t num = 0;
+    for(std::unique_ptr<shard>& sp : shards_)
+    {
+        std::lock_guard<std::mutex> lock(sp->mutex_);
+        num += (uint32_t)sp->entries_.size();
+    }
+    return num;
+}
+
+size_t
+warthog::path_cache::mem()
+{
+    return sizeof(*this) + sizeof(shard) * shards_.size() + entry_bytes_;
+}
+
+void
+warthog::path_cache::path_cells(const std::vector<warthog::sn_id_t>& path,
+        std::vector<warthog::grid_id_t>& cells)
+{
+    cells.clear();
+    for(size_t i = 0; i < path.size(); i++)
+    {
+        uint32_t x, y;
+        to_unpadded_xy((warthog::grid_id_t)path[i], x, y);
+        if(i == 0)
+        {
+            cells.push_back((warthog::grid_id_t)y * width_ + x);
+            continue;
+        }
+
+        // entries of mirrored queries are stored reversed, so the segment
+        // may have been walked from either end; take the cells of both
+        uint32_t px, py;
+        to_unpadded_xy((warthog::grid_id_t)path[i-1], px, py);
+        for(uint32_t from_end = 0; from_end < 2; from_end++)
+        {
+            uint32_t ax = px, ay = py, bx = x, by = y;
+            if(from_end) { std::swap(ax, bx); std::swap(ay, by); }
+            while(ax != bx || ay != by)
+            {
+                uint32_t cx = ax, cy = ay;
+                if(ax != bx) { ax = ax < bx ? ax + 1 : ax - 1; }
+                if(ay != by) { ay = ay < by ? ay + 1 : ay - 1; }
+                cells.push_back((warthog::grid_id_t)ay * width_ + ax);
+
+                // a diagonal step may not cut either corner, so blocking
+                // one of the two orthogonal neighbours invalidates it too
+                if(ax != cx && ay != cy)
+                {
+                    cells.push_back((warthog::grid_id_t)cy * width_ + ax);
+                    cells.push_back((warthog::grid_id_t)ay * width_ + cx);
+                }
+            }
+        }
+    }
+}
+
+void
+warthog::path_cache::erase(shard& s, const query_key& key)
+{
+    auto it = s.entries_.find(key);
+    if(it == s.entries_.end()) { return; }
+    for(warthog::grid_id_t b : it->second.buckets_)
+    {
+        auto bi = s.index_.find(b);
+        bi->second.erase(key);
+        if(bi->second.empty()) { s.index_.erase(bi); }
+    }
+    s.lru_.erase(it->second.lru_pos_);
+    entry_bytes_ -= entry_mem(it->second);
+    s.entries_.erase(it);
+}
+
+warthog::cached_grid_searcher::cached_grid_searcher(
+        warthog::grid_searcher* searcher, warthog::path_cache* cache)
+    : grid_searcher(searcher->get_name(), searcher->get_map()),
+      searcher_(searcher), cache_(cache), epoch_(0), hit_(false)
+{ }
+
+warthog::cached_grid_searcher::~cached_grid_searcher()
+{
+    delete searcher_;
+}
+
+void
+warthog::cached_grid_searcher::get_path(warthog::problem_instance& pi,
+        warthog::solution& sol)
+{
+    warthog::timer t;
+    t.start();
+    sol.reset();
+    uint64_t epoch = cache_->get_epoch();
+    hit_ = cache_->lookup(pi, sol);
+    if(hit_)
+    {
+        t.stop();
+        sol.time_elapsed_nano_ = t.elapsed_time_nano();
+        sol.status_ = warthog::SEARCH_FOUND;
+        return;
+    }
+    searcher_->get_path(pi, sol);
+    cache_->insert(pi, sol, epoch);
+}
+
+void
+warthog::cached_grid_searcher::get_pathcost(warthog::problem_instance& pi,
+        warthog::solution& sol)
+{
+    get_path(pi, sol);
+}
+
+warthog::search_status
+warthog::cached_grid_searcher::begin(warthog::problem_instance& pi,
+        warthog::solution& sol)
+{
+    warthog::timer t;
+    t.start();
+    sol.reset();
+    epoch_ = cache_->get_epoch();
+    hit_ = cache_->lookup(pi, sol);
+    if(hit_)
+    {
+        t.stop();
+        sol.time_elapsed_nano_ = t.elapsed_time_nano();
+        sol.status_ = warthog::SEARCH_FOUND;
+        return sol.status_;
+    }
+    pi_ = pi;
+    return searcher_->begin(pi, sol);
+}
+
+warthog::search_status
+warthog::cached_grid_searcher::step(warthog::solution& sol,
+        uint32_t max_expansions, double max_nanos, bool want_path)
+{
+    if(sol.status_ != warthog::SEARCH_IN_PROGRESS) { return sol.status_; }
+    warthog::search_status status =
+        searcher_->step(sol, max_expansions, max_nanos, true);
+    if(status == warthog::SEARCH_FOUND) { cache_->insert(pi_, sol, epoch_); }
+    return status;
+}
@@ -0,0 +1,270 @@
+#ifndef WARTHOG_PATH_CACHE_H
+#define WARTHOG_PATH_CACHE_H
+
+// search/path_cache.h
+//
+// A bounded, thread-safe cache of recently found grid paths, keyed by
+// start and goal cell. A query and its mirror (goal to start) share one
+// entry since paths on a gridmap are symmetric. Paths are stored in the
+// jump point form returned by the search (padded ids of the map).
+//
+// The cache is split into shards, each with its own lock and its own LRU
+// list, so concurrent lookups only contend when they hash to the same
+// shard. Each shard also keeps a spatial index: the map is divided into
+// square buckets and every bucket lists the entries whose paths cross it.
+//
+// When a cell becomes an obstacle, ::invalidate removes every entry whose
+// path crosses that cell. Paths that avoid the cell stay valid and remain
+// optimal (blocking cells never makes a path shorter). Freeing a cell can
+// shorten any path, so after that the cache must be cleared.
+//
+// A search that runs while the map changes (see gridmap_snapshot.h) may
+// find a path that is already stale. Callers read ::get_epoch before the
+// search and pass it to ::insert, which drops the path if the cache has
+// been invalidated or cleared in the meantime.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "gridmap.h"
+#include "grid_searcher.h"
+#include "problem_instance.h"
+#include "solution.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace warthog
+{
+
+class path_cache
+{
+    public:
+        // @param capacity is the total number of cached paths, spread over
+        // @param num_shards shards (rounded up to a power of two). the
+        // spatial index uses buckets of @param bucket_size x bucket_size cells.
+        // only the dimensions of @param map are kept, so the cache serves
+        // every version of it
+        path_cache(warthog::gridmap* map, uint32_t capacity = 65536,
+                uint32_t num_shards = 16, uint32_t bucket_size = 16);
+        ~path_cache();
+
+        // if the start and target of @param pi (unpadded ids), or the
+        // reverse query, are cached: copy the path and cost into @param sol
+        // and return true
+        bool
+        lookup(warthog::problem_instance& pi, warthog::solution& sol);
+
+        // remember the path of @param sol for the query @param pi, unless
+        // the cache has been invalidated or cleared since @param epoch was
+        // read from ::get_epoch; queries without a path are not cached
+        void
+        insert(warthog::problem_instance& pi, warthog::solution& sol,
+                uint64_t epoch);
+
+        inline uint64_t
+        get_epoch() { return epoch_; }
+
+        // make ::insert reject the paths of searches that began before
+        // now. call after publishing a new version of the map
+        inline void
+        advance_epoch() { epoch_++; }
+
+        // drop the entries whose paths cross the cell with unpadded id
+        // @param cell. call after making the cell an obstacle.
+        // @return the number of entries removed
+        uint32_t
+        invalidate(warthog::grid_id_t cell);
+
+        void
+        clear();
+
+        uint32_t
+        size();
+
+        // kept as entries come and go; does not walk the cache
+        size_t
+        mem();
+
+        inline uint64_t
+        num_hits() { return hits_; }
+
+        inline uint64_t
+        num_misses() { return misses_; }
+
+        inline uint64_t
+        num_invalidated() { return invalidated_; }
+
+    private:
+        // unpadded ids of the lower and the higher of start and goal
+        typedef std::pair<warthog::grid_id_t, warthog::grid_id_t> query_key;
+
+        struct key_hash
+        {
+            inline size_t
+            operator()(const query_key& key) const
+            {
+                // murmur3 finaliser; start and goal ids are far from random
+                uint64_t h = (uint64_t)key.first * 0x9e3779b97f4a7c15ULL ^
+                    (uint64_t)key.second;
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdULL;
+                h ^= h >> 33;
+                return (size_t)h;
+            }
+        };
+
+        struct entry
+        {
+            warthog::cost_t cost_;
+            // padded ids, from the lower to the higher of start and goal
+            std::vector<warthog::sn_id_t> path_;
+            std::vector<warthog::grid_id_t> buckets_;
+            std::list<query_key>::iterator lru_pos_;
+        };
+
+        struct shard
+        {
+            std::mutex mutex_;
+            std::unordered_map<query_key, entry, key_hash> entries_;
+            // most recently used first
+            std::list<query_key> lru_;
+            // bucket -> keys of the entries crossing it
+            std::unordered_map<warthog::grid_id_t,
+                std::unordered_set<query_key, key_hash>> index_;
+        };
+
+        // geometry of the map, for converting padded ids
+        uint32_t width_;
+        uint32_t padded_width_;
+        warthog::grid_id_t padded_offset_;
+        uint32_t shard_capacity_;
+        uint32_t shard_mask_;
+        uint32_t bucket_size_;
+        uint32_t buckets_per_row_;
+        std::vector<std::unique_ptr<shard>> shards_;
+
+        std::atomic<uint64_t> hits_;
+        std::atomic<uint64_t> misses_;
+        std::atomic<uint64_t> invalidated_;
+        // advanced by every ::invalidate and ::clear
+        std::atomic<uint64_t> epoch_;
+        // memory of all entries, as counted by ::entry_mem
+        std::atomic<size_t> entry_bytes_;
+
+        inline shard&
+        get_shard(const query_key& key)
+        {
+            // the low bits pick the shard, the others the bucket within it
+            return *shards_[key_hash()(key) & shard_mask_];
+        }
+
+        // key, entry, lru node and index references of @param e
+        inline size_t
+        entry_mem(const entry& e)
+        {
+            return sizeof(query_key) + sizeof(entry) + 3 * sizeof(query_key) +
+                sizeof(warthog::sn_id_t) * e.path_.capacity() +
+                (sizeof(warthog::grid_id_t) + 2 * sizeof(query_key)) *
+                e.buckets_.capacity();
+        }
+
+        // the key of the query from @param start to @param goal (unpadded
+        // ids) and whether its path is stored reversed
+        inline query_key
+        make_key(warthog::grid_id_t start, warthog::grid_id_t goal,
+                bool& mirrored)
+        {
+            mirrored = start > goal;
+            return mirrored ? query_key(goal, start) : query_key(start, goal);
+        }
+
+        // the spatial index bucket of the cell with unpadded id @param cell
+        inline warthog::grid_id_t
+        bucket_of(warthog::grid_id_t cell)
+        {
+            return (cell / width_ / bucket_size_) * buckets_per_row_ +
+                (cell % width_) / bucket_size_;
+        }
+
+        // the cells of the path, in unpadded ids. consecutive jump points
+        // are joined diagonal-first, as in the searches that produce them,
+        // starting from either point. each diagonal step also lists the two
+        // corners it must not cut; some cells may be listed twice
+        void
+        path_cells(const std::vector<warthog::sn_id_t>& path,
+                std::vector<warthog::grid_id_t>& cells);
+
+        void
+        erase(shard& s, const query_key& key);
+
+        inline void
+        to_unpadded_xy(warthog::grid_id_t padded_id, uint32_t& x, uint32_t& y)
+        {
+            padded_id -= padded_offset_;
+            y = (uint32_t)(padded_id / padded_width_);
+            x = (uint32_t)(padded_id % padded_width_);
+        }
+};
+
+// a searcher that answers repeated (and mirrored) queries from a
+// path_cache and forwards the rest to another searcher. the cache is not
+// owned and can be shared by several searchers on the same map; the
+// wrapped searcher is owned
+class cached_grid_searcher : public warthog::grid_searcher
+{
+    public:
+        cached_grid_searcher(warthog::grid_searcher* searcher,
+                warthog::path_cache* cache);
+        virtual ~cached_grid_searcher();
+
+        virtual void
+        get_path(warthog::problem_instance& pi, warthog::solution& sol);
+
+        // on a miss the full path is computed so that it can be cached
+        virtual void
+        get_pathcost(warthog::problem_instance& pi, warthog::solution& sol);
+
+        // a cached query ends in ::begin; the others are cached when
+        // they end with a path
+        virtual warthog::search_status
+        begin(warthog::problem_instance& pi, warthog::solution& sol);
+
+        virtual warthog::search_status
+        step(warthog::solution& sol, uint32_t max_expansions,
+                double max_nanos = 0, bool want_path = true);
+
+        virtual size_t
+        mem() { return searcher_->mem(); }
+
+        // 0 after a query answered from the cache
+        virtual uint32_t
+        get_scan_count() { return hit_ ? 0 : searcher_->get_scan_count(); }
+
+        virtual void
+        set_map(warthog::gridmap* map, warthog::gridmap* rmap = 0)
+        {
+            map_ = map;
+            searcher_->set_map(map, rmap);
+        }
+
+    private:
+        warthog::grid_searcher* searcher_;
+        warthog::path_cache* cache_;
+        // the query started by ::begin and the cache epoch it started in
+        warthog::problem_instance pi_;
+        uint64_t epoch_;
+        // whether the last query was answered from the cache
+        bool hit_;
+};
+
+}
+
+#endif
@@ -2,6 +2,9 @@
 #define WARTHOG_PROBLEM_INSTANCE_H
 
 #include "search_node.h"
+#include "timer.h"
+
+#include <atomic>
 
 namespace warthog
 {
@@ -17,7 +20,11 @@ class problem_instance
             target_id_(targetid), 
             instance_id_(instance_counter_++),
             verbose_(verbose),
-            extra_params_(0)
+            extra_params_(0),
+            cancel_(0),
+            deadline_nano_(0),
+            cancelled_(false),
+            timed_out_(false)
 
         { }
 
@@ -26,7 +33,11 @@ class problem_instance
             target_id_(warthog::SN_ID_MAX),
             instance_id_(instance_counter_++),
             verbose_(0),
-            extra_params_(0)
+            extra_params_(0),
+            cancel_(0),
+            deadline_nano_(0),
+            cancelled_(false),
+            timed_out_(false)
         { }
 
 
@@ -38,6 +49,9 @@ class problem_instance
             this->instance_id_ = instance_counter_++;
             this->verbose_ = other.verbose_;
             this->extra_params_ = other.extra_params_;
+            this->cancel_ = other.cancel_;
+            this->deadline_nano_ = other.deadline_nano_;
+            this->cancelled_ = this->timed_out_ = false;
         }
 
 		~problem_instance() { }
@@ -46,8 +60,63 @@ class problem_instance
         reset()
         {
             instance_id_ = instance_counter_++;
+            cancelled_ = timed_out_ = false;
+        }
+
+        // true if the query has a cancellation token or a deadline
+        inline bool
+        interruptible() const
+        {
+            return cancel_ || deadline_nano_ > 0;
         }
 
+        // @return true if the query has been cancelled or its deadline
+        // has passed. the outcome is sticky: once true, ::cancelled
+        // or ::timed_out says why and later calls do not look again
+        inline bool
+        should_stop()
+        {
+            if(cancelled_ || timed_out_) { return true; }
+            if(cancel_ && cancel_->load(std::memory_order_relaxed))
+            {
+                cancelled_ = true;
+            }
+            else if(deadline_nano_ > 0 &&
+                    warthog::timer().get_time_nano() >= deadline_nano_)
+            {
+                timed_out_ = true;
+            }
+            return cancelled_ || timed_out_;
+        }
+
+        inline bool
+        cancelled() const { return cancelled_; }
+
+        inline bool
+        timed_out() const { return timed_out_; }
+
+        // give up the query if @param token becomes true. the token is
+        // not owned; it is typically shared with the requester, who sets
+        // it when the answer is no longer wanted, and must outlive the
+        // search
+        inline void
+        set_cancel_token(const std::atomic<bool>* token) { cancel_ = token; }
+
+        // give up the query @param nanos from now
+        inline void
+        set_timeout(double nanos)
+        {
+            deadline_nano_ = warthog::timer().get_time_nano() + nanos;
+        }
+
+        // give up the query at time @param deadline (as returned by
+        // timer::get_time_nano); 0 means no deadline
+        inline void
+        set_deadline(double deadline) { deadline_nano_ = deadline; }
+
+        inline double
+        get_deadline() const { return deadline_nano_; }
+
 		warthog::problem_instance&
 		operator=(const warthog::problem_instance& other)
         {
@@ -57,6 +126,9 @@ class problem_instance
             this->instance_id_ = instance_counter_++;
             this->verbose_ = other.verbose_;
             this->extra_params_ = other.extra_params_;
+            this->cancel_ = other.cancel_;
+            this->deadline_nano_ = other.deadline_nano_;
+            this->cancelled_ = this->timed_out_ = false;
             return *this;
         }
 
@@ -77,7 +149,15 @@ class problem_instance
         void* extra_params_;
 
         private:
-            static uint32_t instance_counter_;
+            // cooperative cancellation; see ::should_stop
+            const std::atomic<bool>* cancel_;
+            double deadline_nano_;
+            bool cancelled_;
+            bool timed_out_;
+
+            // shared by all threads; ids only need to be unique per thread
+            // but a racy counter could hand out a repeated id
+            static std::atomic<uint32_t> instance_counter_;
 
 };
 
@@ -0,0 +1,168 @@
+#include "rsr_expansion_policy.h"
+#include "problem_instance.h"
+
+namespace
+{
+
+// the grid moves, as in gridmap_expansion_policy: the tiles that must be
+// traversable (bits of gridmap::get_neighbours) and the offset
+struct grid_move
+{
+    uint32_t tiles_;
+    int32_t dx_, dy_;
+};
+
+const grid_move moves[8] =
+{
+    {514, 0, -1}, {1536, 1, 0}, {131584, 0, 1}, {768, -1, 0},
+    {1542, 1, -1}, {394752, 1, 1}, {197376, -1, 1}, {771, -1, -1}
+};
+
+}
+
+warthog::rsr_expansion_policy::rsr_expansion_policy(warthog::gridmap* map)
+    : expansion_policy(map->height() * map->width()), map_(map)
+{
+    rects_ = new warthog::rect_decomposition(map);
+}
+
+warthog::rsr_expansion_policy::~rsr_expansion_policy()
+{
+    delete rects_;
+}
+
+void
+warthog::rsr_expansion_policy::set_map(warthog::gridmap* map)
+{
+    delete rects_;
+    map_ = map;
+    rects_ = new warthog::rect_decomposition(map);
+}
+
+void
+warthog::rsr_expansion_policy::expand(warthog::search_node* current,
+        warthog::problem_instance* problem)
+{
+    reset();
+
+    uint32_t id = (uint32_t)current->get_id();
+    uint32_t target = (uint32_t)problem->target_id_;
+    uint32_t x, y, tx, ty;
+    map_->to_padded_xy(id, x, y);
+    map_->to_padded_xy(target, tx, ty);
+
+    uint32_t r = rects_->get_rect_id(id);
+    const warthog::rect_decomposition::rect& rect = rects_->get_rect(r);
+    bool target_inside = rects_->get_rect_id(target) == r &&
+        !rect.on_perimeter(tx, ty);
+
+    if(!rect.on_perimeter(x, y))
+    {
+        // only the start is expanded off a perimeter
+        if(target_inside) { add_macro(x, y, tx, ty); }
+        for(uint32_t px = rect.x0_; px <= rect.x1_; px++)
+        {
+            add_macro(x, y, px, rect.y0_);
+            add_macro(x, y, px, rect.y1_);
+        }
+        for(uint32_t py = rect.y0_ + 1; py < rect.y1_; py++)
+        {
+            add_macro(x, y, rect.x0_, py);
+            add_macro(x, y, rect.x1_, py);
+        }
+        return;
+    }
+
+    uint32_t tiles = 0;
+    map_->get_neighbours(id, (uint8_t*)&tiles);
+    for(const grid_move& m : moves)
+    {
+        if((tiles & m.tiles_) != m.tiles_) { continue; }
+        uint32_t nx = x + m.dx_;
+        uint32_t ny = y + m.dy_;
+        if(nx > rect.x0_ && nx < rect.x1_ && ny > rect.y0_ && ny < rect.y1_)
+        {
+            continue;
+        }
+        add_neighbour(generate(ny * map_->width() + nx),
+                m.dx_ && m.dy_ ? warthog::DBL_ROOT_TWO : 1);
+    }
+    if(target_inside) { add_macro(x, y, tx, ty); }
+    if(!rect.has_interior()) { return; }
+
+    // the edges across the rectangle are only needed where a path enters
+    // it: a path that reached this tile from the rectangle's perimeter
+    // could have crossed from where it entered
+    uint32_t parent = (uint32_t)current->get_parent();
+    bool entered = current->get_parent() == warthog::SN_ID_MAX ||
+        rects_->get_rect_id(parent) != r;
+
+    // across to the opposite side, as far along it as the rectangle is
+    // wide (or high)
+    uint32_t w = rect.x1_ - rect.x0_;
+    uint32_t h = rect.y1_ - rect.y0_;
+    if(entered && (x == rect.x0_ || x == rect.x1_))
+    {
+        uint32_t ox = x == rect.x0_ ? rect.x1_ : rect.x0_;
+        uint32_t lo = y - rect.y0_ > w ? y - w : rect.y0_;
+        uint32_t hi = rect.y1_ - y > w ? y + w : rect.y1_;
+        for(uint32_t oy = lo; oy <= hi; oy++) { add_macro(x, y, ox, oy); }
+    }
+    if(entered && (y == rect.y0_ || y == rect.y1_))
+    {
+        uint32_t oy = y == rect.y0_ ? rect.y1_ : rect.y0_;
+        uint32_t lo = x - rect.x0_ > h ? x - h : rect.x0_;
+        uint32_t hi = rect.x1_ - x > h ? x + h : rect.x1_;
+        for(uint32_t ox = lo; ox <= hi; ox++) { add_macro(x, y, ox, oy); }
+    }
+
+    // diagonally into the rectangle, up to the side they meet. where the
+    // edges above were made, those that meet the opposite side are
+    // among them already
+    for(uint32_t i = 4; i < 8; i++)
+    {
+        const grid_move& m = moves[i];
+        uint32_t kx = m.dx_ > 0 ? rect.x1_ - x : x - rect.x0_;
+        uint32_t ky = m.dy_ > 0 ? rect.y1_ - y : y - rect.y0_;
+        uint32_t k = kx < ky ? kx : ky;
+        if(k < 2) { continue; }
+        if(entered && kx == k && (x == rect.x0_ || x == rect.x1_)) { continue; }
+        if(entered && ky == k && (y == rect.y0_ || y == rect.y1_)) { continue; }
+        add_macro(x, y, x + m.dx_ * (int32_t)k, y + m.dy_ * (int32_t)k);
+    }
+}
+
+void
+warthog::rsr_expansion_policy::get_xy(warthog::sn_id_t nid,
+        int32_t& x, int32_t& y)
+{
+    map_->to_unpadded_xy((uint32_t)nid, (uint32_t&)x, (uint32_t&)y);
+}
+
+warthog::search_node*
+warthog::rsr_expansion_policy::generate_start_node(
+        warthog::problem_instance* pi)
+{
+    uint32_t max_id = map_->header_width() * map_->header_height();
+    if((uint32_t)pi->start_id_ >= max_id) { return 0; }
+    uint32_t padded_id = map_->to_padded_id((uint32_t)pi->start_id_);
+    if(map_->get_label(padded_id) == 0) { return 0; }
+    return generate(padded_id);
+}
+
+warthog::search_node*
+warthog::rsr_expansion_policy::generate_target_node(
+        warthog::problem_instance* pi)
+{
+    uint32_t max_id = map_->header_width() * map_->header_height();
+    if((uint32_t)pi->target_id_ >= max_id) { return 0; }
+    uint32_t padded_id = map_->to_padded_id((uint32_t)pi->target_id_);
+    if(map_->get_label(padded_id) == 0) { return 0; }
+    return generate(padded_id);
+}
+
+size_t
+warthog::rsr_expansion_policy::mem()
+{
+    return expansion_policy::mem() + sizeof(*this) + rects_->mem();
+}
@@ -0,0 +1,88 @@
+#ifndef WARTHOG_RSR_EXPANSION_POLICY_H
+#define WARTHOG_RSR_EXPANSION_POLICY_H
+
+// search/rsr_expansion_policy.h
+//
+// Rectangular symmetry reduction: an expansion policy for gridmaps
+// decomposed into empty rectangles (see warthog::rect_decomposition).
+// Tiles inside a rectangle, off its perimeter, are never generated
+// (except the target). A perimeter tile has as successors:
+//
+//  - its grid neighbours, other than those inside its own rectangle;
+//  - macro edges across the rectangle to every tile of the opposite
+//    side that an octile path reaches as fast as a straight one, i.e.
+//    no further along that side than the rectangle is wide;
+//  - diagonal macro edges into the rectangle, up to the adjacent side
+//    they meet;
+//  - the target, if it lies inside the rectangle.
+//
+// Any path of octile length between two perimeter tiles of a rectangle
+// can be rebuilt from these edges and steps along the perimeter, so the
+// search stays optimal. Edges to the opposite side are only made from a
+// tile whose parent lies outside the rectangle, where paths enter it. A start inside a rectangle is joined to all of
+// its perimeter. Rectangles less than three tiles wide or high have no
+// inside and no macro edges.
+//
+// Like the jump point policies, paths list the ends of macro edges only.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "expansion_policy.h"
+#include "gridmap.h"
+#include "rect_decomposition.h"
+#include "search_node.h"
+
+namespace warthog
+{
+
+class problem_instance;
+class rsr_expansion_policy : public expansion_policy
+{
+    public:
+        rsr_expansion_policy(warthog::gridmap* map);
+        virtual ~rsr_expansion_policy();
+
+        virtual void
+        expand(warthog::search_node*, warthog::problem_instance*);
+
+        virtual void
+        get_xy(sn_id_t node_id, int32_t& x, int32_t& y);
+
+        virtual warthog::search_node*
+        generate_start_node(warthog::problem_instance* pi);
+
+        virtual warthog::search_node*
+        generate_target_node(warthog::problem_instance* pi);
+
+        virtual size_t
+        mem();
+
+        // switch to another version of the map with the same dimensions
+        // between searches. the map is decomposed again
+        void
+        set_map(warthog::gridmap* map);
+
+        inline warthog::rect_decomposition*
+        get_decomposition() { return rects_; }
+
+    private:
+        warthog::gridmap* map_;
+        warthog::rect_decomposition* rects_;
+
+        // add a macro edge from (x, y) to (x2, y2)
+        inline void
+        add_macro(uint32_t x, uint32_t y, uint32_t x2, uint32_t y2)
+        {
+            uint32_t dx = x > x2 ? x - x2 : x2 - x;
+            uint32_t dy = y > y2 ? y - y2 : y2 - y;
+            uint32_t diag = dx < dy ? dx : dy;
+            add_neighbour(generate(y2 * map_->width() + x2),
+                    diag * warthog::DBL_ROOT_TWO + (dx + dy - 2 * diag));
+        }
+};
+
+}
+
+#endif
@@ -15,6 +15,17 @@
 namespace warthog
 {
 
+// how a search ended, or that it has not ended yet (resumable searches)
+typedef enum
+{
+    SEARCH_FOUND = 0,
+    SEARCH_NO_PATH,
+    SEARCH_IN_PROGRESS,
+    SEARCH_CUTOFF,
+    SEARCH_CANCELLED,
+    SEARCH_TIMED_OUT
+} search_status;
+
 class solution
 {
     public:
@@ -32,6 +43,7 @@ class solution
             nodes_updated_(other.nodes_updated_), 
             nodes_touched_(other.nodes_updated_),
             nodes_surplus_(other.nodes_updated_),
+            status_(other.status_),
             path_(other.path_)
         { }
 
@@ -75,6 +87,7 @@ class solution
             nodes_updated_ = 0;
             nodes_touched_ = 0;
             nodes_surplus_ = 0;
+            status_ = warthog::SEARCH_NO_PATH;
             path_.clear();
         }
 
@@ -86,6 +99,7 @@ class solution
         uint32_t nodes_updated_;
         uint32_t nodes_touched_;
         uint32_t nodes_surplus_;
+        warthog::search_status status_;
 
         // the sequence of states that comprise 
         // a solution path
@@ -0,0 +1,114 @@
+#include "subgoal_expansion_policy.h"
+#include "problem_instance.h"
+
+#include <algorithm>
+
+warthog::subgoal_expansion_policy::subgoal_expansion_policy(
+        warthog::gridmap* map, warthog::gridmap* rmap)
+    : expansion_policy(map->height() * map->width()), map_(map), stamp_(0)
+{
+    graph_ = new warthog::subgoal_graph(map, rmap);
+    target_stamp_.assign(graph_->num_subgoals(), 0);
+}
+
+warthog::subgoal_expansion_policy::~subgoal_expansion_policy()
+{
+    delete graph_;
+}
+
+void
+warthog::subgoal_expansion_policy::set_map(warthog::gridmap* map,
+        warthog::gridmap* rmap)
+{
+    delete graph_;
+    map_ = map;
+    graph_ = new warthog::subgoal_graph(map, rmap);
+    target_stamp_.assign(graph_->num_subgoals(), 0);
+    stamp_ = 0;
+}
+
+void
+warthog::subgoal_expansion_policy::expand(
+        warthog::search_node* current, warthog::problem_instance* problem)
+{
+    reset();
+    uint32_t id = (uint32_t)current->get_id();
+    uint32_t target = (uint32_t)problem->target_id_;
+
+    if(!graph_->is_subgoal(id))
+    {
+        // only the start is expanded without being a subgoal
+        neis_.clear();
+        graph_->connect(id, neis_, target);
+        for(uint32_t n : neis_)
+        {
+            add_neighbour(generate(n), graph_->distance(id, n));
+        }
+        return;
+    }
+
+    uint32_t index = graph_->index_of(id);
+    uint32_t end = graph_->first_edge(index + 1);
+    for(uint32_t i = graph_->first_edge(index); i < end; i++)
+    {
+        add_neighbour(generate(graph_->edge_target(i)), graph_->edge_cost(i));
+    }
+    if(target_stamp_[index] == stamp_)
+    {
+        add_neighbour(generate(target), graph_->distance(id, target));
+    }
+}
+
+void
+warthog::subgoal_expansion_policy::get_xy(warthog::sn_id_t node_id,
+        int32_t& x, int32_t& y)
+{
+    map_->to_unpadded_xy((uint32_t)node_id, (uint32_t&)x, (uint32_t&)y);
+}
+
+warthog::search_node*
+warthog::subgoal_expansion_policy::generate_start_node(
+        warthog::problem_instance* pi)
+{
+    uint32_t start_id = (uint32_t)pi->start_id_;
+    uint32_t max_id = map_->header_width() * map_->header_height();
+
+    if(start_id >= max_id) { return 0; }
+    uint32_t padded_id = map_->to_padded_id(start_id);
+    if(map_->get_label(padded_id) == 0) { return 0; }
+    return generate(padded_id);
+}
+
+warthog::search_node*
+warthog::subgoal_expansion_policy::generate_target_node(
+        warthog::problem_instance* pi)
+{
+    uint32_t target_id = (uint32_t)pi->target_id_;
+    uint32_t max_id = map_->header_width() * map_->header_height();
+
+    if(target_id >= max_id) { return 0; }
+    uint32_t padded_id = map_->to_padded_id(target_id);
+    if(map_->get_label(padded_id) == 0) { return 0; }
+
+    // a new stamp for the subgoals connected to this target. a target
+    // that is a subgoal already has its edges
+    if(++stamp_ == 0)
+    {
+        std::fill(target_stamp_.begin(), target_stamp_.end(), 0);
+        stamp_ = 1;
+    }
+    if(!graph_->is_subgoal(padded_id))
+    {
+        neis_.clear();
+        graph_->connect(padded_id, neis_);
+        for(uint32_t n : neis_) { target_stamp_[graph_->index_of(n)] = stamp_; }
+    }
+    return generate(padded_id);
+}
+
+size_t
+warthog::subgoal_expansion_policy::mem()
+{
+    return expansion_policy::mem() + sizeof(*this) + graph_->mem() +
+        sizeof(uint32_t) * (target_stamp_.capacity() + neis_.capacity());
+}
@@ -0,0 +1,78 @@
+#ifndef WARTHOG_SUBGOAL_EXPANSION_POLICY_H
+#define WARTHOG_SUBGOAL_EXPANSION_POLICY_H
+
+// search/subgoal_expansion_policy.h
+//
+// An expansion policy for searching the simple subgoal graph of a gridmap
+// (see warthog::subgoal_graph). Nodes are padded map ids, so the octile
+// heuristic works unchanged. A query connects its target to the graph
+// when the target node is generated and its start when the start is
+// expanded; the start is connected to the target directly if it can be.
+//
+// Paths found this way list subgoals only; ::refine turns them into
+// paths over every tile.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "expansion_policy.h"
+#include "gridmap.h"
+#include "search_node.h"
+#include "subgoal_graph.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class problem_instance;
+class subgoal_expansion_policy : public expansion_policy
+{
+    public:
+        // @param rmap is a rotated copy of @param map; see
+        // warthog::subgoal_graph
+        subgoal_expansion_policy(warthog::gridmap* map,
+                warthog::gridmap* rmap = 0);
+        virtual ~subgoal_expansion_policy();
+
+        virtual void
+        expand(warthog::search_node*, warthog::problem_instance*);
+
+        virtual void
+        get_xy(sn_id_t node_id, int32_t& x, int32_t& y);
+
+        virtual warthog::search_node*
+        generate_start_node(warthog::problem_instance* pi);
+
+        virtual warthog::search_node*
+        generate_target_node(warthog::problem_instance* pi);
+
+        virtual size_t
+        mem();
+
+        // switch to another version of the map with the same dimensions
+        // between searches. the subgoal graph is rebuilt
+        void
+        set_map(warthog::gridmap* map, warthog::gridmap* rmap = 0);
+
+        inline void
+        refine(std::vector<warthog::sn_id_t>& path) { graph_->refine(path); }
+
+        inline warthog::subgoal_graph*
+        get_graph() { return graph_; }
+
+    private:
+        warthog::gridmap* map_;
+        warthog::subgoal_graph* graph_;
+
+        // subgoals connected to the target of the current query are
+        // stamped with the query number
+        std::vector<uint32_t> target_stamp_;
+        uint32_t stamp_;
+        std::vector<uint32_t> neis_;
+};
+
+}
+
+#endif
@@ -18,6 +18,15 @@ namespace warthog
     static const sn_id_t SN_ID_MAX = UINT64_MAX;
     static const sn_id_t NO_PARENT = SN_ID_MAX;
 
+	// padded ids of gridmap tiles. 32 bits unless built with -DGRID_ID64
+	// (make wide), which admits maps of more than 2^32 padded tiles at
+	// the cost of wider ids in the jump point searches
+#ifdef GRID_ID64
+	typedef uint64_t grid_id_t;
+#else
+	typedef uint32_t grid_id_t;
+#endif
+
 	// each node in a weighted grid map uses sizeof(dbword) memory.
 	// in a uniform-cost grid map each dbword is a contiguous set
 	// of nodes s.t. every bit represents a node.
@@ -5,6 +5,8 @@
 void
 warthog::experiment::print(std::ostream& out)
 {
+	// GPPC rows begin with a bucket id; by convention it is distance / 4
+	out << (uint32_t)(this->distance() / 4) << "\t";
 	out << this->map() <<"\t";
 	out << this->mapwidth() << "\t";
 	out << this->mapheight() << "\t";
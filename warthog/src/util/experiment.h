@@ -70,6 +70,9 @@ class experiment
 		inline void
 		set_precision(int32_t prec) { precision_ = prec; }
 
+		inline void
+		set_distance(double d) { distance_ = d; }
+
 		void
 		print(std::ostream& out);
 
@@ -10,12 +10,80 @@
 #include "solution.h"
 using namespace std;
 // set global variable that can be accessed everywhere
+// NB: the variables below are shared by all threads and only meant for
+// single-threaded experiments. the state that a search shares with its
+// jump point locators and pruner is kept in a search_context instead
 namespace global{
 
 extern string alg;
 extern warthog::mem::node_pool* nodepool;
 extern warthog::solution* sol;
 
+// per-search state read by the jump point locators (and the pruner of
+// jps2-prune2) while they scan. each locator owns one and its expansion
+// policy binds the running query, so searches on different threads never
+// share it and the scans reach it without going through thread-local
+// storage
+struct search_context {
+  warthog::mem::node_pool* nodepool = nullptr;
+  warthog::pqueue_min* open = nullptr;
+  warthog::problem_instance* pi = nullptr;
+  // the running query if it can be cancelled or has a deadline, else null
+  warthog::problem_instance* interrupt = nullptr;
+  warthog::cost_t cur_diag_gval = warthog::INFTY;
+  // scanning steps since the owner last reset it
+  uint32_t scan_cnt = 0;
+
+  // the policy calls this before expanding each node of @param p
+  inline void bind(warthog::problem_instance* p) {
+    pi = p;
+    interrupt = p->interruptible() ? p : nullptr;
+  }
+
+  // long diagonal scans call this with their step count and give up
+  // (reporting no successors) when it returns true. the query is only
+  // looked at every 128 steps; flexible_astar then sees that the query
+  // should stop and ends it before its next expansion
+  inline bool stop_scan(uint32_t num_steps) {
+    return (num_steps & 127) == 0 && interrupt != nullptr &&
+      interrupt->should_stop();
+  }
+
+  inline warthog::cost_t gval(warthog::grid_id_t id) {
+    warthog::cost_t res = warthog::INFTY;
+    warthog::search_node* s = nodepool->get_ptr(id);
+    if (s != nullptr && s->get_search_number() == pi->instance_id_) 
+      res = min(res, s->get_g());
+    return res;
+  }
+
+  // set gvalue on corner point
+  inline void set_corner_gv(warthog::grid_id_t id, warthog::cost_t g) {
+    warthog::search_node* n = nodepool->get_ptr(id);
+    if (n->get_search_number() != pi->instance_id_) {
+      n->init(pi->instance_id_, warthog::SN_ID_MAX, warthog::INFTY, warthog::INFTY);
+      n->set_g(g);
+    }
+    else if (open->contains(n)) {
+      // n has been generated and pushed in queue
+      if (g < n->get_g()) {
+        // and the current g is better, so n can be pruned.
+        // n->relax(g, nullptr);
+        n->set_expanded(true);
+        // open->decrease_key(n); // this is to maintain the consistant heuristic
+        // later when n is popped out, if g > 0 and parent is null,
+        // we won't expand this node.
+      }
+    }
+    else if (g < n->get_g()) {
+      // n has been generated but not pushed yet,
+      // implies that n is a corner point of another parent
+      n->set_g(g);
+      n->set_parent(warthog::NO_PARENT);
+    }
+  }
+};
+
 namespace statis {
 
   struct Log {
@@ -49,7 +117,6 @@ namespace statis {
   extern uint32_t subopt_expd;
   extern uint32_t subopt_gen;
   extern uint32_t subopt_insert;
-  extern uint32_t scan_cnt;
   extern vector<Log> logs;
 
   extern uint32_t prunable;
@@ -88,6 +155,8 @@ namespace statis {
   }
 
   inline void update_pruneable(warthog::search_node* cur) {
+    // nodepool is only bound by the programs that fill dist
+    if (dist.empty()) return;
     warthog::sn_id_t pid = cur->get_parent();
     warthog::search_node* pa = pid == warthog::NO_PARENT? 
       nullptr: nodepool->get_ptr(pid);
@@ -107,7 +176,6 @@ namespace statis {
     subopt_insert = 0;
     subopt_expd = 0;
     subopt_gen = 0;
-    scan_cnt = 0;
     prunable = 0;
   }
 
@@ -131,46 +199,8 @@ namespace statis {
 };
 
 namespace query {
-  extern uint32_t startid, goalid;
-  extern warthog::cost_t cur_diag_gval;
+  extern warthog::grid_id_t startid, goalid;
   extern warthog::gridmap *map;
-extern warthog::problem_instance* pi;
-extern warthog::pqueue_min* open;
-  extern uint32_t jump_step;
-
-  inline warthog::cost_t gval(uint32_t id) {
-    warthog::cost_t res = warthog::INFTY;
-    warthog::search_node* s = nodepool->get_ptr(id);
-    if (s != nullptr && s->get_search_number() == pi->instance_id_) 
-      res = min(res, s->get_g());
-    return res;
-  }
-
-  // set gvalue on corner point
-  inline void set_corner_gv(uint32_t id, warthog::cost_t g) {
-    warthog::search_node* n = nodepool->get_ptr(id);
-    if (n->get_search_number() != pi->instance_id_) {
-      n->init(pi->instance_id_, warthog::SN_ID_MAX, warthog::INFTY, warthog::INFTY);
-      n->set_g(g);
-    }
-    else if (open->contains(n)) {
-      // n has been generated and pushed in queue
-      if (g < n->get_g()) {
-        // and the current g is better, so n can be pruned.
-        // n->relax(g, nullptr);
-        n->set_expanded(true);
-        // open->decrease_key(n); // this is to maintain the consistant heuristic
-        // later when n is popped out, if g > 0 and parent is null,
-        // we won't expand this node.
-      }
-    }
-    else if (g < n->get_g()) {
-      // n has been generated but not pushed yet,
-      // implies that n is a corner point of another parent
-      n->set_g(g);
-      n->set_parent(warthog::NO_PARENT);
-    }
-  }
   inline void clear() {
     map = nullptr;
   }
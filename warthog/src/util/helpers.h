@@ -22,7 +22,8 @@ namespace helpers
 
 // convert a one-dimensional grid index into x/y coordinates 
 inline void
-index_to_xy(uint32_t grid_id, uint32_t mapwidth, int32_t& x, int32_t& y)
+index_to_xy(warthog::grid_id_t grid_id, uint32_t mapwidth, int32_t& x,
+		int32_t& y)
 {	
 	y = (int32_t)(grid_id / mapwidth);
 	x = (int32_t)(grid_id  % mapwidth);
@@ -0,0 +1,475 @@
+#include "map_generator.h"
+
+#include <algorithm>
+#include <string>
+
+namespace
+{
+
+// the helpers below take unpadded coordinates and ignore tiles outside
+// the map; generators can then write past the edges without checks
+inline void
+set_tile(warthog::gridmap* map, int64_t x, int64_t y, bool traversable)
+{
+    if(x < 0 || y < 0 ||
+       x >= map->header_width() || y >= map->header_height())
+    { return; }
+    map->set_label(map->to_padded_id((uint32_t)x, (uint32_t)y), traversable);
+}
+
+inline bool
+get_tile(warthog::gridmap* map, int64_t x, int64_t y)
+{
+    if(x < 0 || y < 0 ||
+       x >= map->header_width() || y >= map->header_height())
+    { return false; }
+    return map->get_label(map->to_padded_id((uint32_t)x, (uint32_t)y));
+}
+
+void
+fill(warthog::gridmap* map, int64_t x0, int64_t y0, int64_t x1, int64_t y1,
+        bool traversable)
+{
+    for(int64_t y = y0; y <= y1; y++)
+    {
+        for(int64_t x = x0; x <= x1; x++)
+        {
+            set_tile(map, x, y, traversable);
+        }
+    }
+}
+
+void
+add_border(warthog::gridmap* map)
+{
+    int64_t w = map->header_width();
+    int64_t h = map->header_height();
+    fill(map, 0, 0, w-1, 0, false);
+    fill(map, 0, 0, 0, h-1, false);
+    fill(map, w-1, 0, w-1, h-1, false);
+    fill(map, 0, h-1, w-1, h-1, false);
+}
+
+warthog::gridmap*
+copy_map(warthog::gridmap* map)
+{
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    warthog::gridmap* ret = new warthog::gridmap(h, w);
+    for(uint32_t y = 0; y < h; y++)
+    {
+        for(uint32_t x = 0; x < w; x++)
+        {
+            set_tile(ret, x, y, get_tile(map, x, y));
+        }
+    }
+    return ret;
+}
+
+}
+
+warthog::map_generator::map_generator(uint64_t seed) : rng_(seed)
+{ }
+
+warthog::gridmap*
+warthog::map_generator::diag(uint32_t l, double r, double dr)
+{
+    warthog::gridmap* map = new warthog::gridmap(l, l);
+    fill(map, 0, 0, l-1, l-1, true);
+    add_border(map);
+
+    // blockage in the middle of the anti-diagonal;
+    // dr = 1: fully blocked, dr = 0: no blockage
+    if(dr >= 1)
+    {
+        for(int64_t x = 0; x < l; x++) { set_tile(map, x, l-1-x, false); }
+    }
+    else
+    {
+        int64_t bl = (int64_t)(l * dr);
+        int64_t sx = (l - bl) / 2;
+        int64_t sy = l - (l - bl) / 2;
+        for(int64_t i = 0; i < bl; i++) { set_tile(map, sx+i, sy-i, false); }
+    }
+
+    // random obstacles on the anti-diagonals either side of the blockage
+    for(int64_t d = 1; d < l / 8; d++)
+    {
+        for(int64_t x = 0; x < l - d; x++)
+        {
+            if(coin(r)) { set_tile(map, x, l - d - x, false); }
+        }
+    }
+    for(int64_t d = 1; d < l / 8; d++)
+    {
+        for(int64_t x = d; x < l; x++)
+        {
+            if(coin(r)) { set_tile(map, x, l - 1 + d - x, false); }
+        }
+    }
+    return map;
+}
+
+warthog::gridmap*
+warthog::map_generator::square(uint32_t l, double r)
+{
+    warthog::gridmap* map = new warthog::gridmap(l, l);
+    fill(map, 0, 0, l-1, l-1, true);
+    add_border(map);
+
+    fill(map, l / 8, l / 2, l - l / 8 - 1, l / 2, false);
+    for(int64_t y = l*3 / 8; y < l*5 / 8; y++)
+    {
+        for(int64_t x = 1; x < l; x++)
+        {
+            if(coin(r)) { set_tile(map, x, y, false); }
+        }
+    }
+    return map;
+}
+
+warthog::gridmap*
+warthog::map_generator::empty(uint32_t l)
+{
+    warthog::gridmap* map = new warthog::gridmap(l, l);
+    fill(map, 0, 0, l-1, l-1, true);
+    fill(map, (int64_t)l-2, 0, (int64_t)l-2, l-1, false);
+    return map;
+}
+
+warthog::gridmap*
+warthog::map_generator::random(uint32_t height, uint32_t width, double r)
+{
+    warthog::gridmap* map = new warthog::gridmap(height, width);
+    for(uint32_t y = 0; y < height; y++)
+    {
+        for(uint32_t x = 0; x < width; x++)
+        {
+            set_tile(map, x, y, !coin(r));
+        }
+    }
+    return map;
+}
+
+warthog::gridmap*
+warthog::map_generator::rooms(uint32_t height, uint32_t width,
+        uint32_t room, double doors)
+{
+    warthog::gridmap* map = new warthog::gridmap(height, width);
+    fill(map, 0, 0, width-1, height-1, true);
+    if(room == 0) { return map; }
+
+    // walls one tile thick after every room
+    int64_t stride = room + 1;
+    for(int64_t x = room; x < width; x += stride)
+    { fill(map, x, 0, x, height-1, false); }
+    for(int64_t y = room; y < height; y += stride)
+    { fill(map, 0, y, width-1, y, false); }
+
+    uint32_t nrx = (uint32_t)((width + room) / stride);
+    uint32_t nry = (uint32_t)((height + room) / stride);
+    int64_t door_width = std::max<int64_t>(1, room / 4);
+
+    // open a door in the wall east of (rx, ry) or south of (rx, ry)
+    auto open_door = [&] (uint32_t rx, uint32_t ry, bool east) -> void
+    {
+        // rooms on the last row/column can be cut short by the map edge
+        int64_t span = east ?
+            std::min<int64_t>(room, height - ry * stride) :
+            std::min<int64_t>(room, width - rx * stride);
+        int64_t dw = std::min(door_width, span);
+        int64_t pos = uniform_int(0, (uint32_t)(span - dw));
+        if(east)
+        {
+            int64_t x = rx * stride + room;
+            int64_t y = ry * stride + pos;
+            fill(map, x, y, x, y + dw - 1, true);
+        }
+        else
+        {
+            int64_t x = rx * stride + pos;
+            int64_t y = ry * stride + room;
+            fill(map, x, y, x + dw - 1, y, true);
+        }
+    };
+
+    // a randomised depth-first spanning tree guarantees every room is
+    // reachable from every other
+    std::vector<bool> visited((size_t)nrx * nry, false);
+    std::vector<uint32_t> stack;
+    stack.push_back(0);
+    visited.at(0) = true;
+    while(stack.size())
+    {
+        uint32_t cur = stack.back();
+        uint32_t rx = cur % nrx, ry = cur / nrx;
+        uint32_t succ[4];
+        uint32_t nsucc = 0;
+        if(rx > 0 && !visited.at(cur-1)) { succ[nsucc++] = cur-1; }
+        if(rx+1 < nrx && !visited.at(cur+1)) { succ[nsucc++] = cur+1; }
+        if(ry > 0 && !visited.at(cur-nrx)) { succ[nsucc++] = cur-nrx; }
+        if(ry+1 < nry && !visited.at(cur+nrx)) { succ[nsucc++] = cur+nrx; }
+        if(nsucc == 0) { stack.pop_back(); continue; }
+
+        uint32_t next = succ[uniform_int(0, nsucc-1)];
+        uint32_t nx = next % nrx, ny = next / nrx;
+        open_door(std::min(rx, nx), std::min(ry, ny), ny == ry);
+        visited.at(next) = true;
+        stack.push_back(next);
+    }
+
+    // extra doors make for more than one route between rooms
+    for(uint32_t ry = 0; ry < nry; ry++)
+    {
+        for(uint32_t rx = 0; rx < nrx; rx++)
+        {
+            if(rx+1 < nrx && coin(doors)) { open_door(rx, ry, true); }
+            if(ry+1 < nry && coin(doors)) { open_door(rx, ry, false); }
+        }
+    }
+    return map;
+}
+
+warthog::gridmap*
+warthog::map_generator::maze(uint32_t height, uint32_t width,
+        uint32_t corridor)
+{
+    // the map starts out blocked; corridors are carved out of it.
+    // cell (cx, cy) is the corridor x corridor square whose top-left tile
+    // is (cx * stride + 1, cy * stride + 1). a cell has been visited iff
+    // its tiles are traversable, so no extra memory is needed for that.
+    warthog::gridmap* map = new warthog::gridmap(height, width);
+    if(corridor == 0) { return map; }
+    int64_t stride = corridor + 1;
+    uint32_t ncx = (uint32_t)((width - 1) / stride);
+    uint32_t ncy = (uint32_t)((height - 1) / stride);
+    if(ncx == 0 || ncy == 0) { return map; }
+
+    auto cell_x = [&] (uint32_t c) -> int64_t { return (c % ncx) * stride + 1; };
+    auto cell_y = [&] (uint32_t c) -> int64_t { return (c / ncx) * stride + 1; };
+    auto visited = [&] (uint32_t c) -> bool
+    { return get_tile(map, cell_x(c), cell_y(c)); };
+    auto carve = [&] (uint32_t c) -> void
+    {
+        fill(map, cell_x(c), cell_y(c),
+                cell_x(c) + corridor - 1, cell_y(c) + corridor - 1, true);
+    };
+
+    std::vector<uint32_t> stack;
+    uint32_t first = uniform_int(0, ncx * ncy - 1);
+    carve(first);
+    stack.push_back(first);
+    while(stack.size())
+    {
+        uint32_t cur = stack.back();
+        uint32_t cx = cur % ncx, cy = cur / ncx;
+        uint32_t succ[4];
+        uint32_t nsucc = 0;
+        if(cx > 0 && !visited(cur-1)) { succ[nsucc++] = cur-1; }
+        if(cx+1 < ncx && !visited(cur+1)) { succ[nsucc++] = cur+1; }
+        if(cy > 0 && !visited(cur-ncx)) { succ[nsucc++] = cur-ncx; }
+        if(cy+1 < ncy && !visited(cur+ncx)) { succ[nsucc++] = cur+ncx; }
+        if(nsucc == 0) { stack.pop_back(); continue; }
+
+        // carve the next cell and the wall between it and the current one
+        uint32_t next = succ[uniform_int(0, nsucc-1)];
+        carve(next);
+        int64_t x0 = std::min(cell_x(cur), cell_x(next));
+        int64_t y0 = std::min(cell_y(cur), cell_y(next));
+        int64_t x1 = std::max(cell_x(cur), cell_x(next)) + corridor - 1;
+        int64_t y1 = std::max(cell_y(cur), cell_y(next)) + corridor - 1;
+        fill(map, x0, y0, x1, y1, true);
+        stack.push_back(next);
+    }
+    return map;
+}
+
+warthog::gridmap*
+warthog::map_generator::cave(uint32_t height, uint32_t width,
+        double fill, uint32_t iterations)
+{
+    warthog::gridmap* map = random(height, width, fill);
+
+    // each round updates the map one row at a time, keeping the previous
+    // values of the rows above and below. tiles outside the map count
+    // as walls. 1 = wall in the row buffers; index 0 and width+1 pad the
+    // row ends.
+    std::vector<uint8_t> above(width+2), cur(width+2), below(width+2);
+    std::vector<uint8_t> col(width+2);
+    auto read_row = [&] (int64_t y, std::vector<uint8_t>& row) -> void
+    {
+        for(uint32_t x = 0; x < width; x++)
+        { row[x+1] = !get_tile(map, x, y); }
+        row[0] = row[width+1] = 1;
+    };
+
+    for(uint32_t it = 0; it < iterations; it++)
+    {
+        std::fill(above.begin(), above.end(), 1);
+        read_row(0, cur);
+        for(uint32_t y = 0; y < height; y++)
+        {
+            if(y+1 < height) { read_row(y+1, below); }
+            else { std::fill(below.begin(), below.end(), 1); }
+
+            for(uint32_t x = 0; x < width+2; x++)
+            { col[x] = above[x] + cur[x] + below[x]; }
+            for(uint32_t x = 1; x <= width; x++)
+            {
+                uint32_t walls = col[x-1] + col[x] + col[x+1];
+                set_tile(map, x-1, y, walls < 5);
+            }
+            std::swap(above, cur);
+            std::swap(cur, below);
+        }
+    }
+    return map;
+}
+
+warthog::gridmap*
+warthog::map_generator::scale(warthog::gridmap* map, uint32_t factor)
+{
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    warthog::gridmap* ret = new warthog::gridmap(h * factor, w * factor);
+    for(uint32_t y = 0; y < h * factor; y++)
+    {
+        for(uint32_t x = 0; x < w * factor; x++)
+        {
+            set_tile(ret, x, y, get_tile(map, x / factor, y / factor));
+        }
+    }
+    return ret;
+}
+
+warthog::gridmap*
+warthog::map_generator::add_obstacles(warthog::gridmap* map, double r,
+        const std::vector<uint32_t>& keep)
+{
+    warthog::gridmap* ret = copy_map(map);
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    std::vector<bool> keep_free((size_t)w * h, false);
+    for(uint32_t id : keep)
+    {
+        if(id < keep_free.size()) { keep_free.at(id) = true; }
+    }
+
+    for(uint32_t y = 0; y < h; y++)
+    {
+        for(uint32_t x = 0; x < w; x++)
+        {
+            if(!get_tile(ret, x, y) || keep_free[(size_t)y * w + x])
+            { continue; }
+            if(coin(r)) { set_tile(ret, x, y, false); }
+        }
+    }
+    return ret;
+}
+
+warthog::experiment*
+warthog::map_generator::sample_query(warthog::gridmap* map,
+        const std::string& mapname,
+        uint32_t sx0, uint32_t sy0, uint32_t sx1, uint32_t sy1,
+        uint32_t tx0, uint32_t ty0, uint32_t tx1, uint32_t ty1)
+{
+    const uint32_t MAXTRIES = 10000000;
+    uint32_t sx = 0, sy = 0, tx = 0, ty = 0;
+    uint32_t tries = 0;
+    do
+    {
+        if(tries++ == MAXTRIES) { return 0; }
+        sx = uniform_int(sx0, sx1);
+        sy = uniform_int(sy0, sy1);
+    } while(!get_tile(map, sx, sy));
+
+    tries = 0;
+    do
+    {
+        if(tries++ == MAXTRIES) { return 0; }
+        tx = uniform_int(tx0, tx1);
+        ty = uniform_int(ty0, ty1);
+    } while(!get_tile(map, tx, ty));
+
+    return new warthog::experiment(sx, sy, tx, ty,
+            map->header_width(), map->header_height(), 0, mapname);
+}
+
+void
+warthog::map_generator::diag_scenario(warthog::gridmap* map, uint32_t num,
+        const std::string& mapname, warthog::scenario_manager& scenmgr)
+{
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    uint32_t dw = std::max<uint32_t>(1, w / 8);
+    uint32_t dh = std::max<uint32_t>(1, h / 8);
+    for(uint32_t i = 0; i < num; i++)
+    {
+        warthog::experiment* exp = sample_query(map, mapname,
+                1, 1, dw, dh, w - dw, h - dh, w - 1, h - 1);
+        if(!exp)
+        {
+            std::cerr << "err; map_generator::diag_scenario could not find "
+                << "traversable start and target tiles. giving up.\n";
+            return;
+        }
+        scenmgr.add_experiment(exp);
+    }
+}
+
+void
+warthog::map_generator::random_scenario(warthog::gridmap* map, uint32_t num,
+        const std::string& mapname, warthog::scenario_manager& scenmgr,
+        uint32_t goals_per_start)
+{
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    uint32_t sx0 = 0, sy0 = 0, sx1 = w - 1, sy1 = h - 1;
+    if(goals_per_start == 0) { goals_per_start = 1; }
+    for(uint32_t i = 0; i < num; i++)
+    {
+        // pin the start of the previous query to reuse it
+        if(i % goals_per_start != 0)
+        {
+            warthog::experiment* prev =
+                scenmgr.get_experiment(scenmgr.num_experiments() - 1);
+            sx0 = sx1 = prev->startx();
+            sy0 = sy1 = prev->starty();
+        }
+        else
+        {
+            sx0 = 0; sy0 = 0; sx1 = w - 1; sy1 = h - 1;
+        }
+
+        warthog::experiment* exp = sample_query(map, mapname,
+                sx0, sy0, sx1, sy1, 0, 0, w - 1, h - 1);
+        if(!exp)
+        {
+            std::cerr << "err; map_generator::random_scenario could not find "
+                << "traversable start and target tiles. giving up.\n";
+            return;
+        }
+        scenmgr.add_experiment(exp);
+    }
+}
+
+void
+warthog::map_generator::write_map(warthog::gridmap* map, std::ostream& out)
+{
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    out << "type octile\n"
+        << "height " << h << "\n"
+        << "width " << w << "\n"
+        << "map\n";
+
+    std::string row(w + 1, '\n');
+    for(uint32_t y = 0; y < h; y++)
+    {
+        for(uint32_t x = 0; x < w; x++)
+        {
+            row[x] = get_tile(map, x, y) ? '.' : '@';
+        }
+        out.write(row.data(), row.size());
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef WARTHOG_MAP_GENERATOR_H
+#define WARTHOG_MAP_GENERATOR_H
+
+// util/map_generator.h
+//
+// Generates synthetic grid maps and scenarios. Covers the families built
+// by gen.py (diag-*, square, empty, random obstacles added to an existing
+// map, scaled-up copies for the vary-size experiments) plus random, room,
+// maze and cave maps. Maps are built directly in a warthog::gridmap, so
+// sizes up to 16k x 16k are practical; scenario distances are computed
+// with warthog::scenario_manager::compute_distances.
+//
+// All coordinates are in the unpadded space of the map (i.e. as they
+// appear in .map and .scen files). Every generator returns a new map
+// which the caller is responsible for deleting.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "gridmap.h"
+#include "scenario_manager.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace warthog
+{
+
+class map_generator
+{
+    public:
+        map_generator(uint64_t seed = 0);
+        ~map_generator() { }
+
+        // l x l map with a wall border, an anti-diagonal blockage covering
+        // a fraction @param dr of the diagonal and random obstacles (with
+        // probability @param r) on the l/8 anti-diagonals either side
+        warthog::gridmap*
+        diag(uint32_t l, double r, double dr);
+
+        // l x l map with a wall border, a wall across the middle row and
+        // random obstacles (probability @param r) in the middle quarter
+        warthog::gridmap*
+        square(uint32_t l, double r);
+
+        // l x l obstacle-free map, except for one wall column at x = l-2
+        warthog::gridmap*
+        empty(uint32_t l);
+
+        // every tile is an obstacle with probability @param r
+        warthog::gridmap*
+        random(uint32_t height, uint32_t width, double r);
+
+        // square rooms of side @param room separated by walls one tile thick.
+        // adjacent rooms are joined by a spanning tree of doors and any other
+        // pair of adjacent rooms gets a door with probability @param doors
+        warthog::gridmap*
+        rooms(uint32_t height, uint32_t width, uint32_t room, double doors);
+
+        // perfect maze (recursive backtracker) with corridors of width
+        // @param corridor and walls one tile thick
+        warthog::gridmap*
+        maze(uint32_t height, uint32_t width, uint32_t corridor);
+
+        // cellular automaton caves: random fill with probability @param fill
+        // then @param iterations rounds of the 4-5 smoothing rule
+        warthog::gridmap*
+        cave(uint32_t height, uint32_t width, double fill, uint32_t iterations);
+
+        // copy of @param map where every tile becomes a
+        // @param factor x @param factor block
+        warthog::gridmap*
+        scale(warthog::gridmap* map, uint32_t factor);
+
+        // copy of @param map where each traversable tile becomes an obstacle
+        // with probability @param r. tiles listed (as unpadded ids) in
+        // @param keep are never blocked.
+        // NB: gen.py blocks exactly r * |traversable| tiles; sampling each
+        // tile independently gives the same expected count in one pass.
+        warthog::gridmap*
+        add_obstacles(warthog::gridmap* map, double r,
+                const std::vector<uint32_t>& keep);
+
+        // add @param num queries to @param scenmgr. starts are drawn from
+        // the top-left and targets from the bottom-right eighth of the map
+        // (as in gen.py diag-scen). distances are not computed.
+        void
+        diag_scenario(warthog::gridmap* map, uint32_t num,
+                const std::string& mapname, warthog::scenario_manager& scenmgr);
+
+        // as above, but start and target are drawn uniformly at random.
+        // each start is reused for @param goals_per_start queries, which
+        // lets compute_distances settle them with a single search
+        void
+        random_scenario(warthog::gridmap* map, uint32_t num,
+                const std::string& mapname, warthog::scenario_manager& scenmgr,
+                uint32_t goals_per_start = 1);
+
+        // write @param map in the movingai ascii format
+        static void
+        write_map(warthog::gridmap* map, std::ostream& out);
+
+    private:
+        std::mt19937_64 rng_;
+
+        // uniform double in [0, 1)
+        inline double
+        uniform() { return (double)(rng_() >> 11) * (1.0 / 9007199254740992.0); }
+
+        inline bool
+        coin(double p) { return uniform() < p; }
+
+        // uniform integer in [lo, hi]
+        inline uint32_t
+        uniform_int(uint32_t lo, uint32_t hi)
+        { return lo + (uint32_t)(rng_() % ((uint64_t)hi - lo + 1)); }
+
+        warthog::experiment*
+        sample_query(warthog::gridmap* map, const std::string& mapname,
+                uint32_t sx0, uint32_t sy0, uint32_t sx1, uint32_t sy1,
+                uint32_t tx0, uint32_t ty0, uint32_t tx1, uint32_t ty1);
+};
+
+}
+
+#endif
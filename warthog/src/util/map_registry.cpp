@@ -0,0 +1,391 @@
+#include "map_registry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace
+{
+
+// check that the text map @param filename can be read by gm_parser, which
+// exits on malformed files: three header fields (type octile, height and
+// width, in any order), "map", then exactly height * width tiles.
+// @return false, with a reason in @param err, if it cannot
+bool
+check_text_map(const std::string& filename, std::string& err)
+{
+    std::ifstream in(filename.c_str());
+    std::map<std::string, std::string> fields;
+    for(int i = 0; i < 3; i++)
+    {
+        std::string field, value;
+        if(!(in >> field >> value))
+        {
+            err = "bad map header in " + filename;
+            return false;
+        }
+        fields[field] = value;
+    }
+    uint64_t height = strtoul(fields["height"].c_str(), 0, 10);
+    uint64_t width = strtoul(fields["width"].c_str(), 0, 10);
+    std::string keyword;
+    if(fields["type"] != "octile" || height == 0 || width == 0 ||
+       !(in >> keyword) || keyword != "map")
+    {
+        err = "bad map header in " + filename;
+        return false;
+    }
+
+    uint64_t tiles = 0;
+    for(char c; in.get(c); )
+    {
+        if(c != ' ' && c != '\t' && c != '\n' && c != '\r') { tiles++; }
+    }
+    if(tiles != height * width)
+    {
+        err = "wrong number of tiles in " + filename;
+        return false;
+    }
+    return true;
+}
+
+// @return true if @param a exists and is at least as recent as @param b
+bool
+up_to_date(const std::string& a, const std::string& b)
+{
+    struct stat sa, sb;
+    return stat(a.c_str(), &sa) == 0 && stat(b.c_str(), &sb) == 0 &&
+        sa.st_mtime >= sb.st_mtime;
+}
+
+}
+
+warthog::map_registry::entry::entry(const std::string& name,
+        warthog::versioned_gridmap* maps, warthog::path_cache* cache)
+    : name_(name), maps_(maps), cache_(cache), total_(0), accounted_(0)
+{ }
+
+warthog::map_registry::entry::~entry()
+{
+    for(auto& s : searchers_) { delete s.first; }
+    delete cache_;
+    delete maps_;
+}
+
+warthog::grid_searcher*
+warthog::map_registry::entry::checkout(const std::string& alg,
+        const warthog::gridmap_snapshot& snap)
+{
+    warthog::grid_searcher* s = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<warthog::grid_searcher*>& idle = idle_[alg];
+        if(!idle.empty())
+        {
+            s = idle.back();
+            idle.pop_back();
+            // the version a searcher was bound to may be gone by now, so
+            // versions are compared rather than map addresses
+            searcher_info& info = searchers_[s];
+            if(info.version_ == snap.get_version()) { return s; }
+            info.version_ = snap.get_version();
+        }
+    }
+    if(s)
+    {
+        s->set_map(snap.get_map(), snap.get_rmap());
+        return s;
+    }
+
+    s = warthog::create_grid_searcher(alg, snap.get_map(), snap.get_rmap());
+    if(s)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        searchers_[s] = searcher_info{0, snap.get_version()};
+    }
+    return s;
+}
+
+uint64_t
+warthog::map_registry::entry::update(
+        const std::vector<warthog::cell_update>& changes)
+{
+    if(!cache_)
+    {
+        uint64_t version = maps_->update(changes);
+        std::lock_guard<std::mutex> lock(mutex_);
+        reaccount();
+        return version;
+    }
+
+    // the affected paths are dropped before the new version is published,
+    // so that no lookup returns one of them once it is. blocking a cell
+    // only affects the paths through it; freeing one can shorten any path
+    uint32_t w = snapshot()->get_map()->header_width();
+    for(const warthog::cell_update& c : changes)
+    {
+        if(c.traversable_)
+        {
+            cache_->clear();
+            break;
+        }
+        cache_->invalidate((warthog::grid_id_t)c.y_ * w + c.x_);
+    }
+    uint64_t version = maps_->update(changes);
+
+    // searches that began in between ran on the old version; their paths
+    // are rejected by ::insert
+    cache_->advance_epoch();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    reaccount();
+    return version;
+}
+
+void
+warthog::map_registry::entry::checkin(warthog::grid_searcher* searcher)
+{
+    // searchers count the map they run on; it is accounted once, by ::mem
+    size_t bytes = searcher->mem();
+    size_t shared = searcher->get_map()->mem();
+    bytes = bytes > shared ? bytes - shared : 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    searchers_[searcher].mem_ = bytes;
+    idle_[searcher->get_name()].push_back(searcher);
+    reaccount();
+}
+
+size_t
+warthog::map_registry::entry::mem()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mem_locked();
+}
+
+void
+warthog::map_registry::entry::account(std::atomic<size_t>* total)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(total_) { *total_ -= accounted_; }
+    total_ = total;
+    accounted_ = 0;
+    reaccount();
+}
+
+size_t
+warthog::map_registry::entry::mem_locked()
+{
+    size_t bytes = sizeof(*this) + snapshot()->mem();
+    if(cache_) { bytes += cache_->mem(); }
+    for(auto& s : searchers_) { bytes += s.second.mem_; }
+    return bytes;
+}
+
+void
+warthog::map_registry::entry::reaccount()
+{
+    if(!total_) { return; }
+    // one atomic step, so the total never passes through a value that
+    // is off by the old or the new count
+    size_t bytes = mem_locked();
+    total_->fetch_add(bytes - accounted_);
+    accounted_ = bytes;
+}
+
+warthog::map_registry::map_registry(size_t budget,
+        const std::string& cache_dir, bool components)
+    : budget_(budget), cache_dir_(cache_dir), components_(components),
+      path_cache_(0), loads_(0), evictions_(0), resident_bytes_(0)
+{ }
+
+warthog::map_registry::~map_registry()
+{ }
+
+void
+warthog::map_registry::add(const std::string& name,
+        const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sources_.find(name);
+    if(it != sources_.end() && it->second->resident_)
+    {
+        lru_.erase(it->second->lru_pos_);
+        it->second->resident_->account(0);
+    }
+
+    std::shared_ptr<source> src(new source());
+    src->filename_ = filename;
+    sources_[name] = src;
+}
+
+bool
+warthog::map_registry::contains(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sources_.find(name) != sources_.end();
+}
+
+std::shared_ptr<warthog::map_registry::entry>
+warthog::map_registry::acquire(const std::string& name, std::string& err)
+{
+    std::shared_ptr<source> src;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sources_.find(name);
+        if(it == sources_.end())
+        {
+            err = "unknown map " + name;
+            return std::shared_ptr<entry>();
+        }
+        src = it->second;
+        if(src->resident_)
+        {
+            lru_.splice(lru_.begin(), lru_, src->lru_pos_);
+            return src->resident_;
+        }
+    }
+
+    // other maps stay available while this one loads; concurrent
+    // requests for the same map wait for the first load to finish
+    std::lock_guard<std::mutex> load_lock(src->load_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(src->resident_)
+        {
+            lru_.splice(lru_.begin(), lru_, src->lru_pos_);
+            return src->resident_;
+        }
+    }
+
+    warthog::gridmap* map = load(name, src->filename_, err);
+    if(!map) { return std::shared_ptr<entry>(); }
+    warthog::path_cache* cache =
+        path_cache_ ? new warthog::path_cache(map, path_cache_) : 0;
+    std::shared_ptr<entry> e(new entry(name,
+                new warthog::versioned_gridmap(map, components_), cache));
+    loads_++;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the map may have been replaced while it was loading; the caller
+    // still gets this copy but it is not kept
+    auto it = sources_.find(name);
+    if(it != sources_.end() && it->second == src)
+    {
+        make_resident(name, *src, e);
+        enforce_budget();
+    }
+    return e;
+}
+
+void
+warthog::map_registry::release(std::shared_ptr<entry>& e,
+        warthog::grid_searcher* searcher)
+{
+    if(searcher) { e->checkin(searcher); }
+    e.reset();
+    if(budget_ == 0 || resident_bytes_ <= budget_) { return; }
+    std::lock_guard<std::mutex> lock(mutex_);
+    enforce_budget();
+}
+
+uint32_t
+warthog::map_registry::num_registered()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (uint32_t)sources_.size();
+}
+
+uint32_t
+warthog::map_registry::num_resident()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (uint32_t)lru_.size();
+}
+
+std::vector<std::string>
+warthog::map_registry::names()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> names;
+    for(auto& s : sources_) { names.push_back(s.first); }
+    return names;
+}
+
+warthog::gridmap*
+warthog::map_registry::load(const std::string& name,
+        const std::string& filename, std::string& err)
+{
+    std::ifstream probe(filename.c_str());
+    if(!probe.good())
+    {
+        err = "cannot read " + filename;
+        return 0;
+    }
+    probe.close();
+
+    if(warthog::gridmap::is_binary(filename.c_str()))
+    {
+        warthog::gridmap* map = warthog::gridmap::load(filename.c_str());
+        if(!map) { err = "bad binary map " + filename; }
+        return map;
+    }
+
+    std::string cached;
+    if(cache_dir_ != "")
+    {
+        std::string base = name;
+        for(char& c : base) { if(c == '/') { c = '_'; } }
+        cached = cache_dir_ + "/" + base + ".wgm";
+        if(up_to_date(cached, filename))
+        {
+            warthog::gridmap* map = warthog::gridmap::load(cached.c_str());
+            if(map) { return map; }
+        }
+    }
+
+    // the text parser exits on malformed files, which would take the
+    // whole server down; they are rejected here instead
+    if(!check_text_map(filename, err)) { return 0; }
+    warthog::gridmap* map = new warthog::gridmap(filename.c_str());
+    if(cached != "")
+    {
+        // write under a temporary name so readers never see half a file
+        std::string tmp = cached + ".tmp";
+        if(map->save(tmp.c_str())) { rename(tmp.c_str(), cached.c_str()); }
+        else { remove(tmp.c_str()); }
+    }
+    return map;
+}
+
+void
+warthog::map_registry::make_resident(const std::string& name, source& src,
+        std::shared_ptr<entry> e)
+{
+    src.resident_ = e;
+    lru_.push_front(name);
+    src.lru_pos_ = lru_.begin();
+    e->account(&resident_bytes_);
+}
+
+void
+warthog::map_registry::evict(const std::string& name, source& src)
+{
+    lru_.erase(src.lru_pos_);
+    src.resident_->account(0);
+    src.resident_.reset();
+    evictions_++;
+}
+
+void
+warthog::map_registry::enforce_budget()
+{
+    if(budget_ == 0) { return; }
+
+    while(resident_bytes_ > budget_ && lru_.size() > 1)
+    {
+        std::string victim = lru_.back();
+        evict(victim, *sources_[victim]);
+    }
+}
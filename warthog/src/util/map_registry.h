@@ -0,0 +1,227 @@
+#ifndef WARTHOG_MAP_REGISTRY_H
+#define WARTHOG_MAP_REGISTRY_H
+
+// util/map_registry.h
+//
+// A registry of named grid maps for processes that serve many maps. Maps
+// are registered by name and loaded on first use. A resident map keeps its
+// gridmap, optional component labels, an optional path cache and a pool
+// of searchers per algorithm (each searcher brings its own expansion
+// policy, node pool and, for jps2, rotated map). The memory of all this is
+// accounted per map and when the total exceeds the budget the least
+// recently used maps are evicted. Evicted maps are reloaded on demand.
+//
+// Resident maps can be changed while they are queried: each keeps its
+// versions in a warthog::versioned_gridmap and queries run on the
+// snapshot that was current when they started (see gridmap_snapshot.h).
+// Searchers are moved to the newest version when they are checked out.
+//
+// With a cache directory, every map parsed from a text .map file is also
+// saved in the binary format of warthog::gridmap::save and later loads
+// read the binary copy instead (as long as it is newer than the source).
+// Binary files can also be registered directly.
+//
+// Callers hold a std::shared_ptr to an entry while they use it, so
+// eviction never pulls a map out from under a running query; the memory
+// is released when the last user lets go.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "gridmap.h"
+#include "gridmap_snapshot.h"
+#include "grid_searcher.h"
+#include "path_cache.h"
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace warthog
+{
+
+class map_registry
+{
+    public:
+        // everything kept in memory for one resident map
+        class entry
+        {
+            public:
+                entry(const std::string& name,
+                        warthog::versioned_gridmap* maps,
+                        warthog::path_cache* cache);
+                ~entry();
+
+                inline const std::string&
+                get_name() { return name_; }
+
+                // the current version of the map. component labels are
+                // part of it if the registry computes them
+                inline std::shared_ptr<const warthog::gridmap_snapshot>
+                snapshot() { return maps_->current(); }
+
+                // 0 unless the registry caches paths
+                inline warthog::path_cache*
+                get_path_cache() { return cache_; }
+
+                // take an idle searcher for @param alg, creating one if
+                // none is free, and bind it to @param snap.
+                // @return 0 if the algorithm is unknown
+                warthog::grid_searcher*
+                checkout(const std::string& alg,
+                        const warthog::gridmap_snapshot& snap);
+
+                // publish a new version of the map with @param changes
+                // applied and drop the cached paths they affect.
+                // @return the new version number
+                uint64_t
+                update(const std::vector<warthog::cell_update>& changes);
+
+                // return a searcher taken with ::checkout
+                void
+                checkin(warthog::grid_searcher* searcher);
+
+                size_t
+                mem();
+
+                // count the memory of this map in @param total from now on
+                // and keep it up to date as searchers are checked in and
+                // the map is updated; 0 takes it out again
+                void
+                account(std::atomic<size_t>* total);
+
+            private:
+                struct searcher_info
+                {
+                    // as of the last checkin
+                    size_t mem_;
+                    // the map version the searcher is bound to
+                    uint64_t version_;
+                };
+
+                std::string name_;
+                warthog::versioned_gridmap* maps_;
+                warthog::path_cache* cache_;
+
+                std::mutex mutex_;
+                std::map<std::string, std::vector<warthog::grid_searcher*>> idle_;
+                // every searcher created for this map
+                std::map<warthog::grid_searcher*, searcher_info> searchers_;
+                // the total set by ::account and what is counted in it
+                std::atomic<size_t>* total_;
+                size_t accounted_;
+
+                // needs mutex_
+                size_t
+                mem_locked();
+
+                // bring the count in total_ up to date. needs mutex_
+                void
+                reaccount();
+        };
+
+        // @param budget is in bytes; 0 means no limit. binary copies of
+        // text maps are written to @param cache_dir unless it is empty.
+        map_registry(size_t budget, const std::string& cache_dir = "",
+                bool components = false);
+        ~map_registry();
+
+        // register (or replace) map @param name; nothing is loaded until
+        // the map is acquired
+        void
+        add(const std::string& name, const std::string& filename);
+
+        bool
+        contains(const std::string& name);
+
+        // give every map loaded from now on a path cache holding up to
+        // @param capacity paths (0 disables caching)
+        inline void
+        set_path_cache(uint32_t capacity) { path_cache_ = capacity; }
+
+        // @return the resident entry of map @param name, loading it if
+        // necessary, or null, with a reason in @param err, if the map is
+        // not registered or cannot be read
+        std::shared_ptr<warthog::map_registry::entry>
+        acquire(const std::string& name, std::string& err);
+
+        // give back a searcher taken from @param e and drop the reference;
+        // evicts maps if the searcher has grown the total past the budget.
+        // the registry is only locked when it has
+        void
+        release(std::shared_ptr<warthog::map_registry::entry>& e,
+                warthog::grid_searcher* searcher);
+
+        // memory of all resident maps, as of the last checkin or update
+        inline size_t
+        mem() { return resident_bytes_; }
+
+        inline size_t
+        get_budget() { return budget_; }
+
+        uint32_t
+        num_registered();
+
+        uint32_t
+        num_resident();
+
+        inline uint64_t
+        num_loads() { return loads_; }
+
+        inline uint64_t
+        num_evictions() { return evictions_; }
+
+        // names of all registered maps
+        std::vector<std::string>
+        names();
+
+    private:
+        struct source
+        {
+            std::string filename_;
+            std::shared_ptr<warthog::map_registry::entry> resident_;
+            std::list<std::string>::iterator lru_pos_;
+            // serialises loads of this map
+            std::mutex load_mutex_;
+        };
+
+        size_t budget_;
+        std::string cache_dir_;
+        bool components_;
+        uint32_t path_cache_;
+
+        std::mutex mutex_;
+        std::map<std::string, std::shared_ptr<source>> sources_;
+        // resident maps, most recently used first
+        std::list<std::string> lru_;
+
+        std::atomic<uint64_t> loads_;
+        std::atomic<uint64_t> evictions_;
+        // memory of the maps in lru_; see entry::account
+        std::atomic<size_t> resident_bytes_;
+
+        warthog::gridmap*
+        load(const std::string& name, const std::string& filename,
+                std::string& err);
+
+        void
+        make_resident(const std::string& name, source& src,
+                std::shared_ptr<warthog::map_registry::entry> e);
+
+        void
+        evict(const std::string& name, source& src);
+
+        // evict least recently used maps while over budget, keeping
+        // at least the most recently used one. needs mutex_
+        void
+        enforce_budget();
+};
+
+}
+
+#endif
@@ -0,0 +1,14 @@
+#include "phase_timer.h"
+
+thread_local uint64_t
+warthog::phase::cycles[warthog::phase::NUM_PHASES+1] = {0};
+
+thread_local uint32_t
+warthog::phase::active = warthog::phase::NONE;
+
+thread_local uint64_t
+warthog::phase::mark = 0;
+
+const char*
+warthog::phase::names[warthog::phase::NUM_PHASES] =
+    {"scan", "succ", "gen", "heur", "open", "path"};
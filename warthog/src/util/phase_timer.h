@@ -0,0 +1,136 @@
+#ifndef WARTHOG_PHASE_TIMER_H
+#define WARTHOG_PHASE_TIMER_H
+
+// util/phase_timer.h
+//
+// Cycle counters that split the time of a search into phases: jump point
+// scanning, successor computation, node generation, heuristic evaluation,
+// open list operations and path extraction.
+//
+// Instrumentation is compiled in only when PHASE_TIMING is defined (see the
+// `phase` build flavour); otherwise PHASE_SCOPE expands to nothing.
+// Each PHASE_SCOPE charges the cycles spent inside it to one phase. Scopes
+// may nest: entering an inner scope pauses the outer one, so the phases
+// never double count. Cycles of the whole search are kept separately
+// (phase TOTAL) and anything not covered by a phase is "other".
+//
+// Counters are thread_local and accumulate until ::clear is called.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace warthog
+{
+
+namespace phase
+{
+
+enum phase_id
+{
+    SCAN = 0,       // jump point scanning (locator ::jump calls)
+    SUCCESSORS,     // jps::compute_successors
+    GENERATE,       // node_pool::generate
+    HEURISTIC,      // heuristic evaluation
+    OPEN,           // open list push / pop / decrease_key
+    PATH,           // path extraction
+    NUM_PHASES,
+    TOTAL = NUM_PHASES, // the whole search
+    NONE
+};
+
+extern thread_local uint64_t cycles[NUM_PHASES+1];
+extern thread_local uint32_t active;
+extern thread_local uint64_t mark;
+
+extern const char* names[NUM_PHASES];
+
+inline uint64_t
+now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+inline void
+clear()
+{
+    for(uint32_t i = 0; i <= NUM_PHASES; i++) { cycles[i] = 0; }
+    active = NONE;
+}
+
+// cycles not attributed to any phase
+inline uint64_t
+other()
+{
+    uint64_t sum = 0;
+    for(uint32_t i = 0; i < NUM_PHASES; i++) { sum += cycles[i]; }
+    return cycles[TOTAL] > sum ? cycles[TOTAL] - sum : 0;
+}
+
+class scope
+{
+    public:
+        inline explicit
+        scope(phase_id p)
+        {
+            uint64_t t = now();
+            if(active != NONE) { cycles[active] += t - mark; }
+            prev_ = active;
+            active = p;
+            mark = t;
+        }
+
+        inline
+        ~scope()
+        {
+            uint64_t t = now();
+            cycles[active] += t - mark;
+            active = prev_;
+            mark = t;
+        }
+
+    private:
+        uint32_t prev_;
+};
+
+// times the whole search; independent of the phase scopes
+class total_scope
+{
+    public:
+        inline total_scope() : start_(now()) { }
+        inline ~total_scope() { cycles[TOTAL] += now() - start_; }
+
+    private:
+        uint64_t start_;
+};
+
+}
+
+}
+
+#define PHASE_CONCAT_(a, b) a##b
+#define PHASE_CONCAT(a, b) PHASE_CONCAT_(a, b)
+
+#ifdef PHASE_TIMING
+#define PHASE_SCOPE(p) \
+    warthog::phase::scope PHASE_CONCAT(phase_scope_, __LINE__)(warthog::phase::p)
+#define PHASE_TOTAL_SCOPE() \
+    warthog::phase::total_scope PHASE_CONCAT(phase_total_, __LINE__)
+#else
+#define PHASE_SCOPE(p)
+#define PHASE_TOTAL_SCOPE()
+#endif
+
+#endif
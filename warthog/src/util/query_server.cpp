@@ -0,0 +1,488 @@
+#include "query_server.h"
+#include "constants.h"
+#include "problem_instance.h"
+#include "solution.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+
+// responses a connection may have outstanding before its reader blocks
+const size_t MAX_PENDING = 4096;
+
+// buffered line reader on top of a file descriptor
+class line_reader
+{
+    public:
+        line_reader(int fd) : fd_(fd), pos_(0), len_(0) { }
+
+        bool
+        next(std::string& line)
+        {
+            line.clear();
+            while(true)
+            {
+                while(pos_ < len_)
+                {
+                    char c = buf_[pos_++];
+                    if(c == '\n') { return true; }
+                    if(c != '\r') { line.push_back(c); }
+                }
+                ssize_t n = read(fd_, buf_, sizeof(buf_));
+                if(n < 0 && errno == EINTR) { continue; }
+                if(n <= 0) { return line.size() > 0; }
+                pos_ = 0;
+                len_ = (size_t)n;
+            }
+        }
+
+    private:
+        int fd_;
+        char buf_[65536];
+        size_t pos_;
+        size_t len_;
+};
+
+bool
+write_all(int fd, const std::string& data)
+{
+    const char* p = data.c_str();
+    size_t left = data.size();
+    while(left > 0)
+    {
+        // send avoids SIGPIPE when a socket client goes away;
+        // stdout and pipes fall back to write
+        ssize_t n = send(fd, p, left, MSG_NOSIGNAL);
+        if(n < 0 && errno == ENOTSOCK) { n = write(fd, p, left); }
+        if(n < 0 && errno == EINTR) { continue; }
+        if(n <= 0) { return false; }
+        p += n;
+        left -= (size_t)n;
+    }
+    return true;
+}
+
+std::string
+first_token(const std::string& line)
+{
+    std::istringstream in(line);
+    std::string tok;
+    in >> tok;
+    return tok;
+}
+
+}
+
+warthog::query_server::query_server(uint32_t num_workers, size_t budget,
+        const std::string& cache_dir, bool components)
+    : stopping_(false), registry_(budget, cache_dir, components),
+      timeout_(0), queries_(0), cancelled_(0), timeouts_(0), running_(false),
+      listen_fd_(-1)
+{
+    if(num_workers == 0) { num_workers = 1; }
+    for(uint32_t i = 0; i < num_workers; i++)
+    {
+        workers_.push_back(std::thread(&query_server::worker_loop, this));
+    }
+}
+
+warthog::query_server::~query_server()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        stopping_ = true;
+    }
+    jobs_cv_.notify_all();
+    for(std::thread& t : workers_) { t.join(); }
+}
+
+bool
+warthog::query_server::load_map(const std::string& name,
+        const std::string& filename, std::string& err)
+{
+    registry_.add(name, filename);
+    std::shared_ptr<warthog::map_registry::entry> e =
+        registry_.acquire(name, err);
+    if(!e) { return false; }
+    registry_.release(e, 0);
+    return true;
+}
+
+void
+warthog::query_server::worker_loop()
+{
+    while(true)
+    {
+        job* j = 0;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex_);
+            jobs_cv_.wait(lock, [this] { return !jobs_.empty() || stopping_; });
+            if(jobs_.empty()) { break; }
+            j = jobs_.front();
+            jobs_.pop_front();
+        }
+        j->response_.set_value(answer(*j));
+        delete j;
+    }
+}
+
+std::string
+warthog::query_server::answer(job& j)
+{
+    // nobody is waiting for queries of a closed connection
+    if(j.cancel_->load(std::memory_order_relaxed))
+    {
+        cancelled_++;
+        return "err cancelled";
+    }
+
+    std::istringstream in(j.request_);
+    std::string cmd, name, alg;
+    int64_t sx, sy, gx, gy;
+    if(!(in >> cmd >> name >> alg >> sx >> sy >> gx >> gy))
+    {
+        return "err usage: " + cmd + " <map> <alg> <sx> <sy> <gx> <gy>";
+    }
+
+    std::string err;
+    std::shared_ptr<warthog::map_registry::entry> e =
+        registry_.acquire(name, err);
+    if(!e) { return "err " + err; }
+
+    // the query runs on the version of the map that is current now, even
+    // if the map changes meanwhile. the cache epoch is read first: a path
+    // found on a version that has since been replaced is then not cached
+    warthog::path_cache* pcache = e->get_path_cache();
+    uint64_t epoch = pcache ? pcache->get_epoch() : 0;
+    std::shared_ptr<const warthog::gridmap_snapshot> snap = e->snapshot();
+    warthog::gridmap* map = snap->get_map();
+
+    int64_t w = map->header_width();
+    int64_t h = map->header_height();
+    if(sx < 0 || sy < 0 || gx < 0 || gy < 0 ||
+       sx >= w || gx >= w || sy >= h || gy >= h)
+    {
+        registry_.release(e, 0);
+        return "err coordinates outside the map";
+    }
+    warthog::grid_id_t startid = (warthog::grid_id_t)(sy * w + sx);
+    warthog::grid_id_t goalid = (warthog::grid_id_t)(gy * w + gx);
+    if(!map->get_label(map->to_padded_id(startid)) ||
+       !map->get_label(map->to_padded_id(goalid)))
+    {
+        registry_.release(e, 0);
+        return "err start or goal is not traversable";
+    }
+
+    const std::vector<std::string>& algs = warthog::grid_searcher_names();
+    if(std::find(algs.begin(), algs.end(), alg) == algs.end())
+    {
+        registry_.release(e, 0);
+        return "err unknown algorithm " + alg;
+    }
+
+    // no search is needed between different components
+    warthog::grid_components* comps = snap->get_components();
+    if(comps && !comps->connected(startid, goalid))
+    {
+        registry_.release(e, 0);
+        queries_++;
+        return "none";
+    }
+
+    // cached paths are shared by all algorithms; they are all optimal
+    warthog::problem_instance pi(startid, goalid);
+    pi.set_cancel_token(j.cancel_.get());
+    pi.set_deadline(j.deadline_);
+    warthog::solution sol;
+    warthog::grid_searcher* searcher = 0;
+    if(!pcache || !pcache->lookup(pi, sol))
+    {
+        searcher = e->checkout(alg, *snap);
+        if(cmd == "path" || pcache) { searcher->get_path(pi, sol); }
+        else { searcher->get_pathcost(pi, sol); }
+        if(pcache) { pcache->insert(pi, sol, epoch); }
+    }
+    queries_++;
+
+    if(sol.status_ == warthog::SEARCH_CANCELLED ||
+       sol.status_ == warthog::SEARCH_TIMED_OUT)
+    {
+        registry_.release(e, searcher);
+        if(sol.status_ == warthog::SEARCH_CANCELLED)
+        {
+            cancelled_++;
+            return "err cancelled";
+        }
+        timeouts_++;
+        return "err timeout";
+    }
+
+    if(sol.sum_of_edge_costs_ == warthog::COST_MAX)
+    {
+        registry_.release(e, searcher);
+        return "none";
+    }
+
+    std::ostringstream out;
+    out << std::setprecision(12) << "ok " << sol.sum_of_edge_costs_;
+    if(cmd == "path")
+    {
+        out << " " << sol.path_.size();
+        for(warthog::sn_id_t id : sol.path_)
+        {
+            uint32_t x, y;
+            map->to_unpadded_xy((warthog::grid_id_t)id, x, y);
+            out << " " << x << " " << y;
+        }
+    }
+    registry_.release(e, searcher);
+    return out.str();
+}
+
+std::string
+warthog::query_server::immediate(const std::string& cmd,
+        const std::string& request)
+{
+    std::istringstream in(request);
+    std::string tok;
+    in >> tok;
+
+    std::ostringstream out;
+    if(cmd == "load")
+    {
+        std::string name, file, err;
+        if(!(in >> name >> file)) { return "err usage: load <name> <mapfile>"; }
+        registry_.add(name, file);
+        std::shared_ptr<warthog::map_registry::entry> e =
+            registry_.acquire(name, err);
+        if(!e) { return "err " + err; }
+        warthog::gridmap* map = e->snapshot()->get_map();
+        out << "ok " << name << " " << map->header_width()
+            << " " << map->header_height();
+        registry_.release(e, 0);
+    }
+    else if(cmd == "add")
+    {
+        std::string name, file;
+        if(!(in >> name >> file)) { return "err usage: add <name> <mapfile>"; }
+        registry_.add(name, file);
+        out << "ok " << name;
+    }
+    else if(cmd == "block" || cmd == "unblock")
+    {
+        std::string name, err;
+        std::vector<warthog::cell_update> changes;
+        int64_t x, y;
+        in >> name;
+        while(in >> x >> y)
+        {
+            if(x < 0 || y < 0 || x > UINT32_MAX || y > UINT32_MAX)
+            {
+                return "err coordinates outside the map";
+            }
+            changes.push_back(warthog::cell_update{
+                    (uint32_t)x, (uint32_t)y, cmd == "unblock"});
+        }
+        if(name == "" || changes.empty() || !in.eof())
+        {
+            return "err usage: " + cmd + " <name> <x> <y> [<x> <y> ...]";
+        }
+        std::shared_ptr<warthog::map_registry::entry> e =
+            registry_.acquire(name, err);
+        if(!e) { return "err " + err; }
+        out << "ok " << e->update(changes);
+        registry_.release(e, 0);
+    }
+    else if(cmd == "maps")
+    {
+        out << "ok";
+        for(const std::string& name : registry_.names()) { out << " " << name; }
+    }
+    else if(cmd == "stats")
+    {
+        out << "ok maps=" << registry_.num_registered()
+            << " resident=" << registry_.num_resident()
+            << " mem=" << registry_.mem()
+            << " loads=" << registry_.num_loads()
+            << " evictions=" << registry_.num_evictions()
+            << " queries=" << queries_
+            << " cancelled=" << cancelled_
+            << " timeouts=" << timeouts_
+            << " workers=" << workers_.size();
+    }
+    else
+    {
+        out << "err unknown request " << cmd;
+    }
+    return out.str();
+}
+
+void
+warthog::query_server::serve(int in_fd, int out_fd)
+{
+    // responses are queued as futures in request order; a writer thread
+    // sends each one as soon as it and all earlier ones are ready
+    std::deque<std::future<std::string>> pending;
+    std::mutex pending_mutex;
+    std::condition_variable pending_cv;
+    bool eof = false;
+    // raised once a response cannot be written; the queries of this
+    // connection that are still queued or running are then given up
+    std::shared_ptr<std::atomic<bool>> gone(new std::atomic<bool>(false));
+    warthog::timer clock;
+
+    std::thread writer([&]()
+    {
+        bool ok = true;
+        while(true)
+        {
+            std::future<std::string> next;
+            {
+                std::unique_lock<std::mutex> lock(pending_mutex);
+                pending_cv.wait(lock, [&] { return !pending.empty() || eof; });
+                if(pending.empty()) { break; }
+                next = std::move(pending.front());
+                pending.pop_front();
+            }
+            pending_cv.notify_all();
+            std::string response = next.get() + "\n";
+            // keep draining after a failed write so the reader never blocks
+            if(ok) { ok = write_all(out_fd, response); }
+            if(!ok) { gone->store(true, std::memory_order_relaxed); }
+        }
+    });
+
+    line_reader reader(in_fd);
+    std::string line;
+    while(reader.next(line))
+    {
+        std::string cmd = first_token(line);
+        if(cmd == "" || cmd[0] == '#') { continue; }
+        if(cmd == "quit") { break; }
+        if(cmd == "shutdown") { stop(); break; }
+
+        std::future<std::string> response;
+        if(cmd == "path" || cmd == "cost")
+        {
+            job* j = new job();
+            j->request_ = line;
+            j->cancel_ = gone;
+            j->deadline_ = timeout_ > 0 ? clock.get_time_nano() + timeout_ : 0;
+            response = j->response_.get_future();
+            {
+                std::lock_guard<std::mutex> lock(jobs_mutex_);
+                jobs_.push_back(j);
+            }
+            jobs_cv_.notify_one();
+        }
+        else
+        {
+            std::promise<std::string> done;
+            done.set_value(immediate(cmd, line));
+            response = done.get_future();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(pending_mutex);
+            pending_cv.wait(lock,
+                    [&] { return pending.size() < MAX_PENDING; });
+            pending.push_back(std::move(response));
+        }
+        pending_cv.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        eof = true;
+    }
+    pending_cv.notify_all();
+    writer.join();
+}
+
+bool
+warthog::query_server::listen(const std::string& path)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(addr.sun_path))
+    {
+        std::cerr << "err; socket path too long: " << path << "\n";
+        return false;
+    }
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0)
+    {
+        std::cerr << "err; socket: " << strerror(errno) << "\n";
+        return false;
+    }
+    unlink(path.c_str());
+    if(bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(fd, 64) < 0)
+    {
+        std::cerr << "err; cannot listen on " << path << ": "
+            << strerror(errno) << "\n";
+        close(fd);
+        return false;
+    }
+
+    listen_fd_ = fd;
+    running_ = true;
+    std::condition_variable done_cv;
+    while(running_)
+    {
+        int conn = accept(listen_fd_, 0, 0);
+        if(conn < 0)
+        {
+            if(errno == EINTR || errno == ECONNABORTED) { continue; }
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            if(!running_) { close(conn); break; }
+            connections_.insert(conn);
+        }
+        std::thread([this, conn, &done_cv]()
+        {
+            serve(conn, conn);
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            connections_.erase(conn);
+            close(conn);
+            done_cv.notify_all();
+        }).detach();
+    }
+
+    // wait for the open connections to finish their outstanding requests
+    {
+        std::unique_lock<std::mutex> lock(connections_mutex_);
+        running_ = false;
+        for(int conn : connections_) { shutdown(conn, SHUT_RD); }
+        done_cv.wait(lock, [this] { return connections_.empty(); });
+    }
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(path.c_str());
+    return true;
+}
+
+void
+warthog::query_server::stop()
+{
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    running_ = false;
+    if(listen_fd_ >= 0) { shutdown(listen_fd_, SHUT_RDWR); }
+    for(int conn : connections_) { shutdown(conn, SHUT_RD); }
+}
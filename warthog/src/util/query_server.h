@@ -0,0 +1,167 @@
+#ifndef WARTHOG_QUERY_SERVER_H
+#define WARTHOG_QUERY_SERVER_H
+
+// util/query_server.h
+//
+// A long running query server. Maps are kept resident in a
+// warthog::map_registry; queries arrive as text lines on stdin or on a
+// Unix domain socket and are answered by a pool of worker threads. Workers
+// borrow searchers from the registry, so node pools and other per-map
+// structures are built once per map rather than once per query.
+//
+// Protocol: one request per line, one response line per request.
+// Responses on a connection come back in the order the requests were sent,
+// even though the requests themselves are answered concurrently.
+//
+//   load <name> <mapfile>                 -> ok <name> <width> <height>
+//   add <name> <mapfile>                  -> ok <name> (loaded on first use)
+//   path <name> <alg> <sx> <sy> <gx> <gy> -> ok <cost> <n> <x1> <y1> ... <xn> <yn>
+//   cost <name> <alg> <sx> <sy> <gx> <gy> -> ok <cost>
+//   block <name> <x> <y> [<x> <y> ...]    -> ok <version>
+//   unblock <name> <x> <y> [<x> <y> ...]  -> ok <version>
+//   maps                                  -> ok <name1> <name2> ...
+//   stats                                 -> ok maps=<n> resident=<n> mem=<bytes>
+//                                            loads=<n> evictions=<n>
+//                                            queries=<n> cancelled=<n>
+//                                            timeouts=<n> workers=<n>
+//   quit                                  (closes the connection)
+//   shutdown                              (stops the server)
+//
+// With a path cache (see warthog::map_registry::set_path_cache) repeated
+// and mirrored queries are answered from the cache, whichever algorithm
+// they name.
+//
+// block and unblock change tiles of a map and publish the result as a new
+// version (see gridmap_snapshot.h). Queries do not wait for the update and
+// updates do not wait for queries: a query runs on the version that was
+// current when a worker picked it up. Cached paths are invalidated. Like
+// load, an update is done before later requests on the connection are read,
+// but queries sent before it may still be answered on the old version.
+//
+// Queries without a path are answered with `none`; malformed requests with
+// `err <reason>`. With a timeout, queries not answered in time (counting
+// the time spent waiting for a worker) get `err timeout`. Once a response
+// cannot be delivered the client is taken to be gone: its queued and
+// running queries are cancelled and answered with `err cancelled`. Coordinates are unpadded (as in .map and .scen files).
+// A `load` is completed before any later request on the same connection is
+// read, so queries may follow it immediately. `stats` is answered when it
+// is read and does not wait for earlier queries.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include "map_registry.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace warthog
+{
+
+class query_server
+{
+    public:
+        // maps are kept within @param budget bytes (0 for no limit) and
+        // @param cache_dir and @param components are passed on to the
+        // map registry
+        query_server(uint32_t num_workers, size_t budget = 0,
+                const std::string& cache_dir = "", bool components = false);
+        ~query_server();
+
+        // load @param filename and make it available as @param name,
+        // replacing any earlier map of that name. queries already running
+        // on the old map finish on it. @return false, with a reason in
+        // @param err, if the map cannot be read
+        bool
+        load_map(const std::string& name, const std::string& filename,
+                std::string& err);
+
+        // as ::load_map but the map is only read when first queried
+        inline void
+        add_map(const std::string& name, const std::string& filename)
+        { registry_.add(name, filename); }
+
+        inline warthog::map_registry&
+        get_registry() { return registry_; }
+
+        // give up queries that are not answered within @param nanos of
+        // being read (0, the default, for no limit)
+        inline void
+        set_timeout(double nanos) { timeout_ = nanos; }
+
+        // answer the requests read from @param in_fd and write responses
+        // to @param out_fd until the input ends or a quit request is read
+        void
+        serve(int in_fd, int out_fd);
+
+        // accept connections on the Unix domain socket @param path and
+        // serve each one on its own thread. returns after ::stop is called
+        // (e.g. by a shutdown request) or false if the socket cannot be set up
+        bool
+        listen(const std::string& path);
+
+        void
+        stop();
+
+        inline uint64_t
+        num_queries() { return queries_; }
+
+        inline uint64_t
+        num_cancelled() { return cancelled_; }
+
+        inline uint64_t
+        num_timeouts() { return timeouts_; }
+
+        inline uint32_t
+        num_workers() { return (uint32_t)workers_.size(); }
+
+    private:
+        struct job
+        {
+            std::string request_;
+            std::promise<std::string> response_;
+            // set when the connection of the request is gone
+            std::shared_ptr<std::atomic<bool>> cancel_;
+            // timer::get_time_nano; 0 for none
+            double deadline_;
+        };
+
+        std::vector<std::thread> workers_;
+        std::deque<job*> jobs_;
+        std::mutex jobs_mutex_;
+        std::condition_variable jobs_cv_;
+        bool stopping_;
+
+        warthog::map_registry registry_;
+        double timeout_;
+
+        std::atomic<uint64_t> queries_;
+        std::atomic<uint64_t> cancelled_;
+        std::atomic<uint64_t> timeouts_;
+        std::atomic<bool> running_;
+        int listen_fd_;
+        std::set<int> connections_;
+        std::mutex connections_mutex_;
+
+        void
+        worker_loop();
+
+        std::string
+        answer(job& j);
+
+        std::string
+        immediate(const std::string& cmd, const std::string& request);
+};
+
+}
+
+#endif
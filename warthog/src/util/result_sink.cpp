@@ -0,0 +1,419 @@
+#include "result_sink.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+
+const char RESULTS_MAGIC[8] = {'W', 'R', 'E', 'S', 'U', 'L', 'T', 'S'};
+const uint32_t RESULTS_VERSION = 1;
+
+// text is written out when the buffer reaches this size
+const size_t TEXT_BUFFER_SIZE = 1 << 16;
+
+void
+write_string(std::ostream& out, const std::string& s)
+{
+    uint32_t len = (uint32_t)s.size();
+    out.write((const char*)&len, sizeof(len));
+    out.write(s.data(), len);
+}
+
+bool
+read_string(std::istream& in, std::string& s)
+{
+    uint32_t len;
+    if(!in.read((char*)&len, sizeof(len)) || len > (1u << 20)) { return false; }
+    s.resize(len);
+    return (bool)in.read(&s[0], len);
+}
+
+// one column of a block: field @param f of every row
+template<class T>
+void
+write_column(std::ostream& out,
+        const std::vector<warthog::query_result>& rows,
+        T warthog::query_result::* f, std::vector<char>& buf)
+{
+    buf.resize(rows.size() * sizeof(T));
+    T* col = (T*)buf.data();
+    for(size_t i = 0; i < rows.size(); i++) { col[i] = rows[i].*f; }
+    out.write(buf.data(), buf.size());
+}
+
+template<class T>
+bool
+read_column(std::istream& in, std::vector<warthog::query_result>& rows,
+        T warthog::query_result::* f, std::vector<char>& buf)
+{
+    buf.resize(rows.size() * sizeof(T));
+    if(!in.read(buf.data(), buf.size())) { return false; }
+    const T* col = (const T*)buf.data();
+    for(size_t i = 0; i < rows.size(); i++) { rows[i].*f = col[i]; }
+    return true;
+}
+
+}
+
+warthog::text_result_sink::text_result_sink(std::ostream& out, char sep)
+    : out_(&out), file_(0), sep_(sep), num_extra_(0)
+{
+    buf_.reserve(TEXT_BUFFER_SIZE + 1024);
+}
+
+warthog::text_result_sink::text_result_sink(const std::string& filename,
+        char sep)
+    : file_(new std::ofstream(filename.c_str())), sep_(sep), num_extra_(0)
+{
+    out_ = file_;
+    buf_.reserve(TEXT_BUFFER_SIZE + 1024);
+}
+
+warthog::text_result_sink::~text_result_sink()
+{
+    finish();
+    delete file_;
+}
+
+void
+warthog::text_result_sink::append(std::string& to, const std::string& field)
+{
+    // csv fields with separators or quotes are quoted
+    if(sep_ == ',' && field.find_first_of(",\"\n") != std::string::npos)
+    {
+        to += '"';
+        for(char c : field)
+        {
+            if(c == '"') { to += '"'; }
+            to += c;
+        }
+        to += '"';
+        return;
+    }
+    to += field;
+}
+
+void
+warthog::text_result_sink::begin(const warthog::result_header& header)
+{
+    const char* cols[] =
+        {"id", "alg", "expd", "gend", "touched", "time", "cost", "scnt",
+         "sfile"};
+    for(uint32_t i = 0; i < 9; i++)
+    {
+        if(i) { buf_ += sep_; }
+        buf_ += cols[i];
+    }
+    num_extra_ = (uint32_t)std::min<size_t>(
+            header.extra_.size(), warthog::RESULT_MAX_EXTRA);
+    for(uint32_t i = 0; i < num_extra_; i++)
+    {
+        buf_ += sep_;
+        append(buf_, header.extra_[i]);
+    }
+    buf_ += '\n';
+
+    alg_.clear();
+    append(alg_, header.alg_);
+    sfile_.clear();
+    append(sfile_, header.scenario_);
+}
+
+void
+warthog::text_result_sink::write(const warthog::query_result& r)
+{
+    // numbers are formatted as an std::ostream with default flags would
+    char num[64];
+    int n = snprintf(num, sizeof(num), "%u", r.id_);
+    buf_.append(num, n);
+    buf_ += sep_;
+    buf_ += alg_;
+    n = snprintf(num, sizeof(num), "%c%u%c%u%c%u%c%g%c%g%c%u%c",
+            sep_, r.expanded_, sep_, r.inserted_, sep_, r.touched_,
+            sep_, r.time_nano_, sep_, r.cost_, sep_, r.scans_, sep_);
+    buf_.append(num, n);
+    buf_ += sfile_;
+    for(uint32_t i = 0; i < num_extra_; i++)
+    {
+        n = snprintf(num, sizeof(num), "%c%llu", sep_,
+                (unsigned long long)r.extra_[i]);
+        buf_.append(num, n);
+    }
+    buf_ += '\n';
+    if(buf_.size() >= TEXT_BUFFER_SIZE)
+    {
+        out_->write(buf_.data(), buf_.size());
+        buf_.clear();
+    }
+}
+
+void
+warthog::text_result_sink::finish()
+{
+    out_->write(buf_.data(), buf_.size());
+    out_->flush();
+    buf_.clear();
+}
+
+warthog::binary_result_sink::binary_result_sink(const std::string& filename,
+        uint32_t block_rows)
+    : out_(filename.c_str(), std::ios::binary),
+      block_rows_(std::max<uint32_t>(1, block_rows)), num_extra_(0)
+{
+    block_.reserve(block_rows_);
+}
+
+warthog::binary_result_sink::~binary_result_sink()
+{
+    finish();
+}
+
+void
+warthog::binary_result_sink::begin(const warthog::result_header& header)
+{
+    num_extra_ = (uint32_t)std::min<size_t>(
+            header.extra_.size(), warthog::RESULT_MAX_EXTRA);
+    out_.write(RESULTS_MAGIC, sizeof(RESULTS_MAGIC));
+    out_.write((const char*)&RESULTS_VERSION, sizeof(RESULTS_VERSION));
+    write_string(out_, header.alg_);
+    write_string(out_, header.scenario_);
+    out_.write((const char*)&num_extra_, sizeof(num_extra_));
+    for(uint32_t i = 0; i < num_extra_; i++)
+    {
+        write_string(out_, header.extra_[i]);
+    }
+}
+
+void
+warthog::binary_result_sink::write(const warthog::query_result& r)
+{
+    block_.push_back(r);
+    if(block_.size() >= block_rows_) { write_block(); }
+}
+
+void
+warthog::binary_result_sink::finish()
+{
+    if(!block_.empty()) { write_block(); }
+    out_.flush();
+}
+
+void
+warthog::binary_result_sink::write_block()
+{
+    typedef warthog::query_result qr;
+    uint32_t n = (uint32_t)block_.size();
+    std::vector<char> buf;
+    out_.write((const char*)&n, sizeof(n));
+    write_column(out_, block_, &qr::id_, buf);
+    write_column(out_, block_, &qr::expanded_, buf);
+    write_column(out_, block_, &qr::inserted_, buf);
+    write_column(out_, block_, &qr::touched_, buf);
+    write_column(out_, block_, &qr::time_nano_, buf);
+    write_column(out_, block_, &qr::cost_, buf);
+    write_column(out_, block_, &qr::scans_, buf);
+    buf.resize(n * sizeof(uint64_t));
+    uint64_t* col = (uint64_t*)buf.data();
+    for(uint32_t e = 0; e < num_extra_; e++)
+    {
+        for(uint32_t i = 0; i < n; i++) { col[i] = block_[i].extra_[e]; }
+        out_.write(buf.data(), buf.size());
+    }
+    block_.clear();
+}
+
+warthog::async_result_sink::async_result_sink(warthog::result_sink* sink,
+        uint32_t batch_rows, uint32_t max_batches)
+    : sink_(sink), batch_rows_(std::max<uint32_t>(1, batch_rows)),
+      max_batches_(std::max<uint32_t>(1, max_batches)),
+      busy_(false), stop_(false)
+{
+    batch_.reserve(batch_rows_);
+    worker_ = std::thread(&warthog::async_result_sink::run, this);
+}
+
+warthog::async_result_sink::~async_result_sink()
+{
+    finish();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void
+warthog::async_result_sink::begin(const warthog::result_header& header)
+{
+    // the header goes out after every row of an earlier run
+    submit();
+    drain();
+    sink_->begin(header);
+}
+
+void
+warthog::async_result_sink::finish()
+{
+    submit();
+    drain();
+    sink_->finish();
+}
+
+void
+warthog::async_result_sink::submit()
+{
+    if(batch_.empty()) { return; }
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return queue_.size() < max_batches_; });
+    queue_.push_back(std::vector<warthog::query_result>());
+    queue_.back().swap(batch_);
+    if(!spare_.empty())
+    {
+        batch_.swap(spare_.back());
+        spare_.pop_back();
+    }
+    else { batch_.reserve(batch_rows_); }
+    lock.unlock();
+    cv_.notify_all();
+}
+
+void
+warthog::async_result_sink::drain()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+}
+
+void
+warthog::async_result_sink::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true)
+    {
+        cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if(queue_.empty()) { return; }
+
+        std::vector<warthog::query_result> rows;
+        rows.swap(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        lock.unlock();
+        cv_.notify_all();
+
+        for(const warthog::query_result& r : rows) { sink_->write(r); }
+        rows.clear();
+
+        lock.lock();
+        spare_.push_back(std::vector<warthog::query_result>());
+        spare_.back().swap(rows);
+        busy_ = false;
+        cv_.notify_all();
+    }
+}
+
+warthog::result_reader::result_reader(const std::string& filename)
+    : in_(filename.c_str(), std::ios::binary), good_(false), pos_(0)
+{
+    char magic[sizeof(RESULTS_MAGIC)];
+    uint32_t version, num_extra;
+    if(!in_.read(magic, sizeof(magic)) ||
+       memcmp(magic, RESULTS_MAGIC, sizeof(magic)) != 0 ||
+       !in_.read((char*)&version, sizeof(version)) ||
+       version != RESULTS_VERSION ||
+       !read_string(in_, header_.alg_) ||
+       !read_string(in_, header_.scenario_) ||
+       !in_.read((char*)&num_extra, sizeof(num_extra)) ||
+       num_extra > warthog::RESULT_MAX_EXTRA)
+    {
+        return;
+    }
+    header_.extra_.resize(num_extra);
+    for(uint32_t i = 0; i < num_extra; i++)
+    {
+        if(!read_string(in_, header_.extra_[i])) { return; }
+    }
+    good_ = true;
+}
+
+bool
+warthog::result_reader::next(warthog::query_result& r)
+{
+    if(!good_) { return false; }
+    if(pos_ == block_.size())
+    {
+        if(!read_block()) { return false; }
+    }
+    r = block_[pos_++];
+    return true;
+}
+
+bool
+warthog::result_reader::read_block()
+{
+    typedef warthog::query_result qr;
+    uint32_t n;
+    pos_ = 0;
+    block_.clear();
+    if(!in_.read((char*)&n, sizeof(n)) || n == 0) { return false; }
+
+    block_.resize(n);
+    std::vector<char> buf;
+    bool ok = read_column(in_, block_, &qr::id_, buf) &&
+        read_column(in_, block_, &qr::expanded_, buf) &&
+        read_column(in_, block_, &qr::inserted_, buf) &&
+        read_column(in_, block_, &qr::touched_, buf) &&
+        read_column(in_, block_, &qr::time_nano_, buf) &&
+        read_column(in_, block_, &qr::cost_, buf) &&
+        read_column(in_, block_, &qr::scans_, buf);
+    buf.resize(n * sizeof(uint64_t));
+    for(uint32_t e = 0; ok && e < header_.extra_.size(); e++)
+    {
+        ok = (bool)in_.read(buf.data(), buf.size());
+        const uint64_t* col = (const uint64_t*)buf.data();
+        for(uint32_t i = 0; ok && i < n; i++) { block_[i].extra_[e] = col[i]; }
+    }
+    if(!ok)
+    {
+        // a truncated block, e.g. from a run that was killed
+        block_.clear();
+        good_ = false;
+    }
+    return ok;
+}
+
+warthog::result_sink*
+warthog::create_result_sink(const std::string& format,
+        const std::string& filename, std::string& err)
+{
+    if(format == "tsv" || format == "csv")
+    {
+        char sep = format == "tsv" ? '\t' : ',';
+        if(filename == "") { return new warthog::text_result_sink(std::cout, sep); }
+        warthog::text_result_sink* sink =
+            new warthog::text_result_sink(filename, sep);
+        if(sink->good()) { return sink; }
+        delete sink;
+    }
+    else if(format == "bin")
+    {
+        if(filename == "")
+        {
+            err = "binary results need an output file";
+            return 0;
+        }
+        warthog::binary_result_sink* sink =
+            new warthog::binary_result_sink(filename);
+        if(sink->good()) { return sink; }
+        delete sink;
+    }
+    else
+    {
+        err = "unknown result format " + format;
+        return 0;
+    }
+    err = "cannot write " + filename;
+    return 0;
+}
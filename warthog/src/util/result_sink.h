@@ -0,0 +1,246 @@
+#ifndef WARTHOG_RESULT_SINK_H
+#define WARTHOG_RESULT_SINK_H
+
+// util/result_sink.h
+//
+// Destinations for per-query experiment results. Large sweeps record
+// millions of rows, and formatting each one through an std::ostream (and
+// flushing it with std::endl) can cost more than the searches being
+// measured. A result_sink takes rows as plain structs instead:
+//
+//  - text_result_sink formats them as TSV (the historical output of the
+//    warthog program) or CSV into a large buffer that is written out in
+//    one go when it fills up;
+//  - binary_result_sink stores them column by column in blocks of rows,
+//    without any formatting; result_reader (and the resultcat program)
+//    reads them back;
+//  - async_result_sink hands rows to another sink on a background thread,
+//    so the measured loop only copies each row into a batch.
+//
+// Binary files start with the magic "WRESULTS", a version number and the
+// result_header, followed by blocks of up to block_rows rows. A block is
+// its number of rows n and then every column in turn, n values each, in
+// the order of the fields of query_result. Values are in the byte order
+// of the host.
+//
+// @author: shizhe
+// @created: 2026-10-18
+//
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace warthog
+{
+
+// most extra columns a result can have
+const uint32_t RESULT_MAX_EXTRA = 8;
+
+// the outcome of one query
+struct query_result
+{
+    uint32_t id_;
+    uint32_t expanded_;
+    uint32_t inserted_;
+    uint32_t touched_;
+    double time_nano_;
+    double cost_;
+    uint32_t scans_;
+    // values of the extra columns named in the result_header
+    uint64_t extra_[RESULT_MAX_EXTRA];
+};
+
+// what a run of results is about
+struct result_header
+{
+    std::string alg_;
+    std::string scenario_;
+    // names of the extra columns, at most RESULT_MAX_EXTRA
+    std::vector<std::string> extra_;
+};
+
+class result_sink
+{
+    public:
+        virtual ~result_sink() { }
+
+        // start a run of results described by @param header
+        virtual void
+        begin(const warthog::result_header& header) = 0;
+
+        virtual void
+        write(const warthog::query_result& r) = 0;
+
+        // write out everything received so far
+        virtual void
+        finish() = 0;
+};
+
+// rows of text with the columns id, alg, expd, gend, touched, time, cost,
+// scnt, sfile and any extra columns, separated by @param sep. every
+// ::begin prints a header row
+class text_result_sink : public result_sink
+{
+    public:
+        text_result_sink(std::ostream& out, char sep = '\t');
+        // write to the file @param filename
+        text_result_sink(const std::string& filename, char sep = '\t');
+        virtual ~text_result_sink();
+
+        // false if the output could not be written
+        inline bool
+        good() { return out_->good(); }
+
+        virtual void
+        begin(const warthog::result_header& header);
+
+        virtual void
+        write(const warthog::query_result& r);
+
+        virtual void
+        finish();
+
+    private:
+        std::ostream* out_;
+        // set if the sink opened the output itself
+        std::ofstream* file_;
+        char sep_;
+        std::string buf_;
+        // the alg and sfile columns, quoted if need be
+        std::string alg_;
+        std::string sfile_;
+        uint32_t num_extra_;
+
+        void
+        append(std::string& to, const std::string& field);
+};
+
+// the binary format described at the top of this file. a file holds one
+// run: ::begin may only be called once
+class binary_result_sink : public result_sink
+{
+    public:
+        binary_result_sink(const std::string& filename,
+                uint32_t block_rows = 65536);
+        virtual ~binary_result_sink();
+
+        // false if the file could not be written
+        inline bool
+        good() { return out_.good(); }
+
+        virtual void
+        begin(const warthog::result_header& header);
+
+        virtual void
+        write(const warthog::query_result& r);
+
+        virtual void
+        finish();
+
+    private:
+        std::ofstream out_;
+        uint32_t block_rows_;
+        uint32_t num_extra_;
+        std::vector<warthog::query_result> block_;
+
+        void
+        write_block();
+};
+
+// forwards rows to @param sink, which is not owned, from a background
+// thread. rows are passed on in batches of @param batch_rows; once
+// @param max_batches batches are waiting, ::write blocks until the
+// sink catches up
+class async_result_sink : public result_sink
+{
+    public:
+        async_result_sink(warthog::result_sink* sink,
+                uint32_t batch_rows = 4096, uint32_t max_batches = 64);
+        virtual ~async_result_sink();
+
+        virtual void
+        begin(const warthog::result_header& header);
+
+        inline virtual void
+        write(const warthog::query_result& r)
+        {
+            batch_.push_back(r);
+            if(batch_.size() >= batch_rows_) { submit(); }
+        }
+
+        // returns once @param sink has received and finished every row
+        virtual void
+        finish();
+
+    private:
+        warthog::result_sink* sink_;
+        uint32_t batch_rows_;
+        uint32_t max_batches_;
+        std::vector<warthog::query_result> batch_;
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::vector<warthog::query_result>> queue_;
+        // emptied batches, reused to avoid allocating
+        std::vector<std::vector<warthog::query_result>> spare_;
+        bool busy_;
+        bool stop_;
+        std::thread worker_;
+
+        void
+        submit();
+
+        // wait until the worker has written every submitted batch
+        void
+        drain();
+
+        void
+        run();
+};
+
+// reads the files of binary_result_sink
+class result_reader
+{
+    public:
+        result_reader(const std::string& filename);
+
+        // false if the file is missing or not a result file
+        inline bool
+        good() { return good_; }
+
+        inline const warthog::result_header&
+        get_header() { return header_; }
+
+        // @return false at the end of the file
+        bool
+        next(warthog::query_result& r);
+
+    private:
+        std::ifstream in_;
+        bool good_;
+        warthog::result_header header_;
+        std::vector<warthog::query_result> block_;
+        size_t pos_;
+
+        bool
+        read_block();
+};
+
+// @return a new sink writing @param format ("tsv", "csv" or "bin") to
+// @param filename; text goes to std::cout if no file is given. null, with
+// a reason in @param err, if the format is unknown or the file cannot be
+// written
+warthog::result_sink*
+create_result_sink(const std::string& format, const std::string& filename,
+        std::string& err);
+
+}
+
+#endif
@@ -1,10 +1,16 @@
 #include "dummy_listener.h"
 #include "flexible_astar.h"
+#include "grid_searcher.h"
+#include "helpers.h"
 #include "scenario_manager.h"
 #include "problem_instance.h"
+#include "zero_heuristic.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <random>
 
 static uint32_t head_offset = 0;
 static uint32_t tail_offset = 0;
@@ -200,17 +206,235 @@ warthog::scenario_manager::write_scenario(std::ostream& scenariofile)
 void 
 warthog::scenario_manager::sort()
 {
-	for(unsigned int i=0; i < experiments_.size(); i++)
+	std::stable_sort(experiments_.begin(), experiments_.end(),
+			[] (warthog::experiment* a, warthog::experiment* b) -> bool
+			{ return a->distance() < b->distance(); });
+}
+
+void
+warthog::scenario_manager::generate_experiments_by_start(
+		warthog::gridmap* map, uint32_t num, uint32_t goals_per_start,
+		uint64_t seed)
+{
+	std::mt19937_64 rng(seed);
+	uint32_t w = map->header_width();
+	uint32_t h = map->header_height();
+	auto random_tile = [&] (uint32_t& x, uint32_t& y) -> bool
+	{
+		for(int tries = 0; tries < MAXTRIES; tries++)
+		{
+			x = (uint32_t)(rng() % w);
+			y = (uint32_t)(rng() % h);
+			if(map->get_label(map->to_padded_id(x, y))) { return true; }
+		}
+		return false;
+	};
+
+	if(goals_per_start == 0) { goals_per_start = 1; }
+	uint32_t target = num_experiments() + num;
+	for(uint32_t round = 0; num_experiments() < target && round < 10; round++)
 	{
-		for(unsigned int j = i; j < experiments_.size(); j++)
+		// new queries are kept aside until their distances are known
+		warthog::scenario_manager batch;
+		uint32_t needed = target - num_experiments();
+		while(batch.num_experiments() < needed)
 		{
-			if(experiments_.at(j)->distance() <
-				   	experiments_.at(i)->distance())
+			uint32_t sx, sy, gx, gy;
+			if(!random_tile(sx, sy)) { break; }
+			for(uint32_t i = 0; i < goals_per_start &&
+					batch.num_experiments() < needed; i++)
 			{
-				experiment* tmp = experiments_.at(i);
-				experiments_.at(i) = experiments_.at(j);
-				experiments_.at(j) = tmp;
+				if(!random_tile(gx, gy)) { break; }
+				batch.add_experiment(new warthog::experiment(
+						sx, sy, gx, gy, w, h, 0, map->filename()));
 			}
 		}
+		if(batch.num_experiments() == 0)
+		{
+			std::cerr << "err; scenario_manager::generate_experiments_by_start"
+				<< " no traversable tiles on the map\n";
+			return;
+		}
+
+		batch.compute_distances(map);
+		batch.remove_unsolvable();
+		std::vector<warthog::experiment*>& solved = batch.experiments_;
+		experiments_.insert(experiments_.end(), solved.begin(), solved.end());
+		solved.clear();
 	}
 }
+
+namespace
+{
+
+// settles the goals of all queries that share a start during a single
+// Dijkstra search and stops the search once every goal has been expanded
+class goal_listener
+{
+    public:
+        // (padded goal id, index into the experiment list), sorted by id
+        std::vector<std::pair<warthog::grid_id_t, uint32_t>> goals_;
+        std::vector<warthog::experiment*>* experiments_;
+        uint32_t remaining_;
+        std::function<void()> stop_;
+
+        inline void
+        generate_node(warthog::search_node* parent,
+                      warthog::search_node* child,
+                      warthog::cost_t edge_cost,
+                      uint32_t edge_id) { }
+
+        inline void
+        expand_node(warthog::search_node* current)
+        {
+            auto it = std::lower_bound(goals_.begin(), goals_.end(),
+                    std::make_pair((warthog::grid_id_t)current->get_id(), (uint32_t)0));
+            if(it == goals_.end() || it->first != current->get_id())
+            { return; }
+
+            for( ; it != goals_.end() && it->first == current->get_id(); it++)
+            { experiments_->at(it->second)->set_distance(current->get_g()); }
+            if(--remaining_ == 0) { stop_(); }
+        }
+
+        inline void
+        relax_node(warthog::search_node* current) { }
+};
+
+}
+
+void
+warthog::scenario_manager::compute_distances(warthog::gridmap* map)
+{
+    struct shared_data
+    {
+        warthog::gridmap* map_;
+        std::vector<warthog::experiment*>* experiments_;
+        // experiment indexes sorted by start; group g (the queries of one
+        // start) is order_[groups_[g]] ... order_[groups_[g+1]-1]
+        std::vector<uint32_t> order_;
+        std::vector<uint32_t> groups_;
+    };
+
+    void*(*thread_compute_fn)(void*) = [] (void* args_in) -> void*
+    {
+        warthog::helpers::thread_params* par =
+            (warthog::helpers::thread_params*) args_in;
+        shared_data* shared = (shared_data*) par->shared_;
+        std::vector<warthog::experiment*>& exps = *shared->experiments_;
+
+        // every thread has its own searches; the map is only read.
+        // a start with a single goal is solved point-to-point with jps2,
+        // which is optimal and generates far fewer nodes than Dijkstra
+        warthog::grid_searcher* search =
+            warthog::create_grid_searcher("jps2", shared->map_);
+
+        warthog::gridmap_expansion_policy expander(shared->map_);
+        warthog::zero_heuristic heuristic;
+        warthog::pqueue_min open;
+        goal_listener listener;
+        warthog::flexible_astar<
+            warthog::zero_heuristic,
+            warthog::gridmap_expansion_policy,
+            warthog::pqueue_min,
+            goal_listener>
+                dijkstra(&heuristic, &expander, &open, &listener);
+        listener.experiments_ = &exps;
+        listener.stop_ = [&dijkstra] () -> void
+        { dijkstra.set_max_expansions_cutoff(0); };
+
+        for(uint32_t g = par->thread_id_; g+1 < shared->groups_.size();
+                g += par->max_threads_)
+        {
+            uint32_t first = shared->groups_.at(g);
+            uint32_t last = shared->groups_.at(g+1);
+            warthog::experiment* exp = exps.at(shared->order_.at(first));
+            warthog::grid_id_t start_id =
+                (warthog::grid_id_t)exp->starty() * exp->mapwidth() +
+                exp->startx();
+
+            if(last - first == 1)
+            {
+                warthog::problem_instance pi(start_id,
+                        (warthog::grid_id_t)exp->goaly() * exp->mapwidth() +
+                        exp->goalx());
+                warthog::solution sol;
+                search->get_pathcost(pi, sol);
+                exp->set_distance(sol.sum_of_edge_costs_);
+                par->nprocessed_++;
+                continue;
+            }
+
+            // goals never reached keep distance COST_MAX
+            listener.goals_.clear();
+            for(uint32_t i = first; i < last; i++)
+            {
+                uint32_t idx = shared->order_.at(i);
+                warthog::experiment* cur = exps.at(idx);
+                cur->set_distance(warthog::COST_MAX);
+                listener.goals_.push_back(std::make_pair(
+                    shared->map_->to_padded_id(cur->goalx(), cur->goaly()),
+                    idx));
+            }
+            std::sort(listener.goals_.begin(), listener.goals_.end());
+            listener.remaining_ = 0;
+            for(uint32_t i = 0; i < listener.goals_.size(); i++)
+            {
+                if(i == 0 || listener.goals_.at(i).first !=
+                             listener.goals_.at(i-1).first)
+                { listener.remaining_++; }
+            }
+
+            warthog::problem_instance pi(start_id);
+            warthog::solution sol;
+            dijkstra.set_max_expansions_cutoff(warthog::INF32);
+            dijkstra.get_pathcost(pi, sol);
+            par->nprocessed_++;
+        }
+        delete search;
+        return 0;
+    };
+
+    shared_data shared;
+    shared.map_ = map;
+    shared.experiments_ = &experiments_;
+    shared.order_.resize(experiments_.size());
+    for(uint32_t i = 0; i < experiments_.size(); i++) { shared.order_[i] = i; }
+
+    auto start_of = [this] (uint32_t i) -> uint64_t
+    {
+        warthog::experiment* exp = experiments_.at(i);
+        return (uint64_t)exp->starty() * exp->mapwidth() + exp->startx();
+    };
+    std::sort(shared.order_.begin(), shared.order_.end(),
+            [&start_of] (uint32_t a, uint32_t b) -> bool
+            { return start_of(a) < start_of(b); });
+    for(uint32_t i = 0; i < shared.order_.size(); i++)
+    {
+        if(i == 0 || start_of(shared.order_[i]) != start_of(shared.order_[i-1]))
+        { shared.groups_.push_back(i); }
+    }
+    shared.groups_.push_back((uint32_t)shared.order_.size());
+
+    warthog::helpers::parallel_compute(
+            thread_compute_fn, &shared, (uint32_t)shared.groups_.size()-1);
+}
+
+uint32_t
+warthog::scenario_manager::remove_unsolvable()
+{
+    uint32_t removed = 0;
+    std::vector<warthog::experiment*> solvable;
+    for(warthog::experiment* exp : experiments_)
+    {
+        if(exp->distance() == warthog::COST_MAX)
+        {
+            delete exp;
+            removed++;
+            continue;
+        }
+        solvable.push_back(exp);
+    }
+    experiments_.swap(solvable);
+    return removed;
+}
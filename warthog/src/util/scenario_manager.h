@@ -69,6 +69,24 @@ class scenario_manager
 		inline void clear() { experiments_.clear(); }
 		
 		void generate_experiments(warthog::gridmap*, int num);
+
+		// add @param num random queries with optimal distances; every start
+		// is shared by @param goals_per_start queries so compute_distances
+		// can settle them all with one search. unsolvable queries are
+		// dropped and replaced.
+		void generate_experiments_by_start(warthog::gridmap*, uint32_t num,
+				uint32_t goals_per_start, uint64_t seed = 0);
+
+		// compute the optimal distance of every experiment on @param map.
+		// queries are grouped by start and the groups are spread across
+		// threads: a group with several goals is solved by one Dijkstra
+		// search that stops once every goal is settled, a single query by
+		// one jps2 search. queries without a path get warthog::COST_MAX
+		void compute_distances(warthog::gridmap* map);
+
+		// delete all experiments with no path (i.e. distance COST_MAX)
+		// @return the number of experiments removed
+		uint32_t remove_unsolvable();
 		void load_scenario(const char* filelocation);
 		void write_scenario(std::ostream& out);
 		void sort(); // organise by increasing solution length